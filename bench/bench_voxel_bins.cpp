@@ -0,0 +1,82 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "data/Sampler.h"
+#include "data/VoxelMask.h"
+
+/**
+ * Замер границ облака и раскладки точек по ячейкам на одном облаке
+ * (по умолчанию 2^22 точек; число можно передать первым аргументом)
+ * против прежних скалярного прохода и сортировки ключей.
+ *
+ *   bench_voxel_bins [points]
+ */
+
+static double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 22;
+    if (count == 0) {
+        std::cerr << "Использование: bench_voxel_bins [points > 0]\n";
+        return 1;
+    }
+    sampler::SplitMix64 rng{5};
+    std::vector<float> v(3 * count);
+    for (size_t i = 0; i < v.size(); ++i) {
+        const size_t a = i % 3;
+        v[i] = static_cast<float>(rng.unit() * (10.0 + 5.0 * a) - 3.0 * a);
+    }
+    std::vector<int32_t> labels(count);
+    for (size_t i = 0; i < count; ++i) labels[i] = static_cast<int32_t>(i % 7);
+    std::cout << "точек: " << count << ", ядер: " << defaultThreadCount() << "\n";
+
+    // Границы: скалярный проход, SIMD в одном потоке и в нескольких
+    auto t0 = std::chrono::steady_clock::now();
+    Bounds sb;
+    for (int a = 0; a < 3; ++a) sb.lo[a] = sb.hi[a] = v[a];
+    for (size_t i = 0; i < count; ++i)
+        for (int a = 0; a < 3; ++a) {
+            sb.lo[a] = std::min(sb.lo[a], v[3 * i + a]);
+            sb.hi[a] = std::max(sb.hi[a], v[3 * i + a]);
+        }
+    std::cout << "границы: скаляр " << msSince(t0) << " мс";
+    for (int threads : {1, 2, 4}) {
+        t0 = std::chrono::steady_clock::now();
+        computeBounds(v.data(), count, 3, threads);
+        std::cout << ", потоков " << threads << " " << msSince(t0) << " мс";
+    }
+    std::cout << "\n";
+
+    // Ячейки: сортировка ключей (ячейка << 32 | метка) против подсчёта
+    const NormalizedGrid g(sb, 32, 32, 32);
+    t0 = std::chrono::steady_clock::now();
+    std::vector<uint64_t> keys(count);
+    for (size_t i = 0; i < count; ++i)
+        keys[i] = static_cast<uint64_t>(g.cell(v.data() + 3 * i)) << 32 | static_cast<uint32_t>(labels[i]);
+    std::sort(keys.begin(), keys.end());
+    std::cout << "ячейки: сортировка ключей " << msSince(t0) << " мс, подсчёт";
+    CellIndex cells;
+    binPoints(v.data(), count, g, cells, 1);  // прогрев буферов
+    for (int threads : {1, 2, 4}) {
+        t0 = std::chrono::steady_clock::now();
+        binPoints(v.data(), count, g, cells, threads);
+        std::cout << (threads > 1 ? "," : "") << " потоков " << threads << " " << msSince(t0) << " мс";
+    }
+    std::cout << "\n";
+
+    Tensor3D mask(32, 32, 32, 1);
+    std::vector<uint8_t> seg(mask.size());
+    for (int threads : {1, 2, 4}) {
+        mask.fill(0.0f);
+        std::fill(seg.begin(), seg.end(), 0);
+        t0 = std::chrono::steady_clock::now();
+        rasterizeNormalizedSeg(v.data(), labels.data(), count, mask, seg.data(), cells, threads);
+        std::cout << "rasterizeNormalizedSeg, потоков " << threads << ": " << msSince(t0) << " мс\n";
+    }
+    return 0;
+}
@@ -2,6 +2,7 @@
 import os
 import sys
 import argparse
+import struct
 import subprocess
 import numpy as np
 
@@ -71,20 +72,69 @@ def save_seg(npz_path, seg_out, vox_n=32):
         grid[i,j,k] = int(counts.argmax())
 
     # save flat
-    with open(seg_out, "w") as f:
-        for v in grid.flatten():
-            f.write(f"{v}\n")
+    flat = grid.flatten()
+    if seg_out.endswith(".seg"):
+        write_seg_compact(flat, N, seg_out)
+    else:
+        with open(seg_out, "w") as f:
+            for v in flat:
+                f.write(f"{v}\n")
     print(f"-> wrote {N**3} seg labels to {seg_out}")
 
+def _varint(v):
+    out = bytearray()
+    while v >= 0x80:
+        out.append((v & 0x7F) | 0x80)
+        v >>= 7
+    out.append(v)
+    return out
+
+def write_seg_compact(flat, N, seg_out):
+    """
+    Метки байтами в формате .seg (src/data/SegLabels.h): заголовок
+    'PGSL', версия 1, кодировка, сторона сетки, длина данных; данные —
+    самая короткая из dense / sparse (пропуск нулей + метка) / rle.
+    """
+    labels = [int(v) for v in flat]
+    if any(v < 0 or v > 255 for v in labels):
+        raise ValueError("метка сегментации вне [0, 255]")
+    sparse, zeros = bytearray(), 0
+    for v in labels:
+        if v == 0:
+            zeros += 1
+            continue
+        sparse += _varint(zeros) + bytes([v])
+        zeros = 0
+    rle, i = bytearray(), 0
+    while i < len(labels):
+        j = i + 1
+        while j < len(labels) and labels[j] == labels[i]:
+            j += 1
+        rle += _varint(j - i) + bytes([labels[i]])
+        i = j
+    enc, payload = min([(0, bytes(labels)), (1, bytes(sparse)), (2, bytes(rle))], key=lambda e: len(e[1]))
+    with open(seg_out, "wb") as f:
+        f.write(b"PGSL" + struct.pack("<BBHII", 1, enc, 0, N, len(payload)) + payload)
+
 def main():
     p = argparse.ArgumentParser()
     p.add_argument("--npz",        required=True,  help=".npz input")
-    p.add_argument("--voxelizer",  required=True,  help="path to voxelize_bin.exe")
-    p.add_argument("--out_ply",    required=True,  help="output .ply")
+    p.add_argument("--voxelizer",  help="path to voxelize_bin.exe")
+    p.add_argument("--out_ply",    help="output .ply")
     p.add_argument("--out_cls",    required=True,  help="output cls.txt")
-    p.add_argument("--out_seg",    required=True,  help="output seg.txt")
+    p.add_argument("--out_seg",    help="output seg.txt или компактный .seg")
+    p.add_argument("--out_bin",    help="только облако .bin + cls.txt: "
+                                        "DataLoader вокселизирует его сам при загрузке")
     args = p.parse_args()
 
+    if args.out_bin:
+        make_bin(args.npz, args.out_bin)
+        save_cls(args.npz, args.out_cls)
+        print("DONE.")
+        return
+    if not (args.voxelizer and args.out_ply and args.out_seg):
+        p.error("нужны --out_bin или все из --voxelizer, --out_ply, --out_seg")
+
     # 1) .npz → cloud.bin
     bin_tmp = "_tmp_pc.bin"
     make_bin(args.npz, bin_tmp)
@@ -0,0 +1,288 @@
+#include "data/Augment.h"
+#include "data/Sampler.h"
+#include "data/Shard.h"
+#include "utils/Intrin.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+SIMD_KERNELS_BEGIN
+
+namespace {
+
+using sampler::SplitMix64;
+
+constexpr int    kBits   = augment::kPackedSide;
+constexpr int    kRows   = kBits * kBits;
+constexpr size_t kVoxels = static_cast<size_t>(kRows) * kBits;
+
+uint32_t reverseBits(uint32_t v) {
+    v = ((v >> 1) & 0x55555555u) | ((v & 0x55555555u) << 1);
+    v = ((v >> 2) & 0x33333333u) | ((v & 0x33333333u) << 2);
+    v = ((v >> 4) & 0x0F0F0F0Fu) | ((v & 0x0F0F0F0Fu) << 4);
+    v = ((v >> 8) & 0x00FF00FFu) | ((v & 0x00FF00FFu) << 8);
+    return (v >> 16) | (v << 16);
+}
+
+#if defined(__AVX512F__)
+__m512i reverseBits(__m512i v) {
+    auto swap = [&](int s, uint32_t mask) {
+        const __m512i m = _mm512_set1_epi32(static_cast<int>(mask));
+        const __m128i c = _mm_cvtsi32_si128(s);
+        v = _mm512_or_si512(_mm512_and_si512(_mm512_srl_epi32(v, c), m),
+                            _mm512_sll_epi32(_mm512_and_si512(v, m), c));
+    };
+    swap(1, 0x55555555u);
+    swap(2, 0x33333333u);
+    swap(4, 0x0F0F0F0Fu);
+    swap(8, 0x00FF00FFu);
+    return _mm512_rol_epi32(v, 16);
+}
+#endif
+
+/**
+ * Транспонирование битов в плоскости (d, w) сразу во всех слоях h: после
+ * него бит w слова (d, h) стоит в бите d слова (w, h). Обмен блоков 16×16,
+ * затем 8×8 внутри них и т. д.; слова слоёв h идут подряд, поэтому каждый
+ * шаг — поэлементная операция над строкой из 32 слов.
+ */
+void transposeLayers(uint32_t* a) {
+    uint32_t m = 0x0000FFFFu;
+    for (int j = 16; j != 0; j >>= 1, m ^= m << j) {
+        for (int k = 0; k < kBits; k = (k + j + 1) & ~j) {
+            uint32_t* lo = a + k * kBits;
+            uint32_t* hi = a + (k + j) * kBits;
+            int h = 0;
+#if defined(__AVX512F__)
+            const __m512i vm = _mm512_set1_epi32(static_cast<int>(m));
+            const __m128i c  = _mm_cvtsi32_si128(j);
+            for (; h < kBits; h += 16) {
+                const __m512i x = _mm512_loadu_si512(lo + h), y = _mm512_loadu_si512(hi + h);
+                const __m512i t = _mm512_and_si512(_mm512_xor_si512(_mm512_srl_epi32(x, c), y), vm);
+                _mm512_storeu_si512(hi + h, _mm512_xor_si512(y, t));
+                _mm512_storeu_si512(lo + h, _mm512_xor_si512(x, _mm512_sll_epi32(t, c)));
+            }
+#endif
+            for (; h < kBits; ++h) {
+                const uint32_t t = ((lo[h] >> j) ^ hi[h]) & m;
+                hi[h] ^= t;
+                lo[h] ^= t << j;
+            }
+        }
+    }
+}
+
+/**
+ * Маска гашения 32 вокселей куска строки key: каждый бит — 1 с
+ * вероятностью p/256. Восемь случайных слов сливаются по битам p от
+ * младшего: 1 — OR (вероятность (1 + q)/2), 0 — AND (q/2).
+ */
+uint32_t dropMask(uint64_t seed, uint64_t key, uint32_t p) {
+    SplitMix64 g{seed + key * 0xD1B54A32D192ED03ull};
+    uint32_t m = 0;
+    for (int i = 0; i < 8; i += 2) {
+        const uint64_t r = g.next();
+        const uint32_t lo = static_cast<uint32_t>(r), hi = static_cast<uint32_t>(r >> 32);
+        m = (p >> i & 1u)       ? (m | lo) : (m & lo);
+        m = (p >> (i + 1) & 1u) ? (m | hi) : (m & hi);
+    }
+    return m;
+}
+
+uint32_t shiftBits(uint32_t v, int s) {
+    if (s >= kBits || s <= -kBits) return 0;
+    return s >= 0 ? v << s : v >> -s;
+}
+
+// Обнулить (value = 0) или выставить в 1 воксели x по установленным битам
+void scatterBits(const uint32_t* bits, float value, float* x) {
+    for (int r = 0; r < kRows; ++r)
+        for (uint32_t v = bits[r]; v; v &= v - 1)
+            x[static_cast<size_t>(r) * kBits + __builtin_ctz(v)] = value;
+}
+
+// Перестановка значений сетки n³ отображением mapVoxel (нули остаются нулями)
+template <typename T>
+void permuteValues(const augment::Transform& t, int n, T* v) {
+    const size_t voxels = static_cast<size_t>(n) * n * n;
+    thread_local std::vector<T> out;
+    out.assign(voxels, T(0));
+    size_t i = 0;
+    for (int d = 0; d < n; ++d)
+        for (int h = 0; h < n; ++h)
+            for (int w = 0; w < n; ++w, ++i) {
+                if (v[i] == T(0)) continue;
+                int od = d, oh = h, ow = w;
+                if (augment::mapVoxel(t, n, od, oh, ow))
+                    out[(static_cast<size_t>(od) * n + oh) * n + ow] = v[i];
+            }
+    std::copy(out.begin(), out.end(), v);
+}
+
+// Гашение поэлементно, теми же масками, что у битового пути (куски по 32 вокселя)
+void dropValues(const augment::Transform& t, int n, float* v) {
+    const int chunks = (n + kBits - 1) / kBits;
+    for (int r = 0; r < n * n; ++r) {
+        float* row = v + static_cast<size_t>(r) * n;
+        for (int c = 0; c < chunks; ++c) {
+            const int lo = c * kBits, hi = std::min(n, lo + kBits);
+            if (std::all_of(row + lo, row + hi, [](float x) { return x == 0.0f; })) continue;
+            const uint32_t m = dropMask(t.drop_seed, static_cast<uint64_t>(r) * chunks + c, t.drop);
+            for (int w = lo; w < hi; ++w)
+                if (m >> (w - lo) & 1u) row[w] = 0.0f;
+        }
+    }
+}
+
+bool isCube(const Tensor3D& x, int n) {
+    return x.depth() == n && x.height() == n && x.width() == n && x.channels() == 1;
+}
+
+bool moves(const augment::Transform& t) {
+    return (t.rot & 3) || t.flip[0] || t.flip[1] || t.flip[2] || t.shift[0] || t.shift[1] || t.shift[2];
+}
+
+// Маска x (уже проверенный куб n³) — битами при n = 32, иначе поэлементно
+void transformMask(const augment::Transform& t, Tensor3D& x) {
+    const int n = x.depth();
+    if (n == kBits) {
+        // Разреженную маску (обычный случай — поверхность) не распаковываем
+        // целиком: гасим прежние воксели и ставим новые
+        alignas(64) uint32_t bits[kRows];
+        shard::packBits(x.data(), kVoxels, reinterpret_cast<uint8_t*>(bits));
+        size_t ones = 0;
+        for (uint32_t v : bits) ones += static_cast<size_t>(__builtin_popcount(v));
+        const bool sparse = ones < kVoxels / 16;
+        if (sparse) scatterBits(bits, 0.0f, x.data());
+        augment::applyPacked(t, bits, bits);
+        if (sparse) scatterBits(bits, 1.0f, x.data());
+        else        shard::unpackBits(reinterpret_cast<const uint8_t*>(bits), kVoxels, x.data());
+    } else {
+        if (moves(t)) permuteValues(t, n, x.data());
+        if (t.drop) dropValues(t, n, x.data());
+    }
+}
+
+// Метки — тем же отображением; погашенные в маске x воксели — 0
+template <typename T>
+void transformLabels(const augment::Transform& t, const Tensor3D& x, T* s) {
+    if (moves(t)) permuteValues(t, x.depth(), s);
+    if (t.drop) {
+        const float* m = x.data();
+        for (int i = 0; i < x.size(); ++i)
+            if (m[i] == 0.0f) s[i] = T(0);
+    }
+}
+
+} // namespace
+
+namespace augment {
+
+Transform draw(const Config& cfg, uint64_t seed, uint64_t epoch, uint64_t index) {
+    SplitMix64 rng{sampler::epochRng(seed, epoch).next() ^ (index * 0x9E3779B97F4A7C15ull)};
+    rng.next();
+    Transform t;
+    if (cfg.rotate) t.rot = static_cast<int>(rng.below(4));
+    const bool flips[3] = {cfg.flip_x, cfg.flip_y, cfg.flip_z};
+    for (int a = 0; a < 3; ++a) t.flip[a] = flips[a] && (rng.next() & 1u);
+    const int span = 2 * std::max(cfg.max_shift, 0) + 1;
+    for (int a = 0; a < 3; ++a)
+        t.shift[a] = static_cast<int>(rng.below(static_cast<uint32_t>(span))) - (span - 1) / 2;
+    const float p = std::min(std::max(cfg.dropout, 0.0f), 1.0f);
+    t.drop      = std::min(255u, static_cast<uint32_t>(std::lround(p * 256.0f)));
+    t.drop_seed = rng.next();
+    return t;
+}
+
+bool mapVoxel(const Transform& t, int n, int& d, int& h, int& w) {
+    for (int k = 0; k < (t.rot & 3); ++k) {
+        const int nd = w;
+        w = n - 1 - d;
+        d = nd;
+    }
+    if (t.flip[0]) d = n - 1 - d;
+    if (t.flip[1]) h = n - 1 - h;
+    if (t.flip[2]) w = n - 1 - w;
+    d += t.shift[0];
+    h += t.shift[1];
+    w += t.shift[2];
+    return 0 <= d && d < n && 0 <= h && h < n && 0 <= w && w < n;
+}
+
+void applyPacked(const Transform& t, const uint32_t* in, uint32_t* out) {
+    alignas(64) uint32_t a[kRows];
+    std::memcpy(a, in, sizeof(a));
+
+    // Поворот на 90° в плоскости (d, w): (d, w) → (w, 31 − d), то есть
+    // транспонирование и разворот битов строк. Поворот на 180° — это
+    // отражения по d и w; отражения коммутируют, поэтому всё, что
+    // разворачивает биты, сводится в одно fw
+    if (t.rot & 1) transposeLayers(a);
+    const bool fd = t.flip[0] != (t.rot >= 2);
+    const bool fh = t.flip[1];
+    const bool fw = (t.flip[2] != (t.rot >= 2)) != static_cast<bool>(t.rot & 1);
+    const int  sd = t.shift[0], sh = t.shift[1], sw = t.shift[2];
+
+    // Строка d переходит в строку od целиком: слой h → oh — перестановка
+    // слов, отражение и сдвиг по w — операции над словом
+    std::memset(out, 0, sizeof(a));
+    for (int d = 0; d < kBits; ++d) {
+        const int od = (fd ? kBits - 1 - d : d) + sd;
+        if (od < 0 || od >= kBits) continue;
+        const uint32_t* src = a + d * kBits;
+        uint32_t*       dst = out + od * kBits;
+        int oh = 0;
+#if defined(__AVX512F__)
+        const __m512i lo = _mm512_loadu_si512(src), hi = _mm512_loadu_si512(src + 16);
+        const __m512i lane = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m128i cl = _mm_cvtsi32_si128(sw > 0 ? sw : 0), cr = _mm_cvtsi32_si128(sw < 0 ? -sw : 0);
+        for (; oh < kBits; oh += 16) {
+            // Слой-источник h для каждого oh; вне [0, 32) — пустое слово
+            __m512i h = _mm512_sub_epi32(_mm512_add_epi32(lane, _mm512_set1_epi32(oh)), _mm512_set1_epi32(sh));
+            if (fh) h = _mm512_sub_epi32(_mm512_set1_epi32(kBits - 1), h);
+            const __mmask16 valid = _mm512_cmplt_epu32_mask(h, _mm512_set1_epi32(kBits));
+            __m512i v = _mm512_maskz_permutex2var_epi32(valid, lo, h, hi);
+            if (fw) v = reverseBits(v);
+            v = _mm512_srl_epi32(_mm512_sll_epi32(v, cl), cr);  // сдвиг ≥ 32 даёт 0
+            _mm512_storeu_si512(dst + oh, v);
+        }
+#endif
+        for (; oh < kBits; ++oh) {
+            const int h = fh ? kBits - 1 - (oh - sh) : oh - sh;
+            if (h < 0 || h >= kBits) continue;
+            const uint32_t v = src[h];
+            dst[oh] = shiftBits(fw ? reverseBits(v) : v, sw);
+        }
+    }
+    if (t.drop)
+        for (int r = 0; r < kRows; ++r)
+            if (out[r]) out[r] &= ~dropMask(t.drop_seed, static_cast<uint64_t>(r), t.drop);
+}
+
+void apply(const Transform& t, Tensor3D& x, Tensor3D* seg) {
+    const int n = x.depth();
+    if (!isCube(x, n))
+        throw std::invalid_argument("augment::apply: маска должна быть кубом n³ с одним каналом");
+    if (seg && !isCube(*seg, n))
+        throw std::invalid_argument("augment::apply: метки seg не совпадают по форме с маской");
+    if (!moves(t) && !t.drop) return;
+    transformMask(t, x);
+    if (seg) transformLabels(t, x, seg->data());
+}
+
+void apply(const Transform& t, Tensor3D& x, std::vector<uint8_t>& seg) {
+    const int n = x.depth();
+    if (!isCube(x, n))
+        throw std::invalid_argument("augment::apply: маска должна быть кубом n³ с одним каналом");
+    if (seg.size() != static_cast<size_t>(x.size()))
+        throw std::invalid_argument("augment::apply: метки seg не совпадают по размеру с маской");
+    if (!moves(t) && !t.drop) return;
+    transformMask(t, x);
+    transformLabels(t, x, seg.data());
+}
+
+} // namespace augment
+
+SIMD_KERNELS_END
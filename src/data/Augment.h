@@ -0,0 +1,69 @@
+#pragma once
+
+#include "net/Tensor3D.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Аугментация образцов прямо на сетке вокселей.
+ *
+ * Преобразование образца — композиция (в этом порядке) поворота на k·90°
+ * вокруг вертикали (ось y облака → ось h сетки), отражений по осям и
+ * целочисленного сдвига; ушедшие за край сетки воксели теряются. Затем
+ * гасится доля dropout занятых вокселей — прореживание облака, которое
+ * работает и для шардов, где точек уже нет. Параметры образца зависят
+ * только от (seed, epoch, index): батч одинаков при любом числе потоков
+ * загрузки и на всех рангах.
+ *
+ * Маска 32³ преобразуется упакованной в биты (4 КБ вместо 128): строка
+ * вдоль w — одно 32-битное слово, поворот — транспонирование битовых
+ * матриц 32×32, отражение по w — разворот битов слова, сдвиг по w —
+ * сдвиг слова, по d и h — перенос строк; гашение — AND со случайной
+ * маской, и только у непустых строк. Метки сегментации и сетки другого
+ * размера переставляются тем же отображением поэлементно.
+ */
+namespace augment {
+
+struct Config {
+    bool  rotate    = true;   ///< поворот на k·90° вокруг вертикали
+    bool  flip_x    = true;   ///< отражение по оси d
+    bool  flip_y    = false;  ///< по вертикали (h): модели обычно не стоят вверх ногами
+    bool  flip_z    = true;   ///< по оси w
+    int   max_shift = 2;      ///< сдвиг по каждой оси в [-max_shift, max_shift]
+    float dropout   = 0.0f;   ///< доля гасимых занятых вокселей, [0, 1)
+};
+
+/// Параметры преобразования одного образца
+struct Transform {
+    int      rot      = 0;      ///< поворотов на 90°: (d, w) → (w, n−1−d)
+    bool     flip[3]  = {};     ///< по d, h, w
+    int      shift[3] = {};     ///< по d, h, w
+    uint32_t drop     = 0;      ///< вероятность гашения в 1/256
+    uint64_t drop_seed = 0;
+};
+
+/// Параметры образца index в эпохе epoch
+Transform draw(const Config& cfg, uint64_t seed, uint64_t epoch, uint64_t index);
+
+/// Куда переходит воксель (d, h, w) сетки n³; false — за край сетки
+bool mapVoxel(const Transform& t, int n, int& d, int& h, int& w);
+
+/**
+ * Преобразовать маску занятости x (куб n³, один канал) на месте и, если
+ * задано, так же — метки seg. Погашенным вокселям в seg ставится 0, как
+ * пустым.
+ */
+void apply(const Transform& t, Tensor3D& x, Tensor3D* seg = nullptr);
+/// То же с метками сегментации байтами (seg — n³ элементов)
+void apply(const Transform& t, Tensor3D& x, std::vector<uint8_t>& seg);
+
+/// Сторона сетки, которая преобразуется упакованной в биты
+constexpr int kPackedSide = 32;
+
+/**
+ * То же для маски 32³, уже упакованной в биты (раскладка shard::packBits:
+ * слово d·32 + h, бит w — воксель w). in и out могут совпадать.
+ */
+void applyPacked(const Transform& t, const uint32_t* in, uint32_t* out);
+
+} // namespace augment
@@ -0,0 +1,385 @@
+#include "data/BatchFileReader.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int uringSetup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+int uringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+// Одно чтение за раз не больше 1 ГБ — read/pread всё равно вернут не больше
+constexpr size_t kMaxChunk = size_t(1) << 30;
+
+// Прочитать файл целиком обычными вызовами (путь PreadPool)
+void readOne(BatchFileReader::Request& r) {
+    r.error = 0;
+    int fd = ::open(r.path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { r.error = errno; return; }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        r.error = errno;
+        ::close(fd);
+        return;
+    }
+    r.out->resize(static_cast<size_t>(st.st_size));
+    size_t off = 0;
+    while (off < r.out->size()) {
+        ssize_t got = ::pread(fd, r.out->data() + off, std::min(kMaxChunk, r.out->size() - off),
+                              static_cast<off_t>(off));
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0) { r.error = errno; break; }
+        if (got == 0) { r.out->resize(off); break; }  // файл укоротился после fstat
+        off += static_cast<size_t>(got);
+    }
+    ::close(fd);
+}
+
+} // namespace
+
+// ---------- кольцо io_uring ----------
+
+class BatchFileReader::Ring {
+public:
+    explicit Ring(unsigned entries) {
+        io_uring_params p{};
+        fd_ = uringSetup(entries, &p);
+        if (fd_ < 0) throw std::runtime_error(std::string("io_uring_setup: ") + std::strerror(errno));
+        sq_entries_ = p.sq_entries;
+
+        sq_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+        sq_ptr_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED) { sq_ptr_ = nullptr; fail("mmap SQ"); }
+        if (single) {
+            cq_ptr_ = sq_ptr_;
+        } else {
+            cq_ptr_ = ::mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             fd_, IORING_OFF_CQ_RING);
+            if (cq_ptr_ == MAP_FAILED) { cq_ptr_ = nullptr; fail("mmap CQ"); }
+        }
+        sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+        void* s = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd_, IORING_OFF_SQES);
+        if (s == MAP_FAILED) fail("mmap SQE");
+        sqes_ = static_cast<io_uring_sqe*>(s);
+
+        char* sq = static_cast<char*>(sq_ptr_);
+        char* cq = static_cast<char*>(cq_ptr_);
+        sq_tail_  = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_  = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        cq_head_  = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_  = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_  = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_     = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+    }
+
+    ~Ring() { release(); }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    unsigned capacity() const { return sq_entries_; }
+
+    /// Следующая запись очереди отправки (обнулённая); не больше capacity() до submitAndWait
+    io_uring_sqe* next() {
+        const unsigned tail = *sq_tail_ + pending_;
+        const unsigned idx  = tail & sq_mask_;
+        sq_array_[idx] = idx;
+        ++pending_;
+        io_uring_sqe* e = &sqes_[idx];
+        std::memset(e, 0, sizeof(*e));
+        return e;
+    }
+
+    /// Отправить накопленные записи одним вызовом и дождаться want завершений
+    void submitAndWait(unsigned want) {
+        __atomic_store_n(sq_tail_, *sq_tail_ + pending_, __ATOMIC_RELEASE);
+        unsigned to_submit = pending_;
+        pending_ = 0;
+        for (;;) {
+            int r = uringEnter(fd_, to_submit, want, IORING_ENTER_GETEVENTS);
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("io_uring_enter: ") + std::strerror(errno));
+            }
+            to_submit -= static_cast<unsigned>(r);
+            if (to_submit == 0 && ready() >= want) return;
+        }
+    }
+
+    /// Обработать все готовые завершения: fn(user_data, res)
+    template <class Fn>
+    void reap(Fn&& fn) {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& c = cqes_[head & cq_mask_];
+            fn(c.user_data, c.res);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    int           fd_ = -1;
+    unsigned      sq_entries_ = 0;
+    void*         sq_ptr_ = nullptr;
+    void*         cq_ptr_ = nullptr;
+    size_t        sq_size_ = 0, cq_size_ = 0, sqes_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned*     sq_tail_  = nullptr;
+    unsigned      sq_mask_  = 0;
+    unsigned*     sq_array_ = nullptr;
+    unsigned*     cq_head_  = nullptr;
+    unsigned*     cq_tail_  = nullptr;
+    unsigned      cq_mask_  = 0;
+    io_uring_cqe* cqes_     = nullptr;
+    unsigned      pending_  = 0;
+
+    unsigned ready() const {
+        return __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) - *cq_head_;
+    }
+
+    void release() {
+        if (sqes_) ::munmap(sqes_, sqes_size_);
+        if (cq_ptr_ && cq_ptr_ != sq_ptr_) ::munmap(cq_ptr_, cq_size_);
+        if (sq_ptr_) ::munmap(sq_ptr_, sq_size_);
+        if (fd_ >= 0) ::close(fd_);
+        sqes_ = nullptr;
+        sq_ptr_ = cq_ptr_ = nullptr;
+        fd_ = -1;
+    }
+
+    [[noreturn]] void fail(const char* what) {
+        std::string msg = std::string(what) + ": " + std::strerror(errno);
+        release();
+        throw std::runtime_error("io_uring " + msg);
+    }
+};
+
+// ---------- пул pread ----------
+
+struct BatchFileReader::Job {
+    Request*            reqs;
+    size_t              n;
+    std::atomic<size_t> next{0};
+    size_t              done  = 0;  // прочитано; под pool_mu_
+    size_t              users = 0;  // потоков пула, держащих указатель; под pool_mu_
+    std::condition_variable cv;
+};
+
+BatchFileReader::BatchFileReader(Backend backend, int threads, unsigned ring_entries)
+    : backend_(backend), ring_entries_(ring_entries ? ring_entries : 1)
+{
+    if (threads < 0) throw std::invalid_argument("BatchFileReader: threads должен быть >= 0");
+    if (backend_ == Backend::Auto)
+        backend_ = uringAvailable() ? Backend::IoUring : Backend::PreadPool;
+    else if (backend_ == Backend::IoUring && !uringAvailable())
+        throw std::runtime_error("BatchFileReader: io_uring недоступен в этом ядре");
+
+    if (backend_ == Backend::PreadPool)
+        for (int t = 0; t < threads; ++t) workers_.emplace_back([this] { poolLoop(); });
+}
+
+BatchFileReader::~BatchFileReader() {
+    {
+        std::lock_guard<std::mutex> lk(pool_mu_);
+        stop_ = true;
+    }
+    pool_cv_.notify_all();
+    for (auto& th : workers_) th.join();
+}
+
+const char* BatchFileReader::name(Backend b) {
+    switch (b) {
+    case Backend::Auto:      return "auto";
+    case Backend::IoUring:   return "io_uring";
+    case Backend::PreadPool: return "pread";
+    }
+    return "?";
+}
+
+bool BatchFileReader::uringAvailable() {
+    static const bool ok = [] {
+        io_uring_params p{};
+        int fd = uringSetup(4, &p);
+        if (fd < 0) return false;
+        // Какие операции знает ядро: OPENAT — с 5.6, READ — с 5.6
+        constexpr unsigned kOps = 256;
+        std::vector<unsigned char> buf(sizeof(io_uring_probe) + kOps * sizeof(io_uring_probe_op), 0);
+        auto* probe = reinterpret_cast<io_uring_probe*>(buf.data());
+        bool supported = ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, kOps) == 0;
+        for (unsigned op : {unsigned(IORING_OP_OPENAT), unsigned(IORING_OP_READ)})
+            supported = supported && op <= probe->last_op
+                     && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+        ::close(fd);
+        return supported;
+    }();
+    return ok;
+}
+
+void BatchFileReader::readAll(Request* reqs, size_t n) {
+    if (n == 0) return;
+    if (backend_ == Backend::IoUring) readUring(reqs, n);
+    else                              readPool(reqs, n);
+}
+
+void BatchFileReader::readUring(Request* reqs, size_t n) {
+    std::unique_ptr<Ring> ring;
+    {
+        std::lock_guard<std::mutex> lk(rings_mu_);
+        if (!free_rings_.empty()) {
+            ring = std::move(free_rings_.back());
+            free_rings_.pop_back();
+        }
+    }
+    if (!ring) ring = std::make_unique<Ring>(ring_entries_);
+
+    const size_t cap = ring->capacity();
+    std::vector<int>    fds(std::min(n, cap), -1);
+    std::vector<size_t> done(fds.size());
+    // Открытые дескрипторы пакета закрываются и тогда, когда submitAndWait
+    // бросает посреди пакета; кольцо в этом случае в пул не возвращается
+    struct FdGuard {
+        std::vector<int>& fds;
+        ~FdGuard() {
+            for (int& fd : fds)
+                if (fd >= 0) { ::close(fd); fd = -1; }
+        }
+    } guard{fds};
+    for (size_t base = 0; base < n; base += cap) {
+        const size_t m = std::min(cap, n - base);
+        Request* r = reqs + base;
+
+        // 1) Все open пакета — одной отправкой
+        for (size_t i = 0; i < m; ++i) {
+            io_uring_sqe* e = ring->next();
+            e->opcode     = IORING_OP_OPENAT;
+            e->fd         = AT_FDCWD;
+            e->addr       = reinterpret_cast<uint64_t>(r[i].path);
+            e->open_flags = O_RDONLY | O_CLOEXEC;
+            e->user_data  = i;
+        }
+        try {
+            ring->submitAndWait(static_cast<unsigned>(m));
+        } catch (...) {
+            // Часть open могла завершиться: их дескрипторы — только в очереди завершений
+            ring->reap([](uint64_t, int res) { if (res >= 0) ::close(res); });
+            throw;
+        }
+        ring->reap([&](uint64_t i, int res) {
+            fds[i] = res;
+            r[i].error = res < 0 ? -res : 0;
+        });
+
+        // 2) Размеры — fstat по уже открытым дескрипторам (метаданные в памяти)
+        for (size_t i = 0; i < m; ++i) {
+            done[i] = 0;
+            if (fds[i] < 0) continue;
+            struct stat st{};
+            if (::fstat(fds[i], &st) != 0) {
+                r[i].error = errno;
+                ::close(fds[i]);
+                fds[i] = -1;
+                continue;
+            }
+            r[i].out->resize(static_cast<size_t>(st.st_size));
+        }
+
+        // 3) Все read — одной отправкой; недочитанное добираем следующим кругом
+        for (;;) {
+            unsigned queued = 0;
+            for (size_t i = 0; i < m; ++i) {
+                if (fds[i] < 0 || done[i] >= r[i].out->size()) continue;
+                io_uring_sqe* e = ring->next();
+                e->opcode    = IORING_OP_READ;
+                e->fd        = fds[i];
+                e->addr      = reinterpret_cast<uint64_t>(r[i].out->data() + done[i]);
+                e->len       = static_cast<uint32_t>(std::min(kMaxChunk, r[i].out->size() - done[i]));
+                e->off       = done[i];
+                e->user_data = i;
+                ++queued;
+            }
+            if (queued == 0) break;
+            ring->submitAndWait(queued);
+            ring->reap([&](uint64_t i, int res) {
+                if (res == -EINTR || res == -EAGAIN) return;  // повторим
+                if (res < 0) {
+                    r[i].error = -res;
+                    ::close(fds[i]);
+                    fds[i] = -1;
+                } else if (res == 0) {
+                    r[i].out->resize(done[i]);  // файл укоротился после fstat
+                } else {
+                    done[i] += static_cast<size_t>(res);
+                }
+            });
+        }
+        for (size_t i = 0; i < m; ++i)
+            if (fds[i] >= 0) {
+                ::close(fds[i]);
+                fds[i] = -1;
+            }
+    }
+
+    std::lock_guard<std::mutex> lk(rings_mu_);
+    free_rings_.push_back(std::move(ring));
+}
+
+void BatchFileReader::readPool(Request* reqs, size_t n) {
+    Job job;
+    job.reqs = reqs;
+    job.n    = n;
+    if (!workers_.empty()) {
+        std::lock_guard<std::mutex> lk(pool_mu_);
+        jobs_.push_back(&job);
+    }
+    pool_cv_.notify_all();
+
+    // Вызывающий поток читает наравне с пулом
+    size_t mine = 0;
+    for (size_t i; (i = job.next.fetch_add(1)) < n; ++mine) readOne(reqs[i]);
+
+    std::unique_lock<std::mutex> lk(pool_mu_);
+    job.done += mine;
+    for (auto it = jobs_.begin(); it != jobs_.end(); ++it)
+        if (*it == &job) { jobs_.erase(it); break; }
+    // Job живёт на стеке: выходим, только когда его больше никто не держит
+    job.cv.wait(lk, [&] { return job.done == n && job.users == 0; });
+}
+
+void BatchFileReader::poolLoop() {
+    std::unique_lock<std::mutex> lk(pool_mu_);
+    for (;;) {
+        pool_cv_.wait(lk, [&] { return stop_ || !jobs_.empty(); });
+        if (stop_) return;
+        Job* job = jobs_.front();
+        ++job->users;
+        lk.unlock();
+        size_t mine = 0;
+        for (size_t i; (i = job->next.fetch_add(1)) < job->n; ++mine) readOne(job->reqs[i]);
+        lk.lock();
+        // Разобранную работу убираем из очереди, чтобы не крутиться на ней
+        if (!jobs_.empty() && jobs_.front() == job) jobs_.pop_front();
+        job->done += mine;
+        if (--job->users == 0 && job->done == job->n) job->cv.notify_all();
+    }
+}
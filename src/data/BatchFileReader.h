@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Пакетное чтение множества мелких файлов целиком.
+ *
+ * На холодном кэше страниц эпоха над россыпью PLY упирается не в объём,
+ * а в задержку: open и read каждого файла по очереди ждут диск. Здесь
+ * все файлы пакета отправляются разом:
+ *   - IoUring — одна отправка io_uring на все open (IORING_OP_OPENAT),
+ *     затем одна на все read, ядро обслуживает их параллельно. Кольцо
+ *     поднимается прямыми системными вызовами, без liburing;
+ *   - PreadPool — запасной путь, если io_uring недоступен (старое ядро,
+ *     seccomp, io_uring_disabled): пул потоков с open/fstat/pread.
+ * Auto выбирает IoUring, если ядро поддерживает нужные операции.
+ *
+ * readAll потокобезопасен: одновременным вызовам достаются разные кольца.
+ */
+class BatchFileReader {
+public:
+    enum class Backend { Auto, IoUring, PreadPool };
+
+    struct Request {
+        const char*        path  = nullptr;  // должна жить до конца readAll
+        std::vector<char>* out   = nullptr;  // всё содержимое файла
+        int                error = 0;        // errno; 0 — прочитан
+    };
+
+    /// threads — потоки пула PreadPool (0 — читает сам вызывающий);
+    /// ring_entries — глубина очереди io_uring
+    explicit BatchFileReader(Backend backend = Backend::Auto, int threads = 4,
+                             unsigned ring_entries = 256);
+    ~BatchFileReader();
+
+    BatchFileReader(const BatchFileReader&) = delete;
+    BatchFileReader& operator=(const BatchFileReader&) = delete;
+
+    /// Прочитать n файлов; ошибки не бросаются, а пишутся в Request::error
+    void readAll(Request* reqs, size_t n);
+
+    /// Фактический путь (Auto разрешается в конструкторе)
+    Backend backend() const { return backend_; }
+    static const char* name(Backend b);
+
+    /// Поддерживает ли ядро io_uring с OPENAT и READ
+    static bool uringAvailable();
+
+private:
+    class Ring;
+    struct Job;
+
+    Backend  backend_;
+    unsigned ring_entries_;
+
+    std::mutex                         rings_mu_;
+    std::vector<std::unique_ptr<Ring>> free_rings_;
+
+    std::mutex               pool_mu_;
+    std::condition_variable  pool_cv_;
+    std::deque<Job*>         jobs_;
+    bool                     stop_ = false;
+    std::vector<std::thread> workers_;
+
+    void readUring(Request* reqs, size_t n);
+    void readPool(Request* reqs, size_t n);
+    void poolLoop();
+};
@@ -1,9 +1,19 @@
 #include "DataLoader.h"
+#include "data/PlyIO.h"
+#include "data/PointCloudIO.h"
+#include "data/SampleCache.h"
+#include "data/Sampler.h"
+#include "data/SegLabels.h"
+#include "data/Shard.h"
+#include "data/VoxelMask.h"
 #include <dirent.h>       // для обхода директорий
+#include <fcntl.h>
+#include <unistd.h>
 #include <fstream>
-#include <sstream>
+#include <iostream>
 #include <algorithm>
-#include <array>          // для std::array
+#include <charconv>
+#include <cctype>
 #include <stdexcept>
 #include <cstring>        // для strcmp
 
@@ -14,15 +24,17 @@ DataLoader::DataLoader(const std::string& data_dir,
       val_ratio_(val_ratio)
 {
     loadFileLists(data_dir);
-    if (voxel_files_.empty())
-        throw std::runtime_error("DataLoader: нет PLY-файлов в " + data_dir);
-    split_index_ = static_cast<size_t>(voxel_files_.size() * (1.0f - val_ratio_));
+    if (num_samples_ == 0)
+        throw std::runtime_error("DataLoader: нет PLY, облаков .bin или шардов в " + data_dir);
+    split_index_ = static_cast<size_t>(num_samples_ * (1.0f - val_ratio_));
+    val_pos_     = split_index_;
 }
 
 void DataLoader::loadFileLists(const std::string& data_dir) {
     DIR* dir = opendir(data_dir.c_str());
     if (!dir) throw std::runtime_error("Не удалось открыть директорию: " + data_dir);
 
+    std::vector<std::string> shard_files, cloud_stems, seg_bins, cls_files;
     struct dirent* entry;
     while ((entry = readdir(dir)) != nullptr) {
         if (std::strcmp(entry->d_name, ".") == 0 ||
@@ -30,111 +42,413 @@ void DataLoader::loadFileLists(const std::string& data_dir) {
             continue;
 
         std::string fname = entry->d_name;
-        if (fname.size() > 4 && fname.substr(fname.size() - 4) == ".ply") {
-            std::string stem = fname.substr(0, fname.size() - 4);
+        if (fname.size() > 4 && fname.substr(fname.size() - 4) == ".ply")
             voxel_files_.push_back(data_dir + "/" + fname);
-            cls_label_files_.push_back(data_dir + "/" + stem + "_cls.txt");
-            seg_label_files_.push_back(data_dir + "/" + stem + "_seg.txt");
-        }
+        else if (fname.size() > 4 && fname.substr(fname.size() - 4) == ".seg")
+            seg_bins.push_back(data_dir + "/" + fname);
+        else if (fname.size() > 4 && fname.substr(fname.size() - 4) == ".pgs")
+            shard_files.push_back(data_dir + "/" + fname);
+        else if (fname.size() > 4 && fname.substr(fname.size() - 4) == ".bin")
+            cloud_stems.push_back(data_dir + "/" + fname.substr(0, fname.size() - 4));
+        else if (fname.size() > 8 && fname.substr(fname.size() - 8) == "_cls.txt")
+            cls_files.push_back(data_dir + "/" + fname);
     }
     closedir(dir);
 
-    std::sort(voxel_files_.begin(),     voxel_files_.end());
-    std::sort(cls_label_files_.begin(), cls_label_files_.end());
-    std::sort(seg_label_files_.begin(), seg_label_files_.end());
+    // Шарды заменяют россыпь PLY целиком
+    if (!shard_files.empty()) {
+        voxel_files_.clear();
+        std::sort(shard_files.begin(), shard_files.end());
+        for (const auto& f : shard_files) {
+            auto sh = std::make_shared<const MappedShard>(f);
+            if (sh->grid() != 32)
+                throw std::runtime_error("DataLoader: шард " + f + " не для сетки 32³");
+            for (size_t i = 0; i < sh->size(); ++i)
+                shard_pos_.emplace_back(static_cast<uint32_t>(shards_.size()), static_cast<uint32_t>(i));
+            shards_.push_back(std::move(sh));
+        }
+        num_samples_ = shard_pos_.size();
+        return;
+    }
+    // Облака .bin — только если нет уже вокселизированных PLY. Облаком
+    // считается .bin с меткой <stem>_cls.txt: чекпоинты и прочие бинарные
+    // файлы рядом с данными пропускаются
+    if (voxel_files_.empty()) {
+        std::sort(cls_files.begin(), cls_files.end());
+        for (const auto& stem : cloud_stems) {
+            if (!std::binary_search(cls_files.begin(), cls_files.end(), stem + "_cls.txt")) {
+                std::cerr << "DataLoader: пропуск " << stem << ".bin — нет " << stem << "_cls.txt\n";
+                continue;
+            }
+            voxel_files_.push_back(stem + ".bin");
+        }
+        raw_clouds_ = !voxel_files_.empty();
+    }
+    num_samples_ = voxel_files_.size();
+
+    // Порядок задают имена файлов образцов; метки выводятся из них, а не
+    // сортируются отдельно: у основ x и x_a порядок x.ply < x_a.ply, но
+    // x_a_cls.txt < x_cls.txt
+    std::sort(voxel_files_.begin(), voxel_files_.end());
+    for (const auto& f : voxel_files_)
+        cls_label_files_.push_back(f.substr(0, f.size() - 4) + "_cls.txt");
+
+    // Метки сегментации PLY: компактный <stem>.seg, если есть, иначе <stem>_seg.txt
+    if (raw_clouds_) return;
+    std::sort(seg_bins.begin(), seg_bins.end());
+    for (const auto& ply : voxel_files_) {
+        const std::string stem = ply.substr(0, ply.size() - 4);
+        const bool compact = std::binary_search(seg_bins.begin(), seg_bins.end(), stem + ".seg");
+        seg_label_files_.push_back(stem + (compact ? ".seg" : "_seg.txt"));
+    }
+}
+
+namespace {
+
+void ensureMaskShape(Tensor3D& x, int n = 32) {
+    if (x.depth() != n || x.height() != n || x.width() != n || x.channels() != 1)
+        x = Tensor3D(n, n, n, 1);
+}
+
+// Буфер координат живёт в потоке загрузки и не перевыделяется от файла к файлу
+std::vector<float>& pointBuffer() {
+    thread_local std::vector<float> xyz;
+    return xyz;
+}
+
+// Маска из точек: облака .bin нормируются в сетку n³, PLY уже в координатах вокселей
+void pointsToMask(const std::vector<float>& xyz, bool raw_cloud, int n, Tensor3D& x) {
+    ensureMaskShape(x, n);
+    x.fill(0.0f);
+    if (raw_cloud) rasterizeNormalized(xyz.data(), xyz.size() / 3, x);
+    else           rasterizePoints(xyz.data(), xyz.size() / 3, x);
+}
+
+// Первое целое из содержимого файла меток
+int parseFirstLabel(const char* p, const char* end, const std::string& path) {
+    while (p < end && std::isspace(static_cast<unsigned char>(*p))) ++p;
+    int label = 0;
+    if (std::from_chars(p, end, label).ec != std::errc())
+        throw std::runtime_error("Пустой файл меток: " + path);
+    return label;
+}
+
+// Первое целое из файла меток; небольшой буфер на стеке вместо потока
+int readFirstLabel(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("Не удалось открыть labels: " + path);
+    char buf[64];
+    ssize_t n = ::read(fd, buf, sizeof(buf));
+    ::close(fd);
+    return parseFirstLabel(buf, buf + (n > 0 ? n : 0), path);
+}
+
+// Укоротить или удлинить v до n, откладывая лишние элементы в spare
+template <typename T>
+void resizeKeeping(std::vector<T>& v, std::vector<T>& spare, size_t n) {
+    while (v.size() > n) {
+        spare.push_back(std::move(v.back()));
+        v.pop_back();
+    }
+    bool grew = false;
+    while (v.size() < n) {
+        if (spare.empty()) {
+            v.emplace_back();
+            grew = true;
+        } else {
+            v.push_back(std::move(spare.back()));
+            spare.pop_back();
+        }
+    }
+    // Место под все элементы в spare — сразу, пока и так выделяем:
+    // иначе первое укорочение батча выделило бы память в установившемся режиме
+    if (grew) spare.reserve(v.size());
+}
+
+} // namespace
+
+void SampleBatch::resize(size_t n) {
+    resizeKeeping(x, spare_, n);
+    y.resize(n);
+}
+
+void SegBatch::resize(size_t n) {
+    resizeKeeping(x, spare_x_, n);
+    resizeKeeping(y, spare_y_, n);
+}
+
+std::vector<size_t> DataLoader::nextBatchIndices(bool train) {
+    std::vector<size_t> idx;
+    nextBatchIndices(train, idx);
+    return idx;
+}
+
+void DataLoader::nextBatchIndices(bool train, std::vector<size_t>& idx) {
+    const size_t end = train ? split_index_ : num_samples_;
+    size_t&      pos = train ? train_pos_   : val_pos_;
+
+    // Глобальный батч — до batch_size_ образцов, последний в эпохе короче;
+    // ранг берёт свою непрерывную часть
+    const size_t n  = pos < end ? std::min(static_cast<size_t>(batch_size_), end - pos) : 0;
+    const size_t lo = n * shard_rank_ / shard_world_;
+    const size_t hi = n * (shard_rank_ + 1) / shard_world_;
+    idx.clear();
+    const bool permuted = train && !train_order_.empty();
+    for (size_t i = pos + lo; i < pos + hi; ++i)
+        idx.push_back(permuted ? train_order_[i] : i);
+    pos += n;
+}
+
+void DataLoader::loadSample(size_t index, Tensor3D& x, int& label) const {
+    if (cache_ && cache_->get(index, x, label)) return;
+    loadUncached(index, x, label);
+}
+
+void DataLoader::loadUncached(size_t index, Tensor3D& x, int& label) const {
+    if (sharded()) {
+        const auto& p = shard_pos_[index];
+        shards_[p.first]->unpackOccupancy(p.second, x);
+        label = shards_[p.first]->label(p.second);
+    } else if (raw_clouds_) {
+        std::vector<float>& xyz = pointBuffer();
+        readPointCloudBin(voxel_files_[index], xyz);
+        pointsToMask(xyz, true, grid_, x);
+        label = readFirstLabel(cls_label_files_[index]);
+    } else {
+        loadVoxelMask(voxel_files_[index], x);
+        label = readFirstLabel(cls_label_files_[index]);
+    }
+    if (cache_) cache_->put(index, x, label);
+}
+
+void DataLoader::enableCache(size_t budget_bytes) {
+    cache_ = budget_bytes ? std::make_shared<SampleCache>(budget_bytes) : nullptr;
+}
+
+void DataLoader::enableAugmentation(const augment::Config& cfg, uint64_t seed) {
+    if (cfg.max_shift < 0)
+        throw std::invalid_argument("DataLoader::enableAugmentation: max_shift < 0");
+    if (!(cfg.dropout >= 0.0f && cfg.dropout < 1.0f))
+        throw std::invalid_argument("DataLoader::enableAugmentation: dropout вне [0, 1)");
+    augment_      = std::make_shared<const augment::Config>(cfg);
+    augment_seed_ = seed;
+}
+
+void DataLoader::augmentSample(size_t index, uint64_t epoch, Tensor3D& x, Tensor3D* seg) const {
+    if (!augment_ || index >= split_index_) return;
+    augment::apply(augment::draw(*augment_, augment_seed_, epoch, index), x, seg);
+}
+
+void DataLoader::augmentSample(size_t index, uint64_t epoch, Tensor3D& x, std::vector<uint8_t>& seg) const {
+    if (!augment_ || index >= split_index_) return;
+    augment::apply(augment::draw(*augment_, augment_seed_, epoch, index), x, seg);
+}
+
+void DataLoader::loadAugmented(size_t index, uint64_t epoch, Tensor3D& x, int& label) const {
+    constexpr int n = augment::kPackedSide;
+    if (!augment_ || index >= split_index_ || grid_ != n) {
+        loadSample(index, x, label);
+        augmentSample(index, epoch, x);
+        return;
+    }
+    // Биты маски берутся из кэша или шарда без распаковки во float
+    alignas(64) uint32_t bits[n * n];
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(bits);
+    bool packed = false;
+    if (cache_) {
+        packed = cache_->getBits(index, n, n, n, bytes, label);
+    } else if (sharded()) {
+        const auto& p = shard_pos_[index];
+        std::memcpy(bits, shards_[p.first]->occupancy(p.second), sizeof(bits));
+        label = shards_[p.first]->label(p.second);
+        packed = true;
+    }
+    if (!packed) {
+        // Промах кэша или файл без кэша: загрузка (и запись в кэш), затем float-путь
+        loadUncached(index, x, label);
+        augmentSample(index, epoch, x);
+        return;
+    }
+    augment::applyPacked(augment::draw(*augment_, augment_seed_, epoch, index), bits, bits);
+    ensureMaskShape(x, n);
+    shard::unpackBits(bytes, static_cast<size_t>(n) * n * n, x.data());
+}
+
+void DataLoader::enableBatchedIo(BatchFileReader::Backend backend, int threads) {
+    io_ = std::make_shared<BatchFileReader>(backend, threads);
+}
+
+void DataLoader::fetchRaw(const size_t* index, size_t n, RawSample* raw) const {
+    if (!batchedIo())
+        throw std::logic_error("DataLoader::fetchRaw без enableBatchedIo или над шардами");
+    thread_local std::vector<BatchFileReader::Request> reqs;
+    thread_local std::vector<size_t>                   owner;
+    reqs.clear();
+    owner.clear();
+    for (size_t i = 0; i < n; ++i) {
+        RawSample& r = raw[i];
+        r.error  = 0;
+        r.cached = cache_ && cache_->contains(index[i]);
+        if (r.cached) continue;
+        reqs.push_back({voxel_files_[index[i]].c_str(),     &r.points, 0});
+        reqs.push_back({cls_label_files_[index[i]].c_str(), &r.cls, 0});
+        owner.push_back(i);
+        owner.push_back(i);
+    }
+    io_->readAll(reqs.data(), reqs.size());
+    for (size_t k = 0; k < reqs.size(); ++k)
+        if (reqs[k].error && !raw[owner[k]].error) raw[owner[k]].error = reqs[k].error;
+}
+
+void DataLoader::loadSample(size_t index, const RawSample& raw, Tensor3D& x, int& label) const {
+    // Из кэша или после ошибки чтения — обычный путь (он и бросит понятную ошибку)
+    if (raw.cached || raw.error) {
+        loadSample(index, x, label);
+        return;
+    }
+    std::vector<float>& xyz = pointBuffer();
+    if (raw_clouds_) parsePointCloudBin(raw.points.data(), raw.points.size(), voxel_files_[index], xyz);
+    else             parsePlyVertices(raw.points.data(), raw.points.size(), voxel_files_[index], xyz);
+    pointsToMask(xyz, raw_clouds_, grid_, x);
+    label = parseFirstLabel(raw.cls.data(), raw.cls.data() + raw.cls.size(), cls_label_files_[index]);
+    if (cache_) cache_->put(index, x, label);
 }
 
 std::pair<std::vector<Tensor3D>, std::vector<int>>
 DataLoader::nextBatch(bool train) {
-    auto& files  = voxel_files_;
-    auto& labs   = cls_label_files_;
-    size_t start = train ? 0            : split_index_;
-    size_t end   = train ? split_index_ : files.size();
-    size_t& pos  = train ? train_pos_   : val_pos_;
+    SampleBatch b;
+    nextBatch(b, train);
+    return {std::move(b.x), std::move(b.y)};
+}
 
-    std::vector<Tensor3D> batchX;
-    std::vector<int>       batchY;
-    batchX.reserve(batch_size_);
-    batchY.reserve(batch_size_);
+void DataLoader::nextBatch(SampleBatch& out, bool train) {
+    nextBatchIndices(train, batch_index_);
+    out.resize(batch_index_.size());
+    for (size_t i = 0; i < batch_index_.size(); ++i)
+        loadAugmented(batch_index_[i], epoch_, out.x[i], out.y[i]);
+}
 
-    for (int i = 0; i < batch_size_; ++i) {
-        if (pos >= end) pos = start;
-        batchX.push_back(loadVoxelMask(files[pos]));
-        auto lbls = loadLabels(labs[pos]);
-        if (lbls.empty())
-            throw std::runtime_error("Пустой файл меток: " + labs[pos]);
-        batchY.push_back(lbls[0]);
-        ++pos;
+void DataLoader::loadSegSample(size_t index, Tensor3D& x, std::vector<uint8_t>& seg) const {
+    if (sharded()) {
+        const auto& p = shard_pos_[index];
+        shards_[p.first]->unpackOccupancy(p.second, x);
+        shards_[p.first]->unpackSeg(p.second, seg);
+        return;
+    }
+    if (raw_clouds_) {
+        thread_local std::vector<int32_t> labels;
+        thread_local CellIndex            cells;
+        std::vector<float>& xyz = pointBuffer();
+        readPointCloudBin(voxel_files_[index], xyz, &labels);
+        ensureMaskShape(x, grid_);
+        x.fill(0.0f);
+        seg.assign(static_cast<size_t>(x.size()), 0);
+        rasterizeNormalizedSeg(xyz.data(), labels.data(), labels.size(), x, seg.data(), cells);
+        return;
     }
-    return {batchX, batchY};
+    loadVoxelMask(voxel_files_[index], x);
+    seglabels::read(seg_label_files_[index], 32, seg);
 }
 
-std::pair<std::vector<Tensor3D>, std::vector<Tensor3D>>
-DataLoader::nextSegBatch(bool train) {
-    auto& files  = voxel_files_;
-    auto& segs   = seg_label_files_;
-    size_t start = train ? 0            : split_index_;
-    size_t end   = train ? split_index_ : files.size();
-    size_t& pos  = train ? train_pos_   : val_pos_;
+void DataLoader::loadSegSample(size_t index, Tensor3D& x, Tensor3D& seg) const {
+    thread_local std::vector<uint8_t> labels;
+    loadSegSample(index, x, labels);
+    ensureMaskShape(seg, x.depth());
+    shard::widenLabels(labels.data(), labels.size(), seg.data());
+}
 
-    std::vector<Tensor3D> batchX;
-    std::vector<Tensor3D> batchY;
-    batchX.reserve(batch_size_);
-    batchY.reserve(batch_size_);
+void DataLoader::nextSegBatch(SegBatch& out, bool train) {
+    nextBatchIndices(train, batch_index_);
+    out.resize(batch_index_.size());
+    for (size_t i = 0; i < batch_index_.size(); ++i) {
+        loadSegSample(batch_index_[i], out.x[i], out.y[i]);
+        augmentSample(batch_index_[i], epoch_, out.x[i], out.y[i]);
+    }
+}
 
-    for (int i = 0; i < batch_size_; ++i) {
-        if (pos >= end) pos = start;
-        batchX.push_back(loadVoxelMask(files[pos]));
-        batchY.push_back(loadSegMask(segs[pos]));
-        ++pos;
+std::pair<std::vector<Tensor3D>, std::vector<Tensor3D>>
+DataLoader::nextSegBatch(bool train) {
+    SegBatch b;
+    nextSegBatch(b, train);
+    std::vector<Tensor3D> batchY(b.y.size());
+    for (size_t i = 0; i < b.y.size(); ++i) {
+        ensureMaskShape(batchY[i], b.x[i].depth());
+        shard::widenLabels(b.y[i].data(), b.y[i].size(), batchY[i].data());
     }
-    return {batchX, batchY};
+    return {std::move(b.x), std::move(batchY)};
 }
 
 void DataLoader::reset() {
-    train_pos_ = 0;
-    val_pos_   = 0;
+    reset(epoch_ + 1);
 }
 
-Tensor3D DataLoader::loadVoxelMask(const std::string& ply_path) {
-    std::ifstream in(ply_path);
-    if (!in) throw std::runtime_error("Не удалось открыть PLY: " + ply_path);
-
-    std::string line;
-    size_t vertex_count = 0;
+void DataLoader::reset(uint64_t epoch) {
+    train_pos_ = 0;
+    val_pos_   = split_index_;
+    if (epoch != epoch_) {
+        epoch_ = epoch;
+        buildOrder();
+    }
+}
 
-    while (std::getline(in, line)) {
-        if (line.rfind("element vertex", 0) == 0) {
-            std::istringstream iss(line);
-            std::string elem, vert;
-            iss >> elem >> vert >> vertex_count;
+void DataLoader::setOrder(Order order, uint64_t seed) {
+    order_ = order;
+    seed_  = seed;
+    if (order_ == Order::Stratified && train_labels_.empty()) {
+        train_labels_.resize(split_index_);
+        for (size_t i = 0; i < split_index_; ++i) {
+            if (sharded()) {
+                const auto& p = shard_pos_[i];
+                train_labels_[i] = shards_[p.first]->label(p.second);
+                continue;
+            }
+            train_labels_[i] = readFirstLabel(cls_label_files_[i]);
         }
-        if (line == "end_header") break;
     }
+    // Перемешанные записи читаются вразнобой — опережающее чтение шардов впустую
+    for (const auto& sh : shards_) sh->adviseRandom(order_ != Order::Sequential);
+    buildOrder();
+}
 
-    // Объявляем points с пробелом между '>' для совместимости
-    std::vector<std::array<float,3> > points(vertex_count);
-    for (size_t i = 0; i < vertex_count; ++i) {
-        in >> points[i][0] >> points[i][1] >> points[i][2];
+void DataLoader::buildOrder() {
+    switch (order_) {
+    case Order::Sequential: train_order_.clear(); break;
+    case Order::Shuffle:    train_order_ = sampler::permutation(split_index_, seed_, epoch_); break;
+    case Order::Stratified: train_order_ = sampler::stratified(train_labels_, seed_, epoch_); break;
     }
+}
 
-    const int D = 32, H = 32, W = 32;
-    Tensor3D mask(D, H, W, 1);
-    mask.fill(0.0f);
+void DataLoader::setVoxelGrid(int n) {
+    if (n < 1)
+        throw std::invalid_argument("DataLoader::setVoxelGrid: сторона сетки должна быть положительной");
+    if (!raw_clouds_ && n != 32)
+        throw std::invalid_argument("DataLoader::setVoxelGrid: PLY и шарды вокселизированы под 32³");
+    grid_ = n;
+    if (cache_) cache_ = std::make_shared<SampleCache>(cache_->budget());
+}
 
-    for (auto& p3 : points) {
-        int x = static_cast<int>(p3[0]);
-        int y = static_cast<int>(p3[1]);
-        int z = static_cast<int>(p3[2]);
-        if (0 <= x && x < D &&
-            0 <= y && y < H &&
-            0 <= z && z < W) {
-            mask(x, y, z, 0) = 1.0f;
-        }
-    }
+void DataLoader::setShard(int rank, int world) {
+    if (world < 1 || rank < 0 || rank >= world)
+        throw std::invalid_argument("DataLoader::setShard: rank вне [0, world)");
+    shard_rank_  = rank;
+    shard_world_ = world;
+}
+
+Tensor3D DataLoader::loadVoxelMask(const std::string& ply_path) {
+    Tensor3D mask;
+    loadVoxelMask(ply_path, mask);
     return mask;
 }
 
+void DataLoader::loadVoxelMask(const std::string& ply_path, Tensor3D& mask) {
+    std::vector<float>& xyz = pointBuffer();
+    readPlyVertices(ply_path, xyz);
+
+    ensureMaskShape(mask);
+    mask.fill(0.0f);
+    rasterizePoints(xyz.data(), xyz.size() / 3, mask);
+}
+
 std::vector<int> DataLoader::loadLabels(const std::string& labels_path) {
     std::ifstream in(labels_path);
     if (!in) throw std::runtime_error("Не удалось открыть labels: " + labels_path);
@@ -145,18 +459,9 @@ std::vector<int> DataLoader::loadLabels(const std::string& labels_path) {
 }
 
 Tensor3D DataLoader::loadSegMask(const std::string& seg_path) {
-    std::ifstream in(seg_path);
-    if (!in) throw std::runtime_error("Не удалось открыть seg: " + seg_path);
-    const int D = 32, H = 32, W = 32;
-    Tensor3D mask(D, H, W, 1);
-    for (int d = 0; d < D; ++d) {
-        for (int h = 0; h < H; ++h) {
-            for (int w = 0; w < W; ++w) {
-                int lbl;
-                in >> lbl;
-                mask(d, h, w, 0) = static_cast<float>(lbl);
-            }
-        }
-    }
+    std::vector<uint8_t> labels;
+    seglabels::read(seg_path, 32, labels);
+    Tensor3D mask(32, 32, 32, 1);
+    shard::widenLabels(labels.data(), labels.size(), mask.data());
     return mask;
 }
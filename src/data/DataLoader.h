@@ -1,10 +1,68 @@
 #pragma once
 
+#include "data/Augment.h"
+#include "data/BatchFileReader.h"
 #include "net/Tensor3D.h"
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <utility>
 
+class MappedShard;
+class SampleCache;
+
+/**
+ * Батч образцов, которым владеет вызывающий. Загрузчик пишет маски прямо
+ * в тензоры x, не пересоздавая их, поэтому один и тот же SampleBatch,
+ * переданный снова, не требует выделений памяти. resize не освобождает
+ * лишние тензоры (короткий последний батч эпохи), а откладывает их до
+ * следующего увеличения.
+ */
+struct SampleBatch {
+    std::vector<Tensor3D> x;
+    std::vector<int>      y;
+
+    void resize(size_t n);
+
+private:
+    std::vector<Tensor3D> spare_;
+};
+
+/**
+ * Батч сегментации: маски x и метки вокселей y байтами (n³ на образец).
+ * Как и SampleBatch, переиспользуется между вызовами без выделений.
+ */
+struct SegBatch {
+    std::vector<Tensor3D>             x;
+    std::vector<std::vector<uint8_t>> y;
+
+    void resize(size_t n);
+
+private:
+    std::vector<Tensor3D>             spare_x_;
+    std::vector<std::vector<uint8_t>> spare_y_;
+};
+
+/**
+ * Загрузчик датасета 32³. Источник — директория data_dir:
+ *   - шарды *.pgs (make_shards), если они там есть: образцы берутся
+ *     из отображённых файлов в порядке имён шардов и записей в них;
+ *   - иначе тройки <stem>.ply, <stem>_cls.txt и метки сегментации —
+ *     компактный <stem>.seg (SegLabels.h), если он есть, иначе <stem>_seg.txt;
+ *   - если нет и PLY — «сырые» облака <stem>.bin (scripts/extract_pc.py)
+ *     с <stem>_cls.txt (.bin без _cls.txt пропускается с предупреждением
+ *     — это не облако, а, например, чекпоинт): они вокселизируются прямо при загрузке
+ *     (rasterizeNormalized, метки сегментации — голосованием точек),
+ *     так что офлайн-вокселизация не нужна, а сетку можно сменить
+ *     setVoxelGrid без пересборки датасета.
+ *
+ * Первые (1 − val_ratio) образцов — обучающая часть, остальные —
+ * валидационная. Эпоха — один проход по каждой части: последний батч
+ * может быть неполным, после него nextBatch возвращает пустой батч до
+ * reset(). Обучающая часть обходится в порядке setOrder, валидационная —
+ * всегда по порядку.
+ */
 class DataLoader {
 public:
     DataLoader(const std::string& data_dir,
@@ -14,16 +72,135 @@ public:
     std::pair<std::vector<Tensor3D>, std::vector<int>>
     nextBatch(bool train = true);
 
+    /// Следующий батч — прямо в буферы out (пустой в конце эпохи)
+    void nextBatch(SampleBatch& out, bool train = true);
+
+    /// Батч сегментации с метками float (расширяются из байтов)
     std::pair<std::vector<Tensor3D>, std::vector<Tensor3D>>
     nextSegBatch(bool train = true);
+    /// Батч сегментации прямо в буферы out, метки — байтами
+    void nextSegBatch(SegBatch& out, bool train = true);
+
+    /// Порядок обхода обучающей части
+    enum class Order {
+        Sequential,  ///< по порядку файлов/шардов
+        Shuffle,     ///< новая случайная перестановка каждую эпоху
+        Stratified   ///< перестановка с классами, равномерно разнесёнными по эпохе
+    };
+
+    /**
+     * Перестановка эпохи определяется только (seed, номер эпохи), поэтому
+     * ранги с одинаковым seed собирают одни и те же глобальные батчи.
+     * Для Stratified метки всех обучающих образцов читаются один раз
+     * (у шардов — из индекса, без распаковки масок).
+     */
+    void setOrder(Order order, uint64_t seed = 0);
+    Order order() const { return order_; }
 
+    /// Начать следующую эпоху: курсоры в начало, новая перестановка
     void reset();
+    /// Начать эпоху с номером epoch (например, при продолжении обучения)
+    void reset(uint64_t epoch);
+    uint64_t epoch() const { return epoch_; }
+
+    /**
+     * Индексы образцов следующего батча этого ранга (курсоры сдвигаются
+     * так же, как в nextBatch; в конце эпохи — пустой вектор). Вместе с loadSample позволяет загружать
+     * батч вне потока обучения (PrefetchLoader).
+     */
+    std::vector<size_t> nextBatchIndices(bool train = true);
+    /// То же в вектор вызывающего (его ёмкость переиспользуется)
+    void nextBatchIndices(bool train, std::vector<size_t>& out);
+
+    /// Маска и метка класса образца index; только читает списки файлов.
+    /// x пересоздаётся, только если его форма не 32³×1
+    void loadSample(size_t index, Tensor3D& x, int& label) const;
+    /// Маска и метки сегментации образца index (seg — x.size() байт)
+    void loadSegSample(size_t index, Tensor3D& x, std::vector<uint8_t>& seg) const;
+    /// То же с метками float
+    void loadSegSample(size_t index, Tensor3D& x, Tensor3D& seg) const;
+
+    /**
+     * Кэшировать образцы loadSample/nextBatch в памяти в пределах
+     * budget_bytes (сжатыми, с LRU-вытеснением), чтобы эпохи после первой
+     * не читали диск. 0 — выключить.
+     */
+    void enableCache(size_t budget_bytes);
+    const SampleCache* cache() const { return cache_.get(); }
+
+    /**
+     * Случайные повороты, отражения, сдвиги и гашение вокселей обучающих
+     * образцов (Augment.h). Применяются nextBatch, nextSegBatch и
+     * PrefetchLoader после загрузки (в кэше лежат исходные образцы);
+     * валидационная часть не меняется.
+     */
+    void enableAugmentation(const augment::Config& cfg, uint64_t seed = 0);
+    void disableAugmentation() { augment_.reset(); }
+    bool augmenting() const { return augment_ != nullptr; }
+    /// Аугментировать образец index эпохи epoch (маску и, если задано, метки seg)
+    void augmentSample(size_t index, uint64_t epoch, Tensor3D& x, Tensor3D* seg = nullptr) const;
+    void augmentSample(size_t index, uint64_t epoch, Tensor3D& x, std::vector<uint8_t>& seg) const;
+    /**
+     * loadSample + augmentSample. Маска 32³ из кэша или шарда
+     * преобразуется ещё упакованной и распаковывается один раз; через
+     * float идёт только первая загрузка файла.
+     */
+    void loadAugmented(size_t index, uint64_t epoch, Tensor3D& x, int& label) const;
+
+    /**
+     * Пакетное чтение файлов образцов (не для шардов): fetchRaw читает
+     * файлы точек (.ply или .bin) и _cls.txt всех образцов пакета одной
+     * отправкой io_uring или пулом pread, loadSample(index, raw, …)
+     * разбирает и вокселизирует их из памяти.
+     * Образцы, уже лежащие в кэше, не читаются.
+     */
+    void enableBatchedIo(BatchFileReader::Backend backend = BatchFileReader::Backend::Auto,
+                         int threads = 4);
+    bool batchedIo() const { return io_ && !sharded(); }
+    const BatchFileReader* io() const { return io_.get(); }
+
+    /// Сырые байты файлов одного образца
+    struct RawSample {
+        std::vector<char> points, cls;  // .ply или .bin; _cls.txt
+        int  error  = 0;      // errno чтения; образец читается заново обычным путём
+        bool cached = false;  // был в кэше — не читался
+    };
+    void fetchRaw(const size_t* index, size_t n, RawSample* raw) const;
+    /// Маска и метка из прочитанных fetchRaw байтов
+    void loadSample(size_t index, const RawSample& raw, Tensor3D& x, int& label) const;
+
+    /**
+     * Загружать только часть rank из world каждого батча (для обучения
+     * несколькими процессами). Курсоры сдвигаются на весь батч, так что
+     * ранги вместе покрывают тот же глобальный батч, что и без шардинга.
+     */
+    void setShard(int rank, int world);
+
+    /**
+     * Сторона сетки вокселизации облаков .bin (по умолчанию 32). PLY и
+     * шарды уже вокселизированы под 32³, для них допустимо только 32.
+     * Кэш образцов сбрасывается.
+     */
+    void setVoxelGrid(int n);
+    int  voxelGrid() const { return grid_; }
+    /// Образцы — облака .bin, вокселизируемые при загрузке
+    bool rawClouds() const { return raw_clouds_; }
+
+    /// Маска занятости 32³ из PLY с координатами вокселей
+    static Tensor3D loadVoxelMask(const std::string& ply_path);
+    static void     loadVoxelMask(const std::string& ply_path, Tensor3D& mask);
+    /// Метки из текстового файла (_cls.txt)
+    static std::vector<int> loadLabels(const std::string& labels_path);
+    /// Метки сегментации 32³ из _seg.txt или .seg
+    static Tensor3D loadSegMask(const std::string& seg_path);
 
     // Новые методы
     /// Общее число примеров в тренировочной части
     size_t getNumTrainSamples() const { return split_index_; }
     /// Общее число примеров в валидационной части
-    size_t getNumValSamples()   const { return voxel_files_.size() - split_index_; }
+    size_t getNumValSamples()   const { return num_samples_ - split_index_; }
+    /// Данные читаются из шардов *.pgs
+    bool   sharded()            const { return !shards_.empty(); }
     /// Размер батча
     int    getBatchSize()       const { return batch_size_; }
 
@@ -32,6 +209,18 @@ private:
     std::vector<std::string> cls_label_files_;
     std::vector<std::string> seg_label_files_;
 
+    // Режим шардов: образец i — запись shard_pos_[i] в shards_
+    std::vector<std::shared_ptr<const MappedShard>> shards_;
+    std::vector<std::pair<uint32_t, uint32_t>>      shard_pos_;
+    size_t num_samples_ = 0;
+    bool   raw_clouds_  = false;  // voxel_files_ — облака .bin
+    int    grid_        = 32;
+
+    std::shared_ptr<SampleCache>     cache_;
+    std::shared_ptr<const augment::Config> augment_;
+    uint64_t                         augment_seed_ = 0;
+    std::shared_ptr<BatchFileReader> io_;
+
     int    batch_size_;
     float  val_ratio_;
     size_t split_index_;
@@ -39,9 +228,18 @@ private:
     size_t train_pos_ = 0;
     size_t val_pos_   = 0;
 
-    void loadFileLists(const std::string& data_dir);
+    Order    order_ = Order::Sequential;
+    uint64_t seed_  = 0;
+    uint64_t epoch_ = 0;
+    std::vector<uint32_t> train_order_;  // перестановка эпохи; пусто — по порядку
+    std::vector<int>      train_labels_; // для Stratified, читаются один раз
+    std::vector<size_t>   batch_index_;  // индексы текущего батча nextBatch(SampleBatch&)
+
+    int shard_rank_  = 0;
+    int shard_world_ = 1;
 
-    Tensor3D loadVoxelMask(const std::string& ply_path);
-    std::vector<int> loadLabels(const std::string& labels_path);
-    Tensor3D loadSegMask(const std::string& seg_path);
+    void loadFileLists(const std::string& data_dir);
+    /// loadSample мимо чтения кэша (результат в кэш кладётся)
+    void loadUncached(size_t index, Tensor3D& x, int& label) const;
+    void buildOrder();
 };
@@ -0,0 +1,376 @@
+#include "data/PlyIO.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+enum class Format { Ascii, BinaryLE, BinaryBE };
+
+// Скалярный тип PLY: размер и вид (знаковое, беззнаковое, плавающее)
+struct Scalar {
+    int  size = 0;
+    char kind = 0;  // 'i' | 'u' | 'f'
+};
+
+struct Property {
+    std::string name;
+    Scalar      type;
+    bool        list = false;
+    Scalar      count_type;  // тип длины списка
+};
+
+struct Element {
+    std::string           name;
+    size_t                count = 0;
+    std::vector<Property> props;
+};
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::runtime_error("Не удалось открыть PLY: " + path);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("PLY пуст: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("mmap PLY не удался: " + path);
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+    }
+    ~MappedFile() { ::munmap(const_cast<char*>(data_), size_); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t      size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t      size_ = 0;
+};
+
+Scalar parseScalar(std::string_view t) {
+    if (t == "char"   || t == "int8")    return {1, 'i'};
+    if (t == "uchar"  || t == "uint8")   return {1, 'u'};
+    if (t == "short"  || t == "int16")   return {2, 'i'};
+    if (t == "ushort" || t == "uint16")  return {2, 'u'};
+    if (t == "int"    || t == "int32")   return {4, 'i'};
+    if (t == "uint"   || t == "uint32")  return {4, 'u'};
+    if (t == "float"  || t == "float32") return {4, 'f'};
+    if (t == "double" || t == "float64") return {8, 'f'};
+    return {};
+}
+
+// Следующее слово строки (разделители — пробелы и табуляции)
+std::string_view word(std::string_view& line) {
+    size_t b = line.find_first_not_of(" \t");
+    if (b == std::string_view::npos) { line = {}; return {}; }
+    size_t e = line.find_first_of(" \t", b);
+    std::string_view w = line.substr(b, e == std::string_view::npos ? std::string_view::npos : e - b);
+    line.remove_prefix(e == std::string_view::npos ? line.size() : e);
+    return w;
+}
+
+/// Разбор заголовка; возвращает смещение первого байта данных
+size_t parseHeader(const char* data, size_t size, const std::string& path,
+                   Format& format, std::vector<Element>& elements) {
+    auto fail = [&](const std::string& what) {
+        throw std::runtime_error("PLY " + path + ": " + what);
+    };
+    std::string_view all(data, size);
+    size_t pos = 0;
+    bool first = true, has_format = false;
+    for (;;) {
+        size_t nl = all.find('\n', pos);
+        if (nl == std::string_view::npos) fail("нет end_header");
+        std::string_view line = all.substr(pos, nl - pos);
+        pos = nl + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+        std::string_view rest = line;
+        std::string_view key = word(rest);
+        if (first) {
+            if (key != "ply") fail("нет сигнатуры ply");
+            first = false;
+            continue;
+        }
+        if (key == "end_header") break;
+        if (key == "format") {
+            std::string_view f = word(rest);
+            if (f == "ascii")                     format = Format::Ascii;
+            else if (f == "binary_little_endian") format = Format::BinaryLE;
+            else if (f == "binary_big_endian")    format = Format::BinaryBE;
+            else fail("неизвестный формат " + std::string(f));
+            has_format = true;
+        } else if (key == "element") {
+            Element e;
+            e.name = std::string(word(rest));
+            std::string_view n = word(rest);
+            if (std::from_chars(n.data(), n.data() + n.size(), e.count).ec != std::errc())
+                fail("неверное число элементов " + e.name);
+            elements.push_back(std::move(e));
+        } else if (key == "property") {
+            if (elements.empty()) fail("property вне element");
+            Property p;
+            std::string_view t = word(rest);
+            if (t == "list") {
+                p.list       = true;
+                p.count_type = parseScalar(word(rest));
+                t            = word(rest);
+                if (p.count_type.size == 0 || p.count_type.kind == 'f') fail("неверный тип длины списка");
+            }
+            p.type = parseScalar(t);
+            if (p.type.size == 0) fail("неизвестный тип свойства " + std::string(t));
+            p.name = std::string(word(rest));
+            elements.back().props.push_back(std::move(p));
+        }
+        // comment, obj_info и прочее пропускаем
+    }
+    if (!has_format) fail("нет строки format");
+    return pos;
+}
+
+// ---------- бинарные данные ----------
+
+template <typename T>
+T loadRaw(const char* p, bool swap) {
+    unsigned char b[sizeof(T)];
+    std::memcpy(b, p, sizeof(T));
+    if (swap)
+        for (size_t i = 0; i < sizeof(T) / 2; ++i) std::swap(b[i], b[sizeof(T) - 1 - i]);
+    T v;
+    std::memcpy(&v, b, sizeof(T));
+    return v;
+}
+
+double loadScalar(const char* p, Scalar s, bool swap) {
+    switch (s.size * 4 + (s.kind == 'f' ? 2 : s.kind == 'u' ? 1 : 0)) {
+    case 4:  return loadRaw<int8_t>(p, swap);
+    case 5:  return loadRaw<uint8_t>(p, swap);
+    case 8:  return loadRaw<int16_t>(p, swap);
+    case 9:  return loadRaw<uint16_t>(p, swap);
+    case 16: return loadRaw<int32_t>(p, swap);
+    case 17: return loadRaw<uint32_t>(p, swap);
+    case 18: return loadRaw<float>(p, swap);
+    case 34: return loadRaw<double>(p, swap);
+    }
+    throw std::logic_error("PLY: неподдерживаемый скалярный тип");
+}
+
+void readBinary(const char* data, size_t size, size_t pos, Format format,
+                const std::vector<Element>& elements, size_t vertex_el,
+                const int (&axis)[3], const std::string& path, std::vector<float>& xyz) {
+    auto fail = [&](const std::string& what) {
+        throw std::runtime_error("PLY " + path + ": " + what);
+    };
+    const bool swap = format == Format::BinaryBE;
+
+    // Элементы до vertex пропускаем целиком — нужен их фиксированный размер
+    for (size_t e = 0; e < vertex_el; ++e) {
+        size_t stride = 0;
+        for (const auto& p : elements[e].props) {
+            if (p.list) fail("списки в элементах до vertex не поддерживаются");
+            stride += static_cast<size_t>(p.type.size);
+        }
+        pos += stride * elements[e].count;
+    }
+
+    const Element& v = elements[vertex_el];
+    size_t stride = 0;
+    size_t offset[3] = {0, 0, 0};
+    for (size_t i = 0; i < v.props.size(); ++i) {
+        if (v.props[i].list) fail("списки в vertex не поддерживаются");
+        for (int a = 0; a < 3; ++a)
+            if (axis[a] == static_cast<int>(i)) offset[a] = stride;
+        stride += static_cast<size_t>(v.props[i].type.size);
+    }
+    const size_t n = v.count;
+    if (pos > size || (size - pos) / stride < n) fail("данные вершин обрезаны");
+
+    xyz.resize(3 * n);
+    const char* base = data + pos;
+    const Scalar tx = v.props[axis[0]].type, ty = v.props[axis[1]].type, tz = v.props[axis[2]].type;
+    const bool all_float = tx.kind == 'f' && tx.size == 4 && ty.kind == 'f' && ty.size == 4
+                        && tz.kind == 'f' && tz.size == 4;
+
+    if (all_float && !swap && offset[0] == 0 && offset[1] == 4 && offset[2] == 8) {
+        // Частый случай (в том числе наш writePlyVertices): x y z float в начале записи
+        if (stride == 12) {
+            std::memcpy(xyz.data(), base, 12 * n);
+        } else {
+            for (size_t i = 0; i < n; ++i) std::memcpy(&xyz[3 * i], base + i * stride, 12);
+        }
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const char* rec = base + i * stride;
+        for (int a = 0; a < 3; ++a)
+            xyz[3 * i + a] = static_cast<float>(loadScalar(rec + offset[a], v.props[axis[a]].type, swap));
+    }
+}
+
+// ---------- текст ----------
+
+struct AsciiCursor {
+    const char* p;
+    const char* end;
+
+    void skipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    }
+    bool skipToken() {
+        skipSpace();
+        if (p == end) return false;
+        while (p < end && !(*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+        return true;
+    }
+    bool number(float& v) {
+        skipSpace();
+        if (p < end && *p == '+') ++p;  // from_chars не принимает ведущий '+'
+        auto r = std::from_chars(p, end, v);
+        if (r.ec != std::errc()) return false;
+        p = r.ptr;
+        return true;
+    }
+    bool count(size_t& n) {
+        skipSpace();
+        auto r = std::from_chars(p, end, n);
+        if (r.ec != std::errc()) return false;
+        p = r.ptr;
+        return true;
+    }
+};
+
+void readAscii(const char* data, size_t size, size_t pos,
+               const std::vector<Element>& elements, size_t vertex_el,
+               const int (&axis)[3], const std::string& path, std::vector<float>& xyz) {
+    auto fail = [&](const std::string& what) {
+        throw std::runtime_error("PLY " + path + ": " + what);
+    };
+    AsciiCursor c{data + pos, data + size};
+
+    // Значения идут подряд через пробелы; строки не обязаны совпадать с записями
+    auto skipRecord = [&](const Element& e) {
+        for (const auto& p : e.props) {
+            size_t n = 1;
+            if (p.list && !c.count(n)) return false;
+            for (size_t k = 0; k < n; ++k)
+                if (!c.skipToken()) return false;
+        }
+        return true;
+    };
+    for (size_t e = 0; e < vertex_el; ++e)
+        for (size_t i = 0; i < elements[e].count; ++i)
+            if (!skipRecord(elements[e])) fail("данные элемента " + elements[e].name + " обрезаны");
+
+    const Element& v = elements[vertex_el];
+    int slot[64];  // свойство → ось (или -1)
+    if (v.props.size() > 64) fail("слишком много свойств у vertex");
+    for (size_t i = 0; i < v.props.size(); ++i) {
+        slot[i] = -1;
+        for (int a = 0; a < 3; ++a)
+            if (axis[a] == static_cast<int>(i)) slot[i] = a;
+    }
+
+    // Каждое значение — хотя бы символ и разделитель (у последнего его может
+    // не быть): число вершин из заголовка не должно превышать остаток файла,
+    // иначе битый заголовок заставит выделить гигабайты
+    const size_t min_record = 2 * std::max<size_t>(1, v.props.size());
+    if (v.count > (static_cast<size_t>(c.end - c.p) + 1) / min_record)
+        fail("данные вершин обрезаны");
+
+    xyz.resize(3 * v.count);
+    float* out = xyz.data();
+    for (size_t i = 0; i < v.count; ++i, out += 3) {
+        for (size_t k = 0; k < v.props.size(); ++k) {
+            const Property& p = v.props[k];
+            bool ok;
+            if (p.list) {
+                size_t n = 0;
+                ok = c.count(n);
+                for (size_t j = 0; ok && j < n; ++j) ok = c.skipToken();
+            } else if (slot[k] >= 0) {
+                ok = c.number(out[slot[k]]);
+            } else {
+                ok = c.skipToken();
+            }
+            if (!ok) fail("вершина #" + std::to_string(i) + " обрезана или не число");
+        }
+    }
+}
+
+} // namespace
+
+void readPlyVertices(const std::string& path, std::vector<float>& xyz) {
+    MappedFile file(path);
+    parsePlyVertices(file.data(), file.size(), path, xyz);
+}
+
+void parsePlyVertices(const char* data, size_t size, const std::string& path, std::vector<float>& xyz) {
+    Format format = Format::Ascii;
+    std::vector<Element> elements;
+    const size_t pos = parseHeader(data, size, path, format, elements);
+
+    size_t vertex_el = elements.size();
+    for (size_t e = 0; e < elements.size(); ++e)
+        if (elements[e].name == "vertex") { vertex_el = e; break; }
+    if (vertex_el == elements.size()) {
+        xyz.clear();  // облако без вершин — пустая маска, как раньше
+        return;
+    }
+    static const char* const kAxes[3] = {"x", "y", "z"};
+    int axis[3] = {-1, -1, -1};
+    const auto& props = elements[vertex_el].props;
+    for (size_t i = 0; i < props.size(); ++i)
+        for (int a = 0; a < 3; ++a)
+            if (props[i].name == kAxes[a] && !props[i].list) axis[a] = static_cast<int>(i);
+    if (axis[0] < 0 || axis[1] < 0 || axis[2] < 0)
+        throw std::runtime_error("PLY " + path + ": у vertex нет свойств x, y, z");
+
+    if (format == Format::Ascii)
+        readAscii(data, size, pos, elements, vertex_el, axis, path, xyz);
+    else
+        readBinary(data, size, pos, format, elements, vertex_el, axis, path, xyz);
+}
+
+void writePlyVertices(const std::string& path, const float* xyz, size_t count, bool binary) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("Не удалось открыть PLY для записи: " + path);
+    out << "ply\nformat " << (binary ? "binary_little_endian" : "ascii") << " 1.0\n"
+        << "element vertex " << count << "\n"
+        << "property float x\nproperty float y\nproperty float z\nend_header\n";
+    if (binary) {
+        static_assert(sizeof(float) == 4, "PLY float — 4 байта");
+        const uint16_t probe = 1;
+        unsigned char low;
+        std::memcpy(&low, &probe, 1);
+        if (!low) throw std::runtime_error("writePlyVertices: binary поддержан только на little-endian");
+        out.write(reinterpret_cast<const char*>(xyz), static_cast<std::streamsize>(12 * count));
+    } else {
+        char buf[64];
+        for (size_t i = 0; i < count; ++i) {
+            char* p = buf;
+            for (int a = 0; a < 3; ++a) {
+                p = std::to_chars(p, buf + sizeof(buf), xyz[3 * i + a]).ptr;
+                *p++ = a < 2 ? ' ' : '\n';
+            }
+            out.write(buf, p - buf);
+        }
+    }
+    if (!out) throw std::runtime_error("Ошибка записи PLY: " + path);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Чтение и запись облаков точек в PLY.
+ *
+ * readPlyVertices возвращает свойства x, y, z элемента vertex
+ * упакованными тройками float. Поддерживаются форматы ascii,
+ * binary_little_endian и binary_big_endian, любые скалярные типы
+ * свойств и другие элементы до vertex (в бинарном виде — без списков).
+ * Файл отображается в память целиком: бинарные вершины копируются
+ * без разбора (если x y z — первые float подряд, одним memcpy),
+ * текст разбирается std::from_chars по буферу, без потоков и локалей.
+ */
+void readPlyVertices(const std::string& path, std::vector<float>& xyz);
+
+/// То же из уже прочитанного в память файла (name — для сообщений об ошибках)
+void parsePlyVertices(const char* data, size_t size, const std::string& name, std::vector<float>& xyz);
+
+/// Записать count точек (только x y z); binary — binary_little_endian, иначе ascii
+void writePlyVertices(const std::string& path, const float* xyz, size_t count, bool binary = false);
@@ -0,0 +1,60 @@
+#include "data/PointCloudIO.h"
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void parsePointCloudBin(const char* data, size_t size, const std::string& name,
+                        std::vector<float>& xyz,
+                        std::vector<int32_t>* labels) {
+    uint32_t M = 0;
+    if (size < sizeof(M))
+        throw std::runtime_error("Облако точек без заголовка: " + name);
+    std::memcpy(&M, data, sizeof(M));
+
+    constexpr size_t kRecord = 3 * sizeof(float) + sizeof(int32_t);
+    if ((size - sizeof(M)) / kRecord < M)
+        throw std::runtime_error("Облако точек обрезано: " + name);
+
+    const char* rec = data + sizeof(M);
+    xyz.resize(static_cast<size_t>(M) * 3);
+    if (labels) labels->resize(M);
+    size_t kept = 0;
+    for (uint32_t i = 0; i < M; ++i, rec += kRecord) {
+        float* p = &xyz[3 * kept];
+        std::memcpy(p, rec, 3 * sizeof(float));
+        // NaN и ±Inf не имеют ячейки и испортили бы бокс облака
+        if (!std::isfinite(p[0]) || !std::isfinite(p[1]) || !std::isfinite(p[2])) continue;
+        if (labels) std::memcpy(&(*labels)[kept], rec + 3 * sizeof(float), sizeof(int32_t));
+        ++kept;
+    }
+    xyz.resize(3 * kept);
+    if (labels) labels->resize(kept);
+}
+
+void readPointCloudBin(const std::string& path,
+                       std::vector<float>& xyz,
+                       std::vector<int32_t>* labels) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("Не удалось открыть облако точек: " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Не удалось открыть облако точек: " + path);
+    }
+    // Буфер файла живёт в потоке загрузки: от облака к облаку не перевыделяется
+    thread_local std::vector<char> raw;
+    raw.resize(static_cast<size_t>(st.st_size));
+    size_t got = 0;
+    while (got < raw.size()) {
+        ssize_t r = ::read(fd, raw.data() + got, raw.size() - got);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        got += static_cast<size_t>(r);
+    }
+    ::close(fd);
+    parsePointCloudBin(raw.data(), got, path, xyz, labels);
+}
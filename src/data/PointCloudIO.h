@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Чтение бинарного облака точек, которое пишет scripts/extract_pc.py
+ * и читает voxelize_bin:
+ *   uint32 M, затем M записей { float x, y, z; int32 label }.
+ *
+ * xyz получает 3*M координат, labels (если не nullptr) — M меток.
+ * Точки с NaN или ±Inf в координатах отбрасываются вместе с меткой.
+ * Файл читается одним блоком в буфер потока, xyz и labels
+ * переиспользуют свою ёмкость.
+ */
+void readPointCloudBin(const std::string& path,
+                       std::vector<float>& xyz,
+                       std::vector<int32_t>* labels = nullptr);
+
+/// То же из уже прочитанного в память файла (name — для сообщений об ошибках)
+void parsePointCloudBin(const char* data, size_t size, const std::string& name,
+                        std::vector<float>& xyz,
+                        std::vector<int32_t>* labels = nullptr);
@@ -0,0 +1,213 @@
+#include "data/PrefetchLoader.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+
+PrefetchLoader::PrefetchLoader(DataLoader& loader, int num_threads, int depth)
+    : loader_(loader), depth_(depth > 0 ? depth : 1)
+{
+    if (num_threads < 0)
+        throw std::invalid_argument("PrefetchLoader: num_threads должен быть >= 0");
+    // В обороте не больше depth_ + 1 буферов (окно и батч вызывающего):
+    // пулы не растут, как бы ни менялось соотношение скоростей
+    pool_.reserve(depth_ + 1);
+    raw_pool_.reserve(depth_ + 1);
+    for (int t = 0; t < num_threads; ++t)
+        workers_.emplace_back([this] { run(); });
+}
+
+PrefetchLoader::~PrefetchLoader() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& th : workers_) th.join();
+}
+
+void PrefetchLoader::schedule(bool train, int batches) {
+    std::vector<std::unique_ptr<Slot>> slots;
+    for (int b = 0; b < batches; ++b) {
+        auto s = std::make_unique<Slot>();
+        loader_.nextBatchIndices(train, s->index);
+        s->epoch = loader_.epoch();
+        slots.push_back(std::move(s));
+    }
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (auto& s : slots) plan_.push_back(std::move(s));
+    }
+    work_cv_.notify_all();
+}
+
+PrefetchLoader::Slot* PrefetchLoader::claim(size_t& sample, bool& fetch) {
+    // Вызывается под mu_; окно — первые depth_ батчей плана
+    const size_t window = std::min(depth_, plan_.size());
+    fetch = false;
+    for (size_t b = 0; b < window; ++b) {
+        Slot& s = *plan_[b];
+        if (s.claimed >= s.index.size()) continue;
+        attach(s);
+        if (s.fetch == Fetch::Pending) {
+            s.fetch = Fetch::Running;
+            fetch = true;
+            return &s;
+        }
+        if (s.fetch == Fetch::Running) continue;  // файлы батча читает другой поток
+        sample = s.claimed++;
+        return &s;
+    }
+    return nullptr;
+}
+
+void PrefetchLoader::attach(Slot& s) {
+    if (s.attached) return;
+    s.attached = true;
+    if (!pool_.empty()) {
+        s.data = std::move(pool_.back());
+        pool_.pop_back();
+    }
+    s.data.resize(s.index.size());
+    if (loader_.batchedIo() && !s.index.empty()) {
+        if (!raw_pool_.empty()) {
+            s.raw = std::move(raw_pool_.back());
+            raw_pool_.pop_back();
+        }
+        s.raw.resize(s.index.size());
+        s.fetch = Fetch::Pending;
+    }
+}
+
+void PrefetchLoader::fetchFiles(Slot& s) {
+    auto t0 = std::chrono::steady_clock::now();
+    try {
+        loader_.fetchRaw(s.index.data(), s.index.size(), s.raw.data());
+    } catch (...) {
+        // Пакет не прочитан — образцы прочитаются по одному обычным путём
+        for (auto& r : s.raw) r.error = EIO;
+    }
+    double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        s.fetch = Fetch::Ready;
+        stats_.decode_seconds += dt;
+        stats_.fetch_seconds  += dt;
+    }
+    work_cv_.notify_all();
+}
+
+void PrefetchLoader::decode(Slot& s, size_t sample) {
+    // Слоты образцов не пересекаются, запись в них идёт без блокировки
+    auto t0 = std::chrono::steady_clock::now();
+    std::exception_ptr err;
+    try {
+        if (s.raw.empty() || s.raw[sample].cached) {
+            loader_.loadAugmented(s.index[sample], s.epoch, s.data.x[sample], s.data.y[sample]);
+        } else {
+            loader_.loadSample(s.index[sample], s.raw[sample], s.data.x[sample], s.data.y[sample]);
+            loader_.augmentSample(s.index[sample], s.epoch, s.data.x[sample]);
+        }
+    } catch (...) {
+        err = std::current_exception();
+    }
+    double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::lock_guard<std::mutex> lk(mu_);
+    if (err && !s.error) s.error = err;
+    ++s.done;
+    stats_.decode_seconds += dt;
+    if (s.done == s.index.size()) ready_cv_.notify_all();
+}
+
+void PrefetchLoader::run() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        Slot*  s = nullptr;
+        size_t sample = 0;
+        bool   fetch  = false;
+        work_cv_.wait(lk, [&] { return stop_ || (s = claim(sample, fetch)) != nullptr; });
+        if (!s) return;  // stop_
+        lk.unlock();
+        if (fetch) fetchFiles(*s);
+        else       decode(*s, sample);
+        lk.lock();
+    }
+}
+
+PrefetchLoader::Batch PrefetchLoader::next() {
+    Batch b;
+    next(b);
+    return b;
+}
+
+void PrefetchLoader::next(Batch& out) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lk(mu_);
+    if (plan_.empty())
+        throw std::runtime_error("PrefetchLoader::next: нет запланированных батчей");
+    Slot& s = *plan_.front();
+
+    bool waited = false;
+    attach(s);  // пустой батч или синхронный режим
+    if (workers_.empty()) {
+        // Синхронный режим: читаем сами, всё время чтения — простой
+        if (s.fetch == Fetch::Pending) {
+            s.fetch = Fetch::Running;
+            lk.unlock();
+            fetchFiles(s);
+            lk.lock();
+        }
+        while (s.claimed < s.index.size()) {
+            size_t sample = s.claimed++;
+            lk.unlock();
+            decode(s, sample);
+            lk.lock();
+        }
+        waited = !s.index.empty();
+    } else if (s.done < s.index.size()) {
+        waited = true;
+        ready_cv_.wait(lk, [&] { return s.done == s.index.size(); });
+    }
+
+    std::unique_ptr<Slot> front = std::move(plan_.front());
+    plan_.pop_front();
+    ++stats_.batches;
+    if (waited) {
+        ++stats_.stalled;
+        stats_.stall_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+    std::exception_ptr error = front->error;
+    if (!error) {
+        std::swap(out, front->data);
+        pool_.push_back(std::move(front->data));  // прежние буферы out
+    }
+    if (!front->raw.empty()) raw_pool_.push_back(std::move(front->raw));
+    lk.unlock();
+    work_cv_.notify_all();  // окно сдвинулось
+
+    if (error) std::rethrow_exception(error);
+}
+
+size_t PrefetchLoader::pending() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return plan_.size();
+}
+
+size_t PrefetchLoader::ready() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    size_t n = 0;
+    while (n < plan_.size() && plan_[n]->done == plan_[n]->index.size()) ++n;
+    return n;
+}
+
+PrefetchLoader::Stats PrefetchLoader::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return stats_;
+}
+
+void PrefetchLoader::resetStats() {
+    std::lock_guard<std::mutex> lk(mu_);
+    stats_ = Stats();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "data/DataLoader.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Фоновая загрузка батчей DataLoader.
+ *
+ * schedule(train, n) сразу забирает у DataLoader индексы n следующих
+ * батчей (порядок образцов тот же, что у nextBatch), а num_threads
+ * потоков читают и декодируют их образцы прямо в слоты батчей. Впереди
+ * потребителя собирается не больше depth батчей — это ограничивает
+ * память; при depth = 2 следующий батч готовится, пока текущий считается.
+ *
+ * next() отдаёт батчи строго в порядке schedule; если батч ещё не готов,
+ * ждёт, и это ожидание копится в stats().stall_seconds — по нему видно,
+ * упирается ли обучение в данные. Ошибка чтения образца бросается из
+ * next() того батча, где она случилась. num_threads = 0 — синхронный
+ * режим: батч читается внутри next(), как раньше в nextBatch.
+ *
+ * Если у загрузчика включено пакетное чтение (DataLoader::enableBatchedIo),
+ * первый взявшийся за батч поток читает файлы всех его образцов одной
+ * отправкой, а разбирают их из памяти уже все потоки. Аугментация
+ * (DataLoader::enableAugmentation) идёт там же, после декодирования,
+ * с эпохой, которая была у загрузчика при schedule.
+ *
+ * next(Batch&) меняется буферами с вызывающим: его прошлый батч уходит
+ * в пул и принимает образцы следующих батчей, так что в установившемся
+ * режиме маски пишутся в уже выделенные тензоры.
+ */
+class PrefetchLoader {
+public:
+    using Batch = SampleBatch;
+
+    struct Stats {
+        size_t batches = 0;         // выдано next()
+        size_t stalled = 0;         // из них пришлось ждать
+        double stall_seconds  = 0;  // ожидание в next()
+        double decode_seconds = 0;  // чтение образцов, сумма по потокам
+        double fetch_seconds  = 0;  // из них пакетное чтение файлов
+    };
+
+    explicit PrefetchLoader(DataLoader& loader, int num_threads = 2, int depth = 2);
+    ~PrefetchLoader();
+
+    PrefetchLoader(const PrefetchLoader&) = delete;
+    PrefetchLoader& operator=(const PrefetchLoader&) = delete;
+
+    /// Запланировать batches батчей (train или val) из курсоров загрузчика;
+    /// курсоры двигает только вызывающий поток, фоновые лишь читают файлы
+    void schedule(bool train, int batches);
+
+    /// Следующий запланированный батч в out (прежние буферы out переиспользуются);
+    /// бросает, если план пуст
+    void  next(Batch& out);
+    /// То же с новым батчем на каждый вызов
+    Batch next();
+
+    /// Запланировано, но ещё не выдано
+    size_t pending() const;
+    /// Готовых батчей подряд с начала плана (next() отдаст их без ожидания)
+    size_t ready() const;
+
+    Stats stats() const;
+    void resetStats();
+
+private:
+    using RawBatch = std::vector<DataLoader::RawSample>;
+    enum class Fetch { Pending, Running, Ready };
+
+    struct Slot {
+        std::vector<size_t> index;
+        uint64_t            epoch = 0;         // эпоха загрузчика при schedule (для аугментации)
+        Batch               data;
+        RawBatch            raw;               // файлы батча при пакетном чтении
+        Fetch               fetch = Fetch::Ready;
+        bool                attached = false;  // буферы взяты из пула
+        size_t              claimed = 0;   // образцов взято потоками
+        size_t              done    = 0;   // образцов готово
+        std::exception_ptr  error;
+    };
+
+    DataLoader&        loader_;
+    const size_t       depth_;
+
+    mutable std::mutex      mu_;
+    std::condition_variable work_cv_;   // появилась работа / остановка
+    std::condition_variable ready_cv_;  // образец готов
+    std::deque<std::unique_ptr<Slot>> plan_;  // plan_.front() выдаётся следующим
+    std::vector<Batch>      pool_;      // буферы, вернувшиеся из next(Batch&)
+    std::vector<RawBatch>   raw_pool_;
+    bool  stop_ = false;
+    Stats stats_;
+    std::vector<std::thread> workers_;
+
+    void run();
+    /// Работа в окне depth_: чтение файлов батча (fetch) или свободный
+    /// образец; nullptr, если нет
+    Slot* claim(size_t& sample, bool& fetch);
+    /// Дать слоту буферы из пула (под mu_, перед первым образцом)
+    void  attach(Slot& s);
+    void  decode(Slot& s, size_t sample);
+    void  fetchFiles(Slot& s);
+};
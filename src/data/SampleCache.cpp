@@ -0,0 +1,130 @@
+#include "data/SampleCache.h"
+#include "data/Shard.h"
+#include <cstring>
+
+namespace {
+
+// Служебные расходы на запись: Entry, узлы map/list, заголовок вектора
+constexpr size_t kEntryOverhead = 128;
+
+} // namespace
+
+size_t SampleCache::Entry::bytes() const { return data.capacity() + kEntryOverhead; }
+
+SampleCache::SampleCache(size_t budget_bytes) : budget_(budget_bytes) {}
+
+std::shared_ptr<const SampleCache::Entry> SampleCache::encode(const Tensor3D& x, int label) {
+    if (x.channels() != 1) return nullptr;
+    const size_t n = static_cast<size_t>(x.size());
+    const float* v = x.data();
+    size_t ones = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (v[i] == 1.0f) ++ones;
+        else if (v[i] != 0.0f) return nullptr;  // не маска — сжимать без потерь нечем
+    }
+
+    auto e = std::make_shared<Entry>();
+    e->D = x.depth(); e->H = x.height(); e->W = x.width();
+    e->label = label;
+    const size_t bitmap = (n + 7) / 8;
+    e->sparse = n <= 65536 && ones * sizeof(uint16_t) < bitmap;
+    if (e->sparse) {
+        e->data.resize(ones * sizeof(uint16_t));
+        uint16_t* idx = reinterpret_cast<uint16_t*>(e->data.data());
+        for (size_t i = 0, k = 0; i < n; ++i)
+            if (v[i] != 0.0f) idx[k++] = static_cast<uint16_t>(i);
+    } else {
+        e->data.resize(bitmap);
+        shard::packBits(v, n, e->data.data());
+    }
+    return e;
+}
+
+void SampleCache::decode(const Entry& e, Tensor3D& x) {
+    if (x.depth() != e.D || x.height() != e.H || x.width() != e.W || x.channels() != 1)
+        x = Tensor3D(e.D, e.H, e.W, 1);
+    const size_t n = static_cast<size_t>(x.size());
+    if (!e.sparse) {
+        shard::unpackBits(e.data.data(), n, x.data());
+        return;
+    }
+    x.fill(0.0f);
+    const uint16_t* idx = reinterpret_cast<const uint16_t*>(e.data.data());
+    const size_t ones = e.data.size() / sizeof(uint16_t);
+    float* out = x.data();
+    for (size_t k = 0; k < ones; ++k) out[idx[k]] = 1.0f;
+}
+
+std::shared_ptr<const SampleCache::Entry> SampleCache::find(size_t key) {
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, it->second.lru);
+    return it->second.entry;
+}
+
+bool SampleCache::get(size_t key, Tensor3D& x, int& label) {
+    std::shared_ptr<const Entry> e = find(key);
+    if (!e) return false;
+    decode(*e, x);
+    label = e->label;
+    return true;
+}
+
+bool SampleCache::getBits(size_t key, int D, int H, int W, uint8_t* bits, int& label) {
+    std::shared_ptr<const Entry> e = find(key);
+    if (!e || e->D != D || e->H != H || e->W != W) return false;
+    const size_t n = static_cast<size_t>(D) * H * W;
+    if (e->sparse) {
+        std::memset(bits, 0, (n + 7) / 8);
+        const uint16_t* idx = reinterpret_cast<const uint16_t*>(e->data.data());
+        const size_t ones = e->data.size() / sizeof(uint16_t);
+        for (size_t k = 0; k < ones; ++k) bits[idx[k] >> 3] |= static_cast<uint8_t>(1u << (idx[k] & 7));
+    } else {
+        std::memcpy(bits, e->data.data(), (n + 7) / 8);
+    }
+    label = e->label;
+    return true;
+}
+
+bool SampleCache::contains(size_t key) const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return map_.count(key) != 0;
+}
+
+bool SampleCache::put(size_t key, const Tensor3D& x, int label) {
+    auto e = encode(x, label);  // сжатие — вне блокировки
+    if (!e || e->bytes() > budget_) return false;
+
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+        // Образец уже положил другой поток — просто обновляем
+        stats_.bytes -= it->second.entry->bytes();
+        lru_.erase(it->second.lru);
+        map_.erase(it);
+    }
+    while (stats_.bytes + e->bytes() > budget_ && !lru_.empty()) {
+        auto victim = map_.find(lru_.back());
+        stats_.bytes -= victim->second.entry->bytes();
+        map_.erase(victim);
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+    lru_.push_front(key);
+    stats_.bytes += e->bytes();
+    map_.emplace(key, Slot{std::move(e), lru_.begin()});
+    stats_.entries = map_.size();
+    return true;
+}
+
+SampleCache::Stats SampleCache::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    Stats s = stats_;
+    s.entries = map_.size();
+    return s;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "net/Tensor3D.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Кэш образцов в памяти между эпохами.
+ *
+ * Маска хранится сжатой: битовой картой D·H·W бит (4 КБ для 32³) или,
+ * если занятых вокселей мало, списком их линейных индексов uint16 —
+ * что короче. Вместе с маской хранится метка класса. Сверх бюджета
+ * байт вытесняются давно не использованные записи (LRU).
+ *
+ * Потокобезопасен: get/put можно звать из потоков PrefetchLoader.
+ * Распаковка идёт вне блокировки — запись удерживается shared_ptr,
+ * даже если её в это время вытеснили.
+ */
+class SampleCache {
+public:
+    explicit SampleCache(size_t budget_bytes);
+
+    /// true и распакованный образец, если key есть в кэше
+    bool get(size_t key, Tensor3D& x, int& label);
+
+    /**
+     * То же упакованным в биты (раскладка shard::packBits, (D·H·W + 7) / 8
+     * байт) без распаковки во float; false, если key нет в кэше или форма
+     * образца не D×H×W.
+     */
+    bool getBits(size_t key, int D, int H, int W, uint8_t* bits, int& label);
+
+    /// Есть ли key в кэше (без учёта в статистике и LRU)
+    bool contains(size_t key) const;
+
+    /// Сохранить образец; false, если он не маска 0/1 или не влезает в бюджет
+    bool put(size_t key, const Tensor3D& x, int label);
+
+    struct Stats {
+        size_t hits = 0, misses = 0, evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;    // учтённый объём записей
+    };
+    Stats  stats() const;
+    size_t budget() const { return budget_; }
+
+private:
+    struct Entry {
+        int  D, H, W;
+        int  label;
+        bool sparse;                 // data — индексы uint16, иначе биты
+        std::vector<uint8_t> data;
+        size_t bytes() const;
+    };
+    using Lru = std::list<size_t>;  // ключи, свежие впереди
+
+    struct Slot {
+        std::shared_ptr<const Entry> entry;
+        Lru::iterator                lru;
+    };
+
+    const size_t budget_;
+    mutable std::mutex mu_;
+    std::unordered_map<size_t, Slot> map_;
+    Lru   lru_;
+    Stats stats_;
+
+    static std::shared_ptr<const Entry> encode(const Tensor3D& x, int label);
+    static void decode(const Entry& e, Tensor3D& x);
+    /// Запись key, если она есть (счётчики и LRU — как у get)
+    std::shared_ptr<const Entry> find(size_t key);
+};
@@ -0,0 +1,65 @@
+#include "data/Sampler.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+using sampler::SplitMix64;
+
+void shuffle(uint32_t* v, size_t n, SplitMix64& rng) {
+    for (size_t i = n; i > 1; --i)
+        std::swap(v[i - 1], v[rng.below(static_cast<uint32_t>(i))]);
+}
+
+} // namespace
+
+namespace sampler {
+
+SplitMix64 epochRng(uint64_t seed, uint64_t epoch) {
+    SplitMix64 mix{seed};
+    SplitMix64 rng{mix.next() ^ (epoch * 0xD1B54A32D192ED03ull)};
+    rng.next();  // разводим соседние эпохи
+    return rng;
+}
+
+std::vector<uint32_t> permutation(size_t n, uint64_t seed, uint64_t epoch) {
+    std::vector<uint32_t> p(n);
+    std::iota(p.begin(), p.end(), 0u);
+    SplitMix64 rng = epochRng(seed, epoch);
+    shuffle(p.data(), n, rng);
+    return p;
+}
+
+std::vector<uint32_t> stratified(const std::vector<int>& labels, uint64_t seed, uint64_t epoch) {
+    SplitMix64 rng = epochRng(seed, epoch);
+
+    // Образцы по классам в порядке первого появления класса
+    std::unordered_map<int, size_t> slot;
+    std::vector<std::vector<uint32_t>> classes;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        auto it = slot.emplace(labels[i], classes.size()).first;
+        if (it->second == classes.size()) classes.emplace_back();
+        classes[it->second].push_back(static_cast<uint32_t>(i));
+    }
+
+    struct Keyed { double key; uint32_t index; };
+    std::vector<Keyed> order;
+    order.reserve(labels.size());
+    for (auto& members : classes) {
+        shuffle(members.data(), members.size(), rng);
+        const double n = static_cast<double>(members.size());
+        for (size_t k = 0; k < members.size(); ++k)
+            order.push_back({(static_cast<double>(k) + rng.unit()) / n, members[k]});
+    }
+    // При равных ключах решает индекс — результат однозначен
+    std::sort(order.begin(), order.end(), [](const Keyed& a, const Keyed& b) {
+        return a.key != b.key ? a.key < b.key : a.index < b.index;
+    });
+
+    std::vector<uint32_t> p(order.size());
+    for (size_t i = 0; i < order.size(); ++i) p[i] = order[i].index;
+    return p;
+}
+
+} // namespace sampler
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Порядок обхода образцов по эпохам.
+ *
+ * Перестановки строятся собственным генератором (splitmix64) и
+ * тасованием Фишера–Йетса, а не std::shuffle с распределениями
+ * стандартной библиотеки: при одинаковых seed и epoch порядок
+ * одинаков на всех рангах, сборках и платформах — иначе процессы
+ * обучения с --procs разошлись бы в составе глобального батча.
+ */
+namespace sampler {
+
+/// splitmix64: малый и быстрый генератор с полностью определённым выходом
+struct SplitMix64 {
+    uint64_t s;
+    uint64_t next() {
+        uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    /// Равномерно в [0, n) (умножение на n со старшей половиной, смещение < n/2^64)
+    uint32_t below(uint32_t n) {
+        return static_cast<uint32_t>(((next() >> 32) * n) >> 32);
+    }
+    /// Равномерно в [0, 1)
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+};
+
+/// Генератор эпохи epoch: одинаковый на всех рангах при одном seed
+SplitMix64 epochRng(uint64_t seed, uint64_t epoch);
+
+/// Случайная перестановка [0, n) для эпохи epoch
+std::vector<uint32_t> permutation(size_t n, uint64_t seed, uint64_t epoch);
+
+/**
+ * Перестановка [0, labels.size()), в которой образцы каждого класса
+ * равномерно разнесены по эпохе: k-й (после тасования внутри класса)
+ * из n_c образцов класса c встаёт около позиции (k + u)/n_c · N,
+ * u ∈ [0, 1). Любое окно из B подряд идущих образцов (батч) содержит
+ * класс c примерно B·n_c/N раз, а не как повезёт при простом тасовании.
+ */
+std::vector<uint32_t> stratified(const std::vector<int>& labels, uint64_t seed, uint64_t epoch);
+
+} // namespace sampler
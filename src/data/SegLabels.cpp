@@ -0,0 +1,254 @@
+#include "data/SegLabels.h"
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+size_t voxels(int grid) { return static_cast<size_t>(grid) * grid * grid; }
+
+size_t varintSize(size_t v) {
+    size_t n = 1;
+    for (; v >= 0x80; v >>= 7) ++n;
+    return n;
+}
+
+void putVarint(std::vector<uint8_t>& out, size_t v) {
+    for (; v >= 0x80; v >>= 7) out.push_back(static_cast<uint8_t>(v | 0x80));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// Серии одинаковых меток: f(длина, метка)
+template <typename F>
+void forEachRun(const uint8_t* labels, size_t n, F&& f) {
+    for (size_t i = 0; i < n;) {
+        size_t j = i + 1;
+        while (j < n && labels[j] == labels[i]) ++j;
+        f(j - i, labels[i]);
+        i = j;
+    }
+}
+
+size_t payloadSize(const uint8_t* labels, size_t n, seglabels::Encoding enc) {
+    size_t bytes = 0;
+    switch (enc) {
+    case seglabels::Encoding::Dense:
+        return n;
+    case seglabels::Encoding::Sparse:
+        for (size_t i = 0, zeros = 0; i < n; ++i) {
+            if (labels[i] == 0) { ++zeros; continue; }
+            bytes += varintSize(zeros) + 1;
+            zeros = 0;
+        }
+        return bytes;
+    case seglabels::Encoding::Rle:
+        forEachRun(labels, n, [&](size_t len, uint8_t) { bytes += varintSize(len) + 1; });
+        return bytes;
+    }
+    throw std::invalid_argument("seglabels: неизвестная кодировка");
+}
+
+[[noreturn]] void corrupt(const std::string& name, const std::string& what) {
+    throw std::runtime_error("Метки сегментации " + name + " повреждены: " + what);
+}
+
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+    const std::string& name;
+
+    size_t varint() {
+        size_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) corrupt(name, "блок обрезан");
+            const uint8_t b = *p++;
+            v |= static_cast<size_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        corrupt(name, "слишком длинное число");
+    }
+    uint8_t byte() {
+        if (p == end) corrupt(name, "блок обрезан");
+        return *p++;
+    }
+};
+
+} // namespace
+
+namespace seglabels {
+
+size_t encodedSize(const uint8_t* labels, int grid, Encoding enc) {
+    return sizeof(Header) + payloadSize(labels, voxels(grid), enc);
+}
+
+Encoding smallest(const uint8_t* labels, int grid) {
+    Encoding best = Encoding::Dense;
+    size_t   best_size = voxels(grid);
+    for (Encoding e : {Encoding::Sparse, Encoding::Rle}) {
+        const size_t s = payloadSize(labels, voxels(grid), e);
+        if (s < best_size) { best = e; best_size = s; }
+    }
+    return best;
+}
+
+void encode(const uint8_t* labels, int grid, Encoding enc, std::vector<uint8_t>& out) {
+    if (grid <= 0 || grid > 1024)
+        throw std::invalid_argument("seglabels::encode: недопустимый размер сетки");
+    const size_t n = voxels(grid);
+    out.resize(sizeof(Header));
+    switch (enc) {
+    case Encoding::Dense:
+        out.insert(out.end(), labels, labels + n);
+        break;
+    case Encoding::Sparse:
+        for (size_t i = 0, zeros = 0; i < n; ++i) {
+            if (labels[i] == 0) { ++zeros; continue; }
+            putVarint(out, zeros);
+            out.push_back(labels[i]);
+            zeros = 0;
+        }
+        break;
+    case Encoding::Rle:
+        forEachRun(labels, n, [&](size_t len, uint8_t l) {
+            putVarint(out, len);
+            out.push_back(l);
+        });
+        break;
+    default:
+        throw std::invalid_argument("seglabels::encode: неизвестная кодировка");
+    }
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(h.magic));
+    h.version       = kVersion;
+    h.encoding      = static_cast<uint8_t>(enc);
+    h.grid          = static_cast<uint32_t>(grid);
+    h.payload_bytes = static_cast<uint32_t>(out.size() - sizeof(Header));
+    std::memcpy(out.data(), &h, sizeof(h));
+}
+
+void decode(const uint8_t* data, size_t size, int grid, const std::string& name, uint8_t* labels) {
+    Header h;
+    if (size < sizeof(h)) corrupt(name, "нет заголовка");
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(h.magic)) != 0) corrupt(name, "неверная сигнатура");
+    if (h.version == 0 || h.version > kVersion)
+        throw std::runtime_error("Метки сегментации " + name + ": неподдерживаемая версия " + std::to_string(h.version));
+    if (h.grid != static_cast<uint32_t>(grid))
+        throw std::runtime_error("Метки сегментации " + name + " для сетки " + std::to_string(h.grid) +
+                                 "³, ожидалась " + std::to_string(grid) + "³");
+    if (h.payload_bytes > size - sizeof(h)) corrupt(name, "блок обрезан");
+
+    const size_t n = voxels(grid);
+    Reader in{data + sizeof(h), data + sizeof(h) + h.payload_bytes, name};
+    switch (static_cast<Encoding>(h.encoding)) {
+    case Encoding::Dense:
+        if (h.payload_bytes != n) corrupt(name, "размер не равен grid³");
+        std::memcpy(labels, in.p, n);
+        return;
+    case Encoding::Sparse: {
+        std::memset(labels, 0, n);
+        size_t i = 0;
+        while (in.p != in.end) {
+            const size_t zeros = in.varint();
+            if (zeros >= n - i) corrupt(name, "индекс вокселя за пределами сетки");
+            i += zeros;
+            labels[i++] = in.byte();
+        }
+        return;
+    }
+    case Encoding::Rle: {
+        size_t i = 0;
+        while (in.p != in.end) {
+            const size_t len = in.varint();
+            if (len == 0 || len > n - i) corrupt(name, "серия за пределами сетки");
+            std::memset(labels + i, in.byte(), len);
+            i += len;
+        }
+        if (i != n) corrupt(name, "серии не покрывают сетку");
+        return;
+    }
+    }
+    corrupt(name, "неизвестная кодировка " + std::to_string(h.encoding));
+}
+
+void parseText(const char* data, size_t size, int grid, const std::string& name, uint8_t* labels) {
+    const char* p   = data;
+    const char* end = data + size;
+    const size_t n  = voxels(grid);
+    for (size_t i = 0; i < n; ++i) {
+        while (p < end && std::isspace(static_cast<unsigned char>(*p))) ++p;
+        int v = 0;
+        auto r = std::from_chars(p, end, v);
+        if (r.ec != std::errc())
+            throw std::runtime_error("В " + name + " меньше " + std::to_string(n) + " меток или не число");
+        if (v < 0 || v > 255)
+            throw std::runtime_error("Метка сегментации вне [0, 255]: " + name);
+        labels[i] = static_cast<uint8_t>(v);
+        p = r.ptr;
+    }
+}
+
+void write(const std::string& path, const uint8_t* labels, int grid, Encoding enc) {
+    std::vector<uint8_t> buf;
+    encode(labels, grid, enc, buf);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error("Не удалось открыть файл для записи меток: " + path);
+    size_t done = 0;
+    while (done < buf.size()) {
+        ssize_t w = ::write(fd, buf.data() + done, buf.size() - done);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) break;
+        done += static_cast<size_t>(w);
+    }
+    if (::close(fd) != 0 || done != buf.size())
+        throw std::runtime_error("Ошибка записи меток: " + path);
+}
+
+void read(const std::string& path, int grid, std::vector<uint8_t>& labels) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("Не удалось открыть seg: " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Не удалось открыть seg: " + path);
+    }
+    // Буфер файла живёт в потоке загрузки и не перевыделяется от образца к образцу
+    thread_local std::vector<char> raw;
+    raw.resize(static_cast<size_t>(st.st_size));
+    size_t got = 0;
+    while (got < raw.size()) {
+        ssize_t r = ::read(fd, raw.data() + got, raw.size() - got);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        got += static_cast<size_t>(r);
+    }
+    ::close(fd);
+
+    labels.resize(voxels(grid));
+    if (got >= sizeof(kMagic) && std::memcmp(raw.data(), kMagic, sizeof(kMagic)) == 0)
+        decode(reinterpret_cast<const uint8_t*>(raw.data()), got, grid, path, labels.data());
+    else
+        parseText(raw.data(), got, grid, path, labels.data());
+}
+
+const char* name(Encoding enc) {
+    switch (enc) {
+    case Encoding::Dense:  return "dense";
+    case Encoding::Sparse: return "sparse";
+    case Encoding::Rle:    return "rle";
+    }
+    return "?";
+}
+
+Encoding parseEncoding(const std::string& s) {
+    for (Encoding e : {Encoding::Dense, Encoding::Sparse, Encoding::Rle})
+        if (s == name(e)) return e;
+    throw std::invalid_argument("Неизвестная кодировка меток: " + s + " (dense, sparse, rle)");
+}
+
+} // namespace seglabels
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Компактное хранение меток сегментации: одна метка — байт, а не
+ * целое в тексте (_seg.txt) и не float. Файл <stem>.seg:
+ *
+ *   [Header, 16 байт][полезные данные payload_bytes]
+ *
+ * Кодировки полезных данных:
+ *   - Dense  — grid³ байт подряд;
+ *   - Sparse — только ненулевые (занятые) воксели в порядке индексов:
+ *              varint(число нулевых вокселей перед ним) + метка;
+ *   - Rle    — серии одинаковых меток: varint(длина) + метка, серии
+ *              покрывают все grid³ вокселей.
+ * Фон — метка 0; у поверхностной модели 32³ занято несколько процентов
+ * вокселей, и Sparse/Rle занимают единицы КБ вместо 32 (и 128 КБ float).
+ * Тот же блок (с заголовком) хранят шарды с флагом shard::kSegEncoded.
+ */
+namespace seglabels {
+
+enum class Encoding : uint8_t { Dense = 0, Sparse = 1, Rle = 2 };
+
+constexpr char     kMagic[4] = {'P', 'G', 'S', 'L'};
+constexpr uint8_t  kVersion  = 1;
+
+struct Header {
+    char     magic[4];
+    uint8_t  version;
+    uint8_t  encoding;          // Encoding
+    uint16_t reserved;
+    uint32_t grid;              // сторона куба
+    uint32_t payload_bytes;
+};
+static_assert(sizeof(Header) == 16, "seglabels::Header должен занимать 16 байт");
+
+/// Байт блока (с заголовком) для меток labels[grid³] в кодировке enc
+size_t encodedSize(const uint8_t* labels, int grid, Encoding enc);
+/// Самая короткая кодировка для этих меток
+Encoding smallest(const uint8_t* labels, int grid);
+
+/// Закодировать labels[grid³] в out (out перезаписывается)
+void encode(const uint8_t* labels, int grid, Encoding enc, std::vector<uint8_t>& out);
+
+/**
+ * Раскодировать блок data[size] в labels[grid³], где grid — ожидаемая
+ * сторона сетки. Повреждённый или чужой блок — runtime_error с именем name.
+ */
+void decode(const uint8_t* data, size_t size, int grid, const std::string& name, uint8_t* labels);
+
+/// Метки из _seg.txt (grid³ целых в [0, 255] через пробельные символы)
+void parseText(const char* data, size_t size, int grid, const std::string& name, uint8_t* labels);
+
+/// Записать метки в файл .seg
+void write(const std::string& path, const uint8_t* labels, int grid, Encoding enc);
+
+/// Метки из .seg или _seg.txt (формат — по сигнатуре) в labels (размер grid³)
+void read(const std::string& path, int grid, std::vector<uint8_t>& labels);
+
+const char* name(Encoding enc);
+/// "dense", "sparse", "rle"; иначе invalid_argument
+Encoding parseEncoding(const std::string& s);
+
+} // namespace seglabels
@@ -0,0 +1,282 @@
+#include "data/Shard.h"
+#include "data/SegLabels.h"
+#include "network/Checkpoint.h"
+#include "utils/Intrin.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+size_t alignUp(size_t n) { return (n + shard::kAlign - 1) / shard::kAlign * shard::kAlign; }
+
+size_t voxels(int grid) { return static_cast<size_t>(grid) * grid * grid; }
+
+// Смещение меток сегментации внутри записи образца
+size_t segOffset(int grid) { return alignUp(shard::occupancyBytes(grid)); }
+
+size_t recordBytes(int grid, bool with_seg) {
+    return alignUp(segOffset(grid) + (with_seg ? voxels(grid) : 0));
+}
+
+void ensureShape(Tensor3D& t, int grid) {
+    if (t.depth() != grid || t.height() != grid || t.width() != grid || t.channels() != 1)
+        t = Tensor3D(grid, grid, grid, 1);
+}
+
+} // namespace
+
+SIMD_KERNELS_BEGIN
+namespace shard {
+
+void packBits(const float* values, size_t n, uint8_t* bits) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const __m512 zero = _mm512_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        uint16_t m = _mm512_cmp_ps_mask(_mm512_loadu_ps(values + i), zero, _CMP_NEQ_UQ);
+        std::memcpy(bits + i / 8, &m, sizeof(m));
+    }
+#endif
+    std::memset(bits + i / 8, 0, (n - i + 7) / 8);
+    for (; i < n; ++i)
+        if (values[i] != 0.0f) bits[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+}
+
+void unpackBits(const uint8_t* bits, size_t n, float* out) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    // 16 бит маски → 16 float одной маскированной пересылкой
+    const __m512 one = _mm512_set1_ps(1.0f);
+    for (; i + 16 <= n; i += 16) {
+        uint16_t m;
+        std::memcpy(&m, bits + i / 8, sizeof(m));
+        _mm512_storeu_ps(out + i, _mm512_maskz_mov_ps(m, one));
+    }
+#endif
+    for (; i < n; ++i) out[i] = (bits[i / 8] >> (i % 8)) & 1u ? 1.0f : 0.0f;
+}
+
+void widenLabels(const uint8_t* labels, size_t n, float* out) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(labels + i));
+        _mm512_storeu_ps(out + i, _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(v)));
+    }
+#endif
+    for (; i < n; ++i) out[i] = static_cast<float>(labels[i]);
+}
+
+} // namespace shard
+SIMD_KERNELS_END
+
+// ---------- ShardWriter ----------
+
+ShardWriter::ShardWriter(const std::string& path, int grid, bool with_seg, bool encode_seg)
+    : path_(path), tmp_(path + ".tmp"), grid_(grid), with_seg_(with_seg),
+      encode_seg_(with_seg && encode_seg), offset_(sizeof(shard::FileHeader))
+{
+    if (grid <= 0 || grid > 1024)
+        throw std::invalid_argument("ShardWriter: недопустимый размер сетки");
+    fd_ = ::open(tmp_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) throw std::runtime_error("Не удалось открыть файл для записи шарда: " + tmp_);
+    // Заголовок пишется в finish(), когда известны индекс и CRC
+    shard::FileHeader blank{};
+    if (::pwrite(fd_, &blank, sizeof(blank), 0) != static_cast<ssize_t>(sizeof(blank))) {
+        ::close(fd_);
+        ::unlink(tmp_.c_str());
+        throw std::runtime_error("Ошибка записи шарда: " + tmp_);
+    }
+    record_.assign(recordBytes(grid_, with_seg_), 0);
+}
+
+ShardWriter::~ShardWriter() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        ::unlink(tmp_.c_str());
+    }
+}
+
+void ShardWriter::append(const void* data, size_t n) {
+    crc_ = ckpt::crc32c(data, n, crc_);
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (n > 0) {
+        ssize_t w = ::pwrite(fd_, p, n, static_cast<off_t>(offset_));
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) throw std::runtime_error("Ошибка записи шарда: " + tmp_);
+        p += w;
+        n -= static_cast<size_t>(w);
+        offset_ += static_cast<uint64_t>(w);
+    }
+}
+
+void ShardWriter::add(const std::string& name, const Tensor3D& occupancy, int label,
+                      const uint8_t* seg) {
+    if (fd_ < 0) throw std::logic_error("ShardWriter::add после finish()");
+    if (occupancy.depth() != grid_ || occupancy.height() != grid_
+        || occupancy.width() != grid_ || occupancy.channels() != 1)
+        throw std::invalid_argument("ShardWriter::add: маска должна быть grid³×1");
+    if (with_seg_ && !seg)
+        throw std::invalid_argument("ShardWriter::add: шард с сегментацией, а меток нет");
+
+    shard::IndexEntry e{};
+    e.offset = offset_;
+    e.label  = label;
+    std::strncpy(e.name, name.c_str(), sizeof(e.name) - 1);
+
+    if (encode_seg_) {
+        seglabels::encode(seg, grid_, seglabels::smallest(seg, grid_), seg_block_);
+        e.seg_bytes = static_cast<uint32_t>(seg_block_.size());
+        record_.resize(alignUp(segOffset(grid_) + seg_block_.size()));
+    }
+    std::fill(record_.begin(), record_.end(), 0);
+    shard::packBits(occupancy.data(), voxels(grid_), record_.data());
+    if (encode_seg_)    std::memcpy(record_.data() + segOffset(grid_), seg_block_.data(), seg_block_.size());
+    else if (with_seg_) std::memcpy(record_.data() + segOffset(grid_), seg, voxels(grid_));
+    append(record_.data(), record_.size());
+    index_.push_back(e);
+}
+
+void ShardWriter::finish() {
+    if (fd_ < 0) throw std::logic_error("ShardWriter::finish вызван повторно");
+    shard::FileHeader h{};
+    std::memcpy(h.magic, shard::kMagic, sizeof(h.magic));
+    // Плотные метки — формат версии 1, его читают и прежние сборки
+    h.version      = encode_seg_ ? shard::kVersion : 1;
+    h.sample_count = static_cast<uint32_t>(index_.size());
+    h.grid         = static_cast<uint32_t>(grid_);
+    h.flags        = (with_seg_ ? shard::kHasSeg : 0) | (encode_seg_ ? shard::kSegEncoded : 0);
+    h.index_offset = offset_;
+    if (!index_.empty()) append(index_.data(), index_.size() * sizeof(shard::IndexEntry));
+    h.file_size    = offset_;
+    h.checksum     = crc_;
+    h.header_size  = sizeof(shard::FileHeader);
+
+    bool ok = ::pwrite(fd_, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) && ::fsync(fd_) == 0;
+    ::close(fd_);
+    fd_ = -1;
+    if (!ok || ::rename(tmp_.c_str(), path_.c_str()) != 0) {
+        ::unlink(tmp_.c_str());
+        throw std::runtime_error("Не удалось записать шард: " + path_);
+    }
+
+    // Сам rename становится устойчивым после fsync каталога (как у CheckpointWriter)
+    const size_t slash = path_.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path_.substr(0, slash));
+    int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd >= 0) {
+        ::fsync(dfd);
+        ::close(dfd);
+    }
+}
+
+// ---------- MappedShard ----------
+
+bool MappedShard::isShard(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(shard::kMagic)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, shard::kMagic, sizeof(magic)) == 0;
+}
+
+MappedShard::MappedShard(const std::string& path, bool verify) : path_(path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("Не удалось открыть шард: " + path);
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(shard::FileHeader))) {
+        ::close(fd);
+        throw std::runtime_error("Шард повреждён (слишком короткий): " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("mmap шарда не удался: " + path);
+    base_   = static_cast<const uint8_t*>(p);
+    header_ = reinterpret_cast<const shard::FileHeader*>(base_);
+    try {
+        validate(verify);
+    } catch (...) {
+        ::munmap(const_cast<uint8_t*>(base_), size_);
+        throw;
+    }
+    index_ = reinterpret_cast<const shard::IndexEntry*>(base_ + header_->index_offset);
+}
+
+MappedShard::~MappedShard() {
+    if (base_) ::munmap(const_cast<uint8_t*>(base_), size_);
+}
+
+void MappedShard::validate(bool verify) const {
+    auto fail = [&](const std::string& what) {
+        throw std::runtime_error("Шард " + path_ + " повреждён: " + what);
+    };
+    const shard::FileHeader& h = *header_;
+    if (std::memcmp(h.magic, shard::kMagic, sizeof(h.magic)) != 0) fail("неверная сигнатура");
+    if (h.version == 0 || h.version > shard::kVersion)
+        throw std::runtime_error("Шард " + path_ + ": неподдерживаемая версия " + std::to_string(h.version));
+    if (h.header_size != sizeof(shard::FileHeader)) fail("неверный размер заголовка");
+    if (h.file_size != size_) fail("размер файла не совпадает с заголовком (обрезан?)");
+    if (h.grid == 0 || h.grid > 1024) fail("неверный размер сетки");
+    if (h.index_offset % shard::kAlign != 0 || h.index_offset > size_
+        || h.sample_count != (size_ - h.index_offset) / sizeof(shard::IndexEntry)
+        || (size_ - h.index_offset) % sizeof(shard::IndexEntry) != 0)
+        fail("индекс не согласован с размером файла");
+
+    const bool encoded = (h.flags & shard::kSegEncoded) != 0;
+    if (encoded && !(h.flags & shard::kHasSeg)) fail("флаг kSegEncoded без kHasSeg");
+    const auto* index = reinterpret_cast<const shard::IndexEntry*>(base_ + h.index_offset);
+    for (uint32_t i = 0; i < h.sample_count; ++i) {
+        const shard::IndexEntry& e = index[i];
+        const size_t record = encoded ? segOffset(static_cast<int>(h.grid)) + e.seg_bytes
+                                      : recordBytes(static_cast<int>(h.grid), (h.flags & shard::kHasSeg) != 0);
+        if (e.offset % shard::kAlign != 0 || e.offset < sizeof(shard::FileHeader)
+            || e.offset > h.index_offset || h.index_offset - e.offset < record)
+            fail("запись образца #" + std::to_string(i) + " вне файла");
+        if (std::memchr(e.name, '\0', sizeof(e.name)) == nullptr)
+            fail("имя образца #" + std::to_string(i));
+    }
+    if (verify && ckpt::crc32c(base_ + sizeof(shard::FileHeader), size_ - sizeof(shard::FileHeader)) != h.checksum)
+        fail("контрольная сумма не совпадает");
+}
+
+const uint8_t* MappedShard::seg(size_t i) const {
+    if (!hasSeg()) throw std::runtime_error("В шарде " + path_ + " нет меток сегментации");
+    return occupancy(i) + segOffset(grid());
+}
+
+size_t MappedShard::segBytes(size_t i) const {
+    return segEncoded() ? index_[i].seg_bytes : voxels(grid());
+}
+
+void MappedShard::unpackOccupancy(size_t i, Tensor3D& x) const {
+    ensureShape(x, grid());
+    shard::unpackBits(occupancy(i), voxels(grid()), x.data());
+}
+
+void MappedShard::unpackSeg(size_t i, Tensor3D& y) const {
+    const uint8_t* s = seg(i);
+    if (segEncoded()) {
+        thread_local std::vector<uint8_t> labels;
+        unpackSeg(i, labels);
+        s = labels.data();
+    }
+    ensureShape(y, grid());
+    shard::widenLabels(s, voxels(grid()), y.data());
+}
+
+void MappedShard::unpackSeg(size_t i, std::vector<uint8_t>& labels) const {
+    const uint8_t* s = seg(i);
+    labels.resize(voxels(grid()));
+    if (segEncoded()) seglabels::decode(s, segBytes(i), grid(), path_ + ":" + name(i), labels.data());
+    else              std::memcpy(labels.data(), s, labels.size());
+}
+
+void MappedShard::adviseRandom(bool random) const {
+    // Только подсказка: ошибка madvise на корректность чтения не влияет
+    ::madvise(const_cast<uint8_t*>(base_), size_, random ? MADV_RANDOM : MADV_NORMAL);
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "net/Tensor3D.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Шард датасета — много образцов в одном файле под mmap:
+ *
+ *   [FileHeader, 64 байта][записи образцов][IndexEntry × sample_count]
+ *
+ * Запись образца начинается со смещения, кратного 64: маска занятости
+ * grid³ бит (бит i — воксель с линейным индексом i в порядке Tensor3D,
+ * младший бит байта первый), затем, если есть флаг kHasSeg, метки
+ * сегментации: grid³ байт или, с флагом kSegEncoded (версия 2), блок
+ * seglabels длиной IndexEntry::seg_bytes — тогда записи разной длины.
+ * Индекс лежит в конце, чтобы шард писался потоком. checksum — CRC32C
+ * всех байт после заголовка. Шарды без kSegEncoded пишутся версией 1.
+ */
+namespace shard {
+
+constexpr char     kMagic[8] = {'P', 'G', 'S', 'H', 'A', 'R', 'D', '\n'};
+constexpr uint32_t kVersion    = 2;
+constexpr size_t   kAlign      = 64;
+constexpr uint32_t kHasSeg     = 1u << 0;
+constexpr uint32_t kSegEncoded = 1u << 1;  // метки — блоки seglabels (SegLabels.h)
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t sample_count;
+    uint32_t grid;              // сторона куба вокселей
+    uint32_t flags;             // kHasSeg, kSegEncoded
+    uint64_t index_offset;
+    uint64_t file_size;
+    uint32_t checksum;
+    uint32_t header_size;
+    uint8_t  reserved[16];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader должен занимать 64 байта");
+
+struct IndexEntry {
+    uint64_t offset;            // от начала файла, кратно kAlign
+    int32_t  label;             // класс образца
+    uint32_t seg_bytes;         // длина блока меток при kSegEncoded, иначе 0
+    char     name[48];          // имя исходного файла без расширения, NUL-терминированное
+};
+static_assert(sizeof(IndexEntry) == 64, "IndexEntry должен занимать 64 байта");
+
+/// Байт маски занятости на grid³ вокселей
+inline size_t occupancyBytes(int grid) { return (static_cast<size_t>(grid) * grid * grid + 7) / 8; }
+
+/// Маска занятости: bits[i/8] бит i%8 = (values[i] != 0)
+void packBits(const float* values, size_t n, uint8_t* bits);
+/// Обратно в 0/1 float
+void unpackBits(const uint8_t* bits, size_t n, float* out);
+/// Метки uint8 → float
+void widenLabels(const uint8_t* labels, size_t n, float* out);
+
+} // namespace shard
+
+/**
+ * Потоковая запись шарда: образцы дописываются по одному, finish()
+ * дописывает индекс и заголовок. Файл собирается в <path>.tmp и
+ * атомарно переименовывается (после fsync), так что недописанный шард
+ * никогда не оказывается под именем path; fsync каталога после rename
+ * делает устойчивым и само переименование.
+ */
+class ShardWriter {
+public:
+    /// encode_seg — хранить метки блоками seglabels (кодировка — самая короткая для образца)
+    ShardWriter(const std::string& path, int grid, bool with_seg, bool encode_seg = false);
+    ~ShardWriter();  // без finish() временный файл удаляется
+
+    ShardWriter(const ShardWriter&) = delete;
+    ShardWriter& operator=(const ShardWriter&) = delete;
+
+    /// occupancy — маска grid³×1; seg — grid³ меток (обязательны при with_seg)
+    void add(const std::string& name, const Tensor3D& occupancy, int label,
+             const uint8_t* seg = nullptr);
+    void finish();
+
+    size_t size() const { return index_.size(); }
+
+private:
+    std::string path_, tmp_;
+    int         grid_;
+    bool        with_seg_;
+    bool        encode_seg_;
+    int         fd_ = -1;
+    uint64_t    offset_;
+    uint32_t    crc_ = 0;
+    std::vector<shard::IndexEntry> index_;
+    std::vector<uint8_t>           record_;
+    std::vector<uint8_t>           seg_block_;
+
+    void append(const void* data, size_t n);
+};
+
+/**
+ * Шард, отображённый в память только для чтения. Загрузка образца —
+ * указатель в отображение и распаковка битов, без открытия файлов и
+ * разбора текста. Конструктор проверяет заголовок и индекс; CRC всего
+ * файла — только при verify (шарды большие и читаются каждый запуск).
+ */
+class MappedShard {
+public:
+    explicit MappedShard(const std::string& path, bool verify = false);
+    ~MappedShard();
+
+    MappedShard(const MappedShard&) = delete;
+    MappedShard& operator=(const MappedShard&) = delete;
+
+    static bool isShard(const std::string& path);
+
+    size_t size()   const { return header_->sample_count; }
+    int    grid()   const { return static_cast<int>(header_->grid); }
+    bool   hasSeg() const { return (header_->flags & shard::kHasSeg) != 0; }
+    bool   segEncoded() const { return (header_->flags & shard::kSegEncoded) != 0; }
+
+    int         label(size_t i) const { return index_[i].label; }
+    std::string name(size_t i)  const { return index_[i].name; }
+
+    /// Упакованная маска и метки сегментации образца i (внутри отображения):
+    /// grid³ байт или блок seglabels длиной segBytes(i) при segEncoded()
+    const uint8_t* occupancy(size_t i) const { return base_ + index_[i].offset; }
+    const uint8_t* seg(size_t i) const;
+    size_t         segBytes(size_t i) const;
+
+    /// Распаковка в grid³×1 (x пересоздаётся, если форма другая)
+    void unpackOccupancy(size_t i, Tensor3D& x) const;
+    void unpackSeg(size_t i, Tensor3D& y) const;
+    /// Метки сегментации байтами (labels — grid³ элементов)
+    void unpackSeg(size_t i, std::vector<uint8_t>& labels) const;
+
+    /**
+     * Подсказка ядру о порядке чтения: при random = true опережающее
+     * чтение отключается (MADV_RANDOM) — при перемешанном обходе оно
+     * тянуло бы соседние записи, которые понадобятся нескоро.
+     */
+    void adviseRandom(bool random) const;
+
+private:
+    const uint8_t*            base_   = nullptr;
+    size_t                    size_   = 0;
+    const shard::FileHeader*  header_ = nullptr;
+    const shard::IndexEntry*  index_  = nullptr;
+    std::string               path_;
+
+    void validate(bool verify) const;
+};
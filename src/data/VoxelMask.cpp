@@ -0,0 +1,165 @@
+#include "data/VoxelMask.h"
+#include "utils/Intrin.h"
+#include <limits>
+
+namespace {
+
+constexpr size_t kMinPointsPerThread = size_t(1) << 16;
+// Гистограммы потоков — потоки × ячейки счётчиков; больше не держим
+constexpr size_t kMaxCounters = size_t(1) << 26;
+
+// Потоков на n единиц работы: не больше threads и не мельче minimum на поток
+int threadsFor(size_t n, int threads, size_t minimum) {
+    if (threads <= 0) threads = defaultThreadCount();
+    const size_t by_size = std::max<size_t>(1, n / minimum);
+    return static_cast<int>(std::min(static_cast<size_t>(threads), by_size));
+}
+
+// Бокс, который поглощается любым min/max
+Bounds emptyBounds() {
+    Bounds b;
+    for (int a = 0; a < 3; ++a) {
+        b.lo[a] = std::numeric_limits<float>::infinity();
+        b.hi[a] = -std::numeric_limits<float>::infinity();
+    }
+    return b;
+}
+
+SIMD_KERNELS_BEGIN
+void boundsRange(const float* xyz, size_t begin, size_t end, size_t stride, Bounds& b) {
+    size_t i = begin;
+#if defined(__AVX512F__)
+    constexpr size_t kMaxStride = 16;
+    if (stride <= kMaxStride) {
+        __m512 lo[kMaxStride], hi[kMaxStride];
+        std::fill_n(lo, kMaxStride, _mm512_set1_ps(std::numeric_limits<float>::infinity()));
+        std::fill_n(hi, kMaxStride, _mm512_set1_ps(-std::numeric_limits<float>::infinity()));
+        // min(v, acc): при NaN в v остаётся acc, как у скалярного сравнения
+        for (; i + 16 <= end; i += 16) {
+            const float* p = xyz + i * stride;
+            for (size_t k = 0; k < stride; ++k) {
+                const __m512 v = _mm512_loadu_ps(p + 16 * k);
+                lo[k] = _mm512_min_ps(v, lo[k]);
+                hi[k] = _mm512_max_ps(v, hi[k]);
+            }
+        }
+        // Дорожка l вектора k — float номер 16k + l блока, ось (16k + l) mod stride
+        alignas(64) float l16[16], h16[16];
+        for (size_t k = 0; k < stride; ++k) {
+            _mm512_store_ps(l16, lo[k]);
+            _mm512_store_ps(h16, hi[k]);
+            for (size_t l = 0; l < 16; ++l) {
+                const size_t a = (16 * k + l) % stride;
+                if (a >= 3) continue;
+                b.lo[a] = std::min(b.lo[a], l16[l]);
+                b.hi[a] = std::max(b.hi[a], h16[l]);
+            }
+        }
+    }
+#endif
+    for (; i < end; ++i)
+        for (int a = 0; a < 3; ++a) {
+            const float v = xyz[i * stride + a];
+            b.lo[a] = v < b.lo[a] ? v : b.lo[a];
+            b.hi[a] = v > b.hi[a] ? v : b.hi[a];
+        }
+}
+SIMD_KERNELS_END
+
+} // namespace
+
+Bounds computeBounds(const float* xyz, size_t count, size_t stride, int threads) {
+    Bounds b{};
+    if (count == 0) return b;
+    const int T = threadsFor(count, threads, kMinPointsPerThread);
+    std::vector<Bounds> part(static_cast<size_t>(T), emptyBounds());
+    parallelFor(count, T, [&](size_t begin, size_t end, int t) {
+        boundsRange(xyz, begin, end, stride, part[static_cast<size_t>(t)]);
+    });
+    b = part[0];
+    for (int t = 1; t < T; ++t)
+        for (int a = 0; a < 3; ++a) {
+            b.lo[a] = std::min(b.lo[a], part[static_cast<size_t>(t)].lo[a]);
+            b.hi[a] = std::max(b.hi[a], part[static_cast<size_t>(t)].hi[a]);
+        }
+    return b;
+}
+
+void binPoints(const float* xyz, size_t count, const NormalizedGrid& g, CellIndex& idx, int threads) {
+    if (count > std::numeric_limits<uint32_t>::max())
+        throw std::length_error("binPoints: больше 2^32 точек в одном облаке");
+    const size_t cells = g.cells();
+    int T = threadsFor(count, threads, kMinPointsPerThread);
+    while (T > 1 && static_cast<size_t>(T) * cells > kMaxCounters) --T;
+    const size_t chunk = (count + T - 1) / T;
+
+    idx.cell_of.resize(count);
+    idx.order.resize(count);
+    idx.start.resize(cells + 1);
+    idx.counts.assign(static_cast<size_t>(T) * cells, 0);
+    idx.part_occupied.resize(static_cast<size_t>(T));
+
+    // 1) Ячейки точек и гистограмма каждого куска
+    parallelFor(static_cast<size_t>(T), T, [&](size_t tb, size_t te, int) {
+        for (size_t t = tb; t < te; ++t) {
+            uint32_t* hist = idx.counts.data() + t * cells;
+            for (size_t i = t * chunk; i < std::min(count, (t + 1) * chunk); ++i) {
+                const uint32_t c = static_cast<uint32_t>(g.cell(xyz + 3 * i));
+                idx.cell_of[i] = c;
+                ++hist[c];
+            }
+        }
+    });
+
+    // 2) Смещения в порядке (ячейка, кусок): каждый поток суммирует свой
+    //    диапазон ячеек, затем заполняет его от общего префикса
+    const size_t cell_chunk = (cells + T - 1) / T;
+    std::vector<size_t> range_total(static_cast<size_t>(T) + 1, 0);
+    auto cellRange = [&](size_t r) {
+        return std::make_pair(std::min(cells, r * cell_chunk), std::min(cells, (r + 1) * cell_chunk));
+    };
+    parallelFor(static_cast<size_t>(T), T, [&](size_t rb, size_t re, int) {
+        for (size_t r = rb; r < re; ++r) {
+            const auto [cb, ce] = cellRange(r);
+            size_t sum = 0;
+            for (size_t t = 0; t < static_cast<size_t>(T); ++t) {
+                const uint32_t* hist = idx.counts.data() + t * cells;
+                for (size_t c = cb; c < ce; ++c) sum += hist[c];
+            }
+            range_total[r + 1] = sum;
+        }
+    });
+    for (size_t r = 0; r < static_cast<size_t>(T); ++r) range_total[r + 1] += range_total[r];
+    parallelFor(static_cast<size_t>(T), T, [&](size_t rb, size_t re, int) {
+        for (size_t r = rb; r < re; ++r) {
+            const auto [cb, ce] = cellRange(r);
+            std::vector<uint32_t>& occ = idx.part_occupied[r];
+            occ.clear();
+            uint32_t run = static_cast<uint32_t>(range_total[r]);
+            for (size_t c = cb; c < ce; ++c) {
+                idx.start[c] = run;
+                for (size_t t = 0; t < static_cast<size_t>(T); ++t) {
+                    uint32_t& n = idx.counts[t * cells + c];
+                    const uint32_t off = run;
+                    run += n;
+                    n = off;
+                }
+                if (run != idx.start[c]) occ.push_back(static_cast<uint32_t>(c));
+            }
+        }
+    });
+    idx.start[cells] = static_cast<uint32_t>(count);
+
+    // 3) Раскладка: у каждого куска свои смещения, записи не пересекаются
+    parallelFor(static_cast<size_t>(T), T, [&](size_t tb, size_t te, int) {
+        for (size_t t = tb; t < te; ++t) {
+            uint32_t* off = idx.counts.data() + t * cells;
+            for (size_t i = t * chunk; i < std::min(count, (t + 1) * chunk); ++i)
+                idx.order[off[idx.cell_of[i]]++] = static_cast<uint32_t>(i);
+        }
+    });
+
+    idx.occupied.clear();
+    for (size_t r = 0; r < static_cast<size_t>(T); ++r)
+        idx.occupied.insert(idx.occupied.end(), idx.part_occupied[r].begin(), idx.part_occupied[r].end());
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "net/Tensor3D.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Растеризация облака точек в маску занятости.
+ *
+ * Точки заданы в координатах вокселей (как в PLY, которые пишет вокселизатор
+ * и читает DataLoader): x → depth, y → height, z → width. Точки вне сетки
+ * отбрасываются. xyz — упакованные тройки float, count — число точек.
+ */
+inline void rasterizePoints(const float* xyz, size_t count, Tensor3D& mask) {
+    const int D = mask.depth(), H = mask.height(), W = mask.width();
+    for (size_t i = 0; i < count; ++i) {
+        int x = static_cast<int>(xyz[3*i + 0]);
+        int y = static_cast<int>(xyz[3*i + 1]);
+        int z = static_cast<int>(xyz[3*i + 2]);
+        if (0 <= x && x < D &&
+            0 <= y && y < H &&
+            0 <= z && z < W) {
+            mask(x, y, z, 0) = 1.0f;
+        }
+    }
+}
+
+/// Покоординатный ограничивающий бокс облака
+struct Bounds {
+    float lo[3], hi[3];
+};
+
+/**
+ * Границы облака из count точек; координаты точки i — xyz[i·stride + 0..2]
+ * (stride в float: 3 для упакованных троек, больше — для структур вроде
+ * PointNL). SIMD-редукция: блок из 16 точек — ровно stride векторов, и
+ * раскладка осей по дорожкам в каждом из них от блока к блоку одна и та
+ * же, так что min/max копятся без перестановок и сводятся по осям один
+ * раз в конце. Облака от 2^16 точек делятся между threads потоками
+ * (≤ 0 — все ядра). Пустое облако — нулевой бокс.
+ */
+Bounds computeBounds(const float* xyz, size_t count, size_t stride = 3, int threads = 1);
+
+/**
+ * Нормировка «сырого» облака (произвольные координаты) в сетку D×H×W:
+ * точки делятся по своему ограничивающему боксу, как в
+ * scripts/preprocess_one.py (save_seg), и попадают в ячейку
+ * min(int((x - min) / span * N), N - 1).
+ */
+struct NormalizedGrid {
+    float lo[3], scale[3];
+    int   dims[3];
+
+    NormalizedGrid(const Bounds& b, int D, int H, int W) : dims{D, H, W} {
+        for (int a = 0; a < 3; ++a) {
+            lo[a]    = b.lo[a];
+            scale[a] = dims[a] / (b.hi[a] - b.lo[a] + 1e-8f);
+        }
+    }
+    NormalizedGrid(const float* xyz, size_t count, int D, int H, int W)
+        : NormalizedGrid(computeBounds(xyz, count), D, H, W) {}
+
+    size_t cells() const { return static_cast<size_t>(dims[0]) * dims[1] * dims[2]; }
+
+    /// Линейный индекс ячейки точки p (d·H·W + h·W + w). Координата
+    /// прижимается к сетке до перевода в int: NaN идёт в 0, вне бокса — к краю
+    size_t cell(const float* p) const {
+        int c[3];
+        for (int a = 0; a < 3; ++a) {
+            float v = (p[a] - lo[a]) * scale[a];
+            v = v > 0.0f ? v : 0.0f;
+            const float top = static_cast<float>(dims[a] - 1);
+            c[a] = static_cast<int>(v < top ? v : top);
+        }
+        return (static_cast<size_t>(c[0]) * dims[1] + c[1]) * dims[2] + c[2];
+    }
+};
+
+/**
+ * Индекс ячейка → точки в формате CSR: точки ячейки c — order[start[c]]
+ * … order[start[c + 1] − 1] по возрастанию номеров, occupied — непустые
+ * ячейки по возрастанию. Остальные поля — рабочие буферы binPoints;
+ * один CellIndex на поток загрузки не перевыделяется от облака к облаку.
+ */
+struct CellIndex {
+    std::vector<uint32_t> start;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> occupied;
+
+    std::vector<uint32_t> cell_of;   // ячейка каждой точки
+    std::vector<uint32_t> counts;    // гистограммы (потоки × ячейки), затем смещения
+    std::vector<std::vector<uint32_t>> part_occupied;
+};
+
+/**
+ * Разложить точки по ячейкам g параллельной сортировкой подсчётом: каждый
+ * из потоков считает ячейки и гистограмму своего куска точек, префиксная
+ * сумма по (ячейка, поток) даёт смещения, и куски раскладываются в order
+ * без блокировок, сохраняя порядок точек.
+ */
+void binPoints(const float* xyz, size_t count, const NormalizedGrid& g, CellIndex& idx, int threads = 1);
+
+/// fn(cell, points, n, thread) для каждой непустой ячейки idx, ячейки делятся между потоками
+template <class Fn>
+void forEachCell(const CellIndex& idx, int threads, Fn&& fn) {
+    parallelFor(idx.occupied.size(), threads, [&](size_t b, size_t e, int t) {
+        for (size_t k = b; k < e; ++k) {
+            const uint32_t c = idx.occupied[k];
+            fn(c, idx.order.data() + idx.start[c], static_cast<size_t>(idx.start[c + 1] - idx.start[c]), t);
+        }
+    });
+}
+
+/// Маска занятости «сырого» облака в ячейках NormalizedGrid
+inline void rasterizeNormalized(const float* xyz, size_t count, Tensor3D& mask) {
+    if (count == 0) return;
+    const NormalizedGrid g(xyz, count, mask.depth(), mask.height(), mask.width());
+    float* m = mask.data();
+    for (size_t i = 0; i < count; ++i) m[g.cell(xyz + 3*i)] = 1.0f;
+}
+
+/**
+ * Маска занятости и метки сегментации «сырого» облака с метками точек.
+ * Ячейки — как в rasterizeNormalized; метка ячейки — самая частая метка
+ * её точек (при равенстве — меньшая), пустые ячейки — 0, как в save_seg.
+ * Точки с отрицательной меткой занимают ячейку, но не голосуют; метки
+ * больше 255 не помещаются в байт — runtime_error.
+ * mask и seg (mask.size() байт) должны быть уже обнулены; cells — рабочий
+ * индекс вызывающего. Голосование идёт по ячейкам в threads потоках.
+ * DataLoader зовёт с threads = 1: он и так грузит образцы параллельно.
+ */
+inline void rasterizeNormalizedSeg(const float* xyz, const int32_t* labels, size_t count,
+                                   Tensor3D& mask, uint8_t* seg, CellIndex& cells, int threads = 1) {
+    if (count == 0) return;
+    const NormalizedGrid g(computeBounds(xyz, count, 3, threads), mask.depth(), mask.height(), mask.width());
+    binPoints(xyz, count, g, cells, threads);
+    float* m = mask.data();
+    for (uint32_t c : cells.occupied) m[c] = 1.0f;
+    forEachCell(cells, threads, [&](uint32_t c, const uint32_t* pts, size_t n, int) {
+        // Счётчики меток потока; после ячейки обнуляются только задетые
+        thread_local uint32_t votes[256] = {};
+        for (size_t k = 0; k < n; ++k) {
+            const int32_t l = labels[pts[k]];
+            if (l > 255) {
+                for (size_t j = 0; j < k; ++j)
+                    if (labels[pts[j]] >= 0) votes[labels[pts[j]]] = 0;
+                throw std::runtime_error("rasterizeNormalizedSeg: метка точки больше 255");
+            }
+            if (l >= 0) ++votes[l];
+        }
+        uint32_t best = 0, best_n = 0;
+        for (size_t k = 0; k < n; ++k) {
+            const int32_t l = labels[pts[k]];
+            if (l < 0 || votes[l] == 0) continue;
+            if (votes[l] > best_n || (votes[l] == best_n && static_cast<uint32_t>(l) < best)) {
+                best_n = votes[l];
+                best   = static_cast<uint32_t>(l);
+            }
+            votes[l] = 0;
+        }
+        seg[c] = static_cast<uint8_t>(best);
+    });
+}
@@ -0,0 +1,11 @@
+#include "dist/GradientSync.h"
+
+void allReduceGradients(Network& net, ICollective& comm) {
+    if (comm.world() == 1) return;
+    comm.allReduce(net.flatGradients(), net.flatSize());
+}
+
+void broadcastParameters(Network& net, ICollective& comm, int root) {
+    if (comm.world() == 1) return;
+    comm.broadcast(net.flatParameters(), net.flatSize(), root);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "dist/ICollective.h"
+#include "network/network.h"
+
+/**
+ * Синхронизация сети между рангами через ICollective.
+ *
+ * Параметры и градиенты сети лежат в непрерывной арене, поэтому на шаг
+ * приходится одна коллективная операция над Network::flatSize() float
+ * прямо в буфере сети, без упаковки по тензорам.
+ */
+
+/// Сумма градиентов по всем рангам
+void allReduceGradients(Network& net, ICollective& comm);
+
+/// Разослать веса ранга root всем остальным
+void broadcastParameters(Network& net, ICollective& comm, int root = 0);
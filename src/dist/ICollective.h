@@ -0,0 +1,35 @@
+#ifndef ICOLLECTIVE_H
+#define ICOLLECTIVE_H
+
+#include <cstddef>
+
+/**
+ * \brief Абстрактный интерфейс коллективных операций между рангами.
+ *
+ * Обучение пишется поверх этого интерфейса; транспорт (общая память
+ * на одном хосте, сеть между узлами) подменяется реализацией.
+ */
+class ICollective {
+public:
+    /// Номер текущего участника в [0, world())
+    virtual int rank() const = 0;
+
+    /// Общее число участников
+    virtual int world() const = 0;
+
+    /**
+     * \brief Поэлементная сумма буфера по всем рангам, результат у всех.
+     * \param data Буфер из n float, перезаписывается суммой.
+     */
+    virtual void allReduce(float* data, size_t n) = 0;
+
+    /// Разослать буфер ранга root всем остальным
+    virtual void broadcast(float* data, size_t n, int root = 0) = 0;
+
+    /// Дождаться всех участников
+    virtual void barrier() = 0;
+
+    virtual ~ICollective() = default;
+};
+
+#endif // ICOLLECTIVE_H
@@ -0,0 +1,157 @@
+#include "dist/ShmAllReduce.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr uint32_t kMagic = 0x52534750;  // "PGSR"
+constexpr size_t   kAlign = 64;
+
+size_t alignUp(size_t n) { return (n + kAlign - 1) / kAlign * kAlign; }
+}
+
+struct ShmAllReduce::Header {
+    uint32_t magic;
+    int32_t  world;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint32_t> arrived;
+    alignas(64) std::atomic<uint32_t> generation;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "барьер в общей памяти требует lock-free атомиков");
+
+void ShmAllReduce::create(const std::string& name, int world, size_t capacity) {
+    if (world < 1 || capacity == 0)
+        throw std::invalid_argument("ShmAllReduce::create: некорректные world/capacity");
+    size_t bytes = alignUp(sizeof(Header)) + world * alignUp(capacity * sizeof(float));
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw std::runtime_error("ShmAllReduce: не удалось создать сегмент " + name);
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) < 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("ShmAllReduce: ftruncate не удался для " + name);
+    }
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("ShmAllReduce: mmap не удался для " + name);
+    }
+    Header* h = new (p) Header;
+    h->world    = world;
+    h->capacity = capacity;
+    h->arrived.store(0);
+    h->generation.store(0);
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic = kMagic;
+    ::munmap(p, bytes);
+}
+
+void ShmAllReduce::unlink(const std::string& name) {
+    ::shm_unlink(name.c_str());
+}
+
+ShmAllReduce::ShmAllReduce(const std::string& name, int rank) : rank_(rank) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) throw std::runtime_error("ShmAllReduce: сегмент не найден: " + name);
+    struct stat st;
+    if (::fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error("ShmAllReduce: повреждённый сегмент " + name);
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+    base_  = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base_ == MAP_FAILED)
+        throw std::runtime_error("ShmAllReduce: mmap не удался для " + name);
+
+    hdr_ = static_cast<Header*>(base_);
+    if (hdr_->magic != kMagic) {
+        ::munmap(base_, bytes_);
+        throw std::runtime_error("ShmAllReduce: сегмент не инициализирован: " + name);
+    }
+    world_    = hdr_->world;
+    capacity_ = hdr_->capacity;
+    if (rank_ < 0 || rank_ >= world_) {
+        ::munmap(base_, bytes_);
+        throw std::invalid_argument("ShmAllReduce: rank вне [0, world)");
+    }
+}
+
+ShmAllReduce::~ShmAllReduce() {
+    if (base_) ::munmap(base_, bytes_);
+}
+
+float* ShmAllReduce::slot(int r) const {
+    char* p = static_cast<char*>(base_) + alignUp(sizeof(Header))
+            + static_cast<size_t>(r) * alignUp(capacity_ * sizeof(float));
+    return reinterpret_cast<float*>(p);
+}
+
+void ShmAllReduce::barrier() {
+    if (world_ == 1) return;
+    uint32_t gen = hdr_->generation.load(std::memory_order_acquire);
+    if (hdr_->arrived.fetch_add(1, std::memory_order_acq_rel) == static_cast<uint32_t>(world_ - 1)) {
+        hdr_->arrived.store(0, std::memory_order_relaxed);
+        hdr_->generation.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t spin = 0; hdr_->generation.load(std::memory_order_acquire) == gen; ++spin) {
+        if (spin < 1024) continue;
+        std::this_thread::yield();
+        if ((spin & 4095) == 0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() > timeout_s_)
+            throw std::runtime_error("ShmAllReduce: таймаут барьера (упал один из рангов?)");
+    }
+}
+
+void ShmAllReduce::allReduce(float* data, size_t n) {
+    if (n > capacity_)
+        throw std::invalid_argument("ShmAllReduce::allReduce: буфер больше capacity");
+    const int K = world_;
+    if (K == 1 || n == 0) return;
+
+    float* mine = slot(rank_);
+    const float* prev = slot((rank_ + K - 1) % K);
+    auto lo = [&](int c) { return n * c / K; };
+    auto hi = [&](int c) { return n * (c + 1) / K; };
+
+    std::memcpy(mine, data, n * sizeof(float));
+    barrier();
+
+    // reduce-scatter: после K-1 шагов кусок (rank+1) mod K полностью просуммирован
+    for (int s = 0; s < K - 1; ++s) {
+        int c = ((rank_ - 1 - s) % K + K) % K;
+        for (size_t i = lo(c); i < hi(c); ++i) mine[i] += prev[i];
+        barrier();
+    }
+    // all-gather: готовые куски идут по кольцу
+    for (int s = 0; s < K - 1; ++s) {
+        int c = ((rank_ - s) % K + K) % K;
+        std::memcpy(mine + lo(c), prev + lo(c), (hi(c) - lo(c)) * sizeof(float));
+        barrier();
+    }
+    std::memcpy(data, mine, n * sizeof(float));
+}
+
+void ShmAllReduce::broadcast(float* data, size_t n, int root) {
+    if (n > capacity_)
+        throw std::invalid_argument("ShmAllReduce::broadcast: буфер больше capacity");
+    if (world_ == 1 || n == 0) return;
+    if (rank_ == root) std::memcpy(slot(root), data, n * sizeof(float));
+    barrier();
+    if (rank_ != root) std::memcpy(data, slot(root), n * sizeof(float));
+    barrier();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "dist/ICollective.h"
+#include <cstddef>
+#include <string>
+
+/**
+ * Коллективные операции между процессами одного хоста через POSIX shared memory.
+ *
+ * Сегмент содержит заголовок с барьером и по одному слоту из capacity float
+ * на каждый ранг. allReduce — кольцевой: world-1 шагов reduce-scatter
+ * (ранг r добавляет к своему слоту кусок слота ранга r-1) и world-1 шагов
+ * all-gather, между шагами — барьер на атомиках в общей памяти.
+ * Каждый ранг читает только соседа, поэтому трафик на шаг — n/world float.
+ *
+ * Сегмент создаётся один раз (create) до запуска рангов, затем каждый
+ * процесс подключается конструктором со своим номером.
+ */
+class ShmAllReduce : public ICollective {
+public:
+    /// Создать сегмент name (например "/pointgrid_123") для world рангов
+    static void create(const std::string& name, int world, size_t capacity);
+
+    /// Удалить имя сегмента (отображения у живых процессов остаются)
+    static void unlink(const std::string& name);
+
+    /// Подключиться к существующему сегменту как ранг rank
+    ShmAllReduce(const std::string& name, int rank);
+    ~ShmAllReduce() override;
+
+    ShmAllReduce(const ShmAllReduce&) = delete;
+    ShmAllReduce& operator=(const ShmAllReduce&) = delete;
+
+    int  rank()  const override { return rank_; }
+    int  world() const override { return world_; }
+    void allReduce(float* data, size_t n) override;
+    void broadcast(float* data, size_t n, int root = 0) override;
+    void barrier() override;
+
+    /// Максимальный размер буфера для allReduce/broadcast
+    size_t capacity() const { return capacity_; }
+
+    /// Сколько ждать отставших рангов, прежде чем считать их упавшими
+    void setTimeoutSeconds(double s) { timeout_s_ = s; }
+
+private:
+    struct Header;
+
+    int     rank_, world_;
+    size_t  capacity_;
+    size_t  bytes_;
+    void*   base_ = nullptr;
+    Header* hdr_  = nullptr;
+    double  timeout_s_ = 300.0;
+
+    float* slot(int r) const;
+};
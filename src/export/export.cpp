@@ -0,0 +1,49 @@
+// export.cpp — упаковка обучающего чекпоинта в модель для инференса
+//
+// Результат — файл формата чекпоинта, в котором веса уже лежат в той
+// раскладке, что читают ядра InferenceEngine; predict/serve принимают его
+// вместо чекпоинта и стартуют без переупаковки (mmap + проверка CRC).
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "infer/InferenceEngine.h"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cout << "Использование:\n"
+                  << "  " << argv[0] << " <checkpoint.bin> <model.packed>\n";
+        return 1;
+    }
+    const std::string src = argv[1], dst = argv[2];
+    try {
+        if (InferenceEngine::isPacked(src)) {
+            std::cerr << src << " уже упакован\n";
+            return 1;
+        }
+        auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+
+        auto t0 = std::chrono::steady_clock::now();
+        InferenceEngine engine(src);
+        auto t1 = std::chrono::steady_clock::now();
+        engine.exportPacked(dst);
+
+        // Контроль: упакованная модель загружается и отвечает тем же
+        auto t2 = std::chrono::steady_clock::now();
+        InferenceEngine packed(dst);
+        auto t3 = std::chrono::steady_clock::now();
+        if (packed.numClasses() != engine.numClasses()
+            || packed.inputChannels() != engine.inputChannels()) {
+            std::cerr << "Упакованная модель не совпадает с исходной\n";
+            return 1;
+        }
+
+        std::cout << "Записано: " << dst << "\n"
+                  << "Загрузка чекпоинта: " << ms(t0, t1) << " мс, "
+                  << "упакованной модели: " << ms(t2, t3) << " мс\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "infer/BnReluPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void bnReluMaxPool(const float* conv, int Do, int Ho, int Wo, int stride, int C,
+                   const float* gamma, const float* beta, float eps,
+                   const PoolGeometry& pool, std::vector<float>& pooled) {
+    const size_t N = static_cast<size_t>(Do) * Ho * Wo;
+
+    // Статистики BN по образцу, свёрнутые в a*x+b
+    std::vector<double> sum(C, 0.0), sum2(C, 0.0);
+    for (size_t i = 0; i < N; ++i) {
+        const float* v = conv + i * stride;
+        for (int c = 0; c < C; ++c) sum[c] += v[c];
+    }
+    std::vector<float> mean(C), scale(C), shift(C);
+    for (int c = 0; c < C; ++c) mean[c] = static_cast<float>(sum[c] / N);
+    for (size_t i = 0; i < N; ++i) {
+        const float* v = conv + i * stride;
+        for (int c = 0; c < C; ++c) {
+            float d = v[c] - mean[c];
+            sum2[c] += d * d;
+        }
+    }
+    for (int c = 0; c < C; ++c) {
+        float inv_std = 1.0f / std::sqrt(static_cast<float>(sum2[c] / N) + eps);
+        scale[c] = gamma[c] * inv_std;
+        shift[c] = beta[c] - mean[c] * scale[c];
+    }
+
+    // BN + ReLU + MaxPool за один проход по окнам
+    const int PD = pool.outDim(Do, pool.kD, pool.sD);
+    const int PH = pool.outDim(Ho, pool.kH, pool.sH);
+    const int PW = pool.outDim(Wo, pool.kW, pool.sW);
+    const int pD = pool.same ? pool.kD / 2 : 0;
+    const int pH = pool.same ? pool.kH / 2 : 0;
+    const int pW = pool.same ? pool.kW / 2 : 0;
+    pooled.resize(static_cast<size_t>(PD) * PH * PW * C);
+
+    for (int d = 0; d < PD; ++d)
+    for (int h = 0; h < PH; ++h)
+    for (int w = 0; w < PW; ++w) {
+        float* dst = &pooled[((static_cast<size_t>(d) * PH + h) * PW + w) * C];
+        for (int c = 0; c < C; ++c) dst[c] = -std::numeric_limits<float>::infinity();
+        for (int kd = 0; kd < pool.kD; ++kd) {
+            int id = d * pool.sD + kd - pD;
+            if (id < 0 || id >= Do) continue;
+            for (int kh = 0; kh < pool.kH; ++kh) {
+                int ih = h * pool.sH + kh - pH;
+                if (ih < 0 || ih >= Ho) continue;
+                for (int kw = 0; kw < pool.kW; ++kw) {
+                    int iw = w * pool.sW + kw - pW;
+                    if (iw < 0 || iw >= Wo) continue;
+                    const float* v = conv + ((static_cast<size_t>(id) * Ho + ih) * Wo + iw) * stride;
+                    for (int c = 0; c < C; ++c) {
+                        float y = std::max(0.0f, v[c] * scale[c] + shift[c]);
+                        dst[c] = std::max(dst[c], y);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/// Геометрия MaxPool3D, как её видят движки инференса
+struct PoolGeometry {
+    int  kD, kH, kW;
+    int  sD, sH, sW;
+    bool same;
+
+    int outDim(int size, int k, int s) const {
+        return same ? (size + s - 1) / s : (size - k) / s + 1;
+    }
+};
+
+/**
+ * Общая стадия движков инференса: BN по статистикам образца (как
+ * BatchNorm3D::forward), ReLU и MaxPool за один проход по окнам.
+ *
+ * conv — выход свёртки Do×Ho×Wo, у каждого вокселя stride float, из них
+ * первые C — каналы. Результат (PD×PH×PW×C) пишется в pooled.
+ */
+void bnReluMaxPool(const float* conv, int Do, int Ho, int Wo, int stride, int C,
+                   const float* gamma, const float* beta, float eps,
+                   const PoolGeometry& pool, std::vector<float>& pooled);
@@ -0,0 +1,260 @@
+#include "infer/InferenceEngine.h"
+#include "network/Checkpoint.h"
+#include "network/network.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+InferenceEngine::InferenceEngine(const Network& net) {
+    pack(ModelView::fromNetwork(net));
+}
+
+namespace {
+
+// Поля packed.meta (int32)
+enum PackedMeta {
+    kFormat, kLanesField, kConvKernelField, kFcKernelField,
+    kInCh, kOutCh, kKD, kKH, kKW, kSD, kSH, kSW, kConvSame,
+    kPoolKD, kPoolKH, kPoolKW, kPoolSD, kPoolSH, kPoolSW, kPoolSame,
+    kFcIn, kFcOut,
+    kMetaSize
+};
+constexpr int32_t kPackedFormat = 1;
+
+// Буферы движка, собранного из весов (pack)
+struct OwnedWeights {
+    std::vector<float> conv_w, gamma, beta, fc_wt, fc_b;
+};
+
+} // namespace
+
+InferenceEngine::InferenceEngine(const std::string& checkpoint_path) {
+    // Новый формат читается прямо из отображения, без построения Network
+    if (MappedCheckpoint::isCheckpoint(checkpoint_path)) {
+        auto ck = std::make_shared<const MappedCheckpoint>(checkpoint_path);
+        if (ck->has("packed.meta")) {
+            bindPacked(std::move(ck));
+            return;
+        }
+        pack(ModelView::fromCheckpoint(*ck));
+        return;
+    }
+    Network net;
+    net.loadCheckpoint(checkpoint_path);
+    pack(ModelView::fromNetwork(net));
+}
+
+bool InferenceEngine::isPacked(const std::string& path) {
+    return MappedCheckpoint::isCheckpoint(path)
+        && MappedCheckpoint(path, /*verify=*/false).has("packed.meta");
+}
+
+void InferenceEngine::pack(const ModelView& m) {
+    in_ch_  = m.in_ch;
+    out_ch_ = m.out_ch;
+    kD_ = m.kD; kH_ = m.kH; kW_ = m.kW;
+    sD_ = m.sD; sH_ = m.sH; sW_ = m.sW;
+    conv_same_ = m.conv_same;
+    oc_blocks_ = (out_ch_ + kLanes - 1) / kLanes;
+    auto own = std::make_shared<OwnedWeights>();
+
+    // Свёртка: [kd][kh][kw][ic][oc] → [oc_block][kd][kh][kw][ic][lane].
+    // Смещение свёртки не нужно: BN по статистикам образца вычитает
+    // среднее канала, и постоянный сдвиг сокращается
+    const int taps = kD_ * kH_ * kW_ * in_ch_;
+    const float* w = m.conv_w;
+    own->conv_w.assign(static_cast<size_t>(oc_blocks_) * taps * kLanes, 0.0f);
+    for (int t = 0; t < taps; ++t)
+        for (int oc = 0; oc < out_ch_; ++oc) {
+            int b = oc / kLanes, l = oc % kLanes;
+            own->conv_w[(static_cast<size_t>(b) * taps + t) * kLanes + l] = w[t * out_ch_ + oc];
+        }
+
+    own->gamma.assign(m.gamma, m.gamma + out_ch_);
+    own->beta.assign(m.beta, m.beta + out_ch_);
+    eps_  = m.eps;
+    pool_ = m.pool;
+
+    // FC: [out][in] → [in][out_pad], чтобы внутренний цикл шёл по выходам
+    fc_in_  = m.fc_in;
+    fc_out_ = m.fc_out;
+    fc_out_pad_ = (fc_out_ + kLanes - 1) / kLanes * kLanes;
+    own->fc_wt.assign(static_cast<size_t>(fc_in_) * fc_out_pad_, 0.0f);
+    own->fc_b.assign(fc_out_pad_, 0.0f);
+    const float* fw = m.fc_w;
+    for (int o = 0; o < fc_out_; ++o)
+        for (int i = 0; i < fc_in_; ++i)
+            own->fc_wt[static_cast<size_t>(i) * fc_out_pad_ + o] = fw[static_cast<size_t>(o) * fc_in_ + i];
+    std::copy(m.fc_b, m.fc_b + fc_out_, own->fc_b.begin());
+
+    conv_w_ = own->conv_w.data();
+    gamma_  = own->gamma.data();
+    beta_   = own->beta.data();
+    fc_wt_  = own->fc_wt.data();
+    fc_b_   = own->fc_b.data();
+    storage_ = std::move(own);
+}
+
+void InferenceEngine::exportPacked(const std::string& path) const {
+    const int taps = kD_ * kH_ * kW_ * in_ch_;
+    const int32_t meta[kMetaSize] = {
+        kPackedFormat, kLanes,
+        static_cast<int32_t>(ConvKernel::DirectBlocked),
+        static_cast<int32_t>(FcKernel::TransposedBlocked),
+        in_ch_, out_ch_, kD_, kH_, kW_, sD_, sH_, sW_, conv_same_ ? 1 : 0,
+        pool_.kD, pool_.kH, pool_.kW, pool_.sD, pool_.sH, pool_.sW, pool_.same ? 1 : 0,
+        fc_in_, fc_out_
+    };
+    auto u32 = [](int v) { return static_cast<uint32_t>(v); };
+
+    CheckpointWriter w;
+    w.add("packed.meta",        {u32(kMetaSize)}, meta);
+    w.add("packed.conv.weight", {u32(oc_blocks_), u32(taps), u32(kLanes)}, conv_w_);
+    w.add("packed.bn.gamma",    {u32(out_ch_)}, gamma_);
+    w.add("packed.bn.beta",     {u32(out_ch_)}, beta_);
+    w.add("packed.bn.eps",      {1}, &eps_);
+    w.add("packed.fc.weight_t", {u32(fc_in_), u32(fc_out_pad_)}, fc_wt_);
+    w.add("packed.fc.bias",     {u32(fc_out_pad_)}, fc_b_);
+    w.write(path);
+}
+
+void InferenceEngine::bindPacked(std::shared_ptr<const MappedCheckpoint> ck) {
+    const int32_t* meta = ck->ints("packed.meta", kMetaSize);
+    if (meta[kFormat] != kPackedFormat || meta[kLanesField] != kLanes
+        || meta[kConvKernelField] != static_cast<int32_t>(ConvKernel::DirectBlocked)
+        || meta[kFcKernelField] != static_cast<int32_t>(FcKernel::TransposedBlocked))
+        throw std::runtime_error("InferenceEngine: упакованная модель собрана под другие ядра, "
+                                 "экспортируйте её заново из чекпоинта");
+
+    in_ch_  = meta[kInCh];  out_ch_ = meta[kOutCh];
+    kD_ = meta[kKD]; kH_ = meta[kKH]; kW_ = meta[kKW];
+    sD_ = meta[kSD]; sH_ = meta[kSH]; sW_ = meta[kSW];
+    conv_same_ = meta[kConvSame] != 0;
+    pool_ = { meta[kPoolKD], meta[kPoolKH], meta[kPoolKW],
+              meta[kPoolSD], meta[kPoolSH], meta[kPoolSW], meta[kPoolSame] != 0 };
+    fc_in_  = meta[kFcIn];
+    fc_out_ = meta[kFcOut];
+    if (in_ch_ <= 0 || out_ch_ <= 0 || kD_ <= 0 || kH_ <= 0 || kW_ <= 0
+        || sD_ <= 0 || sH_ <= 0 || sW_ <= 0 || pool_.kD <= 0 || pool_.kH <= 0 || pool_.kW <= 0
+        || pool_.sD <= 0 || pool_.sH <= 0 || pool_.sW <= 0 || fc_in_ <= 0 || fc_out_ <= 0)
+        throw std::runtime_error("InferenceEngine: некорректная геометрия в packed.meta");
+    oc_blocks_  = (out_ch_ + kLanes - 1) / kLanes;
+    fc_out_pad_ = (fc_out_ + kLanes - 1) / kLanes * kLanes;
+
+    // Размеры проверяет MappedCheckpoint; данные используются на месте
+    const size_t taps = static_cast<size_t>(kD_) * kH_ * kW_ * in_ch_;
+    conv_w_ = ck->floats("packed.conv.weight", oc_blocks_ * taps * kLanes);
+    gamma_  = ck->floats("packed.bn.gamma", out_ch_);
+    beta_   = ck->floats("packed.bn.beta",  out_ch_);
+    eps_    = *ck->floats("packed.bn.eps", 1);
+    fc_wt_  = ck->floats("packed.fc.weight_t", static_cast<size_t>(fc_in_) * fc_out_pad_);
+    fc_b_   = ck->floats("packed.fc.bias", fc_out_pad_);
+    storage_ = std::move(ck);
+}
+
+void InferenceEngine::forward(const Tensor3D& x, Workspace& ws, float* logits) const {
+    if (x.channels() != in_ch_)
+        throw std::invalid_argument("InferenceEngine::forward: неверное число входных каналов");
+    const int D = x.depth(), H = x.height(), W = x.width();
+    const float* xd = x.data();
+
+    // 1) Свёртка, блоками по kLanes выходных каналов
+    auto outDim = [](int size, int k, int s, bool same) {
+        return same ? (size + s - 1) / s : (size - k + s) / s;
+    };
+    const int Do = outDim(D, kD_, sD_, conv_same_);
+    const int Ho = outDim(H, kH_, sH_, conv_same_);
+    const int Wo = outDim(W, kW_, sW_, conv_same_);
+    const int oD = conv_same_ ? kD_ / 2 : 0;
+    const int oH = conv_same_ ? kH_ / 2 : 0;
+    const int oW = conv_same_ ? kW_ / 2 : 0;
+    const int Cp   = oc_blocks_ * kLanes;
+    const int taps = kD_ * kH_ * kW_ * in_ch_;
+    const size_t N = static_cast<size_t>(Do) * Ho * Wo;
+    ws.conv.resize(N * Cp);
+
+    for (int od = 0; od < Do; ++od)
+    for (int oh = 0; oh < Ho; ++oh)
+    for (int ow = 0; ow < Wo; ++ow) {
+        float* out = &ws.conv[((static_cast<size_t>(od) * Ho + oh) * Wo + ow) * Cp];
+        for (int b = 0; b < oc_blocks_; ++b) {
+            float acc[kLanes] = {};
+            const float* wb = &conv_w_[static_cast<size_t>(b) * taps * kLanes];
+            for (int kd = 0; kd < kD_; ++kd) {
+                int id = od * sD_ + kd - oD;
+                if (id < 0 || id >= D) continue;
+                for (int kh = 0; kh < kH_; ++kh) {
+                    int ih = oh * sH_ + kh - oH;
+                    if (ih < 0 || ih >= H) continue;
+                    for (int kw = 0; kw < kW_; ++kw) {
+                        int iw = ow * sW_ + kw - oW;
+                        if (iw < 0 || iw >= W) continue;
+                        const float* xp = xd + ((static_cast<size_t>(id) * H + ih) * W + iw) * in_ch_;
+                        const float* wp = wb + (((kd * kH_ + kh) * kW_ + kw) * in_ch_) * kLanes;
+                        for (int ic = 0; ic < in_ch_; ++ic) {
+                            float xv = xp[ic];
+                            for (int l = 0; l < kLanes; ++l)
+                                acc[l] += xv * wp[ic * kLanes + l];
+                        }
+                    }
+                }
+            }
+            for (int l = 0; l < kLanes; ++l) out[b * kLanes + l] = acc[l];
+        }
+    }
+
+    // 2) BN по статистикам образца + ReLU + MaxPool
+    bnReluMaxPool(ws.conv.data(), Do, Ho, Wo, Cp, out_ch_,
+                  gamma_, beta_, eps_, pool_, ws.pooled);
+
+    // Как и Network::forward, FC читает первые fc_in_ признаков
+    if (ws.pooled.size() < static_cast<size_t>(fc_in_))
+        throw std::invalid_argument("InferenceEngine::forward: вход слишком мал для FC-слоя");
+
+    // 3) FC по транспонированным весам
+    float acc[kLanes];
+    for (int ob = 0; ob < fc_out_pad_; ob += kLanes) {
+        for (int l = 0; l < kLanes; ++l) acc[l] = fc_b_[ob + l];
+        for (int i = 0; i < fc_in_; ++i) {
+            float xv = ws.pooled[i];
+            const float* wr = &fc_wt_[static_cast<size_t>(i) * fc_out_pad_ + ob];
+            for (int l = 0; l < kLanes; ++l) acc[l] += xv * wr[l];
+        }
+        for (int l = 0; l < kLanes && ob + l < fc_out_; ++l) logits[ob + l] = acc[l];
+    }
+}
+
+std::vector<float> InferenceEngine::forward(const Tensor3D& x) const {
+    static thread_local Workspace ws;
+    std::vector<float> logits(fc_out_);
+    forward(x, ws, logits.data());
+    return logits;
+}
+
+int InferenceEngine::classify(const Tensor3D& x) const {
+    auto logits = forward(x);
+    return static_cast<int>(std::max_element(logits.begin(), logits.end()) - logits.begin());
+}
+
+void InferenceEngine::forwardBatch(const Tensor3D* xs, size_t n, float* logits,
+                                   int num_threads) const {
+    std::vector<Workspace> ws(static_cast<size_t>(num_threads > 0 ? num_threads : defaultThreadCount()));
+    forwardBatch(xs, n, logits, ws);
+}
+
+void InferenceEngine::forwardBatch(const Tensor3D* xs, size_t n, float* logits,
+                                   std::vector<Workspace>& ws) const {
+    if (ws.empty()) ws.resize(1);
+    parallelFor(n, static_cast<int>(ws.size()), [&](size_t b, size_t e, int t) {
+        for (size_t i = b; i < e; ++i)
+            forward(xs[i], ws[static_cast<size_t>(t)], logits + i * fc_out_);
+    });
+}
+
+std::vector<float> InferenceEngine::forwardBatch(const std::vector<Tensor3D>& xs,
+                                                 int num_threads) const {
+    std::vector<float> logits(xs.size() * fc_out_);
+    forwardBatch(xs.data(), xs.size(), logits.data(), num_threads);
+    return logits;
+}
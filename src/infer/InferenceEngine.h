@@ -0,0 +1,108 @@
+#pragma once
+
+#include "infer/BnReluPool.h"
+#include "infer/ModelView.h"
+#include "net/Tensor3D.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+
+class Network;
+class MappedCheckpoint;
+
+/**
+ * Потокобезопасный движок инференса 3D-CNN (Conv → BN → ReLU → MaxPool → FC).
+ *
+ * Веса один раз копируются из Network (или чекпоинта) и переупаковываются
+ * в раскладку, удобную для векторизации: свёртка — блоками по kLanes выходных
+ * каналов, FC — транспонированная матрица [in][out]. Градиентных буферов нет,
+ * после конструирования объект не меняется (копии делят одни веса).
+ *
+ * exportPacked() сохраняет уже упакованные веса; такой файл движок
+ * отображает в память и использует на месте, без переупаковки.
+ *
+ * Все промежуточные активации живут в Workspace вызывающего потока, поэтому
+ * один движок можно одновременно использовать из любого числа потоков.
+ * Результат совпадает с Network::forward(x, false) с точностью до округления.
+ */
+class InferenceEngine {
+public:
+    /// Ширина блока выходных каналов свёртки / выходов FC
+    static constexpr int kLanes = 8;
+
+    /// Пер-поточная арена промежуточных буферов (переиспользуется между вызовами)
+    struct Workspace {
+        std::vector<float> conv;    // выход свёртки, D×H×W×(блоки каналов)
+        std::vector<float> pooled;  // признаки после BN+ReLU+MaxPool
+    };
+
+    explicit InferenceEngine(const Network& net);
+
+    /// Чекпоинт нового формата или упакованная модель (exportPacked)
+    /// отображаются в память и читаются на месте
+    explicit InferenceEngine(const std::string& checkpoint_path);
+
+    /**
+     * Упакованная модель для инференса в формате чекпоинта: веса свёртки
+     * в блочной раскладке [oc_block][tap][kLanes], транспонированный FC,
+     * геометрия и идентификаторы ядер (packed.meta). Загрузка такого
+     * файла — только mmap и проверка CRC.
+     */
+    void exportPacked(const std::string& path) const;
+
+    /// Является ли чекпоинт упакованной моделью
+    static bool isPacked(const std::string& path);
+
+    /// Раскладки весов, под которые собраны ядра; в packed.meta
+    /// пишутся их идентификаторы, при несовпадении загрузка отказывает
+    enum class ConvKernel : int32_t { DirectBlocked = 1 };
+    enum class FcKernel   : int32_t { TransposedBlocked = 1 };
+
+    /// Логиты одного образца в logits[0..numClasses()), буферы берутся из ws
+    void forward(const Tensor3D& x, Workspace& ws, float* logits) const;
+
+    /// То же с thread_local ареной текущего потока
+    std::vector<float> forward(const Tensor3D& x) const;
+
+    /// Индекс класса с максимальным логитом
+    int classify(const Tensor3D& x) const;
+
+    /**
+     * Батч из n образцов, логиты упакованы построчно (n × numClasses()).
+     * Образцы делятся между num_threads потоками (<= 0 — все ядра).
+     */
+    void forwardBatch(const Tensor3D* xs, size_t n, float* logits,
+                      int num_threads = 0) const;
+    /// То же в ws.size() потоках с арен вызывающего: буферы живут между батчами
+    void forwardBatch(const Tensor3D* xs, size_t n, float* logits,
+                      std::vector<Workspace>& ws) const;
+    std::vector<float> forwardBatch(const std::vector<Tensor3D>& xs,
+                                    int num_threads = 0) const;
+
+    int numClasses()    const { return fc_out_; }
+    int inputChannels() const { return in_ch_; }
+
+private:
+    // Геометрия свёртки
+    int in_ch_, out_ch_, oc_blocks_;
+    int kD_, kH_, kW_, sD_, sH_, sW_;
+    bool conv_same_;
+    // Геометрия пулинга
+    PoolGeometry pool_;
+    // FC
+    int fc_in_, fc_out_, fc_out_pad_;
+    float eps_;
+
+    // Веса смотрят в storage_: собственные буферы после pack()
+    // или отображённую упакованную модель
+    const float* conv_w_;   // [oc_block][kd][kh][kw][ic][kLanes]
+    const float* gamma_;
+    const float* beta_;
+    const float* fc_wt_;    // [fc_in_][fc_out_pad_]
+    const float* fc_b_;     // [fc_out_pad_]
+    std::shared_ptr<const void> storage_;
+
+    void pack(const ModelView& m);
+    void bindPacked(std::shared_ptr<const MappedCheckpoint> ck);
+};
@@ -0,0 +1,349 @@
+#include "infer/InferenceServer.h"
+#include "data/VoxelMask.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace serve_proto;
+
+namespace {
+
+constexpr size_t   kLatencyWindow = 8192;      // сколько последних запросов учитывать в p50/p99
+constexpr uint64_t kMaxGridVoxels = 256ull * 256 * 256;
+constexpr uint32_t kMaxPoints     = 1u << 26;
+
+bool readAll(int fd, void* buf, size_t n) {
+    char* p = static_cast<char*>(buf);
+    while (n > 0) {
+        ssize_t r = ::recv(fd, p, n, 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r; n -= static_cast<size_t>(r);
+    }
+    return true;
+}
+
+bool writeAll(int fd, const void* buf, size_t n) {
+    const char* p = static_cast<const char*>(buf);
+    while (n > 0) {
+        ssize_t r = ::send(fd, p, n, MSG_NOSIGNAL);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r; n -= static_cast<size_t>(r);
+    }
+    return true;
+}
+
+bool reply(int fd, Status st, const std::vector<float>& values = {}) {
+    ResponseHeader rh{st, static_cast<uint32_t>(values.size())};
+    return writeAll(fd, &rh, sizeof(rh)) &&
+           writeAll(fd, values.data(), values.size() * sizeof(float));
+}
+
+sockaddr_un makeAddr(const std::string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+        throw std::invalid_argument("Слишком длинный путь к сокету: " + path);
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    return addr;
+}
+
+} // namespace
+
+// ---------------- InferenceServer ----------------
+
+InferenceServer::InferenceServer(const InferenceEngine& engine, ServerConfig cfg)
+    : engine_(engine), cfg_(std::move(cfg))
+{
+    if (cfg_.socket_path.empty())
+        throw std::invalid_argument("InferenceServer: не задан путь к сокету");
+    if (cfg_.max_batch < 1 || cfg_.max_wait_us < 0 || cfg_.grid < 1)
+        throw std::invalid_argument("InferenceServer: некорректные параметры батчинга");
+    latencies_us_.reserve(kLatencyWindow);
+}
+
+InferenceServer::~InferenceServer() {
+    stop();
+}
+
+void InferenceServer::run() {
+    int lfd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (lfd < 0) throw std::runtime_error("InferenceServer: socket() не удался");
+    sockaddr_un addr = makeAddr(cfg_.socket_path);
+    ::unlink(cfg_.socket_path.c_str());
+    if (::bind(lfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(lfd, 128) < 0) {
+        ::close(lfd);
+        throw std::runtime_error("InferenceServer: не удалось слушать " + cfg_.socket_path);
+    }
+
+    started_ = std::chrono::steady_clock::now();
+    std::thread batcher(&InferenceServer::batcherLoop, this);
+    listening_.store(true);
+
+    while (!stopping_.load()) {
+        reapClients();
+        pollfd pfd{lfd, POLLIN, 0};
+        if (::poll(&pfd, 1, 100) <= 0) continue;
+        int cfd = ::accept(lfd, nullptr, nullptr);
+        if (cfd < 0) continue;
+        std::lock_guard<std::mutex> lk(clients_mu_);
+        Client& c = clients_.emplace_back();
+        c.fd     = cfd;
+        c.thread = std::thread(&InferenceServer::serveClient, this, std::ref(c));
+    }
+
+    listening_.store(false);
+    ::close(lfd);
+    ::unlink(cfg_.socket_path.c_str());
+
+    // Будим клиентов, заблокированных на чтении, и батчер
+    {
+        std::lock_guard<std::mutex> lk(clients_mu_);
+        for (const Client& c : clients_)
+            if (c.fd >= 0) ::shutdown(c.fd, SHUT_RDWR);
+    }
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        queue_cv_.notify_all();
+    }
+    batcher.join();
+    for (auto& c : clients_) c.thread.join();
+    clients_.clear();
+}
+
+void InferenceServer::reapClients() {
+    std::list<Client> finished;
+    {
+        std::lock_guard<std::mutex> lk(clients_mu_);
+        for (auto it = clients_.begin(); it != clients_.end();) {
+            auto cur = it++;
+            if (cur->fd < 0) finished.splice(finished.end(), clients_, cur);
+        }
+    }
+    // Поток уже отпустил clients_mu_ и выходит — join не ждёт работы
+    for (auto& c : finished) c.thread.join();
+}
+
+size_t InferenceServer::clientThreads() const {
+    std::lock_guard<std::mutex> lk(clients_mu_);
+    return clients_.size();
+}
+
+bool InferenceServer::submit(Tensor3D x, std::vector<float>& logits) {
+    auto p = std::make_shared<Pending>();
+    p->x = std::move(x);
+    p->arrived = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lk(mu_);
+    if (stopping_.load()) return false;
+    queue_.push_back(p);
+    queue_cv_.notify_one();
+    done_cv_.wait(lk, [&] { return p->done; });
+    if (p->failed) return false;
+    logits = std::move(p->logits);
+    return true;
+}
+
+void InferenceServer::batcherLoop() {
+    // Арены, входы и логиты батча живут весь цикл и не перевыделяются
+    std::vector<InferenceEngine::Workspace> ws(cfg_.threads > 0 ? cfg_.threads : defaultThreadCount());
+    std::vector<std::shared_ptr<Pending>> batch;
+    std::vector<Tensor3D> xs;
+    std::vector<float> logits;
+    const auto max_wait = std::chrono::microseconds(cfg_.max_wait_us);
+    const size_t max_batch = static_cast<size_t>(cfg_.max_batch);
+
+    std::unique_lock<std::mutex> lk(mu_);
+    while (true) {
+        queue_cv_.wait(lk, [&] { return stopping_.load() || !queue_.empty(); });
+        if (queue_.empty()) {
+            if (stopping_.load()) break;
+            continue;
+        }
+        // Ждём добора батча, но не дольше дедлайна самого старого запроса
+        auto deadline = queue_.front()->arrived + max_wait;
+        queue_cv_.wait_until(lk, deadline, [&] {
+            return stopping_.load() || queue_.size() >= max_batch;
+        });
+
+        size_t n = std::min(queue_.size(), max_batch);
+        batch.assign(queue_.begin(), queue_.begin() + n);
+        queue_.erase(queue_.begin(), queue_.begin() + n);
+        lk.unlock();
+
+        const size_t C = static_cast<size_t>(engine_.numClasses());
+        xs.resize(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) xs[i] = std::move(batch[i]->x);
+        logits.resize(batch.size() * C);
+        bool failed = false;
+        try { engine_.forwardBatch(xs.data(), xs.size(), logits.data(), ws); }
+        catch (const std::exception&) { failed = true; }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            Pending& p = *batch[i];
+            p.failed = failed;
+            if (!failed) p.logits.assign(logits.begin() + i * C, logits.begin() + (i + 1) * C);
+        }
+        recordBatch(batch);
+
+        lk.lock();
+        for (auto& p : batch) p->done = true;
+        done_cv_.notify_all();
+        batch.clear();
+    }
+}
+
+void InferenceServer::recordBatch(const std::vector<std::shared_ptr<Pending>>& batch) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lk(stats_mu_);
+    ++batches_;
+    for (const auto& p : batch) {
+        double us = std::chrono::duration<double, std::micro>(now - p->arrived).count();
+        if (latencies_us_.size() < kLatencyWindow) latencies_us_.push_back(us);
+        else latencies_us_[lat_next_] = us;
+        lat_next_ = (lat_next_ + 1) % kLatencyWindow;
+        ++requests_;
+    }
+}
+
+ServerStats InferenceServer::stats() const {
+    ServerStats s;
+    std::vector<double> lat;
+    {
+        std::lock_guard<std::mutex> lk(stats_mu_);
+        s.requests = requests_;
+        s.batches  = batches_;
+        lat = latencies_us_;
+    }
+    if (!lat.empty()) {
+        auto pct = [&](double q) {
+            size_t k = std::min(lat.size() - 1, static_cast<size_t>(q * lat.size()));
+            std::nth_element(lat.begin(), lat.begin() + k, lat.end());
+            return lat[k];
+        };
+        s.p50_us = pct(0.50);
+        s.p99_us = pct(0.99);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+    if (elapsed > 0.0) s.throughput = s.requests / elapsed;
+    if (s.batches > 0)  s.mean_batch = double(s.requests) / s.batches;
+    return s;
+}
+
+void InferenceServer::serveClient(Client& c) {
+    const int fd = c.fd;
+    RequestHeader h;
+    std::vector<uint8_t> bytes;
+    std::vector<float>   floats, logits;
+
+    while (readAll(fd, &h, sizeof(h))) {
+        if (h.magic != kMagic) {
+            reply(fd, BAD_REQUEST);
+            break;
+        }
+        if (h.kind == STATS) {
+            ServerStats s = stats();
+            if (!reply(fd, OK, {float(s.requests), float(s.batches),
+                                float(s.p50_us), float(s.p99_us),
+                                float(s.throughput), float(s.mean_batch)}))
+                break;
+            continue;
+        }
+
+        Tensor3D x;
+        if (h.kind == GRID) {
+            uint64_t n = uint64_t(h.dims[0]) * h.dims[1] * h.dims[2];
+            if (n == 0 || n > kMaxGridVoxels) { reply(fd, BAD_REQUEST); break; }
+            bytes.resize(n);
+            if (!readAll(fd, bytes.data(), n)) break;
+            x = Tensor3D(h.dims[0], h.dims[1], h.dims[2], 1);
+            float* xd = x.data();
+            for (size_t i = 0; i < n; ++i) xd[i] = bytes[i] ? 1.0f : 0.0f;
+        } else if (h.kind == POINTS) {
+            uint32_t count = h.dims[0];
+            if (count > kMaxPoints) { reply(fd, BAD_REQUEST); break; }
+            floats.resize(size_t(count) * 3);
+            if (!readAll(fd, floats.data(), floats.size() * sizeof(float))) break;
+            x = Tensor3D(cfg_.grid, cfg_.grid, cfg_.grid, 1);
+            rasterizePoints(floats.data(), count, x);
+        } else {
+            reply(fd, BAD_REQUEST);
+            break;
+        }
+
+        bool ok = submit(std::move(x), logits);
+        if (!reply(fd, ok ? OK : FAILED, ok ? logits : std::vector<float>{}))
+            break;
+    }
+
+    std::lock_guard<std::mutex> lk(clients_mu_);
+    ::close(fd);
+    c.fd = -1;
+}
+
+// ---------------- InferenceClient ----------------
+
+InferenceClient::InferenceClient(const std::string& socket_path) {
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0) throw std::runtime_error("InferenceClient: socket() не удался");
+    sockaddr_un addr = makeAddr(socket_path);
+    if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd_);
+        throw std::runtime_error("InferenceClient: не удалось подключиться к " + socket_path);
+    }
+}
+
+InferenceClient::~InferenceClient() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+std::vector<float> InferenceClient::call(const RequestHeader& hdr,
+                                         const void* payload, size_t bytes) {
+    if (!writeAll(fd_, &hdr, sizeof(hdr)) || !writeAll(fd_, payload, bytes))
+        throw std::runtime_error("InferenceClient: ошибка записи в сокет");
+    ResponseHeader rh;
+    if (!readAll(fd_, &rh, sizeof(rh)))
+        throw std::runtime_error("InferenceClient: соединение закрыто сервером");
+    std::vector<float> values(rh.count);
+    if (!readAll(fd_, values.data(), values.size() * sizeof(float)))
+        throw std::runtime_error("InferenceClient: ответ оборван");
+    if (rh.status != OK)
+        throw std::runtime_error("InferenceClient: сервер вернул ошибку " + std::to_string(rh.status));
+    return values;
+}
+
+std::vector<float> InferenceClient::classifyGrid(const Tensor3D& grid) {
+    if (grid.channels() != 1)
+        throw std::invalid_argument("InferenceClient::classifyGrid: ожидается один канал");
+    std::vector<uint8_t> occ(grid.size());
+    for (int i = 0; i < grid.size(); ++i) occ[i] = grid.data()[i] != 0.0f;
+    RequestHeader h{kMagic, GRID, {uint32_t(grid.depth()), uint32_t(grid.height()), uint32_t(grid.width())}};
+    return call(h, occ.data(), occ.size());
+}
+
+std::vector<float> InferenceClient::classifyPoints(const std::vector<float>& xyz) {
+    RequestHeader h{kMagic, POINTS, {uint32_t(xyz.size() / 3), 0, 0}};
+    return call(h, xyz.data(), (xyz.size() / 3) * 3 * sizeof(float));
+}
+
+ServerStats InferenceClient::stats() {
+    RequestHeader h{kMagic, STATS, {0, 0, 0}};
+    auto v = call(h, nullptr, 0);
+    if (v.size() < 6) throw std::runtime_error("InferenceClient::stats: короткий ответ");
+    ServerStats s;
+    s.requests   = static_cast<uint64_t>(v[0]);
+    s.batches    = static_cast<uint64_t>(v[1]);
+    s.p50_us     = v[2];
+    s.p99_us     = v[3];
+    s.throughput = v[4];
+    s.mean_batch = v[5];
+    return s;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "infer/InferenceEngine.h"
+#include "net/Tensor3D.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Протокол поверх Unix-сокета (все поля little-endian).
+ *
+ * Запрос:  RequestHeader, затем полезная нагрузка:
+ *   GRID   — dims[0]*dims[1]*dims[2] байт занятости (0/1), порядок d,h,w;
+ *   POINTS — dims[0] точек по три float (координаты вокселей),
+ *            растеризуются в сетку ServerConfig::grid³;
+ *   STATS  — без нагрузки.
+ * Ответ:   ResponseHeader, затем count значений float
+ *          (логиты или поля ServerStats по порядку).
+ * Одно соединение может отправлять запросы друг за другом.
+ */
+namespace serve_proto {
+    constexpr uint32_t kMagic = 0x51524750;  // "PGRQ"
+    enum Kind : uint32_t { GRID = 1, POINTS = 2, STATS = 3 };
+    enum Status : uint32_t { OK = 0, BAD_REQUEST = 1, FAILED = 2 };
+
+    struct RequestHeader {
+        uint32_t magic;
+        uint32_t kind;
+        uint32_t dims[3];
+    };
+    struct ResponseHeader {
+        uint32_t status;
+        uint32_t count;
+    };
+}
+
+struct ServerConfig {
+    std::string socket_path;
+    int max_batch   = 32;    // сброс батча при наборе стольких запросов
+    int max_wait_us = 2000;  // ... или когда старейший запрос ждёт дольше
+    int threads     = 0;     // потоки forward (<= 0 — все ядра)
+    int grid        = 32;    // сторона сетки для запросов POINTS
+};
+
+/// Счётчики сервера (латентность — от приёма запроса до готовности логитов)
+struct ServerStats {
+    uint64_t requests   = 0;
+    uint64_t batches    = 0;
+    double   p50_us     = 0.0;
+    double   p99_us     = 0.0;
+    double   throughput = 0.0;  // запросов в секунду с момента старта
+    double   mean_batch = 0.0;
+};
+
+/**
+ * Демон инференса с динамическим батчингом.
+ *
+ * Каждое соединение обслуживается своим потоком, который кладёт запрос
+ * в общую очередь и ждёт результата; потоки отключившихся клиентов
+ * join-ятся в цикле accept, так что их число не копится у долгоживущего
+ * демона. Поток-батчер забирает из очереди
+ * до max_batch запросов, как только их набралось достаточно или истёк
+ * max_wait_us у самого старого, и прогоняет их одним вызовом
+ * InferenceEngine::forwardBatch на cfg.threads потоках; арены Workspace
+ * и буферы батча живут весь срок батчера.
+ */
+class InferenceServer {
+public:
+    InferenceServer(const InferenceEngine& engine, ServerConfig cfg);
+    ~InferenceServer();
+
+    InferenceServer(const InferenceServer&) = delete;
+    InferenceServer& operator=(const InferenceServer&) = delete;
+
+    /// Слушать сокет и обслуживать клиентов до вызова stop()
+    void run();
+
+    /// Запросить остановку (безопасно из обработчика сигнала)
+    void stop() { stopping_.store(true); }
+
+    /// true, когда сокет уже слушает (удобно для тестов)
+    bool listening() const { return listening_.load(); }
+
+    /// Потоков соединений, ещё не прошедших join (удобно для тестов)
+    size_t clientThreads() const;
+
+    ServerStats stats() const;
+
+private:
+    struct Pending {
+        Tensor3D x;
+        std::vector<float> logits;
+        std::chrono::steady_clock::time_point arrived;
+        bool done = false;
+        bool failed = false;
+    };
+
+    const InferenceEngine& engine_;
+    ServerConfig cfg_;
+
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> listening_{false};
+
+    // Очередь запросов к батчеру
+    std::mutex              mu_;
+    std::condition_variable queue_cv_, done_cv_;
+    std::deque<std::shared_ptr<Pending>> queue_;
+
+    // Статистика
+    mutable std::mutex      stats_mu_;
+    std::vector<double>     latencies_us_;   // кольцевой буфер
+    size_t                  lat_next_ = 0;
+    uint64_t                requests_ = 0, batches_ = 0;
+    std::chrono::steady_clock::time_point started_;
+
+    struct Client {
+        int         fd = -1;     // -1 — соединение закрыто, поток завершается
+        std::thread thread;
+    };
+    mutable std::mutex clients_mu_;
+    std::list<Client>  clients_;   // адреса стабильны: поток держит свой Client
+
+    void batcherLoop();
+    void serveClient(Client& c);
+    /// join потоков закрытых соединений
+    void reapClients();
+    bool submit(Tensor3D x, std::vector<float>& logits);
+    void recordBatch(const std::vector<std::shared_ptr<Pending>>& batch);
+};
+
+/**
+ * Клиент протокола serve_proto для одного соединения.
+ */
+class InferenceClient {
+public:
+    explicit InferenceClient(const std::string& socket_path);
+    ~InferenceClient();
+
+    InferenceClient(const InferenceClient&) = delete;
+    InferenceClient& operator=(const InferenceClient&) = delete;
+
+    /// Логиты для сетки занятости (ненулевые значения считаются занятыми)
+    std::vector<float> classifyGrid(const Tensor3D& grid);
+
+    /// Логиты для облака точек в координатах вокселей (xyz упакованы тройками)
+    std::vector<float> classifyPoints(const std::vector<float>& xyz);
+
+    ServerStats stats();
+
+private:
+    int fd_ = -1;
+    std::vector<float> call(const serve_proto::RequestHeader& hdr,
+                            const void* payload, size_t bytes);
+};
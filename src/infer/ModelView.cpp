@@ -0,0 +1,62 @@
+#include "infer/ModelView.h"
+#include "network/Checkpoint.h"
+#include "network/network.h"
+#include <stdexcept>
+
+ModelView ModelView::fromNetwork(const Network& net) {
+    const Conv3D& conv = net.conv1();
+    const BatchNorm3D& bn = net.bn1();
+    const MaxPool3D& pool = net.pool1();
+    const FullyConnected& fc = net.fc();
+    if (bn.channels() != conv.outChannels())
+        throw std::runtime_error("ModelView: число каналов BN не совпадает со свёрткой");
+
+    ModelView m;
+    m.in_ch = conv.inChannels(); m.out_ch = conv.outChannels();
+    m.kD = conv.kernelD(); m.kH = conv.kernelH(); m.kW = conv.kernelW();
+    m.sD = conv.strideD(); m.sH = conv.strideH(); m.sW = conv.strideW();
+    m.conv_same = conv.padding() == Conv3D::Padding::SAME;
+    m.conv_w = conv.weight().data();
+    m.conv_b = conv.bias().data();
+    m.gamma = bn.gamma().data();
+    m.beta  = bn.beta().data();
+    m.eps   = bn.eps();
+    m.pool  = { pool.kernelD(), pool.kernelH(), pool.kernelW(),
+                pool.strideD(), pool.strideH(), pool.strideW(),
+                pool.padding() == MaxPool3D::Padding::SAME };
+    m.fc_in  = fc.inFeatures();
+    m.fc_out = fc.outFeatures();
+    m.fc_w   = fc.weight().data();
+    m.fc_b   = fc.bias().data();
+    return m;
+}
+
+ModelView ModelView::fromCheckpoint(const MappedCheckpoint& ck) {
+    // Геометрия берётся из формы тензоров и config-записей (Network::saveCheckpoint)
+    const ckpt::TensorEntry* cw = ck.find("conv1.weight");
+    const ckpt::TensorEntry* fw = ck.find("fc.weight");
+    if (!cw || cw->ndim != 5 || !fw || fw->ndim != 2)
+        throw std::runtime_error("ModelView: в чекпоинте нет весов conv1/fc ожидаемой формы");
+
+    ModelView m;
+    m.kD = cw->shape[0]; m.kH = cw->shape[1]; m.kW = cw->shape[2];
+    m.in_ch = cw->shape[3]; m.out_ch = cw->shape[4];
+    const int32_t* cc = ck.ints("conv1.config", 4);
+    m.sD = cc[0]; m.sH = cc[1]; m.sW = cc[2];
+    m.conv_same = cc[3] != 0;
+    m.conv_w = ck.floats("conv1.weight", cw->count);
+    m.conv_b = ck.floats("conv1.bias", m.out_ch);
+
+    m.gamma = ck.floats("bn1.gamma", m.out_ch);
+    m.beta  = ck.floats("bn1.beta",  m.out_ch);
+    m.eps   = *ck.floats("bn1.eps", 1);
+
+    const int32_t* pc = ck.ints("pool1.config", 7);
+    m.pool = { pc[0], pc[1], pc[2], pc[3], pc[4], pc[5], pc[6] != 0 };
+
+    m.fc_out = fw->shape[0];
+    m.fc_in  = fw->shape[1];
+    m.fc_w   = ck.floats("fc.weight", fw->count);
+    m.fc_b   = ck.floats("fc.bias", m.fc_out);
+    return m;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "infer/BnReluPool.h"
+
+class Network;
+class MappedCheckpoint;
+
+/**
+ * Веса и геометрия сети Conv → BN → ReLU → MaxPool → FC без владения
+ * памятью: указатели смотрят либо в слои Network, либо прямо в
+ * отображённый чекпоинт (MappedCheckpoint). Источник должен жить,
+ * пока используется вид.
+ */
+struct ModelView {
+    // Свёртка: веса [kD][kH][kW][in_ch][out_ch]
+    int in_ch, out_ch;
+    int kD, kH, kW, sD, sH, sW;
+    bool conv_same;
+    const float* conv_w;
+    const float* conv_b;
+
+    // BatchNorm (по статистикам образца)
+    const float* gamma;
+    const float* beta;
+    float eps;
+
+    PoolGeometry pool;
+
+    // FC: веса [out][in]
+    int fc_in, fc_out;
+    const float* fc_w;
+    const float* fc_b;
+
+    static ModelView fromNetwork(const Network& net);
+    static ModelView fromCheckpoint(const MappedCheckpoint& ck);
+};
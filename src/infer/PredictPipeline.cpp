@@ -0,0 +1,190 @@
+#include "infer/PredictPipeline.h"
+#include "data/DataLoader.h"
+#include "data/PointCloudIO.h"
+#include "data/VoxelMask.h"
+#include "utils/BoundedQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <dirent.h>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+struct Sample {
+    uint32_t index;
+    Tensor3D x;
+};
+
+struct Scored {
+    std::vector<uint32_t> index;
+    std::vector<float>    logits;  // index.size() × C
+};
+
+bool endsWith(const std::string& s, const std::string& suf) {
+    return s.size() >= suf.size() && s.compare(s.size() - suf.size(), suf.size(), suf) == 0;
+}
+
+} // namespace
+
+namespace predict {
+
+std::vector<std::string> listInputs(const std::string& dir) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) throw std::runtime_error("Не удалось открыть директорию: " + dir);
+    std::vector<std::string> files;
+    while (dirent* e = readdir(d)) {
+        std::string f = e->d_name;
+        if (endsWith(f, ".ply") || endsWith(f, ".bin")) files.push_back(dir + "/" + f);
+    }
+    closedir(d);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+Tensor3D loadSample(const std::string& path, int grid, std::vector<float>& xyz) {
+    // .ply уже в координатах вокселей 32³ (выход вокселизатора)
+    if (endsWith(path, ".ply") && grid == 32) return DataLoader::loadVoxelMask(path);
+
+    Tensor3D x(grid, grid, grid, 1);
+    if (endsWith(path, ".bin")) {
+        readPointCloudBin(path, xyz);
+        rasterizeNormalized(xyz.data(), xyz.size() / 3, x);
+    } else {
+        throw std::runtime_error("predict: .ply поддерживается только для --grid=32: " + path);
+    }
+    return x;
+}
+
+int loadLabel(const std::string& path) {
+    const std::string cls = path.substr(0, path.rfind('.')) + "_cls.txt";
+    if (::access(cls.c_str(), R_OK) != 0) return -1;
+    const std::vector<int> labels = DataLoader::loadLabels(cls);
+    if (labels.empty()) throw std::runtime_error("Пустой файл меток: " + cls);
+    return labels[0];
+}
+
+Summary run(const std::vector<std::string>& files, const std::string& output,
+            int classes, const ForwardFn& forward, const PipelineConfig& cfg) {
+    if (cfg.batch <= 0 || cfg.io_threads <= 0 || cfg.grid <= 0 || cfg.queue <= 0 || classes <= 0)
+        throw std::invalid_argument("predict::run: некорректные параметры конвейера");
+    const int C = classes;
+
+    BoundedQueue<Sample> parsed(static_cast<size_t>(cfg.queue) * cfg.batch);
+    BoundedQueue<Scored> scored(static_cast<size_t>(cfg.queue));
+    std::atomic<size_t>  next_file{0};
+    std::atomic<size_t>  failed{0};
+
+    // Первая ошибка любой стадии; закрытые очереди останавливают остальные
+    std::mutex         err_mu;
+    std::exception_ptr error;
+    std::atomic<bool>  stopped{false};
+    auto fail = [&](std::exception_ptr e) {
+        {
+            std::lock_guard<std::mutex> lk(err_mu);
+            if (!error) error = e;
+        }
+        stopped.store(true);
+        parsed.close();
+        scored.close();
+    };
+
+    // Стадия 1: чтение и вокселизация
+    std::vector<std::thread> readers;
+    std::atomic<int> readers_left{cfg.io_threads};
+    for (int t = 0; t < cfg.io_threads; ++t) {
+        readers.emplace_back([&] {
+            std::vector<float> xyz;
+            for (size_t i; !stopped.load() && (i = next_file.fetch_add(1)) < files.size(); ) {
+                Sample smp;
+                try {
+                    smp = {static_cast<uint32_t>(i), loadSample(files[i], cfg.grid, xyz)};
+                } catch (const std::exception& e) {
+                    std::cerr << "Пропуск " << files[i] << ": " << e.what() << "\n";
+                    ++failed;
+                    continue;
+                }
+                if (!parsed.push(std::move(smp))) break;  // конвейер остановлен
+            }
+            if (--readers_left == 0) parsed.close();
+        });
+    }
+
+    // Стадия 3: запись результатов
+    std::thread writer([&] {
+        try {
+            std::ofstream out(output, cfg.binary ? std::ios::binary : std::ios::out);
+            if (!out) throw std::runtime_error("Не удалось открыть " + output + " для записи");
+            if (cfg.binary) {
+                const uint32_t magic = kMagic, header_classes = static_cast<uint32_t>(C);
+                out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+                out.write(reinterpret_cast<const char*>(&header_classes), sizeof(header_classes));
+            } else {
+                out << "path,pred";
+                for (int c = 0; c < C; ++c) out << ",logit" << c;
+                out << "\n";
+            }
+            Scored s;
+            while (scored.pop(s)) {
+                for (size_t k = 0; k < s.index.size(); ++k) {
+                    const float* lg = &s.logits[k * C];
+                    int32_t pred = static_cast<int32_t>(std::max_element(lg, lg + C) - lg);
+                    if (cfg.binary) {
+                        out.write(reinterpret_cast<const char*>(&s.index[k]), sizeof(uint32_t));
+                        out.write(reinterpret_cast<const char*>(&pred), sizeof(pred));
+                        out.write(reinterpret_cast<const char*>(lg), sizeof(float) * C);
+                    } else {
+                        out << files[s.index[k]] << "," << pred;
+                        for (int c = 0; c < C; ++c) out << "," << lg[c];
+                        out << "\n";
+                    }
+                }
+                if (!out) throw std::runtime_error("Ошибка записи " + output);
+            }
+            out.close();
+            if (!out) throw std::runtime_error("Ошибка записи " + output);
+        } catch (...) {
+            fail(std::current_exception());
+        }
+    });
+
+    // Стадия 2 (в вызывающем потоке): батчи через forward
+    Summary sum;
+    try {
+        std::vector<Tensor3D> batch;
+        Scored s;
+        batch.reserve(cfg.batch);
+        auto flush = [&] {
+            if (batch.empty()) return;
+            s.logits.resize(batch.size() * C);
+            forward(batch.data(), batch.size(), s.logits.data());
+            sum.done += batch.size();
+            scored.push(std::move(s));
+            s = Scored{};
+            batch.clear();
+        };
+        Sample smp;
+        while (!stopped.load() && parsed.pop(smp)) {
+            s.index.push_back(smp.index);
+            batch.push_back(std::move(smp.x));
+            if (static_cast<int>(batch.size()) == cfg.batch) flush();
+        }
+        if (!stopped.load()) flush();
+        scored.close();
+    } catch (...) {
+        fail(std::current_exception());
+    }
+
+    for (auto& th : readers) th.join();
+    writer.join();
+    if (error) std::rethrow_exception(error);
+    sum.failed = failed.load();
+    return sum;
+}
+
+} // namespace predict
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "net/Tensor3D.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Конвейер пакетного офлайн-инференса (predict) из трёх стадий с
+ * ограниченными очередями между ними:
+ *   1) io-потоки читают .ply / .bin и вокселизируют их в сетку grid³;
+ *   2) вызывающий поток собирает батчи и гонит их через forward;
+ *   3) писатель сохраняет предсказания в CSV или бинарный файл PGPR.
+ * Пока идёт forward одного батча, io-потоки уже читают следующие файлы.
+ *
+ * Бинарный формат: uint32 kMagic ("PGPR"), uint32 число классов C, затем
+ * записи { uint32 index; int32 pred; float logits[C] }, где index — номер
+ * файла в списке files. Записи идут в порядке батчей; при одном io-потоке
+ * это порядок files.
+ */
+namespace predict {
+
+constexpr uint32_t kMagic = 0x52504750;  // "PGPR"
+
+struct PipelineConfig {
+    bool binary     = false;
+    int  batch      = 64;
+    int  io_threads = 2;
+    int  grid       = 32;
+    int  queue      = 4;   // глубина очередей, в батчах
+};
+
+struct Summary {
+    size_t done   = 0;   // предсказано образцов
+    size_t failed = 0;   // файлов пропущено из-за ошибок чтения
+};
+
+/// Логиты батча: x[0..n) → logits (n × C, построчно)
+using ForwardFn = std::function<void(const Tensor3D* x, size_t n, float* logits)>;
+
+/// .ply в координатах вокселей (только grid = 32) или .bin в сетку grid³
+Tensor3D loadSample(const std::string& path, int grid, std::vector<float>& xyz);
+
+/// Метка класса образца из <stem>_cls.txt рядом с ним; −1, если файла нет
+int loadLabel(const std::string& path);
+
+/// .ply и .bin из dir, отсортированные по имени
+std::vector<std::string> listInputs(const std::string& dir);
+
+/**
+ * Прогнать files через forward и записать предсказания в output.
+ * Нечитаемый файл пропускается (сообщение в stderr, счётчик failed).
+ * Ошибка записи или forward останавливает все стадии: очереди
+ * закрываются, потоки join-ятся, и исключение бросается наружу.
+ */
+Summary run(const std::vector<std::string>& files, const std::string& output,
+            int classes, const ForwardFn& forward, const PipelineConfig& cfg);
+
+} // namespace predict
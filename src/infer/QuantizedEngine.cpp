@@ -0,0 +1,356 @@
+#include "infer/QuantizedEngine.h"
+#include "infer/InferenceEngine.h"
+#include "network/network.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#if defined(__AVX512VNNI__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr int L = QuantizedEngine::kLanes;
+
+/**
+ * Симметричное int8-квантование матрицы K×outs (get(k, o) — вес) с шкалой
+ * на каждый выход. Раскладка [block][quad][L][4]: четвёрка соседних входов
+ * одного выхода лежит подряд, как их ждёт VPDPBUSD.
+ */
+template <class Get>
+void quantizeWeights(int K, int outs, Get get,
+                     std::vector<int8_t>& packed, std::vector<float>& scale,
+                     std::vector<int32_t>& sum, int& quads, int& blocks) {
+    quads  = (K + 3) / 4;
+    blocks = (outs + L - 1) / L;
+    packed.assign(static_cast<size_t>(blocks) * quads * L * 4, 0);
+    scale.assign(static_cast<size_t>(blocks) * L, 0.0f);
+    sum.assign(static_cast<size_t>(blocks) * L, 0);
+    for (int o = 0; o < outs; ++o) {
+        float m = 0.0f;
+        for (int k = 0; k < K; ++k) m = std::max(m, std::fabs(get(k, o)));
+        const float s = m > 0.0f ? m / 127.0f : 1.0f;
+        scale[o] = s;
+        const int b = o / L, l = o % L;
+        for (int k = 0; k < K; ++k) {
+            int q = static_cast<int>(std::lrint(get(k, o) / s));
+            q = std::min(127, std::max(-127, q));
+            packed[((static_cast<size_t>(b) * quads + k / 4) * L + l) * 4 + (k & 3)] = static_cast<int8_t>(q);
+            sum[o] += q;
+        }
+    }
+}
+
+/// Округление половин вверх вместо lrint — цикл векторизуется
+inline uint8_t quantizeU8(float v, float inv_scale, float zero) {
+    float q = std::min(255.0f, std::max(0.0f, v * inv_scale + zero));
+    return static_cast<uint8_t>(static_cast<int>(q + 0.5f));
+}
+
+/// acc[0..L) = Σ_q Σ_j x[4q+j] · w[q][l][j]; нулевые четвёрки входа пропускаются
+inline void dotU8S8(const uint8_t* x, const int8_t* w, int quads, int32_t* acc) {
+#if defined(__AVX512VNNI__)
+    __m512i a = _mm512_setzero_si512();
+    for (int q = 0; q < quads; ++q) {
+        uint32_t xq;
+        std::memcpy(&xq, x + 4 * q, sizeof(xq));
+        if (xq == 0) continue;
+        a = _mm512_dpbusd_epi32(a, _mm512_set1_epi32(static_cast<int>(xq)),
+                                _mm512_loadu_si512(w + static_cast<size_t>(q) * L * 4));
+    }
+    _mm512_storeu_si512(acc, a);
+#else
+    for (int l = 0; l < L; ++l) acc[l] = 0;
+    for (int q = 0; q < quads; ++q) {
+        const uint8_t* xq = x + 4 * q;
+        if ((xq[0] | xq[1] | xq[2] | xq[3]) == 0) continue;
+        const int8_t* wq = w + static_cast<size_t>(q) * L * 4;
+        for (int l = 0; l < L; ++l)
+            acc[l] += xq[0] * wq[4 * l]     + xq[1] * wq[4 * l + 1]
+                    + xq[2] * wq[4 * l + 2] + xq[3] * wq[4 * l + 3];
+    }
+#endif
+}
+
+/// Σ x[i]·w[i] по n байт (n кратно 64) — строка FC без паддинга выходов
+inline int32_t dotRowU8S8(const uint8_t* x, const int8_t* w, int n) {
+#if defined(__AVX512VNNI__)
+    __m512i a = _mm512_setzero_si512();
+    for (int i = 0; i < n; i += 64)
+        a = _mm512_dpbusd_epi32(a, _mm512_loadu_si512(x + i), _mm512_loadu_si512(w + i));
+    alignas(64) int32_t lanes[16];
+    _mm512_store_si512(lanes, a);
+    int32_t sum = 0;
+    for (int l = 0; l < 16; ++l) sum += lanes[l];
+    return sum;
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < n; ++i) sum += x[i] * w[i];
+    return sum;
+#endif
+}
+
+} // namespace
+
+const char* QuantizedEngine::kernelName() {
+#if defined(__AVX512VNNI__)
+    return "avx512-vnni";
+#else
+    return "portable";
+#endif
+}
+
+QuantizedEngine::Calibration QuantizedEngine::calibrate(Network& net, const Tensor3D* xs, size_t n) {
+    if (n == 0) throw std::invalid_argument("QuantizedEngine::calibrate: пустая калибровочная выборка");
+    Calibration c;
+    const size_t fc_in = static_cast<size_t>(net.fc().inFeatures());
+    for (size_t i = 0; i < n; ++i) {
+        net.forward(xs[i], /*training=*/false);
+        const float* x = xs[i].data();
+        for (int j = 0; j < xs[i].size(); ++j) {
+            c.input_min = std::min(c.input_min, x[j]);
+            c.input_max = std::max(c.input_max, x[j]);
+        }
+        const auto& f = net.fc().lastInput();
+        for (size_t j = 0; j < std::min(fc_in, f.size()); ++j)
+            c.fc_max = std::max(c.fc_max, f[j]);
+    }
+    c.samples = n;
+    return c;
+}
+
+QuantizedEngine::QuantizedEngine(const Network& net, const Calibration& calib) {
+    if (calib.samples == 0)
+        throw std::invalid_argument("QuantizedEngine: нужна калибровка (calibrate)");
+
+    const Conv3D& conv = net.conv1();
+    in_ch_  = conv.inChannels();
+    out_ch_ = conv.outChannels();
+    kD_ = conv.kernelD(); kH_ = conv.kernelH(); kW_ = conv.kernelW();
+    sD_ = conv.strideD(); sH_ = conv.strideH(); sW_ = conv.strideW();
+    conv_same_ = conv.padding() == Conv3D::Padding::SAME;
+
+    // Вход: асимметричный uint8, диапазон обязательно содержит 0 (паддинг)
+    const float lo = std::min(0.0f, calib.input_min), hi = std::max(0.0f, calib.input_max);
+    in_scale_ = hi > lo ? (hi - lo) / 255.0f : 1.0f;
+    in_zero_  = static_cast<uint8_t>(std::min(255L, std::max(0L, std::lrint(-lo / in_scale_))));
+
+    const int taps = kD_ * kH_ * kW_ * in_ch_;
+    const auto& w = conv.weight();
+    std::vector<int32_t> wsum;
+    quantizeWeights(taps, out_ch_, [&](int k, int o) { return w[static_cast<size_t>(k) * out_ch_ + o]; },
+                    conv_w_, conv_scale_, wsum, conv_quads_, oc_blocks_);
+    conv_zsum_.resize(wsum.size());
+    for (size_t o = 0; o < wsum.size(); ++o) {
+        conv_scale_[o] *= in_scale_;
+        conv_zsum_[o]   = in_zero_ * wsum[o];
+    }
+    conv_b_.assign(static_cast<size_t>(oc_blocks_) * L, 0.0f);
+    std::copy(conv.bias().begin(), conv.bias().end(), conv_b_.begin());
+
+    const BatchNorm3D& bn = net.bn1();
+    if (bn.channels() != out_ch_)
+        throw std::runtime_error("QuantizedEngine: число каналов BN не совпадает со свёрткой");
+    gamma_.assign(bn.gamma().begin(), bn.gamma().end());
+    beta_.assign(bn.beta().begin(), bn.beta().end());
+    eps_ = bn.eps();
+
+    const MaxPool3D& pool = net.pool1();
+    pool_ = { pool.kernelD(), pool.kernelH(), pool.kernelW(),
+              pool.strideD(), pool.strideH(), pool.strideW(),
+              pool.padding() == MaxPool3D::Padding::SAME };
+
+    // FC: вход после ReLU неотрицателен — uint8 без нулевой точки
+    const FullyConnected& fc = net.fc();
+    fc_in_  = fc.inFeatures();
+    fc_out_ = fc.outFeatures();
+    fc_in_scale_ = calib.fc_max > 0.0f ? calib.fc_max / 255.0f : 1.0f;
+    fc_in_pad_ = (fc_in_ + 63) / 64 * 64;
+    fc_w_.assign(static_cast<size_t>(fc_out_) * fc_in_pad_, 0);
+    fc_scale_.assign(fc_out_, 0.0f);
+    const auto& fw = fc.weight();
+    for (int o = 0; o < fc_out_; ++o) {
+        const float* row = &fw[static_cast<size_t>(o) * fc_in_];
+        float m = 0.0f;
+        for (int i = 0; i < fc_in_; ++i) m = std::max(m, std::fabs(row[i]));
+        const float s = m > 0.0f ? m / 127.0f : 1.0f;
+        for (int i = 0; i < fc_in_; ++i)
+            fc_w_[static_cast<size_t>(o) * fc_in_pad_ + i] =
+                static_cast<int8_t>(std::min(127L, std::max(-127L, std::lrint(row[i] / s))));
+        fc_scale_[o] = fc_in_scale_ * s;
+    }
+    fc_b_.assign(fc.bias().begin(), fc.bias().end());
+}
+
+size_t QuantizedEngine::weightBytes() const {
+    return conv_w_.size() + fc_w_.size()
+         + sizeof(float) * (conv_scale_.size() + conv_b_.size() + fc_scale_.size() + fc_b_.size()
+                            + gamma_.size() + beta_.size())
+         + sizeof(int32_t) * conv_zsum_.size();
+}
+
+void QuantizedEngine::forward(const Tensor3D& x, Workspace& ws, float* logits) const {
+    if (x.channels() != in_ch_)
+        throw std::invalid_argument("QuantizedEngine::forward: неверное число входных каналов");
+    const int D = x.depth(), H = x.height(), W = x.width();
+
+    // 0) Квантуем вход целиком: каждый воксель читают до kD*kH*kW окон
+    const float inv_in = 1.0f / in_scale_;
+    ws.input.resize(static_cast<size_t>(x.size()));
+    for (int i = 0; i < x.size(); ++i) ws.input[i] = quantizeU8(x.data()[i], inv_in, static_cast<float>(in_zero_));
+
+    // 1) Свёртка uint8×int8 → int32, блоками по L выходных каналов
+    auto outDim = [](int size, int k, int s, bool same) {
+        return same ? (size + s - 1) / s : (size - k + s) / s;
+    };
+    const int Do = outDim(D, kD_, sD_, conv_same_);
+    const int Ho = outDim(H, kH_, sH_, conv_same_);
+    const int Wo = outDim(W, kW_, sW_, conv_same_);
+    const int oD = conv_same_ ? kD_ / 2 : 0;
+    const int oH = conv_same_ ? kH_ / 2 : 0;
+    const int oW = conv_same_ ? kW_ / 2 : 0;
+    const int Cp = oc_blocks_ * L;
+    const size_t N = static_cast<size_t>(Do) * Ho * Wo;
+    ws.conv.resize(N * Cp);
+    ws.patch.assign(std::max(static_cast<size_t>(conv_quads_) * 4, static_cast<size_t>(fc_in_pad_)), 0);
+
+    alignas(64) int32_t acc[L];
+    for (int od = 0; od < Do; ++od)
+    for (int oh = 0; oh < Ho; ++oh)
+    for (int ow = 0; ow < Wo; ++ow) {
+        // Окно; за границей — нулевая точка (вещественный 0).
+        // Соседние kw лежат во входе подряд — строка окна копируется целиком.
+        uint8_t* p = ws.patch.data();
+        const int iw0 = ow * sW_ - oW;
+        const int row = kW_ * in_ch_;
+        const bool w_inside = iw0 >= 0 && iw0 + kW_ <= W;
+        for (int kd = 0; kd < kD_; ++kd) {
+            int id = od * sD_ + kd - oD;
+            for (int kh = 0; kh < kH_; ++kh, p += row) {
+                int ih = oh * sH_ + kh - oH;
+                if (id < 0 || id >= D || ih < 0 || ih >= H) {
+                    for (int j = 0; j < row; ++j) p[j] = in_zero_;
+                    continue;
+                }
+                const uint8_t* src = &ws.input[(static_cast<size_t>(id) * H + ih) * W * in_ch_];
+                if (w_inside) {
+                    for (int j = 0; j < row; ++j) p[j] = src[iw0 * in_ch_ + j];
+                    continue;
+                }
+                for (int kw = 0; kw < kW_; ++kw) {
+                    int iw = iw0 + kw;
+                    for (int ic = 0; ic < in_ch_; ++ic)
+                        p[kw * in_ch_ + ic] = (iw < 0 || iw >= W) ? in_zero_ : src[iw * in_ch_ + ic];
+                }
+            }
+        }
+
+        float* out = &ws.conv[((static_cast<size_t>(od) * Ho + oh) * Wo + ow) * Cp];
+        for (int b = 0; b < oc_blocks_; ++b) {
+            dotU8S8(ws.patch.data(), &conv_w_[static_cast<size_t>(b) * conv_quads_ * L * 4], conv_quads_, acc);
+            for (int l = 0; l < L; ++l) {
+                const int c = b * L + l;
+                out[c] = conv_scale_[c] * static_cast<float>(acc[l] - conv_zsum_[c]) + conv_b_[c];
+            }
+        }
+    }
+
+    // 2) BN по статистикам образца + ReLU + MaxPool во float
+    bnReluMaxPool(ws.conv.data(), Do, Ho, Wo, Cp, out_ch_,
+                  gamma_.data(), beta_.data(), eps_, pool_, ws.pooled);
+    if (ws.pooled.size() < static_cast<size_t>(fc_in_))
+        throw std::invalid_argument("QuantizedEngine::forward: вход слишком мал для FC-слоя");
+
+    // 3) FC uint8×int8 → int32, по строке весов на выход
+    const float inv_fc = 1.0f / fc_in_scale_;
+    std::fill(ws.patch.begin(), ws.patch.end(), uint8_t(0));
+    for (int i = 0; i < fc_in_; ++i) ws.patch[i] = quantizeU8(ws.pooled[i], inv_fc, 0.0f);
+    for (int o = 0; o < fc_out_; ++o) {
+        int32_t dot = dotRowU8S8(ws.patch.data(), &fc_w_[static_cast<size_t>(o) * fc_in_pad_], fc_in_pad_);
+        logits[o] = fc_scale_[o] * static_cast<float>(dot) + fc_b_[o];
+    }
+}
+
+std::vector<float> QuantizedEngine::forward(const Tensor3D& x) const {
+    static thread_local Workspace ws;
+    std::vector<float> logits(fc_out_);
+    forward(x, ws, logits.data());
+    return logits;
+}
+
+int QuantizedEngine::classify(const Tensor3D& x) const {
+    auto logits = forward(x);
+    return static_cast<int>(std::max_element(logits.begin(), logits.end()) - logits.begin());
+}
+
+void QuantizedEngine::forwardBatch(const Tensor3D* xs, size_t n, float* logits,
+                                   int num_threads) const {
+    parallelFor(n, num_threads, [&](size_t b, size_t e, int) {
+        Workspace ws;
+        for (size_t i = b; i < e; ++i)
+            forward(xs[i], ws, logits + i * fc_out_);
+    });
+}
+
+std::vector<float> QuantizedEngine::forwardBatch(const std::vector<Tensor3D>& xs,
+                                                 int num_threads) const {
+    std::vector<float> logits(xs.size() * fc_out_);
+    forwardBatch(xs.data(), xs.size(), logits.data(), num_threads);
+    return logits;
+}
+
+// ---------- Отчёт INT8 против FP32 ----------
+
+QuantizationReport compareQuantized(const InferenceEngine& fp32, const QuantizedEngine& int8,
+                                    const Tensor3D* xs, size_t n,
+                                    const int* labels, int num_threads) {
+    if (fp32.numClasses() != int8.numClasses())
+        throw std::invalid_argument("compareQuantized: движки с разным числом классов");
+    const int C = fp32.numClasses();
+    std::vector<float> a(n * C), b(n * C);
+    fp32.forwardBatch(xs, n, a.data(), num_threads);
+    int8.forwardBatch(xs, n, b.data(), num_threads);
+
+    QuantizationReport r;
+    r.samples = n;
+    if (n == 0) return r;
+    size_t agree = 0, ok32 = 0, ok8 = 0;
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const float* la = &a[i * C];
+        const float* lb = &b[i * C];
+        for (int c = 0; c < C; ++c) {
+            double d = std::fabs(la[c] - lb[c]);
+            sum += d;
+            r.max_abs_diff = std::max(r.max_abs_diff, d);
+        }
+        int pa = static_cast<int>(std::max_element(la, la + C) - la);
+        int pb = static_cast<int>(std::max_element(lb, lb + C) - lb);
+        agree += pa == pb;
+        if (labels) {
+            ok32 += pa == labels[i];
+            ok8  += pb == labels[i];
+        }
+    }
+    r.agreement     = static_cast<double>(agree) / n;
+    r.mean_abs_diff = sum / (static_cast<double>(n) * C);
+    if (labels) {
+        r.fp32_accuracy = static_cast<double>(ok32) / n;
+        r.int8_accuracy = static_cast<double>(ok8) / n;
+    }
+    return r;
+}
+
+std::string QuantizationReport::toString() const {
+    std::ostringstream os;
+    os << "INT8 против FP32 на " << samples << " образцах: совпадение top-1 "
+       << agreement * 100 << "%, |Δлогит| среднее " << mean_abs_diff
+       << ", максимум " << max_abs_diff;
+    if (fp32_accuracy >= 0)
+        os << "; точность FP32 " << fp32_accuracy * 100 << "%, INT8 " << int8_accuracy * 100
+           << "% (Δ " << (int8_accuracy - fp32_accuracy) * 100 << " п.п.)";
+    return os.str();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "infer/BnReluPool.h"
+#include "net/Tensor3D.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Network;
+class InferenceEngine;
+
+/**
+ * INT8-движок инференса (post-training quantization) той же сети, что
+ * InferenceEngine: Conv → BN → ReLU → MaxPool → FC.
+ *
+ * Веса Conv3D и FullyConnected квантуются симметрично в int8 с отдельной
+ * шкалой на каждый выходной канал. Активации на входе свёртки и FC —
+ * uint8 с шкалой (и нулевой точкой для входа), найденной калибровкой:
+ * образцы прогоняются через Network::forward(x, false) и запоминаются
+ * диапазоны. Свёртка и FC считаются как uint8×int8 → int32 (VPDPBUSD при
+ * AVX512-VNNI, иначе переносимый скалярный код), BN/ReLU/MaxPool — во float.
+ *
+ * Как и InferenceEngine, после конструирования объект не меняется и может
+ * использоваться из любого числа потоков со своими Workspace.
+ */
+class QuantizedEngine {
+public:
+    /// Выходные каналы свёртки обрабатываются блоками по 16 (один zmm из int32)
+    static constexpr int kLanes = 16;
+
+    /// Диапазоны активаций, собранные на калибровочной выборке
+    struct Calibration {
+        float  input_min = 0.0f, input_max = 0.0f;  // вход свёртки
+        float  fc_max    = 0.0f;                    // вход FC (после ReLU, >= 0)
+        size_t samples   = 0;
+    };
+
+    /// Прогнать xs[0..n) через net.forward(x, false) и собрать диапазоны
+    static Calibration calibrate(Network& net, const Tensor3D* xs, size_t n);
+
+    struct Workspace {
+        std::vector<uint8_t> input;   // квантованный вход
+        std::vector<uint8_t> patch;   // окно свёртки / вход FC, uint8
+        std::vector<float>   conv;    // выход свёртки, D×H×W×(блоки каналов)
+        std::vector<float>   pooled;  // признаки после BN+ReLU+MaxPool
+    };
+
+    QuantizedEngine(const Network& net, const Calibration& calib);
+
+    void forward(const Tensor3D& x, Workspace& ws, float* logits) const;
+    std::vector<float> forward(const Tensor3D& x) const;
+    int classify(const Tensor3D& x) const;
+
+    void forwardBatch(const Tensor3D* xs, size_t n, float* logits,
+                      int num_threads = 0) const;
+    std::vector<float> forwardBatch(const std::vector<Tensor3D>& xs,
+                                    int num_threads = 0) const;
+
+    int numClasses()    const { return fc_out_; }
+    int inputChannels() const { return in_ch_; }
+
+    /// Объём весов (int8) и шкал в байтах
+    size_t weightBytes() const;
+
+    /// Имя используемого int8-ядра ("avx512-vnni" или "portable")
+    static const char* kernelName();
+
+private:
+    // Свёртка
+    int in_ch_, out_ch_, oc_blocks_;
+    int kD_, kH_, kW_, sD_, sH_, sW_;
+    bool conv_same_;
+    int conv_quads_;                 // ceil(taps / 4)
+    float in_scale_;
+    uint8_t in_zero_;
+    std::vector<int8_t>  conv_w_;    // [oc_block][quad][kLanes][4]
+    std::vector<float>   conv_scale_;  // in_scale_ * w_scale[oc], [oc_blocks_*kLanes]
+    std::vector<int32_t> conv_zsum_;   // in_zero_ * Σw[oc]
+    std::vector<float>   conv_b_;
+
+    // BN + пулинг
+    std::vector<float> gamma_, beta_;
+    float eps_;
+    PoolGeometry pool_;
+
+    // FC
+    int fc_in_, fc_out_, fc_in_pad_;   // fc_in_pad_ кратен 64
+    float fc_in_scale_;
+    std::vector<int8_t> fc_w_;       // [fc_out_][fc_in_pad_], без паддинга выходов
+    std::vector<float>  fc_scale_;   // fc_in_scale_ * w_scale[o]
+    std::vector<float>  fc_b_;
+};
+
+/// Сравнение INT8 с FP32 на наборе образцов
+struct QuantizationReport {
+    size_t samples        = 0;
+    double agreement      = 0;   // доля совпавших top-1
+    double mean_abs_diff  = 0;   // средняя |Δ логита|
+    double max_abs_diff   = 0;
+    double fp32_accuracy  = -1;  // при наличии меток, иначе -1
+    double int8_accuracy  = -1;
+
+    std::string toString() const;
+};
+
+QuantizationReport compareQuantized(const InferenceEngine& fp32, const QuantizedEngine& int8,
+                                    const Tensor3D* xs, size_t n,
+                                    const int* labels = nullptr, int num_threads = 0);
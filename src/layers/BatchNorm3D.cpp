@@ -49,14 +49,7 @@ Tensor3D BatchNorm3D::forward(const Tensor3D& x, bool training) {
     }
 
     // 3) Обновляем running-статистики, если training
-    if(training) {
-        for(int c=0; c<C_; ++c) {
-            running_mean_[c] = momentum_*batch_mean_[c]
-                             + (1-momentum_)*running_mean_[c];
-            running_var_[c]  = momentum_*batch_var_[c]
-                             + (1-momentum_)*running_var_[c];
-        }
-    }
+    updateStats(training);
 
     // 4) Нормализация и scale+shift
     for(int i=0; i<N_; ++i) {
@@ -73,6 +66,17 @@ Tensor3D BatchNorm3D::forward(const Tensor3D& x, bool training) {
     return y;
 }
 
+void BatchNorm3D::updateStats(bool training) {
+    if(training) {
+        for(int c=0; c<C_; ++c) {
+            running_mean_[c] = momentum_*batch_mean_[c]
+                             + (1-momentum_)*running_mean_[c];
+            running_var_[c]  = momentum_*batch_var_[c]
+                             + (1-momentum_)*running_var_[c];
+        }
+    }
+}
+
 // backward
 Tensor3D BatchNorm3D::backward(const Tensor3D& grad_y) {
     // Проверяем, что forward был вызван
@@ -84,11 +88,9 @@ Tensor3D BatchNorm3D::backward(const Tensor3D& grad_y) {
     const float* dy = grad_y.data();
     float* dx = grad_x.data();
 
-    // Сбрасываем градиенты по γ/β
-    std::fill(grad_gamma_.begin(), grad_gamma_.end(), 0.0f);
-    std::fill(grad_beta_.begin(),  grad_beta_.end(),  0.0f);
-
-    // 1) grad_beta и grad_gamma
+    // 1) grad_beta и grad_gamma этого образца; в параметры — накопление,
+    //    как в Conv3D/FullyConnected (сброс — в zeroGrad)
+    std::vector<float> gb_local(C_), gg_local(C_);
     for(int c=0; c<C_; ++c){
         float gb=0, gg=0;
         for(int i=0; i<N_; ++i){
@@ -96,14 +98,16 @@ Tensor3D BatchNorm3D::backward(const Tensor3D& grad_y) {
             gb += dy[idx];
             gg += dy[idx] * x_hat_[idx];
         }
-        grad_beta_[c]  = gb;
-        grad_gamma_[c] = gg;
+        gb_local[c] = gb;
+        gg_local[c] = gg;
+        grad_beta_[c]  += gb;
+        grad_gamma_[c] += gg;
     }
 
     // 2) grad_x по формуле
     for(int c=0; c<C_; ++c){
-        float g  = grad_gamma_[c];
-        float b  = grad_beta_[c];
+        float g  = gg_local[c];
+        float b  = gb_local[c];
         float is = inv_std_[c];
         float scale = gamma_[c] * is / N_;
         for(int i=0; i<N_; ++i){
@@ -128,3 +132,84 @@ void BatchNorm3D::zeroGrad() {
     x_hat_.clear();
     D_ = H_ = W_ = N_ = 0;
 }
+
+// ---------- Смешанная точность (bf16) ----------
+// Та же арифметика, что в fp32-пути; bf16 только в хранении тензоров.
+
+void BatchNorm3D::forward(const Tensor3DBF16& x, bool training, Tensor3DBF16& y) {
+    assert(x.channels() == C_);
+    D_ = x.depth(); H_ = x.height(); W_ = x.width();
+    N_ = D_ * H_ * W_;
+    y.resize(D_, H_, W_, C_);
+
+    batch_mean_.assign(C_, 0.0f);
+    batch_var_.assign(C_,  0.0f);
+    inv_std_.assign(C_,    0.0f);
+    x_hat_.clear();
+    row_.resize(C_);
+
+    const uint16_t* xdata = x.data();
+    for(int i=0; i<N_; ++i) {
+        bf16::toFloat(xdata + static_cast<size_t>(i)*C_, row_.data(), C_);
+        for(int c=0; c<C_; ++c) batch_mean_[c] += row_[c];
+    }
+    for(int c=0; c<C_; ++c) batch_mean_[c] /= N_;
+    for(int i=0; i<N_; ++i) {
+        bf16::toFloat(xdata + static_cast<size_t>(i)*C_, row_.data(), C_);
+        for(int c=0; c<C_; ++c) {
+            float v = row_[c] - batch_mean_[c];
+            batch_var_[c] += v * v;
+        }
+    }
+    for(int c=0; c<C_; ++c) {
+        batch_var_[c] /= N_;
+        inv_std_[c] = 1.0f / std::sqrt(batch_var_[c] + eps_);
+    }
+    updateStats(training);
+
+    uint16_t* ydata = y.data();
+    for(int i=0; i<N_; ++i) {
+        bf16::toFloat(xdata + static_cast<size_t>(i)*C_, row_.data(), C_);
+        for(int c=0; c<C_; ++c)
+            row_[c] = gamma_[c] * ((row_[c] - batch_mean_[c]) * inv_std_[c]) + beta_[c];
+        bf16::fromFloat(row_.data(), ydata + static_cast<size_t>(i)*C_, C_);
+    }
+}
+
+void BatchNorm3D::backward(const Tensor3DBF16& x, const Tensor3DBF16& grad_y, Tensor3DBF16& grad_x) {
+    assert(D_>0 && N_>0 && static_cast<int>(inv_std_.size()) == C_);
+    assert(grad_y.depth()==D_ && grad_y.height()==H_
+        && grad_y.width()==W_ && grad_y.channels()==C_);
+    grad_x.resize(D_, H_, W_, C_);
+    row_.resize(C_);
+    row2_.resize(C_);
+
+    const uint16_t* xdata = x.data();
+    const uint16_t* dy    = grad_y.data();
+    std::vector<float> gb_local(C_, 0.0f), gg_local(C_, 0.0f);
+    for(int i=0; i<N_; ++i) {
+        bf16::toFloat(xdata + static_cast<size_t>(i)*C_, row_.data(), C_);
+        bf16::toFloat(dy    + static_cast<size_t>(i)*C_, row2_.data(), C_);
+        for(int c=0; c<C_; ++c) {
+            float xh = (row_[c] - batch_mean_[c]) * inv_std_[c];
+            gb_local[c] += row2_[c];
+            gg_local[c] += row2_[c] * xh;
+        }
+    }
+    for(int c=0; c<C_; ++c) {
+        grad_beta_[c]  += gb_local[c];
+        grad_gamma_[c] += gg_local[c];
+    }
+
+    uint16_t* dx = grad_x.data();
+    for(int i=0; i<N_; ++i) {
+        bf16::toFloat(xdata + static_cast<size_t>(i)*C_, row_.data(), C_);
+        bf16::toFloat(dy    + static_cast<size_t>(i)*C_, row2_.data(), C_);
+        for(int c=0; c<C_; ++c) {
+            float xh    = (row_[c] - batch_mean_[c]) * inv_std_[c];
+            float scale = gamma_[c] * inv_std_[c] / N_;
+            row_[c] = scale * (N_*row2_[c] - gb_local[c] - xh * gg_local[c]);
+        }
+        bf16::fromFloat(row_.data(), dx + static_cast<size_t>(i)*C_, C_);
+    }
+}
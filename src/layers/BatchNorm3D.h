@@ -1,6 +1,8 @@
 #pragma once
 
 #include "net/Tensor3D.h"
+#include "net/Tensor3DBF16.h"
+#include "net/ParamBuffer.h"
 #include <vector>
 #include <cassert>
 
@@ -15,31 +17,44 @@ public:
     Tensor3D backward(const Tensor3D& grad_y);
     void zeroGrad();
 
+    // Смешанная точность: x, y и градиенты в bf16, статистики и параметры во float.
+    // x_hat не хранится — backward пересчитывает его из x и статистик батча.
+    void forward(const Tensor3DBF16& x, bool training, Tensor3DBF16& y);
+    void backward(const Tensor3DBF16& x, const Tensor3DBF16& grad_y, Tensor3DBF16& grad_x);
+
     // НЕКОНСТАНТНЫЕ геттеры для оптимизатора
-    std::vector<float>& gamma()      { return gamma_; }
-    std::vector<float>& beta()       { return beta_; }
-    std::vector<float>& grad_gamma() { return grad_gamma_; }
-    std::vector<float>& grad_beta()  { return grad_beta_; }
+    ParamBuffer& gamma()      { return gamma_; }
+    ParamBuffer& beta()       { return beta_; }
+    ParamBuffer& grad_gamma() { return grad_gamma_; }
+    ParamBuffer& grad_beta()  { return grad_beta_; }
 
     // Константные геттеры
-    const std::vector<float>& gamma()      const { return gamma_; }
-    const std::vector<float>& beta()       const { return beta_; }
-    const std::vector<float>& grad_gamma() const { return grad_gamma_; }
-    const std::vector<float>& grad_beta()  const { return grad_beta_; }
-
-    // для inference
+    const ParamBuffer& gamma()      const { return gamma_; }
+    const ParamBuffer& beta()       const { return beta_; }
+    const ParamBuffer& grad_gamma() const { return grad_gamma_; }
+    const ParamBuffer& grad_beta()  const { return grad_beta_; }
+
+    // для inference и чекпоинта
+    std::vector<float>&       runningMean()       { return running_mean_; }
+    std::vector<float>&       runningVar()        { return running_var_; }
     const std::vector<float>& runningMean() const { return running_mean_; }
     const std::vector<float>& runningVar()  const { return running_var_; }
 
+    int   channels() const { return C_; }
+    float eps()      const { return eps_; }
+
 private:
     int C_;
     float eps_, momentum_;
 
-    std::vector<float> gamma_, beta_;
-    std::vector<float> grad_gamma_, grad_beta_;
+    ParamBuffer gamma_, beta_;
+    ParamBuffer grad_gamma_, grad_beta_;
     std::vector<float> running_mean_, running_var_;
 
     // временные буферы для backward
     int D_, H_, W_, N_;
     std::vector<float> batch_mean_, batch_var_, inv_std_, x_hat_;
+    std::vector<float> row_, row2_;  // строка каналов во float (bf16-путь)
+
+    void updateStats(bool training);
 };
@@ -1,5 +1,9 @@
 #include "Conv3D.h"
+#include "utils/Simd.h"
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstring>
 #include <random>
 
 Conv3D::Conv3D(int in_ch, int out_ch,
@@ -132,3 +136,112 @@ void Conv3D::zeroGrad() {
     std::fill(grad_w_.begin(), grad_w_.end(), 0.0f);
     std::fill(grad_b_.begin(), grad_b_.end(), 0.0f);
 }
+
+// ---------- Смешанная точность (bf16) ----------
+
+void Conv3D::packWeightsBF16() {
+    // Отсчёт окна k = ((kd*kH + kh)*kW + kw)*in_ch + ic, т.е. weight_[k*out_ch + oc]
+    const int K = kD_ * kH_ * kW_ * in_ch_;
+    kpairs_ = (K + 1) / 2;
+    oc_pad_ = (out_ch_ + 15) / 16 * 16;
+    w16_.assign(static_cast<size_t>(kpairs_) * oc_pad_ * 2, 0);
+    for (int k = 0; k < K; ++k)
+        for (int oc = 0; oc < out_ch_; ++oc)
+            w16_[(static_cast<size_t>(k / 2) * oc_pad_ + oc) * 2 + (k & 1)] =
+                bf16::fromFloat(weight_[static_cast<size_t>(k) * out_ch_ + oc]);
+    bias_pad_.assign(oc_pad_, 0.0f);
+    std::copy(bias_.begin(), bias_.end(), bias_pad_.begin());
+    patch16_.assign(static_cast<size_t>(kpairs_) * 2, 0);
+    go_pad_.assign(oc_pad_, 0.0f);
+}
+
+void Conv3D::gatherPatchBF16(const Tensor3DBF16& x, int od, int oh, int ow) {
+    const int D = x.depth(), H = x.height(), W = x.width();
+    uint16_t* dst = patch16_.data();
+    for (int kd = 0; kd < kD_; ++kd) {
+        int id = od*sD_ + kd - (pad_==Padding::SAME ? kD_/2 : 0);
+        for (int kh = 0; kh < kH_; ++kh) {
+            int ih = oh*sH_ + kh - (pad_==Padding::SAME ? kH_/2 : 0);
+            for (int kw = 0; kw < kW_; ++kw, dst += in_ch_) {
+                int iw = ow*sW_ + kw - (pad_==Padding::SAME ? kW_/2 : 0);
+                if (id<0||id>=D||ih<0||ih>=H||iw<0||iw>=W) {
+                    std::fill(dst, dst + in_ch_, uint16_t(0));
+                    continue;
+                }
+                const uint16_t* src = x.data() + ((static_cast<size_t>(id)*H + ih)*W + iw) * in_ch_;
+                std::copy(src, src + in_ch_, dst);
+            }
+        }
+    }
+}
+
+void Conv3D::forward(const Tensor3DBF16& x, Tensor3DBF16& y) {
+    packWeightsBF16();
+    int D_out, H_out, W_out;
+    computeOutputDims(x.depth(), x.height(), x.width(), D_out, H_out, W_out);
+    y.resize(D_out, H_out, W_out, out_ch_);
+
+    // Пара соседних bf16 входа одним словом; memcpy — без нарушения
+    // strict aliasing (патч пишется как uint16_t)
+    auto pair = [this](int kp) {
+        uint32_t v;
+        std::memcpy(&v, patch16_.data() + 2 * static_cast<size_t>(kp), sizeof(v));
+        return v;
+    };
+    uint16_t* out = y.data();
+    for (int od = 0; od < D_out; ++od)
+    for (int oh = 0; oh < H_out; ++oh)
+    for (int ow = 0; ow < W_out; ++ow, out += out_ch_) {
+        gatherPatchBF16(x, od, oh, ow);
+        for (int b = 0; b < oc_pad_; b += 16) {
+            const int lanes = std::min(16, out_ch_ - b);
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+            __m512 acc = _mm512_loadu_ps(bias_pad_.data() + b);
+            for (int kp = 0; kp < kpairs_; ++kp) {
+                const uint32_t xp = pair(kp);
+                if (xp == 0) continue;  // пустые воксели — частый случай
+                __m512i xv = _mm512_set1_epi32(static_cast<int>(xp));
+                __m512i wv = _mm512_loadu_si512(w16_.data() + (static_cast<size_t>(kp) * oc_pad_ + b) * 2);
+                acc = _mm512_dpbf16_ps(acc, (__m512bh)xv, (__m512bh)wv);
+            }
+            __m256bh h = _mm512_cvtneps_pbh(acc);
+            _mm256_mask_storeu_epi16(out + b, static_cast<__mmask16>((1u << lanes) - 1), (__m256i)h);
+#else
+            float acc[16];
+            std::copy(bias_pad_.begin() + b, bias_pad_.begin() + b + 16, acc);
+            for (int kp = 0; kp < kpairs_; ++kp) {
+                if (pair(kp) == 0) continue;
+                for (int j = 0; j < 2; ++j) {
+                    float xv = bf16::toFloat(patch16_[2 * kp + j]);
+                    const uint16_t* w = w16_.data() + (static_cast<size_t>(kp) * oc_pad_ + b) * 2 + j;
+                    for (int l = 0; l < 16; ++l) acc[l] += xv * bf16::toFloat(w[2 * l]);
+                }
+            }
+            bf16::fromFloat(acc, out + b, lanes);
+#endif
+        }
+    }
+}
+
+void Conv3D::backwardParams(const Tensor3DBF16& x, const Tensor3DBF16& grad_out) {
+    if (static_cast<int>(go_pad_.size()) != oc_pad_ || oc_pad_ == 0) packWeightsBF16();
+    int D_out, H_out, W_out;
+    computeOutputDims(x.depth(), x.height(), x.width(), D_out, H_out, W_out);
+    assert(grad_out.depth()==D_out && grad_out.height()==H_out
+        && grad_out.width()==W_out && grad_out.channels()==out_ch_);
+
+    const int K = kD_ * kH_ * kW_ * in_ch_;
+    const uint16_t* go16 = grad_out.data();
+    for (int od = 0; od < D_out; ++od)
+    for (int oh = 0; oh < H_out; ++oh)
+    for (int ow = 0; ow < W_out; ++ow, go16 += out_ch_) {
+        bf16::toFloat(go16, go_pad_.data(), out_ch_);
+        simd::add(grad_b_.data(), go_pad_.data(), out_ch_);
+        gatherPatchBF16(x, od, oh, ow);
+        for (int k = 0; k < K; ++k) {
+            if (patch16_[k] == 0) continue;
+            simd::axpy(grad_w_.data() + static_cast<size_t>(k) * out_ch_,
+                       bf16::toFloat(patch16_[k]), go_pad_.data(), out_ch_);
+        }
+    }
+}
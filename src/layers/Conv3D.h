@@ -1,6 +1,8 @@
 #pragma once
 
 #include "net/Tensor3D.h"
+#include "net/Tensor3DBF16.h"
+#include "net/ParamBuffer.h"
 #include <vector>
 
 /**
@@ -22,17 +24,40 @@ public:
     Tensor3D backward(const Tensor3D& x, const Tensor3D& grad_out);
     void zeroGrad();
 
+    /**
+     * Смешанная точность: вход и выход в bf16, веса — bf16-копия
+     * fp32-мастера (перепаковывается на каждом вызове, поэтому всегда
+     * свежая после шага оптимизатора), накопление во float
+     * (VDPBF16PS при AVX512-BF16, иначе эмуляция во float32).
+     */
+    void forward(const Tensor3DBF16& x, Tensor3DBF16& y);
+
+    /// Градиенты весов и bias (fp32) по bf16-входу и bf16-градиенту выхода.
+    /// Градиент по входу не считается — слой используется первым в сети.
+    void backwardParams(const Tensor3DBF16& x, const Tensor3DBF16& grad_out);
+
     // НЕКОНСТАНТНЫЕ геттеры для оптимизатора
-    std::vector<float>& weight()     { return weight_; }
-    std::vector<float>& bias()       { return bias_; }
-    std::vector<float>& weightGrad() { return grad_w_; }
-    std::vector<float>& biasGrad()   { return grad_b_; }
+    ParamBuffer& weight()     { return weight_; }
+    ParamBuffer& bias()       { return bias_; }
+    ParamBuffer& weightGrad() { return grad_w_; }
+    ParamBuffer& biasGrad()   { return grad_b_; }
 
     // Константные геттеры (если вам нужно читать параметры)
-    const std::vector<float>& weight()     const { return weight_; }
-    const std::vector<float>& bias()       const { return bias_; }
-    const std::vector<float>& weightGrad() const { return grad_w_; }
-    const std::vector<float>& biasGrad()   const { return grad_b_; }
+    const ParamBuffer& weight()     const { return weight_; }
+    const ParamBuffer& bias()       const { return bias_; }
+    const ParamBuffer& weightGrad() const { return grad_w_; }
+    const ParamBuffer& biasGrad()   const { return grad_b_; }
+
+    // Гиперпараметры слоя (нужны при экспорте весов в движок инференса)
+    int inChannels()  const { return in_ch_; }
+    int outChannels() const { return out_ch_; }
+    int kernelD() const { return kD_; }
+    int kernelH() const { return kH_; }
+    int kernelW() const { return kW_; }
+    int strideD() const { return sD_; }
+    int strideH() const { return sH_; }
+    int strideW() const { return sW_; }
+    Padding padding() const { return pad_; }
 
 private:
     int in_ch_, out_ch_;
@@ -40,10 +65,18 @@ private:
     int sD_, sH_, sW_;
     Padding pad_;
 
-    std::vector<float> weight_;    // size = kD*kH*kW*in_ch*out_ch
-    std::vector<float> bias_;      // size = out_ch
-    std::vector<float> grad_w_;    // того же размера, что weight_
-    std::vector<float> grad_b_;    // size = out_ch
+    ParamBuffer weight_;    // size = kD*kH*kW*in_ch*out_ch
+    ParamBuffer bias_;      // size = out_ch
+    ParamBuffer grad_w_;    // того же размера, что weight_
+    ParamBuffer grad_b_;    // size = out_ch
+
+    // bf16-путь: веса парами по входным отсчётам [K/2][oc_pad][2] и окно входа
+    int kpairs_ = 0, oc_pad_ = 0;
+    std::vector<uint16_t> w16_, patch16_;
+    std::vector<float>    bias_pad_, go_pad_;
+
+    void packWeightsBF16();
+    void gatherPatchBF16(const Tensor3DBF16& x, int od, int oh, int ow);
 
     inline int wIndex(int od, int oh, int ow, int ic, int oc) const {
         return (((od * kH_ + oh) * kW_ + ow)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "net/ParamBuffer.h"
 #include <vector>
 #include <random>
 #include <cmath>
@@ -17,21 +18,27 @@ public:
     void zeroGrad();
 
     // НЕКОНСТАНТНЫЕ геттеры для оптимизатора
-    std::vector<float>& weight()     { return weight_; }
-    std::vector<float>& bias()       { return bias_; }
-    std::vector<float>& gradWeight() { return grad_weight_; }
-    std::vector<float>& gradBias()   { return grad_bias_; }
+    ParamBuffer& weight()     { return weight_; }
+    ParamBuffer& bias()       { return bias_; }
+    ParamBuffer& gradWeight() { return grad_weight_; }
+    ParamBuffer& gradBias()   { return grad_bias_; }
 
     // Константные геттеры
-    const std::vector<float>& weight()     const { return weight_; }
-    const std::vector<float>& bias()       const { return bias_; }
-    const std::vector<float>& gradWeight() const { return grad_weight_; }
-    const std::vector<float>& gradBias()   const { return grad_bias_; }
+    const ParamBuffer& weight()     const { return weight_; }
+    const ParamBuffer& bias()       const { return bias_; }
+    const ParamBuffer& gradWeight() const { return grad_weight_; }
+    const ParamBuffer& gradBias()   const { return grad_bias_; }
+
+    // Вход последнего forward (калибровка диапазона активаций)
+    const std::vector<float>& lastInput() const { return input_; }
+
+    int inFeatures()  const { return in_f_; }
+    int outFeatures() const { return out_f_; }
 
 private:
     int in_f_, out_f_;
-    std::vector<float> weight_, bias_;
-    std::vector<float> grad_weight_, grad_bias_;
+    ParamBuffer weight_, bias_;
+    ParamBuffer grad_weight_, grad_bias_;
     std::vector<float> input_;  // сохранённый вход для backward
 
     void initWeightsXavier() noexcept;
@@ -16,9 +16,9 @@ MaxPool3D::MaxPool3D(int kD, int kH, int kW,
       pad_(pad)
 {}
 
-Tensor3D MaxPool3D::forward(const Tensor3D& x) {
+void MaxPool3D::setShapes(int D, int H, int W, int C) {
     // Сохраняем форму входа
-    inD_ = x.depth(); inH_ = x.height(); inW_ = x.width(); inC_ = x.channels();
+    inD_ = D; inH_ = H; inW_ = W; inC_ = C;
 
     // Вычисляем форму выхода
     if (pad_ == Padding::SAME) {
@@ -30,6 +30,10 @@ Tensor3D MaxPool3D::forward(const Tensor3D& x) {
         outH_ = (inH_ - kH_) / sH_ + 1;
         outW_ = (inW_ - kW_) / sW_ + 1;
     }
+}
+
+Tensor3D MaxPool3D::forward(const Tensor3D& x) {
+    setShapes(x.depth(), x.height(), x.width(), x.channels());
 
     // Резервируем результат и индексы
     Tensor3D y(outD_, outH_, outW_, inC_);
@@ -90,6 +94,56 @@ Tensor3D MaxPool3D::backward(const Tensor3D& grad_y) {
     return gradInput_;
 }
 
+void MaxPool3D::forward(const Tensor3DBF16& x, Tensor3DBF16& y) {
+    setShapes(x.depth(), x.height(), x.width(), x.channels());
+    y.resize(outD_, outH_, outW_, inC_);
+    maxIndex_.assign(outD_*outH_*outW_*inC_, 0);
+
+    const uint16_t* xd = x.data();
+    for(int d=0; d<outD_; ++d){
+      for(int h=0; h<outH_; ++h){
+        for(int w=0; w<outW_; ++w){
+          for(int c=0; c<inC_; ++c){
+            float best = -std::numeric_limits<float>::infinity();
+            int bestIdx = 0;
+            for(int kd=0; kd<kD_; ++kd){
+              int id = d*sD_ + kd - (pad_==Padding::SAME ? kD_/2 : 0);
+              for(int kh=0; kh<kH_; ++kh){
+                int ih = h*sH_ + kh - (pad_==Padding::SAME ? kH_/2 : 0);
+                for(int kw=0; kw<kW_; ++kw){
+                  int iw = w*sW_ + kw - (pad_==Padding::SAME ? kW_/2 : 0);
+                  if(id<0||id>=inD_||ih<0||ih>=inH_||iw<0||iw>=inW_) continue;
+                  int idx = ((id*inH_ + ih)*inW_ + iw)*inC_ + c;
+                  float v = bf16::toFloat(xd[idx]);
+                  if(v > best){
+                    best = v;
+                    bestIdx = idx;
+                  }
+                }
+              }
+            }
+            int outFlat = ((d*outH_ + h)*outW_ + w)*inC_ + c;
+            y.data()[outFlat]  = xd[bestIdx];
+            maxIndex_[outFlat] = bestIdx;
+          }
+        }
+      }
+    }
+}
+
+void MaxPool3D::backward(const Tensor3DBF16& grad_y, Tensor3DBF16& grad_x) {
+    grad_x.resize(inD_, inH_, inW_, inC_);
+    std::fill(grad_x.data(), grad_x.data() + grad_x.size(), uint16_t(0));
+
+    // Окна могут перекрываться — суммируем во float
+    uint16_t* gx = grad_x.data();
+    int N = outD_*outH_*outW_*inC_;
+    for(int i=0; i<N; ++i){
+        int j = maxIndex_[i];
+        gx[j] = bf16::fromFloat(bf16::toFloat(gx[j]) + bf16::toFloat(grad_y.data()[i]));
+    }
+}
+
 void MaxPool3D::zeroGrad() {
     gradInput_.fill(0.0f);
     // maxIndex_ будет перезаписан в следующем forward()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "net/Tensor3D.h"
+#include "net/Tensor3DBF16.h"
 #include <vector>
 
 /**
@@ -21,12 +22,25 @@ public:
     // Обратный проход: принимает dL/dy, возвращает dL/dx
     Tensor3D backward(const Tensor3D& grad_y);
 
+    // То же для bf16-тензоров (смешанная точность); gradInput() не заполняется
+    void forward(const Tensor3DBF16& x, Tensor3DBF16& y);
+    void backward(const Tensor3DBF16& grad_y, Tensor3DBF16& grad_x);
+
     // Сбросить накопленные градиенты
     void zeroGrad();
 
     // Геттер накопленного dL/dx (после backward)
     const Tensor3D& gradInput() const { return gradInput_; }
 
+    // Гиперпараметры окна
+    int kernelD() const { return kD_; }
+    int kernelH() const { return kH_; }
+    int kernelW() const { return kW_; }
+    int strideD() const { return sD_; }
+    int strideH() const { return sH_; }
+    int strideW() const { return sW_; }
+    Padding padding() const { return pad_; }
+
 private:
     int kD_, kH_, kW_;
     int sD_, sH_, sW_;
@@ -42,4 +56,7 @@ private:
 
     // Накопленные градиенты по входу
     Tensor3D gradInput_;
+
+    // Запомнить форму входа и посчитать форму выхода
+    void setShapes(int D, int H, int W, int C);
 };
@@ -37,6 +37,36 @@ Tensor3D ReLU3D::backward(const Tensor3D& grad_y) {
     return grad_x;
 }
 
+void ReLU3D::forward(const Tensor3DBF16& x, Tensor3DBF16& y) {
+    D_ = x.depth(); H_ = x.height();
+    W_ = x.width(); C_ = x.channels();
+
+    int N = D_*H_*W_*C_;
+    y.resize(D_, H_, W_, C_);
+    mask_.resize(N);
+
+    const uint16_t* x_data = x.data();
+    uint16_t*       y_data = y.data();
+    for(int i = 0; i < N; ++i) {
+        bool on   = bf16::positive(x_data[i]);
+        mask_[i]  = on;
+        y_data[i] = on ? x_data[i] : uint16_t(0);
+    }
+}
+
+void ReLU3D::backward(const Tensor3DBF16& grad_y, Tensor3DBF16& grad_x) {
+    assert(grad_y.depth()==D_ && grad_y.height()==H_
+        && grad_y.width()==W_ && grad_y.channels()==C_);
+
+    grad_x.resize(D_, H_, W_, C_);
+    const uint16_t* gy = grad_y.data();
+    uint16_t*       gx = grad_x.data();
+    int N = D_*H_*W_*C_;
+    for(int i = 0; i < N; ++i) {
+        gx[i] = mask_[i] ? gy[i] : uint16_t(0);
+    }
+}
+
 void ReLU3D::zeroGrad() {
     mask_.clear();
     D_ = H_ = W_ = C_ = 0;
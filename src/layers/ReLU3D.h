@@ -1,5 +1,6 @@
 #pragma once
 #include "net/Tensor3D.h"
+#include "net/Tensor3DBF16.h"
 #include <vector>
 
 class ReLU3D {
@@ -12,6 +13,10 @@ public:
     // backward умножает grad_y на маску и проверяет форму
     Tensor3D backward(const Tensor3D& grad_y);
 
+    // то же для bf16-тензоров (смешанная точность)
+    void forward(const Tensor3DBF16& x, Tensor3DBF16& y);
+    void backward(const Tensor3DBF16& grad_y, Tensor3DBF16& grad_x);
+
     // полный сброс состояния
     void zeroGrad();
 
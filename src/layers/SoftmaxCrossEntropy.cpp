@@ -1,57 +1,84 @@
 #include "layers/SoftmaxCrossEntropy.h"
 
-float SoftmaxCrossEntropy::forward(const std::vector<float>& logits,
-                                   const std::vector<int>& labels) {
-    assert(!logits.empty());
-    N_ = static_cast<int>(labels.size());
-    assert(static_cast<int>(logits.size()) % N_ == 0);
-    C_ = static_cast<int>(logits.size()) / N_;
-    probs_.assign(logits.size(), 0.0f);
-    labels_ = labels;
+namespace {
 
+// Softmax по строкам logits в probs и средняя потеря; L — int или uint8_t
+template <typename L>
+float softmaxLoss(const std::vector<float>& logits, const L* labels, int N, int C,
+                  std::vector<float>& probs) {
+    probs.assign(logits.size(), 0.0f);
     float loss = 0.0f;
     // для каждой выборки i вычисляем softmax
-    for (int i = 0; i < N_; ++i) {
+    for (int i = 0; i < N; ++i) {
         // найти max для стабильности
-        float maxLogit = logits[i*C_];
-        for (int j = 1; j < C_; ++j) {
-            maxLogit = std::max(maxLogit, logits[i*C_ + j]);
+        float maxLogit = logits[i*C];
+        for (int j = 1; j < C; ++j) {
+            maxLogit = std::max(maxLogit, logits[i*C + j]);
         }
         // sum exp
         float sumExp = 0.0f;
-        for (int j = 0; j < C_; ++j) {
-            float e = std::exp(logits[i*C_ + j] - maxLogit);
-            probs_[i*C_ + j] = e;
+        for (int j = 0; j < C; ++j) {
+            float e = std::exp(logits[i*C + j] - maxLogit);
+            probs[i*C + j] = e;
             sumExp += e;
         }
         float logSumExp = std::log(sumExp) + maxLogit;
         // нормируем
-        for (int j = 0; j < C_; ++j) {
-            probs_[i*C_ + j] /= sumExp;
+        for (int j = 0; j < C; ++j) {
+            probs[i*C + j] /= sumExp;
         }
-        int lbl = labels_[i];
-        assert(lbl >= 0 && lbl < C_);
-        loss += (logSumExp - logits[i*C_ + lbl]);  // -log p_lbl = logSumExp - logit_lbl
+        int lbl = labels[i];
+        assert(lbl >= 0 && lbl < C);
+        loss += (logSumExp - logits[i*C + lbl]);  // -log p_lbl = logSumExp - logit_lbl
     }
-    return loss / N_;
+    return loss / N;
 }
 
-std::vector<float> SoftmaxCrossEntropy::backward() {
-    assert(static_cast<int>(probs_.size()) == N_ * C_);
-    // Правильная инициализация градиентов размером N_*C_
-    std::vector<float> grad(N_ * C_, 0.0f);
+template <typename L>
+std::vector<float> softmaxGrad(const std::vector<float>& probs, const L* labels, int N, int C) {
+    // Правильная инициализация градиентов размером N*C
+    std::vector<float> grad(N * C, 0.0f);
     // dL/dlogit = (p - y) / N
-    for (int i = 0; i < N_; ++i) {
-        for (int j = 0; j < C_; ++j) {
-            float p = probs_[i*C_ + j];
-            grad[i*C_ + j] = p - (j == labels_[i] ? 1.0f : 0.0f);
+    for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < C; ++j) {
+            float p = probs[i*C + j];
+            grad[i*C + j] = p - (j == labels[i] ? 1.0f : 0.0f);
         }
     }
     // усредняем по батчу
-    float invN = 1.0f / N_;
+    float invN = 1.0f / N;
     for (auto& g : grad) {
         g *= invN;
     }
     return grad;
 }
 
+} // namespace
+
+float SoftmaxCrossEntropy::forward(const std::vector<float>& logits,
+                                   const std::vector<int>& labels) {
+    assert(!logits.empty());
+    N_ = static_cast<int>(labels.size());
+    assert(static_cast<int>(logits.size()) % N_ == 0);
+    C_ = static_cast<int>(logits.size()) / N_;
+    labels_ = labels;
+    byte_labels_.clear();
+    return softmaxLoss(logits, labels_.data(), N_, C_, probs_);
+}
+
+float SoftmaxCrossEntropy::forward(const std::vector<float>& logits,
+                                   const std::vector<uint8_t>& labels) {
+    assert(!logits.empty());
+    N_ = static_cast<int>(labels.size());
+    assert(static_cast<int>(logits.size()) % N_ == 0);
+    C_ = static_cast<int>(logits.size()) / N_;
+    byte_labels_ = labels;
+    labels_.clear();
+    return softmaxLoss(logits, byte_labels_.data(), N_, C_, probs_);
+}
+
+std::vector<float> SoftmaxCrossEntropy::backward() {
+    assert(static_cast<int>(probs_.size()) == N_ * C_);
+    if (!byte_labels_.empty()) return softmaxGrad(probs_, byte_labels_.data(), N_, C_);
+    return softmaxGrad(probs_, labels_.data(), N_, C_);
+}
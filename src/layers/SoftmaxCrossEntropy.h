@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include <cassert>
 #include <cmath>
 #include <algorithm>
@@ -22,6 +23,14 @@ public:
     float forward(const std::vector<float>& logits,
                   const std::vector<int>& labels);
 
+    /**
+     * Прямой проход для сегментации: N = labels.size() вокселей (батч
+     * подряд), метки — байты, как их отдаёт DataLoader::nextSegBatch,
+     * без расширения в int или float.
+     */
+    float forward(const std::vector<float>& logits,
+                  const std::vector<uint8_t>& labels);
+
     /**
      * Обратный проход.
      * @return  Вектор градиентов dL/dlogits того же размера N*C.
@@ -33,4 +42,5 @@ private:
     int C_ = 0;                       // число классов
     std::vector<float> probs_;        // сохранённые softmax-вероятности (N*C)
     std::vector<int> labels_;         // сохранённые метки (N)
+    std::vector<uint8_t> byte_labels_; // или метки вокселей байтами (N)
 };
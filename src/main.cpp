@@ -1,4 +1,5 @@
 #include "utils/Voxelizer.h"
+#include "data/VoxelMask.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -68,14 +69,12 @@ void writePLY(const std::string& out,
 
     // 2) центры занятых вокселей (красные точки)
     // найдём границы и размер ячейки
-    float minx=pts[0].x, maxx=pts[0].x,
-          miny=pts[0].y, maxy=pts[0].y,
-          minz=pts[0].z, maxz=pts[0].z;
-    for(const auto& p : pts) {
-        minx = std::min(minx, p.x); maxx = std::max(maxx, p.x);
-        miny = std::min(miny, p.y); maxy = std::max(maxy, p.y);
-        minz = std::min(minz, p.z); maxz = std::max(maxz, p.z);
-    }
+    // PointNL — семь 4-байтных полей, x/y/z первыми: шаг 7 float
+    static_assert(sizeof(PointNL) == 7 * sizeof(float), "computeBounds ждёт PointNL из 7 полей");
+    const Bounds bb = computeBounds(&pts[0].x, pts.size(), sizeof(PointNL) / sizeof(float), 0);
+    const float minx = bb.lo[0], maxx = bb.hi[0],
+                miny = bb.lo[1], maxy = bb.hi[1],
+                minz = bb.lo[2], maxz = bb.hi[2];
     float dx = (maxx - minx) / N;
     float dy = (maxy - miny) / N;
     float dz = (maxz - minz) / N;
@@ -1,4 +1,5 @@
 #include "utils/Voxelizer.h"
+#include "data/VoxelMask.h"
 #include <fstream>
 #include <vector>
 #include <cstdint>
@@ -64,14 +65,11 @@ static void writePLY(const std::string& fn,
     // 2) находим центры занятых вокселей
     //    (забираем те, у которых vox[i][3+3*VOX_K] > 0.5)
     //    и добавляем их красным цветом
-    float minx=pts[0].x, maxx=pts[0].x,
-          miny=pts[0].y, maxy=pts[0].y,
-          minz=pts[0].z, maxz=pts[0].z;
-    for(auto& p: pts){
-        minx = std::min(minx,p.x); maxx = std::max(maxx,p.x);
-        miny = std::min(miny,p.y); maxy = std::max(maxy,p.y);
-        minz = std::min(minz,p.z); maxz = std::max(maxz,p.z);
-    }
+    static_assert(sizeof(PointNL) == 7*sizeof(float), "computeBounds ждёт PointNL из 7 полей");
+    const Bounds bb = computeBounds(&pts[0].x, pts.size(), sizeof(PointNL)/sizeof(float), 0);
+    const float minx=bb.lo[0], maxx=bb.hi[0],
+                miny=bb.lo[1], maxy=bb.hi[1],
+                minz=bb.lo[2], maxz=bb.hi[2];
     float dx=(maxx-minx)/N, dy=(maxy-miny)/N, dz=(maxz-minz)/N;
     for(int idx=0; idx < N*N*N; ++idx){
         if(vox[idx][3 + 3*VOX_K] > 0.5f){
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "utils/Intrin.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * bfloat16: старшие 16 бит float32 (тот же порядок, 8 бит мантиссы).
+ *
+ * Хранится как uint16_t. Перевод из float — с округлением к ближайшему
+ * чётному; обратно — сдвиг без потерь, поэтому произведение двух bf16
+ * точно представимо во float и эмуляция bf16-скалярного произведения
+ * во float32 совпадает с VDPBF16PS с точностью до порядка суммирования.
+ */
+namespace bf16 {
+
+inline uint16_t fromFloat(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    if ((u & 0x7FFFFFFFu) > 0x7F800000u)          // NaN остаётся NaN
+        return static_cast<uint16_t>((u >> 16) | 0x40);
+    u += 0x7FFFu + ((u >> 16) & 1u);
+    return static_cast<uint16_t>(u >> 16);
+}
+
+inline float toFloat(uint16_t h) {
+    uint32_t u = static_cast<uint32_t>(h) << 16;
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/// x > 0 без распаковки (для ReLU): знак 0 и не ноль (NaN не встречается)
+inline bool positive(uint16_t h) { return h != 0 && (h & 0x8000u) == 0; }
+
+SIMD_KERNELS_BEGIN
+
+/// Пакетный перевод float → bf16 (AVX512-BF16, иначе целочисленная эмуляция)
+inline void fromFloat(const float* src, uint16_t* dst, size_t n) {
+    size_t i = 0;
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+    for (; i + 16 <= n; i += 16) {
+        __m256bh h = _mm512_cvtneps_pbh(_mm512_loadu_ps(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), (__m256i)h);
+    }
+#elif defined(__AVX512BW__)
+    const __m512i bias = _mm512_set1_epi32(0x7FFF), one = _mm512_set1_epi32(1);
+    for (; i + 16 <= n; i += 16) {
+        __m512i u   = _mm512_loadu_si512(src + i);
+        __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(u, 16), one);
+        __m512i r   = _mm512_srli_epi32(_mm512_add_epi32(u, _mm512_add_epi32(bias, lsb)), 16);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_cvtepi32_epi16(r));
+    }
+#endif
+    for (; i < n; ++i) dst[i] = fromFloat(src[i]);
+}
+
+/// Пакетный перевод bf16 → float
+inline void toFloat(const uint16_t* src, float* dst, size_t n) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16) {
+        __m512i h = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+        _mm512_storeu_si512(dst + i, _mm512_slli_epi32(h, 16));
+    }
+#endif
+    for (; i < n; ++i) dst[i] = toFloat(src[i]);
+}
+
+SIMD_KERNELS_END
+
+} // namespace bf16
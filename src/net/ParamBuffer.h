@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+/// Выравнивание буферов параметров: 16 float = 64 байта (строка кэша, регистр AVX-512)
+constexpr size_t kParamAlign = 16;
+
+/// Размер, округлённый вверх до kParamAlign
+inline size_t paddedSize(size_t n) { return (n + kParamAlign - 1) / kParamAlign * kParamAlign; }
+
+/**
+ * Буфер float для весов и градиентов слоя.
+ *
+ * Либо владеет собственной памятью, выровненной на 64 байта, либо является
+ * видом на чужую память (bind) — так Network раскладывает параметры всех
+ * слоёв в одну непрерывную арену. Размер вида фиксирован: assign/resize
+ * с другим размером бросают исключение, а копирующее присваивание
+ * переносит значения, не меняя привязки.
+ *
+ * Интерфейс повторяет нужное слоям подмножество std::vector<float>.
+ */
+class ParamBuffer {
+public:
+    ParamBuffer() = default;
+    explicit ParamBuffer(size_t n, float value = 0.0f) { allocate(n); std::fill(begin(), end(), value); }
+    ParamBuffer(std::initializer_list<float> il) { allocate(il.size()); std::copy(il.begin(), il.end(), data_); }
+
+    /// Копия всегда владеющая (независимая от арены оригинала)
+    ParamBuffer(const ParamBuffer& o) { allocate(o.size_); std::copy(o.begin(), o.end(), data_); }
+    ParamBuffer(ParamBuffer&& o) noexcept
+        : owned_(std::move(o.owned_)), data_(o.data_), size_(o.size_) {
+        o.data_ = nullptr;
+        o.size_ = 0;
+    }
+
+    ParamBuffer& operator=(const ParamBuffer& o) {
+        if (this != &o) assignRange(o.begin(), o.end());
+        return *this;
+    }
+    ParamBuffer& operator=(ParamBuffer&& o) {
+        if (this == &o) return *this;
+        if (isView()) return assignRange(o.begin(), o.end());
+        owned_ = std::move(o.owned_);
+        data_  = o.data_;
+        size_  = o.size_;
+        o.data_ = nullptr;
+        o.size_ = 0;
+        return *this;
+    }
+    ParamBuffer& operator=(std::initializer_list<float> il) { return assignRange(il.begin(), il.end()); }
+    ParamBuffer& operator=(const std::vector<float>& v)     { return assignRange(v.data(), v.data() + v.size()); }
+
+    void assign(size_t n, float value) { resize(n); std::fill(begin(), end(), value); }
+
+    /// Новые элементы — нули; для вида допустим только текущий размер
+    void resize(size_t n) {
+        if (n == size_) return;
+        if (isView())
+            throw std::runtime_error("ParamBuffer: нельзя менять размер буфера, привязанного к арене");
+        ParamBuffer tmp(n);
+        std::copy(begin(), begin() + std::min(n, size_), tmp.data_);
+        *this = std::move(tmp);
+    }
+
+    /// Скопировать содержимое в external (не меньше size() float) и стать видом на него
+    void bind(float* external) {
+        if (size_) std::memcpy(external, data_, size_ * sizeof(float));
+        owned_.reset();
+        data_ = external;
+    }
+
+    bool isView() const { return data_ != nullptr && !owned_; }
+
+    size_t size()  const { return size_; }
+    bool   empty() const { return size_ == 0; }
+
+    float*       data()       { return data_; }
+    const float* data() const { return data_; }
+    float*       begin()       { return data_; }
+    float*       end()         { return data_ + size_; }
+    const float* begin() const { return data_; }
+    const float* end()   const { return data_ + size_; }
+
+    float&       operator[](size_t i)       { return data_[i]; }
+    const float& operator[](size_t i) const { return data_[i]; }
+
+private:
+    struct FreeDeleter { void operator()(float* p) const { std::free(p); } };
+
+    std::unique_ptr<float, FreeDeleter> owned_;
+    float* data_ = nullptr;
+    size_t size_ = 0;
+
+    void allocate(size_t n) {
+        size_ = n;
+        if (n == 0) { owned_.reset(); data_ = nullptr; return; }
+        void* p = std::aligned_alloc(kParamAlign * sizeof(float), paddedSize(n) * sizeof(float));
+        if (!p) throw std::bad_alloc();
+        owned_.reset(static_cast<float*>(p));
+        data_ = owned_.get();
+        std::fill(data_ + n, data_ + paddedSize(n), 0.0f);
+    }
+
+    ParamBuffer& assignRange(const float* b, const float* e) {
+        size_t n = static_cast<size_t>(e - b);
+        if (n != size_) {
+            if (isView())
+                throw std::runtime_error("ParamBuffer: размер не совпадает с буфером в арене");
+            allocate(n);
+        }
+        std::copy(b, e, data_);
+        return *this;
+    }
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "net/BF16.h"
+#include "net/Tensor3D.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Тензор D×H×W×C в bfloat16 (тот же row-major порядок, что Tensor3D).
+ *
+ * Вдвое меньше Tensor3D — для хранения активаций и их градиентов
+ * в режиме смешанной точности. resize не освобождает память, поэтому
+ * буферы переиспользуются между шагами без выделений.
+ */
+class Tensor3DBF16 {
+public:
+    Tensor3DBF16() = default;
+    Tensor3DBF16(int depth, int height, int width, int channels) { resize(depth, height, width, channels); }
+
+    void resize(int depth, int height, int width, int channels) {
+        D_ = depth; H_ = height; W_ = width; C_ = channels;
+        data_.resize(static_cast<size_t>(size()));
+    }
+
+    void fill(float value) { std::fill(data_.begin(), data_.end(), bf16::fromFloat(value)); }
+
+    int depth()    const { return D_; }
+    int height()   const { return H_; }
+    int width()    const { return W_; }
+    int channels() const { return C_; }
+    int size()     const { return D_ * H_ * W_ * C_; }
+
+    uint16_t*       data()       { return data_.data(); }
+    const uint16_t* data() const { return data_.data(); }
+
+    /// Значение элемента во float
+    float at(int d, int h, int w, int c) const {
+        return bf16::toFloat(data_[((static_cast<size_t>(d) * H_ + h) * W_ + w) * C_ + c]);
+    }
+
+    /// Скопировать x с округлением до bf16
+    void assign(const Tensor3D& x) {
+        resize(x.depth(), x.height(), x.width(), x.channels());
+        bf16::fromFloat(x.data(), data_.data(), data_.size());
+    }
+
+    /// Распаковать в Tensor3D
+    Tensor3D toFloat() const {
+        Tensor3D y(D_, H_, W_, C_);
+        bf16::toFloat(data_.data(), y.data(), data_.size());
+        return y;
+    }
+
+private:
+    int D_ = 0, H_ = 0, W_ = 0, C_ = 0;
+    std::vector<uint16_t> data_;
+};
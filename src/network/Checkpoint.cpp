@@ -0,0 +1,271 @@
+#include "network/Checkpoint.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace ckpt {
+
+uint32_t crc32c(const void* data, size_t n, uint32_t crc) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+#if defined(__SSE4_2__)
+    uint64_t c = crc;
+    for (; n >= 8; n -= 8, p += 8) {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        c = _mm_crc32_u64(c, v);
+    }
+    crc = static_cast<uint32_t>(c);
+    for (; n > 0; --n, ++p) crc = _mm_crc32_u8(crc, *p);
+#else
+    static const auto table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1u)));
+            t[i] = c;
+        }
+        return t;
+    }();
+    for (; n > 0; --n, ++p) crc = table[(crc ^ *p) & 0xFFu] ^ (crc >> 8);
+#endif
+    return ~crc;
+}
+
+} // namespace ckpt
+
+namespace {
+
+size_t alignUp(size_t n) { return (n + ckpt::kAlign - 1) / ckpt::kAlign * ckpt::kAlign; }
+
+size_t elementSize(uint32_t) { return 4; }  // F32 и I32
+
+} // namespace
+
+// ---------- CheckpointWriter ----------
+
+void CheckpointWriter::addRaw(const std::string& name, const std::vector<uint32_t>& shape,
+                              ckpt::DType dtype, const void* data) {
+    Item it{};
+    if (name.empty() || name.size() >= sizeof(it.entry.name))
+        throw std::invalid_argument("CheckpointWriter: недопустимое имя тензора '" + name + "'");
+    if (shape.size() > static_cast<size_t>(ckpt::kMaxDims))
+        throw std::invalid_argument("CheckpointWriter: слишком много измерений у '" + name + "'");
+    for (const auto& other : items_)
+        if (name == other.entry.name)
+            throw std::invalid_argument("CheckpointWriter: повторное имя тензора '" + name + "'");
+
+    std::memcpy(it.entry.name, name.data(), name.size());
+    it.entry.dtype = static_cast<uint32_t>(dtype);
+    it.entry.ndim  = static_cast<uint32_t>(shape.size());
+    it.entry.count = 1;
+    for (size_t d = 0; d < shape.size(); ++d) {
+        it.entry.shape[d] = shape[d];
+        it.entry.count   *= shape[d];
+    }
+    it.data = data;
+    items_.push_back(it);
+}
+
+void CheckpointWriter::add(const std::string& name, const std::vector<uint32_t>& shape, const float* data) {
+    addRaw(name, shape, ckpt::DType::F32, data);
+}
+
+void CheckpointWriter::add(const std::string& name, const std::vector<uint32_t>& shape, const int32_t* data) {
+    addRaw(name, shape, ckpt::DType::I32, data);
+}
+
+void CheckpointWriter::serialize(std::vector<uint8_t>& image, bool checksum) const {
+    // Раскладка: заголовок, таблица, данные с выравниванием каждого тензора
+    std::vector<ckpt::TensorEntry> table;
+    table.reserve(items_.size());
+    size_t off = alignUp(sizeof(ckpt::FileHeader) + items_.size() * sizeof(ckpt::TensorEntry));
+    const size_t data_offset = off;
+    for (const auto& it : items_) {
+        ckpt::TensorEntry e = it.entry;
+        e.offset = off;
+        off = alignUp(off + e.count * elementSize(e.dtype));
+        table.push_back(e);
+    }
+    const size_t file_size = off;
+
+    // Файл собирается в памяти целиком: так CRC считается за один проход
+    image.assign(file_size, 0);
+    std::memcpy(image.data() + sizeof(ckpt::FileHeader), table.data(), table.size() * sizeof(ckpt::TensorEntry));
+    for (size_t i = 0; i < items_.size(); ++i)
+        if (table[i].count)
+            std::memcpy(image.data() + table[i].offset, items_[i].data, table[i].count * elementSize(table[i].dtype));
+
+    ckpt::FileHeader h{};
+    std::memcpy(h.magic, ckpt::kMagic, sizeof(h.magic));
+    h.version      = ckpt::kVersion;
+    h.tensor_count = static_cast<uint32_t>(items_.size());
+    h.table_offset = sizeof(ckpt::FileHeader);
+    h.data_offset  = data_offset;
+    h.file_size    = file_size;
+    h.header_size  = sizeof(ckpt::FileHeader);
+    std::memcpy(image.data(), &h, sizeof(h));
+    if (checksum) seal(image);
+}
+
+void CheckpointWriter::seal(std::vector<uint8_t>& image) {
+    if (image.size() < sizeof(ckpt::FileHeader))
+        throw std::invalid_argument("CheckpointWriter::seal: образ короче заголовка");
+    uint32_t crc = ckpt::crc32c(image.data() + sizeof(ckpt::FileHeader), image.size() - sizeof(ckpt::FileHeader));
+    std::memcpy(image.data() + offsetof(ckpt::FileHeader, checksum), &crc, sizeof(crc));
+}
+
+void CheckpointWriter::writeImage(const std::string& path, const std::vector<uint8_t>& image) {
+    const std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error("Не удалось открыть файл для записи чекпоинта: " + tmp);
+    const uint8_t* p = image.data();
+    size_t left = image.size();
+    while (left > 0) {
+        ssize_t n = ::write(fd, p, left);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            ::close(fd);
+            ::unlink(tmp.c_str());
+            throw std::runtime_error("Ошибка записи чекпоинта: " + tmp);
+        }
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+    if (::fsync(fd) != 0) {
+        ::close(fd);
+        ::unlink(tmp.c_str());
+        throw std::runtime_error("fsync чекпоинта не удался: " + tmp);
+    }
+    ::close(fd);
+    if (::rename(tmp.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        throw std::runtime_error("Не удалось переименовать " + tmp + " в " + path);
+    }
+
+    // Сам rename становится устойчивым после fsync каталога
+    const size_t slash = path.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dfd >= 0) {
+        ::fsync(dfd);
+        ::close(dfd);
+    }
+}
+
+void CheckpointWriter::write(const std::string& path) const {
+    std::vector<uint8_t> image;
+    serialize(image);
+    writeImage(path, image);
+}
+
+// ---------- MappedCheckpoint ----------
+
+bool MappedCheckpoint::isCheckpoint(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(ckpt::kMagic)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, ckpt::kMagic, sizeof(magic)) == 0;
+}
+
+MappedCheckpoint::MappedCheckpoint(const std::string& path, bool verify) : path_(path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("Не удалось открыть чекпоинт: " + path);
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(ckpt::FileHeader))) {
+        ::close(fd);
+        throw std::runtime_error("Чекпоинт повреждён (слишком короткий): " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("mmap чекпоинта не удался: " + path);
+    base_   = static_cast<const uint8_t*>(p);
+    header_ = reinterpret_cast<const ckpt::FileHeader*>(base_);
+    try {
+        validate(verify);
+    } catch (...) {
+        ::munmap(const_cast<uint8_t*>(base_), size_);
+        throw;
+    }
+    table_ = reinterpret_cast<const ckpt::TensorEntry*>(base_ + header_->table_offset);
+}
+
+MappedCheckpoint::~MappedCheckpoint() {
+    if (base_) ::munmap(const_cast<uint8_t*>(base_), size_);
+}
+
+void MappedCheckpoint::validate(bool verify) const {
+    auto fail = [&](const std::string& what) {
+        throw std::runtime_error("Чекпоинт " + path_ + " повреждён: " + what);
+    };
+    const ckpt::FileHeader& h = *header_;
+    if (std::memcmp(h.magic, ckpt::kMagic, sizeof(h.magic)) != 0) fail("неверная сигнатура");
+    if (h.version == 0 || h.version > ckpt::kVersion)
+        throw std::runtime_error("Чекпоинт " + path_ + ": неподдерживаемая версия " + std::to_string(h.version));
+    if (h.header_size != sizeof(ckpt::FileHeader)) fail("неверный размер заголовка");
+    if (h.file_size != size_) fail("размер файла не совпадает с заголовком (обрезан?)");
+    if (h.table_offset != sizeof(ckpt::FileHeader)
+        || h.tensor_count > (size_ - h.table_offset) / sizeof(ckpt::TensorEntry))
+        fail("таблица тензоров выходит за пределы файла");
+    if (h.data_offset % ckpt::kAlign != 0 || h.data_offset > size_) fail("неверное смещение данных");
+
+    const auto* table = reinterpret_cast<const ckpt::TensorEntry*>(base_ + h.table_offset);
+    for (uint32_t i = 0; i < h.tensor_count; ++i) {
+        const ckpt::TensorEntry& e = table[i];
+        if (std::memchr(e.name, '\0', sizeof(e.name)) == nullptr || e.name[0] == '\0')
+            fail("имя тензора #" + std::to_string(i));
+        if (e.dtype > static_cast<uint32_t>(ckpt::DType::I32) || e.ndim > static_cast<uint32_t>(ckpt::kMaxDims))
+            fail(std::string("тип или размерность тензора ") + e.name);
+        uint64_t count = 1;
+        for (uint32_t d = 0; d < e.ndim; ++d) count *= e.shape[d];
+        if (count != e.count) fail(std::string("shape не согласован с count у ") + e.name);
+        if (e.offset % ckpt::kAlign != 0 || e.offset < h.data_offset
+            || e.count > (size_ - e.offset) / elementSize(e.dtype))
+            fail(std::string("данные тензора вне файла: ") + e.name);
+    }
+    if (verify && ckpt::crc32c(base_ + sizeof(ckpt::FileHeader), size_ - sizeof(ckpt::FileHeader)) != h.checksum)
+        fail("контрольная сумма не совпадает");
+}
+
+uint32_t MappedCheckpoint::version()     const { return header_->version; }
+size_t   MappedCheckpoint::tensorCount() const { return header_->tensor_count; }
+
+const ckpt::TensorEntry* MappedCheckpoint::find(const std::string& name) const {
+    for (uint32_t i = 0; i < header_->tensor_count; ++i)
+        if (name == table_[i].name) return &table_[i];
+    return nullptr;
+}
+
+std::vector<std::string> MappedCheckpoint::names() const {
+    std::vector<std::string> out;
+    for (uint32_t i = 0; i < header_->tensor_count; ++i) out.emplace_back(table_[i].name);
+    return out;
+}
+
+const void* MappedCheckpoint::data(const std::string& name, ckpt::DType dtype, size_t expected) const {
+    const ckpt::TensorEntry* e = find(name);
+    if (!e) throw std::runtime_error("В чекпоинте " + path_ + " нет тензора " + name);
+    if (e->dtype != static_cast<uint32_t>(dtype))
+        throw std::runtime_error("Тензор " + name + ": неожиданный тип данных");
+    if (e->count != expected)
+        throw std::runtime_error("Тензор " + name + ": " + std::to_string(e->count)
+                                 + " элементов, ожидалось " + std::to_string(expected));
+    return base_ + e->offset;
+}
+
+const float* MappedCheckpoint::floats(const std::string& name, size_t expected) const {
+    return static_cast<const float*>(data(name, ckpt::DType::F32, expected));
+}
+
+const int32_t* MappedCheckpoint::ints(const std::string& name, size_t expected) const {
+    return static_cast<const int32_t*>(data(name, ckpt::DType::I32, expected));
+}
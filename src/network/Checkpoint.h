@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Формат чекпоинта (версия 1), рассчитанный на mmap:
+ *
+ *   [FileHeader, 64 байта][TensorEntry × tensor_count][данные]
+ *
+ * Каждый тензор лежит со смещения, кратного 64 байтам, поэтому после
+ * mmap его можно читать на месте (в том числе выровненными AVX-512
+ * загрузками). checksum — CRC32C всех байт после заголовка.
+ * Числа — little-endian, как на всех поддерживаемых машинах.
+ */
+namespace ckpt {
+
+constexpr char     kMagic[8] = {'P', 'G', 'C', 'K', 'P', 'T', '\r', '\n'};
+constexpr uint32_t kVersion  = 1;
+constexpr size_t   kAlign    = 64;
+constexpr int      kMaxDims  = 6;
+
+enum class DType : uint32_t { F32 = 0, I32 = 1 };
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t tensor_count;
+    uint64_t table_offset;
+    uint64_t data_offset;
+    uint64_t file_size;
+    uint32_t checksum;
+    uint32_t header_size;
+    uint8_t  reserved[16];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader должен занимать 64 байта");
+
+struct TensorEntry {
+    char     name[64];          // NUL-терминированное имя
+    uint32_t dtype;             // DType
+    uint32_t ndim;
+    uint32_t shape[kMaxDims];
+    uint64_t offset;            // от начала файла, кратно kAlign
+    uint64_t count;             // число элементов = произведение shape
+    uint8_t  reserved[16];
+};
+static_assert(sizeof(TensorEntry) == 128, "TensorEntry должен занимать 128 байт");
+
+/// CRC32C (Castagnoli); SSE4.2, если доступен
+uint32_t crc32c(const void* data, size_t n, uint32_t crc = 0);
+
+} // namespace ckpt
+
+/**
+ * Сборка чекпоинта: тензоры добавляются по указателю (данные не
+ * копируются до serialize/write), затем образ файла собирается одним проходом.
+ *
+ * write() безопасен при падении: образ пишется во временный файл рядом,
+ * fsync, атомарный rename поверх path и fsync каталога — на диске всегда
+ * либо старый, либо новый чекпоинт целиком.
+ */
+class CheckpointWriter {
+public:
+    void add(const std::string& name, const std::vector<uint32_t>& shape, const float* data);
+    void add(const std::string& name, const std::vector<uint32_t>& shape, const int32_t* data);
+
+    void write(const std::string& path) const;
+
+    /// Образ файла в image (ёмкость переиспользуется); без checksum поле CRC
+    /// остаётся нулём — его дописывает seal(), например в фоновом потоке
+    void serialize(std::vector<uint8_t>& image, bool checksum = true) const;
+    static void seal(std::vector<uint8_t>& image);
+
+    /// Записать готовый образ: temp-файл, fsync, rename, fsync каталога
+    static void writeImage(const std::string& path, const std::vector<uint8_t>& image);
+
+private:
+    struct Item {
+        ckpt::TensorEntry entry;
+        const void*       data;
+    };
+    std::vector<Item> items_;
+
+    void addRaw(const std::string& name, const std::vector<uint32_t>& shape,
+                ckpt::DType dtype, const void* data);
+};
+
+/**
+ * Чекпоинт, отображённый в память только для чтения.
+ *
+ * Конструктор проверяет заголовок, таблицу (границы, выравнивание,
+ * согласованность shape и count) и, если verify, контрольную сумму —
+ * при любой ошибке бросает std::runtime_error. Указатели floats()/ints()
+ * смотрят прямо в отображение и живут, пока жив объект.
+ */
+class MappedCheckpoint {
+public:
+    explicit MappedCheckpoint(const std::string& path, bool verify = true);
+    ~MappedCheckpoint();
+
+    MappedCheckpoint(const MappedCheckpoint&) = delete;
+    MappedCheckpoint& operator=(const MappedCheckpoint&) = delete;
+
+    /// Начинается ли файл с сигнатуры этого формата (иначе — старый формат)
+    static bool isCheckpoint(const std::string& path);
+
+    uint32_t version()     const;
+    size_t   tensorCount() const;
+    size_t   fileSize()    const { return size_; }
+
+    /// Запись таблицы по имени или nullptr
+    const ckpt::TensorEntry* find(const std::string& name) const;
+    bool has(const std::string& name) const { return find(name) != nullptr; }
+    std::vector<std::string> names() const;
+
+    /// Данные тензора; бросает, если его нет, тип другой или count != expected
+    const float*   floats(const std::string& name, size_t expected) const;
+    const int32_t* ints(const std::string& name, size_t expected) const;
+
+private:
+    const uint8_t*           base_ = nullptr;
+    size_t                   size_ = 0;
+    const ckpt::FileHeader*  header_ = nullptr;
+    const ckpt::TensorEntry* table_  = nullptr;
+    std::string              path_;
+
+    const void* data(const std::string& name, ckpt::DType dtype, size_t expected) const;
+    void validate(bool verify) const;
+};
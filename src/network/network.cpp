@@ -1,4 +1,6 @@
 #include "network.h"
+#include "network/Checkpoint.h"
+#include <cstring>
 
 Network::Network()
     : conv1_(1, 16, 3, 3, 3, 1, 1, 1, Conv3D::Padding::SAME),
@@ -6,19 +8,38 @@ Network::Network()
       relu1_(),
       pool1_(2, 2, 2, 2, 2, 2, MaxPool3D::Padding::VALID),
       fc_(16 * 4 * 4 * 4, 10),
-      criterion_(),
-      optimizer_(0.01f, 0.9f)
+      criterion_()
 {
-    // Регистрация параметров в оптимизаторе
-    optimizer_.addParam(conv1_.weight(), conv1_.weightGrad());
-    optimizer_.addParam(conv1_.bias(),   conv1_.biasGrad());
-    optimizer_.addParam(bn1_.gamma(),    bn1_.grad_gamma());
-    optimizer_.addParam(bn1_.beta(),     bn1_.grad_beta());
-    optimizer_.addParam(fc_.weight(),    fc_.gradWeight());
-    optimizer_.addParam(fc_.bias(),      fc_.gradBias());
+    // Переносим параметры и градиенты слоёв в общую арену
+    auto params = parameters();
+    auto grads  = gradients();
+    for (auto* p : params) flat_size_ += p->size();
+    grad_offset_ = paddedSize(flat_size_);
+    arena_ = ParamBuffer(grad_offset_ + flat_size_);
+
+    size_t off = 0;
+    for (size_t i = 0; i < params.size(); ++i) {
+        const size_t n = params[i]->size();
+        params[i]->bind(arena_.data() + off);
+        grads[i]->bind(arena_.data() + grad_offset_ + off);
+        off += n;
+    }
+    setOptimizer(std::make_unique<SGD>(0.01f, 0.9f));
+}
+
+void Network::setOptimizer(std::unique_ptr<IOptimizer> opt) {
+    if (!opt) throw std::invalid_argument("Network::setOptimizer: пустой оптимизатор");
+    // Регистрируем тензоры подряд — оптимизатор обновит арену одним проходом
+    auto params = parameters();
+    auto grads  = gradients();
+    for (size_t i = 0; i < params.size(); ++i)
+        opt->addParam(params[i]->data(), grads[i]->data(), params[i]->size());
+    optimizer_ = std::move(opt);
 }
 
 std::vector<float> Network::forward(const Tensor3D& input, bool training) {
+    if (bf16_) return forwardBF16(input, training);
+    input_    = input;  // нужен свёртке в backward
     conv_out_ = conv1_.forward(input);
     bn_out_   = bn1_.forward(conv_out_, training);
     relu_out_ = relu1_.forward(bn_out_);
@@ -34,6 +55,7 @@ float Network::computeLoss(const std::vector<int>& labels) {
 void Network::backward() {
     auto grad_logits = criterion_.backward();
     auto grad_fc     = fc_.backward(grad_logits);
+    if (bf16_) return backwardBF16(grad_fc);
 
     Tensor3D grad_pool(pool_out_.depth(),
                        pool_out_.height(),
@@ -44,61 +66,169 @@ void Network::backward() {
     auto grad_relu = pool1_.backward(grad_pool);
     auto grad_bn   = relu1_.backward(grad_relu);
     auto grad_conv = bn1_.backward(grad_bn);
-    conv1_.backward(conv_out_, grad_conv);
+    conv1_.backward(input_, grad_conv);
+}
+
+std::vector<float> Network::forwardBF16(const Tensor3D& input, bool training) {
+    input16_.assign(input);
+    conv1_.forward(input16_, conv_out16_);
+    bn1_.forward(conv_out16_, training, bn_out16_);
+    relu1_.forward(bn_out16_, relu_out16_);
+    pool1_.forward(relu_out16_, pool_out16_);
+
+    // FC остаётся во float32: распаковываем только его вход
+    std::vector<float> flat(pool_out16_.size());
+    bf16::toFloat(pool_out16_.data(), flat.data(), flat.size());
+    fc_out_ = fc_.forward(flat);
+    return fc_out_;
+}
+
+void Network::backwardBF16(const std::vector<float>& grad_fc) {
+    grad_pool16_.resize(pool_out16_.depth(), pool_out16_.height(),
+                        pool_out16_.width(), pool_out16_.channels());
+    bf16::fromFloat(grad_fc.data(), grad_pool16_.data(), grad_fc.size());
+
+    pool1_.backward(grad_pool16_, grad_relu16_);
+    relu1_.backward(grad_relu16_, grad_bn16_);
+    bn1_.backward(conv_out16_, grad_bn16_, grad_conv16_);
+    conv1_.backwardParams(input16_, grad_conv16_);
 }
 
 void Network::optimize() {
-    optimizer_.step();
+    optimizer_->step();
 }
 
 void Network::zeroGrad() {
-    conv1_.zeroGrad();
-    bn1_.zeroGrad();
-    relu1_.zeroGrad();
-    pool1_.zeroGrad();
-    fc_.zeroGrad();
-    optimizer_.zeroGrad();
+    // Градиенты всех слоёв — один непрерывный кусок арены;
+    // у ReLU и MaxPool накопленных градиентов нет
+    std::memset(flatGradients(), 0, flat_size_ * sizeof(float));
+}
+
+std::vector<ParamBuffer*> Network::parameters() {
+    return { &conv1_.weight(), &conv1_.bias(),
+             &bn1_.gamma(),    &bn1_.beta(),
+             &fc_.weight(),    &fc_.bias() };
+}
+
+std::vector<ParamBuffer*> Network::gradients() {
+    return { &conv1_.weightGrad(), &conv1_.biasGrad(),
+             &bn1_.grad_gamma(),   &bn1_.grad_beta(),
+             &fc_.gradWeight(),    &fc_.gradBias() };
 }
 
 void Network::saveCheckpoint(const std::string& filepath) const {
-    std::ofstream out(filepath, std::ios::binary);
-    if (!out) throw std::runtime_error("Не удалось открыть файл для записи чекпоинта: " + filepath);
-
-    // Сериализуем conv1 weights и bias
-    auto writeVec = [&](const std::vector<float>& v) {
-        int n = static_cast<int>(v.size());
-        out.write(reinterpret_cast<const char*>(&n), sizeof(n));
-        out.write(reinterpret_cast<const char*>(v.data()), sizeof(float) * n);
+    withCheckpoint([&](const CheckpointWriter& w) { w.write(filepath); });
+}
+
+void Network::serializeCheckpoint(std::vector<uint8_t>& image, bool checksum) const {
+    withCheckpoint([&](const CheckpointWriter& w) { w.serialize(image, checksum); });
+}
+
+void Network::withCheckpoint(const std::function<void(const CheckpointWriter&)>& sink) const {
+    // Writer хранит указатели, поэтому локальные конфиги живут до вызова sink
+    CheckpointWriter w;
+    auto u = [](int v) { return static_cast<uint32_t>(v); };
+    auto len = [](const auto& v) { return static_cast<uint32_t>(v.size()); };
+
+    // Свёртка: веса [kD][kH][kW][in][out] и геометрия {sD, sH, sW, SAME}
+    const int32_t conv_cfg[] = { conv1_.strideD(), conv1_.strideH(), conv1_.strideW(),
+                                 conv1_.padding() == Conv3D::Padding::SAME };
+    w.add("conv1.weight", { u(conv1_.kernelD()), u(conv1_.kernelH()), u(conv1_.kernelW()),
+                            u(conv1_.inChannels()), u(conv1_.outChannels()) }, conv1_.weight().data());
+    w.add("conv1.bias",   { len(conv1_.bias()) }, conv1_.bias().data());
+    w.add("conv1.config", { 4 }, conv_cfg);
+
+    // BatchNorm: γ, β, running-статистики и eps
+    const float eps = bn1_.eps();
+    w.add("bn1.gamma",        { len(bn1_.gamma()) },       bn1_.gamma().data());
+    w.add("bn1.beta",         { len(bn1_.beta()) },        bn1_.beta().data());
+    w.add("bn1.running_mean", { len(bn1_.runningMean()) }, bn1_.runningMean().data());
+    w.add("bn1.running_var",  { len(bn1_.runningVar()) },  bn1_.runningVar().data());
+    w.add("bn1.eps",          { 1 }, &eps);
+
+    // MaxPool: {kD, kH, kW, sD, sH, sW, SAME}
+    const int32_t pool_cfg[] = { pool1_.kernelD(), pool1_.kernelH(), pool1_.kernelW(),
+                                 pool1_.strideD(), pool1_.strideH(), pool1_.strideW(),
+                                 pool1_.padding() == MaxPool3D::Padding::SAME };
+    w.add("pool1.config", { 7 }, pool_cfg);
+
+    // FullyConnected: веса [out][in]
+    w.add("fc.weight", { u(fc_.outFeatures()), u(fc_.inFeatures()) }, fc_.weight().data());
+    w.add("fc.bias",   { len(fc_.bias()) }, fc_.bias().data());
+
+    // Состояние оптимизатора: тип (коды символов имени), счётчик шагов
+    // {младшие, старшие 32 бита} и буферы моментов — optimizer.state.<i>
+    const std::string opt_name = optimizer_->name();
+    const std::vector<int32_t> opt_type(opt_name.begin(), opt_name.end());
+    const uint64_t t = static_cast<uint64_t>(optimizer_->steps());
+    const int32_t opt_step[] = { static_cast<int32_t>(t & 0xffffffffu), static_cast<int32_t>(t >> 32) };
+    w.add("optimizer.type", { len(opt_type) }, opt_type.data());
+    w.add("optimizer.step", { 2 }, opt_step);
+    auto states = optimizer_->getStateBuffers();
+    for (size_t i = 0; i < states.size(); ++i)
+        w.add("optimizer.state." + std::to_string(i), { len(states[i]) }, states[i].data());
+
+    sink(w);
+}
+
+void Network::loadCheckpoint(const std::string& filepath) {
+    if (!MappedCheckpoint::isCheckpoint(filepath)) return loadLegacyCheckpoint(filepath);
+
+    MappedCheckpoint ck(filepath);
+    // Буферы разных оптимизаторов могут совпасть по форме (LARS и SGD),
+    // поэтому тип сверяется по имени
+    if (const auto* e = ck.find("optimizer.type")) {
+        const int32_t* p = ck.ints(e->name, e->count);
+        const std::string saved(p, p + e->count);
+        if (saved != optimizer_->name())
+            throw std::runtime_error("Чекпоинт " + filepath + " сохранён оптимизатором " + saved +
+                                     ", а у сети " + optimizer_->name());
+    }
+
+    auto read = [&](const char* name, auto& v) {
+        const float* p = ck.floats(name, v.size());
+        std::copy(p, p + v.size(), v.begin());
     };
-    writeVec(conv1_.weight());
-    writeVec(conv1_.bias());
-
-    // Сериализуем BatchNorm γ и β
-    writeVec(bn1_.gamma());
-    writeVec(bn1_.beta());
-
-    // Сериализуем FullyConnected weights и bias
-    writeVec(fc_.weight());
-    writeVec(fc_.bias());
-
-    // Сериализуем состояние оптимизатора (velocity buffers)
-    auto vels = optimizer_.getVelocityStates();
-    int m = static_cast<int>(vels.size());
-    out.write(reinterpret_cast<const char*>(&m), sizeof(m));
-    for (const auto& vel : vels) {
-        writeVec(vel);
+    read("conv1.weight", conv1_.weight());
+    read("conv1.bias",   conv1_.bias());
+    read("bn1.gamma",    bn1_.gamma());
+    read("bn1.beta",     bn1_.beta());
+    read("bn1.running_mean", bn1_.runningMean());
+    read("bn1.running_var",  bn1_.runningVar());
+    read("fc.weight",    fc_.weight());
+    read("fc.bias",      fc_.bias());
+
+    std::vector<std::vector<float>> states;
+    for (size_t i = 0; ; ++i) {
+        const auto* e = ck.find("optimizer.state." + std::to_string(i));
+        if (!e) break;
+        const float* p = ck.floats(e->name, e->count);
+        states.emplace_back(p, p + e->count);
+    }
+    optimizer_->setStateBuffers(states);
+    if (ck.has("optimizer.step")) {
+        const auto* t = reinterpret_cast<const uint32_t*>(ck.ints("optimizer.step", 2));
+        optimizer_->setSteps(static_cast<long long>(static_cast<uint64_t>(t[1]) << 32 | t[0]));
     }
 }
 
-void Network::loadCheckpoint(const std::string& filepath) {
+void Network::loadLegacyCheckpoint(const std::string& filepath) {
+    // Старый формат: int-длина + float-данные в фиксированном порядке
     std::ifstream in(filepath, std::ios::binary);
     if (!in) throw std::runtime_error("Не удалось открыть файл для чтения чекпоинта: " + filepath);
 
-    auto readVec = [&](std::vector<float>& v) {
-        int n;
+    auto readCount = [&](size_t limit) {
+        int n = -1;
         in.read(reinterpret_cast<char*>(&n), sizeof(n));
-        v.resize(n);
-        in.read(reinterpret_cast<char*>(v.data()), sizeof(float) * n);
+        if (!in || n < 0 || static_cast<size_t>(n) > limit)
+            throw std::runtime_error("Чекпоинт повреждён: " + filepath);
+        return static_cast<size_t>(n);
+    };
+    auto readVec = [&](auto& v) {
+        if (readCount(v.size()) != v.size())
+            throw std::runtime_error("Чекпоинт не подходит к архитектуре сети: " + filepath);
+        in.read(reinterpret_cast<char*>(v.data()), sizeof(float) * v.size());
+        if (!in) throw std::runtime_error("Чекпоинт обрезан: " + filepath);
     };
     readVec(conv1_.weight());
     readVec(conv1_.bias());
@@ -110,14 +240,12 @@ void Network::loadCheckpoint(const std::string& filepath) {
     readVec(fc_.bias());
 
     // Восстанавливаем состояние оптимизатора
-    int m;
-    in.read(reinterpret_cast<char*>(&m), sizeof(m));
-    std::vector<std::vector<float>> vels;
-    vels.reserve(m);
-    for (int i = 0; i < m; ++i) {
-        std::vector<float> vel;
-        readVec(vel);
-        vels.push_back(std::move(vel));
+    const size_t m = readCount(64);
+    std::vector<std::vector<float>> vels(m);
+    for (auto& vel : vels) {
+        vel.resize(readCount(flat_size_));
+        in.read(reinterpret_cast<char*>(vel.data()), sizeof(float) * vel.size());
+        if (!in) throw std::runtime_error("Чекпоинт обрезан: " + filepath);
     }
-    optimizer_.setVelocityStates(vels);
+    optimizer_->setStateBuffers(vels);
 }
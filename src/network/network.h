@@ -14,14 +14,28 @@
 #include "layers/FullyConnected.h"
 #include "layers/SoftmaxCrossEntropy.h"
 #include "optim/SGD.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+class CheckpointWriter;
 
 /**
- * Обёртка над всей 3D-CNN + оптимизатор SGD с моментом.
+ * Обёртка над всей 3D-CNN + оптимизатор (по умолчанию SGD с моментом).
+ *
+ * Параметры всех слоёв лежат подряд в одной выровненной арене, градиенты —
+ * во второй её половине в том же порядке; буферы слоёв — виды на арену.
+ * Поэтому шаг оптимизатора и zeroGrad — по одному проходу, а all-reduce
+ * и рассылка весов работают с одним непрерывным буфером.
  */
 class Network {
 public:
     Network();
 
+    // Буферы слоёв указывают в арену — копировать нельзя
+    Network(const Network&) = delete;
+    Network& operator=(const Network&) = delete;
+
     // Прямой проход: input → логиты
     std::vector<float> forward(const Tensor3D& input, bool training = true);
 
@@ -34,13 +48,44 @@ public:
     // Шаг оптимизации
     void optimize();
 
+    // Заменить оптимизатор (параметры регистрируются в нём заново).
+    // Состояние в чекпоинте привязано к типу оптимизатора.
+    void setOptimizer(std::unique_ptr<IOptimizer> opt);
+    IOptimizer& optimizer() { return *optimizer_; }
+
+    // Смешанная точность: активации conv/bn/relu/pool и их градиенты
+    // хранятся в bf16, веса, градиенты весов и FC — во float32
+    void setBF16Activations(bool on) { bf16_ = on; }
+    bool bf16Activations() const { return bf16_; }
+
     // Сброс всех градиентов в слоях и оптимизаторе
     void zeroGrad();
 
-    // Сохранение и загрузка состояния (чекпоинт)
+    // Сохранение и загрузка состояния (чекпоинт, формат network/Checkpoint.h).
+    // loadCheckpoint читает и старый формат без заголовка.
     void saveCheckpoint(const std::string& filepath) const;
     void loadCheckpoint(const std::string& filepath);
 
+    // Образ файла чекпоинта в памяти (для фоновой записи, см. AsyncCheckpointer)
+    void serializeCheckpoint(std::vector<uint8_t>& image, bool checksum = true) const;
+
+    // Все обучаемые параметры и их градиенты, в порядке регистрации в оптимизаторе
+    std::vector<ParamBuffer*> parameters();
+    std::vector<ParamBuffer*> gradients();
+
+    // Те же параметры и градиенты одним непрерывным буфером из flatSize() float
+    float*       flatParameters()       { return arena_.data(); }
+    const float* flatParameters() const { return arena_.data(); }
+    float*       flatGradients()        { return arena_.data() + grad_offset_; }
+    const float* flatGradients()  const { return arena_.data() + grad_offset_; }
+    size_t       flatSize()       const { return flat_size_; }
+
+    // Доступ к слоям только для чтения (экспорт весов, инференс)
+    const Conv3D&         conv1() const { return conv1_; }
+    const BatchNorm3D&    bn1()   const { return bn1_; }
+    const MaxPool3D&      pool1() const { return pool1_; }
+    const FullyConnected& fc()    const { return fc_; }
+
 private:
     Conv3D              conv1_;
     BatchNorm3D         bn1_;
@@ -48,9 +93,24 @@ private:
     MaxPool3D           pool1_;
     FullyConnected      fc_;
     SoftmaxCrossEntropy criterion_;
-    SGD                 optimizer_;
+    std::unique_ptr<IOptimizer> optimizer_;
+
+    ParamBuffer         arena_;            // [параметры | выравнивание | градиенты]
+    size_t              flat_size_   = 0;
+    size_t              grad_offset_ = 0;
 
     // Буферы для промежуточных результатов
-    Tensor3D            conv_out_, bn_out_, relu_out_, pool_out_;
+    Tensor3D            input_, conv_out_, bn_out_, relu_out_, pool_out_;
     std::vector<float>  fc_out_;
+
+    // Режим bf16: те же активации и градиенты по ним, буферы переиспользуются
+    bool                bf16_ = false;
+    Tensor3DBF16        input16_, conv_out16_, bn_out16_, relu_out16_, pool_out16_;
+    Tensor3DBF16        grad_pool16_, grad_relu16_, grad_bn16_, grad_conv16_;
+
+    void                loadLegacyCheckpoint(const std::string& filepath);
+    void                withCheckpoint(const std::function<void(const CheckpointWriter&)>& sink) const;
+
+    std::vector<float>  forwardBF16(const Tensor3D& input, bool training);
+    void                backwardBF16(const std::vector<float>& grad_fc);
 };
@@ -0,0 +1,68 @@
+#include "Adam.h"
+#include "utils/Simd.h"
+#include <cmath>
+
+Adam::Adam(float learning_rate, float beta1, float beta2, float eps,
+           float weight_decay, bool decoupled)
+    : lr_(learning_rate), beta1_(beta1), beta2_(beta2), eps_(eps),
+      wd_(weight_decay), decoupled_(decoupled)
+{
+    if (lr_ <= 0.0f)
+        throw std::invalid_argument("Adam: learning_rate должен быть > 0");
+    if (beta1_ < 0.0f || beta1_ >= 1.0f || beta2_ < 0.0f || beta2_ >= 1.0f)
+        throw std::invalid_argument("Adam: beta1 и beta2 должны быть в [0, 1)");
+    if (eps_ <= 0.0f)
+        throw std::invalid_argument("Adam: eps должен быть > 0");
+    if (wd_ < 0.0f)
+        throw std::invalid_argument("Adam: weight_decay должен быть >= 0");
+}
+
+void Adam::addParam(float* param, float* grad, size_t n) {
+    params_.add(param, grad, n);
+    m_.resize(params_.total());
+    v_.resize(params_.total());
+}
+
+void Adam::step() {
+    ++t_;
+    // Поправки смещения считаем в double: при beta2 = 0.999 и малых t
+    // 1 - beta2^t теряет точность во float
+    const double bc1 = 1.0 - std::pow(double(beta1_), double(t_));
+    const double bc2 = 1.0 - std::pow(double(beta2_), double(t_));
+    const float step_size    = static_cast<float>(lr_ / bc1);
+    const float inv_sqrt_bc2 = static_cast<float>(1.0 / std::sqrt(bc2));
+    const float l2    = decoupled_ ? 0.0f : wd_;
+    const float decay = decoupled_ ? lr_ * wd_ : 0.0f;
+
+    float* m = m_.data();
+    float* v = v_.data();
+    params_.forEachRange([&](float* p, const float* g, size_t off, size_t n) {
+        simd::adam(p, g, m + off, v + off, n, step_size, inv_sqrt_bc2,
+                   beta1_, beta2_, eps_, l2, decay);
+    });
+}
+
+void Adam::zeroGrad() {
+    params_.zeroGrad();
+}
+
+void Adam::zeroState() {
+    std::fill(m_.begin(), m_.end(), 0.0f);
+    std::fill(v_.begin(), v_.end(), 0.0f);
+    t_ = 0;
+}
+
+std::vector<std::vector<float>> Adam::getStateBuffers() const {
+    auto out = params_.split(m_);
+    auto vs  = params_.split(v_);
+    out.insert(out.end(), vs.begin(), vs.end());
+    return out;
+}
+
+void Adam::setStateBuffers(const std::vector<std::vector<float>>& states) {
+    const size_t K = params_.blocks().size();
+    if (states.size() != 2 * K)
+        throw std::runtime_error("Adam::setStateBuffers: количество буферов не совпадает");
+    if (!params_.merge(states, 0, m_) || !params_.merge(states, K, v_))
+        throw std::runtime_error("Adam::setStateBuffers: размер внутреннего буфера не совпадает");
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "IOptimizer.h"
+#include "ParamBlocks.h"
+#include <vector>
+#include <stdexcept>
+
+/**
+ * Adam (Kingma & Ba) с поправкой смещения моментов.
+ *
+ * Первый и второй моменты всех параметров лежат подряд в двух выровненных
+ * массивах; шаг — один векторный проход (моменты, поправка, затухание
+ * весов и обновление за одно чтение каждого элемента), для арены Network
+ * поделённый между потоками.
+ *
+ * weight_decay при decoupled = false добавляется к градиенту как L2-штраф
+ * (классический Adam), при decoupled = true — уменьшает веса напрямую
+ * на lr*wd*p (AdamW, Loshchilov & Hutter).
+ */
+class Adam : public IOptimizer {
+public:
+    Adam(float learning_rate = 1e-3f,
+         float beta1 = 0.9f, float beta2 = 0.999f, float eps = 1e-8f,
+         float weight_decay = 0.0f, bool decoupled = false);
+
+    using IOptimizer::addParam;
+    void addParam(float* param, float* grad, size_t n) override;
+
+    void step() override;
+    void zeroGrad() override;
+
+    // Сброс моментов и счётчика шагов
+    void zeroState();
+
+    // Число потоков для шага (<= 0 — по размеру задачи)
+    void setThreads(int n) { params_.setThreads(n); }
+
+    /// Сколько шагов сделано (для поправки смещения)
+    long long steps() const override { return t_; }
+    void setSteps(long long t) override { t_ = t; }
+
+    const char* name() const override { return decoupled_ ? "AdamW" : "Adam"; }
+
+    /**
+     * Состояние для чекпоинта: буферы m по тензорам, затем v по тензорам.
+     * Счётчик шагов — отдельно, через steps()/setSteps().
+     */
+    std::vector<std::vector<float>> getStateBuffers() const override;
+    void setStateBuffers(const std::vector<std::vector<float>>& states) override;
+
+private:
+    float lr_, beta1_, beta2_, eps_, wd_;
+    bool  decoupled_;
+    long long t_ = 0;
+
+    ParamBlocks params_;
+    ParamBuffer m_, v_;
+};
+
+/// AdamW: Adam с развязанным затуханием весов
+class AdamW : public Adam {
+public:
+    AdamW(float learning_rate = 1e-3f,
+          float beta1 = 0.9f, float beta2 = 0.999f, float eps = 1e-8f,
+          float weight_decay = 1e-2f)
+        : Adam(learning_rate, beta1, beta2, eps, weight_decay, /*decoupled=*/true) {}
+};
@@ -1,6 +1,8 @@
 #ifndef IOPTIMIZER_H
 #define IOPTIMIZER_H
 
+#include <cstddef>
+#include <stdexcept>
 #include <vector>
 
 /**
@@ -13,11 +15,21 @@ class IOptimizer {
 public:
     /**
      * \brief Зарегистрировать параметры и соответствующие им градиенты.
-     * \param param Ссылка на вектор параметров.
-     * \param grad Ссылка на вектор градиентов тех же размеров.
+     * \param param Указатель на n параметров.
+     * \param grad Указатель на n градиентов.
+     * \param n Число элементов.
+     *
+     * Память должна жить дольше оптимизатора. Тензоры, зарегистрированные
+     * подряд из одной арены, оптимизатор может обновлять одним проходом.
      */
-    virtual void addParam(std::vector<float>& param,
-                          std::vector<float>& grad) = 0;
+    virtual void addParam(float* param, float* grad, size_t n) = 0;
+
+    /// То же для пары векторов одного размера
+    void addParam(std::vector<float>& param, std::vector<float>& grad) {
+        if (param.size() != grad.size())
+            throw std::invalid_argument("IOptimizer::addParam: размеры param и grad должны совпадать");
+        addParam(param.data(), grad.data(), param.size());
+    }
 
     /**
      * \brief Сделать один шаг обновления всех зарегистрированных параметров.
@@ -29,6 +41,23 @@ public:
      */
     virtual void zeroGrad() = 0;
 
+    /**
+     * \brief Внутреннее состояние (моменты и т.п.) для сохранения в чекпоинт.
+     *
+     * Набор и порядок буферов определяет реализация; setStateBuffers
+     * принимает ровно то, что вернул getStateBuffers оптимизатора того же
+     * типа с теми же параметрами.
+     */
+    virtual std::vector<std::vector<float>> getStateBuffers() const = 0;
+    virtual void setStateBuffers(const std::vector<std::vector<float>>& states) = 0;
+
+    /// Имя типа («SGD», «Adam», …): чекпоинт загружается только в оптимизатор того же типа
+    virtual const char* name() const = 0;
+
+    /// Счётчик шагов (у оптимизаторов без поправки смещения — всегда 0)
+    virtual long long steps() const { return 0; }
+    virtual void setSteps(long long) {}
+
     virtual ~IOptimizer() = default;
 };
 
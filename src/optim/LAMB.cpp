@@ -0,0 +1,72 @@
+#include "LAMB.h"
+#include "utils/Simd.h"
+#include <cmath>
+
+LAMB::LAMB(float learning_rate, float beta1, float beta2, float eps, float weight_decay)
+    : lr_(learning_rate), beta1_(beta1), beta2_(beta2), eps_(eps), wd_(weight_decay)
+{
+    if (lr_ <= 0.0f)
+        throw std::invalid_argument("LAMB: learning_rate должен быть > 0");
+    if (beta1_ < 0.0f || beta1_ >= 1.0f || beta2_ < 0.0f || beta2_ >= 1.0f)
+        throw std::invalid_argument("LAMB: beta1 и beta2 должны быть в [0, 1)");
+    if (eps_ <= 0.0f)
+        throw std::invalid_argument("LAMB: eps должен быть > 0");
+    if (wd_ < 0.0f)
+        throw std::invalid_argument("LAMB: weight_decay должен быть >= 0");
+}
+
+void LAMB::addParam(float* param, float* grad, size_t n) {
+    params_.add(param, grad, n);
+    m_.resize(params_.total());
+    v_.resize(params_.total());
+    update_.resize(params_.total());
+    trust_.push_back(1.0f);
+}
+
+void LAMB::step() {
+    ++t_;
+    const double bc1 = 1.0 - std::pow(double(beta1_), double(t_));
+    const double bc2 = 1.0 - std::pow(double(beta2_), double(t_));
+    const float inv_bc1      = static_cast<float>(1.0 / bc1);
+    const float inv_sqrt_bc2 = static_cast<float>(1.0 / std::sqrt(bc2));
+
+    float* m = m_.data();
+    float* v = v_.data();
+    float* r = update_.data();
+    const auto& blocks = params_.blocks();
+    params_.forEachBlock([&](const ParamBlocks::Block& b) {
+        const double rn2 = simd::lambDirection(b.param, b.grad, m + b.offset, v + b.offset,
+                                               r + b.offset, b.size, beta1_, beta2_,
+                                               inv_bc1, inv_sqrt_bc2, eps_, wd_);
+        const double wn = std::sqrt(simd::sumSquares(b.param, b.size));
+        const double rn = std::sqrt(rn2);
+        double trust = (wn > 0.0 && rn > 0.0) ? wn / rn : 1.0;
+        trust_[&b - blocks.data()] = static_cast<float>(trust);
+        simd::axpy(b.param, static_cast<float>(-lr_ * trust), r + b.offset, b.size);
+    });
+}
+
+void LAMB::zeroGrad() {
+    params_.zeroGrad();
+}
+
+void LAMB::zeroState() {
+    std::fill(m_.begin(), m_.end(), 0.0f);
+    std::fill(v_.begin(), v_.end(), 0.0f);
+    t_ = 0;
+}
+
+std::vector<std::vector<float>> LAMB::getStateBuffers() const {
+    auto out = params_.split(m_);
+    auto vs  = params_.split(v_);
+    out.insert(out.end(), vs.begin(), vs.end());
+    return out;
+}
+
+void LAMB::setStateBuffers(const std::vector<std::vector<float>>& states) {
+    const size_t K = params_.blocks().size();
+    if (states.size() != 2 * K)
+        throw std::runtime_error("LAMB::setStateBuffers: количество буферов не совпадает");
+    if (!params_.merge(states, 0, m_) || !params_.merge(states, K, v_))
+        throw std::runtime_error("LAMB::setStateBuffers: размер внутреннего буфера не совпадает");
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "IOptimizer.h"
+#include "ParamBlocks.h"
+#include <vector>
+#include <stdexcept>
+
+/**
+ * LAMB (You et al., 2019): Adam с развязанным затуханием весов, где
+ * направление обновления каждого тензора
+ *   r = m̂ / (sqrt(v̂) + eps) + wd*w
+ * масштабируется доверительным коэффициентом trust = ||w|| / ||r||
+ * (1, если одна из норм нулевая): w -= lr * trust * r.
+ *
+ * Моменты и направление считаются одним векторным проходом по тензору
+ * (с накоплением ||r||²), затем второй проход применяет шаг. Тензоры —
+ * те, что пришли через addParam, обрабатываются параллельно.
+ */
+class LAMB : public IOptimizer {
+public:
+    LAMB(float learning_rate = 1e-3f,
+         float beta1 = 0.9f, float beta2 = 0.999f, float eps = 1e-6f,
+         float weight_decay = 1e-2f);
+
+    using IOptimizer::addParam;
+    void addParam(float* param, float* grad, size_t n) override;
+
+    void step() override;
+    void zeroGrad() override;
+
+    void zeroState();
+    void setThreads(int n) { params_.setThreads(n); }
+
+    long long steps() const override { return t_; }
+    void setSteps(long long t) override { t_ = t; }
+
+    const char* name() const override { return "LAMB"; }
+
+    /// Доверительные коэффициенты последнего шага по тензорам
+    const std::vector<float>& trustRatios() const { return trust_; }
+
+    // Состояние: m по тензорам, v по тензорам (как у Adam)
+    std::vector<std::vector<float>> getStateBuffers() const override;
+    void setStateBuffers(const std::vector<std::vector<float>>& states) override;
+
+private:
+    float lr_, beta1_, beta2_, eps_, wd_;
+    long long t_ = 0;
+
+    ParamBlocks        params_;
+    ParamBuffer        m_, v_;
+    ParamBuffer        update_;  // направление r, только внутри step()
+    std::vector<float> trust_;
+};
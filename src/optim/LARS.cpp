@@ -0,0 +1,55 @@
+#include "LARS.h"
+#include "utils/Simd.h"
+#include <cmath>
+
+LARS::LARS(float learning_rate, float momentum, float weight_decay, float trust_coef)
+    : lr_(learning_rate), momentum_(momentum), wd_(weight_decay), eta_(trust_coef)
+{
+    if (lr_ <= 0.0f)
+        throw std::invalid_argument("LARS: learning_rate должен быть > 0");
+    if (momentum_ < 0.0f || momentum_ >= 1.0f)
+        throw std::invalid_argument("LARS: momentum должен быть в [0, 1)");
+    if (wd_ < 0.0f)
+        throw std::invalid_argument("LARS: weight_decay должен быть >= 0");
+    if (eta_ <= 0.0f)
+        throw std::invalid_argument("LARS: trust_coef должен быть > 0");
+}
+
+void LARS::addParam(float* param, float* grad, size_t n) {
+    params_.add(param, grad, n);
+    velocity_.resize(params_.total());
+    trust_.push_back(1.0f);
+}
+
+void LARS::step() {
+    float* v = velocity_.data();
+    const auto& blocks = params_.blocks();
+    params_.forEachBlock([&](const ParamBlocks::Block& b) {
+        const double wn = std::sqrt(simd::sumSquares(b.param, b.size));
+        const double gn = std::sqrt(simd::sumSquares(b.grad, b.size));
+        double trust = 1.0;
+        if (wn > 0.0 && gn > 0.0) trust = eta_ * wn / (gn + wd_ * wn);
+        trust_[&b - blocks.data()] = static_cast<float>(trust);
+        simd::larsMomentum(b.param, b.grad, v + b.offset, b.size,
+                           static_cast<float>(lr_ * trust), momentum_, wd_);
+    });
+}
+
+void LARS::zeroGrad() {
+    params_.zeroGrad();
+}
+
+void LARS::zeroState() {
+    std::fill(velocity_.begin(), velocity_.end(), 0.0f);
+}
+
+std::vector<std::vector<float>> LARS::getStateBuffers() const {
+    return params_.split(velocity_);
+}
+
+void LARS::setStateBuffers(const std::vector<std::vector<float>>& states) {
+    if (states.size() != params_.blocks().size())
+        throw std::runtime_error("LARS::setStateBuffers: количество буферов не совпадает");
+    if (!params_.merge(states, 0, velocity_))
+        throw std::runtime_error("LARS::setStateBuffers: размер внутреннего буфера не совпадает");
+}
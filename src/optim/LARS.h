@@ -0,0 +1,49 @@
+#pragma once
+
+#include "IOptimizer.h"
+#include "ParamBlocks.h"
+#include <vector>
+#include <stdexcept>
+
+/**
+ * LARS (You, Gitman, Ginsburg, 2017): SGD с моментом, где шаг каждого
+ * тензора масштабируется доверительным коэффициентом
+ *   trust = eta * ||w|| / (||g|| + wd*||w||)
+ * (1, если одна из норм нулевая). Это выравнивает относительный размер
+ * шага по слоям и позволяет большие батчи при линейном росте lr.
+ *
+ * Тензоры — те, что пришли через addParam (для Network: веса и bias
+ * каждого слоя отдельно). Нормы считаются векторно, тензоры
+ * обрабатываются параллельно.
+ */
+class LARS : public IOptimizer {
+public:
+    LARS(float learning_rate = 0.1f, float momentum = 0.9f,
+         float weight_decay = 0.0f, float trust_coef = 0.02f);
+
+    using IOptimizer::addParam;
+    void addParam(float* param, float* grad, size_t n) override;
+
+    // v = momentum*v + lr*trust*(g + wd*w); w -= v
+    void step() override;
+    void zeroGrad() override;
+
+    void zeroState();
+    void setThreads(int n) { params_.setThreads(n); }
+
+    /// Доверительные коэффициенты последнего шага по тензорам
+    const std::vector<float>& trustRatios() const { return trust_; }
+
+    // Состояние для чекпоинта — буферы момента по тензорам
+    std::vector<std::vector<float>> getStateBuffers() const override;
+    void setStateBuffers(const std::vector<std::vector<float>>& states) override;
+
+    const char* name() const override { return "LARS"; }
+
+private:
+    float lr_, momentum_, wd_, eta_;
+
+    ParamBlocks        params_;
+    ParamBuffer        velocity_;
+    std::vector<float> trust_;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "net/ParamBuffer.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/**
+ * Зарегистрированные в оптимизаторе тензоры и их смещения в плоских
+ * буферах состояния оптимизатора (моменты лежат подряд, как тензоры
+ * при регистрации).
+ *
+ * Если все param (и все grad) тоже лежат подряд — как в арене Network, —
+ * forEachRange отдаёт весь объём одним диапазоном, порезанным между
+ * потоками; иначе — по тензору.
+ */
+class ParamBlocks {
+public:
+    struct Block {
+        float* param;
+        float* grad;
+        size_t size;
+        size_t offset;  // начало в буферах состояния
+    };
+
+    void add(float* param, float* grad, size_t n) {
+        if (!blocks_.empty()) {
+            const Block& last = blocks_.back();
+            contiguous_ = contiguous_ && param == last.param + last.size && grad == last.grad + last.size;
+        }
+        blocks_.push_back({param, grad, n, total_});
+        total_ += n;
+    }
+
+    const std::vector<Block>& blocks() const { return blocks_; }
+    size_t total()      const { return total_; }
+    bool   contiguous() const { return contiguous_; }
+    bool   empty()      const { return blocks_.empty(); }
+
+    /// threads <= 0 — по размеру задачи (не меньше kMinPerThread float на поток)
+    void setThreads(int n) { threads_ = n; }
+
+    /**
+     * fn(param, grad, offset, n) по всем параметрам. Для непрерывной арены —
+     * куски по целым строкам кэша в нескольких потоках.
+     */
+    template <class Fn>
+    void forEachRange(Fn&& fn) const {
+        if (blocks_.empty()) return;
+        if (!contiguous_) {
+            for (const auto& b : blocks_) fn(b.param, b.grad, b.offset, b.size);
+            return;
+        }
+        float* p = blocks_.front().param;
+        float* g = blocks_.front().grad;
+        const size_t n = total_;
+        size_t lines = (n + kParamAlign - 1) / kParamAlign;
+        parallelFor(lines, threadCount(), [&](size_t b, size_t e, int) {
+            size_t lo = b * kParamAlign, hi = std::min(n, e * kParamAlign);
+            fn(p + lo, g + lo, lo, hi - lo);
+        });
+    }
+
+    /**
+     * fn(block) по каждому тензору целиком (для оптимизаторов с нормами
+     * по тензору); тензоры делятся между потоками.
+     */
+    template <class Fn>
+    void forEachBlock(Fn&& fn) const {
+        parallelFor(blocks_.size(), threadCount(), [&](size_t b, size_t e, int) {
+            for (size_t i = b; i < e; ++i) fn(blocks_[i]);
+        });
+    }
+
+    /// Обнулить все градиенты (для непрерывной арены — один memset)
+    void zeroGrad() const {
+        if (blocks_.empty()) return;
+        if (contiguous_) {
+            std::memset(blocks_.front().grad, 0, total_ * sizeof(float));
+            return;
+        }
+        for (const auto& b : blocks_) std::fill(b.grad, b.grad + b.size, 0.0f);
+    }
+
+    /// Копии кусков плоского буфера состояния по тензорам (для чекпоинта)
+    std::vector<std::vector<float>> split(const ParamBuffer& state) const {
+        std::vector<std::vector<float>> out;
+        out.reserve(blocks_.size());
+        for (const auto& b : blocks_)
+            out.emplace_back(state.data() + b.offset, state.data() + b.offset + b.size);
+        return out;
+    }
+
+    /// Обратное к split; false, если число или размеры буферов не совпадают
+    bool merge(const std::vector<std::vector<float>>& parts, size_t first, ParamBuffer& state) const {
+        if (parts.size() < first + blocks_.size()) return false;
+        for (size_t i = 0; i < blocks_.size(); ++i)
+            if (parts[first + i].size() != blocks_[i].size) return false;
+        for (size_t i = 0; i < blocks_.size(); ++i)
+            std::copy(parts[first + i].begin(), parts[first + i].end(), state.data() + blocks_[i].offset);
+        return true;
+    }
+
+    // Меньше этого числа float на поток шаг не делится: поток дороже обновления
+    static constexpr size_t kMinPerThread = size_t(1) << 15;
+
+private:
+    int threadCount() const {
+        if (threads_ > 0) return threads_;
+        return static_cast<int>(std::max<size_t>(1, std::min<size_t>(defaultThreadCount(),
+                                                                     total_ / kMinPerThread)));
+    }
+
+    std::vector<Block> blocks_;
+    size_t total_      = 0;
+    bool   contiguous_ = true;
+    int    threads_    = 0;
+};
@@ -1,4 +1,5 @@
 #include "SGD.h"
+#include "utils/Simd.h"
 
 SGD::SGD(float learning_rate, float momentum)
     : lr_(learning_rate), momentum_(momentum)
@@ -9,49 +10,33 @@ SGD::SGD(float learning_rate, float momentum)
         throw std::invalid_argument("SGD: momentum должен быть в [0, 1)");
 }
 
-void SGD::addParam(std::vector<float>& param, std::vector<float>& grad) {
-    if (param.size() != grad.size())
-        throw std::invalid_argument("SGD::addParam: размеры param и grad должны совпадать");
-    ParamState st;
-    st.param    = &param;
-    st.grad     = &grad;
-    st.velocity.assign(param.size(), 0.0f);
-    states_.push_back(std::move(st));
+void SGD::addParam(float* param, float* grad, size_t n) {
+    params_.add(param, grad, n);
+    velocity_.resize(params_.total());
 }
 
 void SGD::step() {
-    for (auto& st : states_) {
-        auto& p = *st.param;
-        auto& g = *st.grad;
-        auto& v = st.velocity;
-        for (size_t i = 0; i < p.size(); ++i) {
-            v[i] = momentum_ * v[i] - lr_ * g[i];
-            p[i] += v[i];
-        }
-    }
+    float* v = velocity_.data();
+    params_.forEachRange([&](float* p, const float* g, size_t off, size_t n) {
+        simd::sgdMomentum(p, g, v + off, n, lr_, momentum_);
+    });
 }
 
 void SGD::zeroGrad() {
-    for (auto& st : states_) {
-        std::fill(st.grad->begin(), st.grad->end(), 0.0f);
-    }
+    params_.zeroGrad();
+}
+
+void SGD::zeroState() {
+    std::fill(velocity_.begin(), velocity_.end(), 0.0f);
 }
 
 std::vector<std::vector<float>> SGD::getVelocityStates() const {
-    std::vector<std::vector<float>> vels;
-    vels.reserve(states_.size());
-    for (const auto& st : states_) {
-        vels.push_back(st.velocity);
-    }
-    return vels;
+    return params_.split(velocity_);
 }
 
 void SGD::setVelocityStates(const std::vector<std::vector<float>>& vel_states) {
-    if (vel_states.size() != states_.size())
+    if (vel_states.size() != params_.blocks().size())
         throw std::runtime_error("SGD::setVelocityStates: количество буферов не совпадает");
-    for (size_t i = 0; i < states_.size(); ++i) {
-        if (vel_states[i].size() != states_[i].velocity.size())
-            throw std::runtime_error("SGD::setVelocityStates: размер внутреннего буфера не совпадает");
-        states_[i].velocity = vel_states[i];
-    }
+    if (!params_.merge(vel_states, 0, velocity_))
+        throw std::runtime_error("SGD::setVelocityStates: размер внутреннего буфера не совпадает");
 }
@@ -2,19 +2,25 @@
 #pragma once
 
 #include "IOptimizer.h"
+#include "ParamBlocks.h"
 #include <vector>
 #include <stdexcept>
 
 /**
  * Алгоритм стохастического градиентного спуска с моментумом.
+ *
+ * Буферы момента всех параметров лежат подряд в одном выровненном
+ * массиве. Если параметры и градиенты тоже зарегистрированы подряд из
+ * одной арены (как в Network), шаг — один векторный проход по всему
+ * массиву, поделённый между потоками, а zeroGrad — один memset.
  */
 class SGD : public IOptimizer {
 public:
     SGD(float learning_rate = 0.01f, float momentum = 0.0f);
 
     // Регистрация параметров и их градиентов
-    void addParam(std::vector<float>& param,
-                  std::vector<float>& grad) override;
+    using IOptimizer::addParam;
+    void addParam(float* param, float* grad, size_t n) override;
 
     // Один шаг обновления: v = momentum*v - lr*grad; param += v
     void step() override;
@@ -22,20 +28,27 @@ public:
     // Сброс градиентов
     void zeroGrad() override;
 
+    // Сброс буферов момента
+    void zeroState();
+
+    // Число потоков для шага (<= 0 — по размеру задачи, но не больше ядер)
+    void setThreads(int n) { params_.setThreads(n); }
+
     ~SGD() override = default;
 
     // Сериализация / десериализация буферов момента
     std::vector<std::vector<float>> getVelocityStates() const;
     void setVelocityStates(const std::vector<std::vector<float>>& vel_states);
 
+    // Состояние для чекпоинта — буферы момента
+    std::vector<std::vector<float>> getStateBuffers() const override { return getVelocityStates(); }
+    void setStateBuffers(const std::vector<std::vector<float>>& s) override { setVelocityStates(s); }
+
+    const char* name() const override { return "SGD"; }
+
 private:
     float lr_, momentum_;
 
-    struct ParamState {
-        std::vector<float>* param;
-        std::vector<float>* grad;
-        std::vector<float>  velocity;
-    };
-
-    std::vector<ParamState> states_;
+    ParamBlocks params_;
+    ParamBuffer velocity_;  // все буферы момента подряд
 };
@@ -0,0 +1,142 @@
+// predict.cpp — пакетный офлайн-инференс по директории облаков
+//
+// Разбор параметров, загрузка модели (FP32 или откалиброванная INT8) и
+// запуск конвейера predict::run (infer/PredictPipeline.h): чтение файлов,
+// forward батчами и запись предсказаний идут параллельно.
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "infer/InferenceEngine.h"
+#include "infer/PredictPipeline.h"
+#include "infer/QuantizedEngine.h"
+#include "network/network.h"
+
+namespace {
+
+struct Options {
+    std::string checkpoint, input_dir, output;
+    predict::PipelineConfig pipe;
+    int  threads    = 0;
+    bool int8       = false;
+    int  calib      = 64;   // образцов для калибровки INT8
+    int  eval       = 256;  // образцов вне калибровки для сравнения с FP32
+};
+
+bool parseOptions(int argc, char** argv, Options& o) {
+    if (argc < 4) return false;
+    o.checkpoint = argv[1];
+    o.input_dir  = argv[2];
+    o.output     = argv[3];
+    for (int i = 4; i < argc; ++i) {
+        std::string a = argv[i];
+        auto value = [&](const char* key) { return std::stoi(a.substr(std::strlen(key))); };
+        if      (a == "--format=csv")              o.pipe.binary     = false;
+        else if (a == "--format=bin")              o.pipe.binary     = true;
+        else if (a.rfind("--batch=", 0) == 0)      o.pipe.batch      = value("--batch=");
+        else if (a.rfind("--io-threads=", 0) == 0) o.pipe.io_threads = value("--io-threads=");
+        else if (a.rfind("--threads=", 0) == 0)    o.threads         = value("--threads=");
+        else if (a.rfind("--grid=", 0) == 0)       o.pipe.grid       = value("--grid=");
+        else if (a.rfind("--queue=", 0) == 0)      o.pipe.queue      = value("--queue=");
+        else if (a == "--int8")                    o.int8       = true;
+        else if (a.rfind("--calib=", 0) == 0)      o.calib      = value("--calib=");
+        else if (a.rfind("--eval=", 0) == 0)       o.eval       = value("--eval=");
+        else {
+            std::cerr << "Неизвестный параметр: " << a << "\n";
+            return false;
+        }
+    }
+    return o.pipe.batch > 0 && o.pipe.io_threads > 0 && o.pipe.grid > 0 && o.pipe.queue > 0 && o.calib > 0 && o.eval >= 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        std::cout << "Использование:\n"
+                  << "  " << argv[0] << " <checkpoint.bin|model.packed> <input_dir> <output>"
+                  << " [--format=csv|bin] [--batch=N] [--io-threads=N] [--threads=N]"
+                  << " [--grid=N] [--queue=N] [--int8] [--calib=N] [--eval=N]\n";
+        return 1;
+    }
+
+    const std::vector<std::string> files = predict::listInputs(opt.input_dir);
+    // FP32 берёт веса прямо из файла (упакованная модель — без переупаковки);
+    // INT8-калибровке нужна сама сеть
+    if (opt.int8 && InferenceEngine::isPacked(opt.checkpoint)) {
+        std::cerr << "--int8 требует обучающий чекпоинт, а не упакованную модель\n";
+        return 1;
+    }
+    Network net;
+    if (opt.int8) net.loadCheckpoint(opt.checkpoint);
+    InferenceEngine engine = opt.int8 ? InferenceEngine(net) : InferenceEngine(opt.checkpoint);
+    const int C = engine.numClasses();
+    std::cout << "Файлов: " << files.size() << ", классов: " << C << "\n";
+
+    // INT8: калибруем на первых --calib файлах, а расхождение с FP32 меряем
+    // на следующих --eval; при метках <stem>_cls.txt — и разницу точности
+    std::unique_ptr<QuantizedEngine> qengine;
+    if (opt.int8) {
+        std::vector<Tensor3D> calib, eval;
+        std::vector<int> eval_labels;
+        std::vector<float> xyz;
+        size_t i = 0;
+        for (; i < files.size() && static_cast<int>(calib.size()) < opt.calib; ++i) {
+            try { calib.push_back(predict::loadSample(files[i], opt.pipe.grid, xyz)); }
+            catch (const std::exception& e) { std::cerr << "Пропуск " << files[i] << ": " << e.what() << "\n"; }
+        }
+        if (calib.empty()) {
+            std::cerr << "--int8: нет образцов для калибровки\n";
+            return 1;
+        }
+        for (; i < files.size() && static_cast<int>(eval.size()) < opt.eval; ++i) {
+            try {
+                Tensor3D x = predict::loadSample(files[i], opt.pipe.grid, xyz);
+                eval_labels.push_back(predict::loadLabel(files[i]));
+                eval.push_back(std::move(x));
+            } catch (const std::exception& e) {
+                std::cerr << "Пропуск " << files[i] << ": " << e.what() << "\n";
+            }
+        }
+        const bool labeled = !eval.empty() &&
+            std::all_of(eval_labels.begin(), eval_labels.end(), [](int l) { return l >= 0; });
+
+        qengine = std::make_unique<QuantizedEngine>(net, QuantizedEngine::calibrate(net, calib.data(), calib.size()));
+        std::cout << "INT8 (" << QuantizedEngine::kernelName() << "): веса "
+                  << qengine->weightBytes() << " байт против " << net.flatSize() * sizeof(float)
+                  << " в FP32\n";
+        if (eval.empty()) {
+            std::cout << "Вне калибровки файлов нет: сравнение с FP32 на калибровочных\n"
+                      << compareQuantized(engine, *qengine, calib.data(), calib.size(), nullptr, opt.threads).toString()
+                      << "\n";
+        } else {
+            if (!labeled) std::cout << "Не у всех файлов есть _cls.txt: точность не считается\n";
+            std::cout << compareQuantized(engine, *qengine, eval.data(), eval.size(),
+                                          labeled ? eval_labels.data() : nullptr, opt.threads).toString()
+                      << "\n";
+        }
+    }
+
+    auto forward = [&](const Tensor3D* x, size_t n, float* logits) {
+        if (qengine) qengine->forwardBatch(x, n, logits, opt.threads);
+        else         engine.forwardBatch(x, n, logits, opt.threads);
+    };
+    auto t0 = std::chrono::steady_clock::now();
+    predict::Summary sum;
+    try {
+        sum = predict::run(files, opt.output, C, forward, opt.pipe);
+    } catch (const std::exception& e) {
+        std::cerr << "predict: " << e.what() << "\n";
+        return 1;
+    }
+
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "Обработано: " << sum.done << " (ошибок: " << sum.failed << ") за "
+              << sec << "s, " << (sec > 0 ? sum.done / sec : 0.0) << " samples/s\n";
+    return sum.failed == 0 ? 0 : 2;
+}
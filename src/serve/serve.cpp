@@ -0,0 +1,57 @@
+// serve.cpp — демон инференса с динамическим батчингом на Unix-сокете
+#include <iostream>
+#include <string>
+#include <csignal>
+
+#include "infer/InferenceEngine.h"
+#include "infer/InferenceServer.h"
+
+static InferenceServer* g_server = nullptr;
+
+static void onSignal(int) {
+    if (g_server) g_server->stop();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cout << "Использование:\n"
+                  << "  " << argv[0] << " <checkpoint.bin|model.packed> <socket_path>"
+                  << " [--max-batch=N] [--max-wait-us=N] [--threads=N] [--grid=N]\n";
+        return 1;
+    }
+
+    ServerConfig cfg;
+    cfg.socket_path = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        std::string a = argv[i];
+        auto value = [&](const std::string& key) { return std::stoi(a.substr(key.size())); };
+        if      (a.rfind("--max-batch=", 0) == 0)   cfg.max_batch   = value("--max-batch=");
+        else if (a.rfind("--max-wait-us=", 0) == 0) cfg.max_wait_us = value("--max-wait-us=");
+        else if (a.rfind("--threads=", 0) == 0)     cfg.threads     = value("--threads=");
+        else if (a.rfind("--grid=", 0) == 0)        cfg.grid        = value("--grid=");
+        else {
+            std::cerr << "Неизвестный параметр: " << a << "\n";
+            return 1;
+        }
+    }
+
+    // Чекпоинт загружается один раз на всё время жизни демона
+    InferenceEngine engine(argv[1]);
+    InferenceServer server(engine, cfg);
+    g_server = &server;
+    std::signal(SIGINT,  onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::cout << "Слушаем " << cfg.socket_path
+              << " (max_batch=" << cfg.max_batch
+              << ", max_wait=" << cfg.max_wait_us << "us)\n";
+    server.run();
+
+    ServerStats s = server.stats();
+    std::cout << "Запросов: " << s.requests
+              << ", батчей: " << s.batches
+              << ", средний батч: " << s.mean_batch
+              << ", p50=" << s.p50_us << "us, p99=" << s.p99_us << "us"
+              << ", " << s.throughput << " req/s\n";
+    return 0;
+}
@@ -0,0 +1,141 @@
+// make_shards.cpp — конвертация датасета (.ply + _cls.txt + .seg/_seg.txt) в шарды .pgs
+//
+// Образцы идут в порядке имён, как их перебирает DataLoader, и делятся на
+// файлы shard-00000.pgs, shard-00001.pgs, ... по --per-shard штук.
+// Директорию с шардами DataLoader принимает вместо исходной. Метки
+// сегментации хранятся сжатыми (SegLabels.h); --dense-seg пишет их
+// grid³ байтами — формат шардов версии 1 для прежних сборок.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "data/DataLoader.h"
+#include "data/SegLabels.h"
+#include "data/Shard.h"
+#include "utils/Parallel.h"
+
+namespace {
+
+struct Options {
+    std::string data_dir, out_dir;
+    int  per_shard = 4096;
+    int  threads   = 0;
+    bool seg       = true;
+    bool dense_seg = false;
+};
+
+struct Sample {
+    Tensor3D             mask;
+    int                  label = 0;
+    std::vector<uint8_t> seg;
+};
+
+std::vector<std::string> listStems(const std::string& dir) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) throw std::runtime_error("Не удалось открыть директорию: " + dir);
+    std::vector<std::string> stems;
+    while (dirent* e = readdir(d)) {
+        std::string f = e->d_name;
+        if (f.size() > 4 && f.compare(f.size() - 4, 4, ".ply") == 0) stems.push_back(std::move(f));
+    }
+    closedir(d);
+    // Порядок по именам файлов, как у DataLoader: основы a и a-1 дают
+    // a-1.ply < a.ply, хотя a < a-1
+    std::sort(stems.begin(), stems.end());
+    for (auto& s : stems) s.resize(s.size() - 4);
+    return stems;
+}
+
+// Файл меток сегментации образца: компактный .seg важнее текста
+std::string segPath(const std::string& base) {
+    return ::access((base + ".seg").c_str(), R_OK) == 0 ? base + ".seg" : base + "_seg.txt";
+}
+
+void loadSample(const std::string& base, bool with_seg, Sample& s) {
+    s.mask = DataLoader::loadVoxelMask(base + ".ply");
+    auto labels = DataLoader::loadLabels(base + "_cls.txt");
+    if (labels.empty()) throw std::runtime_error("Пустой файл меток: " + base + "_cls.txt");
+    s.label = labels[0];
+    if (!with_seg) return;
+
+    seglabels::read(segPath(base), 32, s.seg);
+}
+
+bool parseOptions(int argc, char** argv, Options& o) {
+    if (argc < 3) return false;
+    o.data_dir = argv[1];
+    o.out_dir  = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        std::string a = argv[i];
+        auto value = [&](const char* key) { return std::stoi(a.substr(std::strlen(key))); };
+        if      (a.rfind("--per-shard=", 0) == 0) o.per_shard = value("--per-shard=");
+        else if (a.rfind("--threads=", 0) == 0)   o.threads   = value("--threads=");
+        else if (a == "--no-seg")                 o.seg       = false;
+        else if (a == "--dense-seg")              o.dense_seg = true;
+        else {
+            std::cerr << "Неизвестный параметр: " << a << "\n";
+            return false;
+        }
+    }
+    return o.per_shard > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        std::cout << "Использование:\n"
+                  << "  " << argv[0] << " <data_dir> <out_dir> [--per-shard=N] [--threads=N] [--no-seg] [--dense-seg]\n";
+        return 1;
+    }
+
+    try {
+        const std::vector<std::string> stems = listStems(opt.data_dir);
+        if (stems.empty()) throw std::runtime_error("Нет PLY-файлов в " + opt.data_dir);
+
+        // Сегментация пишется, только если она есть у всех образцов
+        size_t with_seg_files = 0;
+        for (const auto& s : stems)
+            if (::access(segPath(opt.data_dir + "/" + s).c_str(), R_OK) == 0) ++with_seg_files;
+        const bool with_seg = opt.seg && with_seg_files == stems.size();
+        if (opt.seg && with_seg_files != 0 && !with_seg)
+            throw std::runtime_error("Метки сегментации есть не у всех образцов; запустите с --no-seg");
+
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<Sample> chunk;
+        size_t shard_no = 0;
+        for (size_t begin = 0; begin < stems.size(); begin += opt.per_shard, ++shard_no) {
+            const size_t n = std::min(stems.size() - begin, static_cast<size_t>(opt.per_shard));
+            chunk.resize(n);
+            // Текст разбирается параллельно, шард пишется последовательно
+            parallelFor(n, opt.threads, [&](size_t b, size_t e, int) {
+                for (size_t i = b; i < e; ++i)
+                    loadSample(opt.data_dir + "/" + stems[begin + i], with_seg, chunk[i]);
+            });
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "/shard-%05zu.pgs", shard_no);
+            const std::string path = opt.out_dir + name;
+            ShardWriter w(path, 32, with_seg, !opt.dense_seg);
+            for (size_t i = 0; i < n; ++i)
+                w.add(stems[begin + i], chunk[i].mask, chunk[i].label,
+                      with_seg ? chunk[i].seg.data() : nullptr);
+            w.finish();
+        }
+        double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << "Образцов: " << stems.size() << ", шардов: " << shard_no
+                  << (with_seg ? ", с сегментацией" : ", без сегментации")
+                  << ", за " << sec << "s\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
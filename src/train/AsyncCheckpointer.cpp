@@ -0,0 +1,139 @@
+#include "train/AsyncCheckpointer.h"
+#include "network/Checkpoint.h"
+#include "network/network.h"
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <unistd.h>
+
+AsyncCheckpointer::AsyncCheckpointer(std::string path, int keep_last)
+    : path_(std::move(path)), keep_last_(keep_last)
+{
+    if (keep_last_ < 0)
+        throw std::invalid_argument("AsyncCheckpointer: keep_last должен быть >= 0");
+    worker_ = std::thread([this] { run(); });
+}
+
+AsyncCheckpointer::~AsyncCheckpointer() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();   // ожидающие снимки дописываются перед выходом
+}
+
+std::string AsyncCheckpointer::stepPath(long long step) const {
+    const std::string ext = ".bin";
+    std::string base = path_;
+    if (base.size() > ext.size() && base.compare(base.size() - ext.size(), ext.size(), ext) == 0)
+        base.resize(base.size() - ext.size());
+    return base + ".step" + std::to_string(step) + ext;
+}
+
+void AsyncCheckpointer::save(const Network& net, long long step) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lk(mu_);
+
+    // Пишется не больше одного буфера; берём свободный, иначе — ожидающий
+    Slot* s = nullptr;
+    for (auto& c : slots_)
+        if (!c.writing && !c.pending) { s = &c; break; }
+    if (!s) {
+        for (auto& c : slots_)
+            if (!c.writing) { s = &c; break; }
+        ++stats_.skipped;
+    }
+    s->pending = false;  // фоновый поток не трогает буфер, пока он заполняется
+    lk.unlock();
+
+    net.serializeCheckpoint(s->image, /*checksum=*/false);
+
+    lk.lock();
+    s->step    = step;
+    s->seq     = ++seq_;
+    s->pending = true;
+    stats_.snapshot_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    lk.unlock();
+    cv_.notify_one();
+}
+
+void AsyncCheckpointer::flush() {
+    std::unique_lock<std::mutex> lk(mu_);
+    idle_cv_.wait(lk, [&] {
+        for (const auto& c : slots_)
+            if (c.pending || c.writing) return false;
+        return true;
+    });
+    if (!error_.empty()) {
+        std::string e = std::move(error_);
+        error_.clear();
+        throw std::runtime_error(e);
+    }
+}
+
+AsyncCheckpointer::Stats AsyncCheckpointer::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return stats_;
+}
+
+void AsyncCheckpointer::run() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+        cv_.wait(lk, [&] { return stop_ || slots_[0].pending || slots_[1].pending; });
+        Slot* s = nullptr;
+        for (auto& c : slots_)
+            if (c.pending && (!s || c.seq < s->seq)) s = &c;
+        if (!s) break;  // stop_ и больше нечего писать
+
+        s->pending = false;
+        s->writing = true;
+        lk.unlock();
+
+        auto t0 = std::chrono::steady_clock::now();
+        std::string err;
+        try {
+            writeSlot(*s);
+        } catch (const std::exception& e) {
+            err = e.what();
+        }
+        double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        lk.lock();
+        s->writing = false;
+        stats_.write_seconds += dt;
+        if (err.empty()) ++stats_.written;
+        else {
+            ++stats_.failed;
+            error_ = err;
+        }
+        idle_cv_.notify_all();
+    }
+}
+
+void AsyncCheckpointer::writeSlot(Slot& s) {
+    CheckpointWriter::seal(s.image);
+    if (keep_last_ == 0) {
+        CheckpointWriter::writeImage(path_, s.image);
+        return;
+    }
+
+    // Снимок шага пишется один раз; path — жёсткая ссылка на него,
+    // подменяемая атомарно (без второй копии данных)
+    const std::string step_file = stepPath(s.step);
+    CheckpointWriter::writeImage(step_file, s.image);
+    const std::string link_tmp = path_ + ".lnk";
+    ::unlink(link_tmp.c_str());
+    if (::link(step_file.c_str(), link_tmp.c_str()) != 0
+        || std::rename(link_tmp.c_str(), path_.c_str()) != 0) {
+        ::unlink(link_tmp.c_str());
+        CheckpointWriter::writeImage(path_, s.image);  // ФС без жёстких ссылок
+    }
+
+    // kept_ трогает только фоновый поток
+    if (kept_.empty() || kept_.back() != step_file) kept_.push_back(step_file);
+    while (kept_.size() > static_cast<size_t>(keep_last_)) {
+        ::unlink(kept_.front().c_str());
+        kept_.pop_front();
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Network;
+
+/**
+ * Запись чекпоинтов в фоновом потоке.
+ *
+ * save() копирует состояние сети в один из двух буферов-образов (memcpy
+ * параметров без CRC) и сразу возвращается; фоновый поток считает CRC и
+ * пишет файл через CheckpointWriter::writeImage (temp + fsync + rename),
+ * так что на диске всегда целый чекпоинт. Пока пишется один буфер,
+ * второй принимает следующий снимок; если и он ещё не записан, новый
+ * снимок его заменяет (старый считается пропущенным) — шаг обучения
+ * никогда не ждёт диска.
+ *
+ * path всегда указывает на последний записанный снимок. При keep_last > 0
+ * каждый снимок дополнительно остаётся как <path без .bin>.step<N>.bin,
+ * хранятся последние keep_last таких файлов.
+ */
+class AsyncCheckpointer {
+public:
+    explicit AsyncCheckpointer(std::string path, int keep_last = 0);
+    ~AsyncCheckpointer();
+
+    AsyncCheckpointer(const AsyncCheckpointer&) = delete;
+    AsyncCheckpointer& operator=(const AsyncCheckpointer&) = delete;
+
+    /// Снимок состояния net на шаге step (вызывается из потока обучения)
+    void save(const Network& net, long long step);
+
+    /// Дождаться записи всех снимков; бросает, если какая-то запись не удалась
+    void flush();
+
+    struct Stats {
+        size_t written  = 0;   // записано на диск
+        size_t skipped  = 0;   // заменены более новым снимком до записи
+        size_t failed   = 0;
+        double snapshot_seconds = 0;  // суммарное время save() в потоке обучения
+        double write_seconds    = 0;  // суммарное время записи в фоне
+    };
+    Stats stats() const;
+
+    /// Имя файла снимка шага step при keep_last > 0
+    std::string stepPath(long long step) const;
+
+private:
+    struct Slot {
+        std::vector<uint8_t> image;
+        long long step    = 0;
+        bool      pending = false;   // ждёт записи
+        bool      writing = false;   // пишется фоновым потоком
+        uint64_t  seq     = 0;       // порядок снимков
+    };
+
+    std::string path_;
+    int         keep_last_;
+
+    mutable std::mutex      mu_;
+    std::condition_variable cv_;       // есть работа / остановка
+    std::condition_variable idle_cv_;  // всё записано
+    Slot        slots_[2];
+    uint64_t    seq_  = 0;
+    bool        stop_ = false;
+    Stats       stats_;
+    std::string error_;
+    std::deque<std::string> kept_;     // файлы step-снимков, старые впереди
+    std::thread worker_;
+
+    void run();
+    void writeSlot(Slot& s);
+};
@@ -0,0 +1,84 @@
+#include "train/DataParallelTrainer.h"
+#include "utils/Parallel.h"
+#include "utils/Simd.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+DataParallelTrainer::DataParallelTrainer(Network& master, int workers)
+    : master_(master)
+{
+    if (workers < 1)
+        throw std::invalid_argument("DataParallelTrainer: workers должен быть >= 1");
+    for (int w = 1; w < workers; ++w) {
+        replicas_.push_back(std::make_unique<Network>());
+        replicas_.back()->setBF16Activations(master.bf16Activations());
+    }
+    broadcastParameters();
+}
+
+void DataParallelTrainer::broadcastParameters() {
+    const float* src = master_.flatParameters();
+    const size_t n   = master_.flatSize();
+    parallelFor(replicas_.size(), static_cast<int>(replicas_.size()),
+                [&](size_t b, size_t e, int) {
+        for (size_t r = b; r < e; ++r)
+            std::memcpy(replicas_[r]->flatParameters(), src, n * sizeof(float));
+    });
+}
+
+void DataParallelTrainer::allReduceGradients() {
+    const int    W = workers();
+    const size_t n = master_.flatSize();
+
+    // Дерево: на раунде s поток w (кратный 2s) забирает градиенты w+s
+    for (int s = 1; s < W; s *= 2) {
+        std::vector<int> dst;
+        for (int w = 0; w + s < W; w += 2 * s) dst.push_back(w);
+        parallelFor(dst.size(), static_cast<int>(dst.size()), [&](size_t b, size_t e, int) {
+            for (size_t k = b; k < e; ++k)
+                simd::add(replica(dst[k]).flatGradients(),
+                          replica(dst[k] + s).flatGradients(), n);
+        });
+    }
+}
+
+DataParallelTrainer::StepResult
+DataParallelTrainer::step(const std::vector<Tensor3D>& xs, const std::vector<int>& ys) {
+    if (xs.size() != ys.size())
+        throw std::invalid_argument("DataParallelTrainer::step: размеры батча и меток различаются");
+    const int W = workers();
+    const size_t N = xs.size();
+    std::vector<StepResult> partial(W);
+
+    // Каждый поток — свой непрерывный кусок батча на своей реплике
+    parallelFor(static_cast<size_t>(W), W, [&](size_t b, size_t e, int) {
+        for (size_t w = b; w < e; ++w) {
+            Network& net = replica(static_cast<int>(w));
+            StepResult& r = partial[w];
+            net.zeroGrad();
+            size_t lo = N * w / W, hi = N * (w + 1) / W;
+            for (size_t i = lo; i < hi; ++i) {
+                auto logits = net.forward(xs[i], /*training=*/true);
+                r.loss_sum += net.computeLoss({ys[i]});
+                net.backward();
+                int pred = static_cast<int>(std::max_element(logits.begin(), logits.end()) - logits.begin());
+                r.correct += pred == ys[i];
+                ++r.samples;
+            }
+        }
+    });
+
+    allReduceGradients();
+    if (grad_hook_) grad_hook_(master_);
+    master_.optimize();
+    broadcastParameters();
+
+    StepResult total;
+    for (const auto& r : partial) {
+        total.loss_sum += r.loss_sum;
+        total.correct  += r.correct;
+        total.samples  += r.samples;
+    }
+    return total;
+}
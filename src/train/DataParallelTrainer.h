@@ -0,0 +1,50 @@
+#pragma once
+
+#include "network/network.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * Синхронное data-parallel обучение в одном процессе.
+ *
+ * Сеть реплицируется по рабочим потокам (реплика 0 — сама master-сеть).
+ * Батч делится на непрерывные куски, каждый поток прогоняет свой кусок
+ * forward/backward на своей реплике, затем градиенты суммируются деревом
+ * (пары потоков параллельно, log2(W) раундов) в master, делается один шаг
+ * оптимизатора master, и новые веса рассылаются по репликам.
+ *
+ * Результат совпадает с последовательным накоплением градиентов по батчу
+ * с точностью до порядка суммирования float. Статистики running_* в BN
+ * остаются от куска master-реплики.
+ */
+class DataParallelTrainer {
+public:
+    struct StepResult {
+        double loss_sum = 0.0;  // сумма потерь по образцам
+        int    correct  = 0;    // верных argmax
+        int    samples  = 0;
+    };
+
+    /// Вызывается с master-сетью после суммирования градиентов потоков, до шага оптимизатора
+    using GradientHook = std::function<void(Network&)>;
+
+    DataParallelTrainer(Network& master, int workers);
+
+    /// Например, all-reduce градиентов между процессами (dist/GradientSync.h)
+    void setGradientHook(GradientHook hook) { grad_hook_ = std::move(hook); }
+
+    /// Один шаг обучения на батче (zeroGrad → forward/backward → all-reduce → optimize)
+    StepResult step(const std::vector<Tensor3D>& xs, const std::vector<int>& ys);
+
+    int workers() const { return static_cast<int>(replicas_.size()) + 1; }
+
+private:
+    Network& master_;
+    std::vector<std::unique_ptr<Network>> replicas_;  // потоки 1..W-1
+    GradientHook grad_hook_;
+
+    Network& replica(int w) { return w == 0 ? master_ : *replicas_[w - 1]; }
+    void broadcastParameters();
+    void allReduceGradients();
+};
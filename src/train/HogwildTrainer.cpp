@@ -0,0 +1,111 @@
+#include "train/HogwildTrainer.h"
+#include "utils/Parallel.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+HogwildTrainer::HogwildTrainer(Network& net, Config cfg)
+    : net_(net), cfg_(cfg)
+{
+    if (cfg_.lr <= 0.0f)
+        throw std::invalid_argument("HogwildTrainer: lr должен быть > 0");
+    if (cfg_.momentum < 0.0f || cfg_.momentum >= 1.0f)
+        throw std::invalid_argument("HogwildTrainer: momentum должен быть в [0, 1)");
+    if (cfg_.local_batch < 1)
+        throw std::invalid_argument("HogwildTrainer: local_batch должен быть >= 1");
+    if (cfg_.threads <= 0) cfg_.threads = defaultThreadCount();
+
+    size_     = net_.flatSize();
+    param_    = std::make_unique<std::atomic<float>[]>(size_);
+    velocity_ = std::make_unique<std::atomic<float>[]>(size_);
+    const float* src = net_.flatParameters();
+    for (size_t j = 0; j < size_; ++j) {
+        param_[j].store(src[j], std::memory_order_relaxed);
+        velocity_[j].store(0.0f, std::memory_order_relaxed);
+    }
+    for (int t = 0; t < cfg_.threads; ++t) {
+        replicas_.push_back(std::make_unique<Network>());
+        replicas_.back()->setBF16Activations(net_.bf16Activations());
+    }
+}
+
+void HogwildTrainer::pullWeights(Network& replica) const {
+    float* dst = replica.flatParameters();
+    for (size_t j = 0; j < size_; ++j)
+        dst[j] = param_[j].load(std::memory_order_relaxed);
+}
+
+void HogwildTrainer::applyUpdate(Network& replica) {
+    const float lr = cfg_.lr, m = cfg_.momentum;
+    const float* g = replica.flatGradients();
+    std::atomic<float>* p = param_.get();
+    std::atomic<float>* v = velocity_.get();
+    for (size_t j = 0; j < size_; ++j) {
+        float vj = m * v[j].load(std::memory_order_relaxed) - lr * g[j];
+        v[j].store(vj, std::memory_order_relaxed);
+        p[j].store(p[j].load(std::memory_order_relaxed) + vj, std::memory_order_relaxed);
+    }
+}
+
+HogwildTrainer::Result HogwildTrainer::run(const PullFn& pull) {
+    std::mutex pull_mu;
+    std::vector<Result> partial(replicas_.size());
+
+    parallelFor(replicas_.size(), static_cast<int>(replicas_.size()),
+                [&](size_t b, size_t e, int) {
+        for (size_t t = b; t < e; ++t) {
+            Network& net = *replicas_[t];
+            Result& r = partial[t];
+            Tensor3D x;
+            int y = 0;
+            bool more = true;
+            while (more) {
+                pullWeights(net);
+                net.zeroGrad();
+                int taken = 0;
+                for (; taken < cfg_.local_batch; ++taken) {
+                    {
+                        std::lock_guard<std::mutex> lk(pull_mu);
+                        more = pull(x, y);
+                    }
+                    if (!more) break;
+                    auto logits = net.forward(x, /*training=*/true);
+                    r.loss_sum += net.computeLoss({y});
+                    net.backward();
+                    int pred = static_cast<int>(std::max_element(logits.begin(), logits.end()) - logits.begin());
+                    r.correct += pred == y;
+                    ++r.samples;
+                }
+                if (taken > 0) applyUpdate(net);
+            }
+        }
+    });
+
+    Result total;
+    for (const auto& r : partial) {
+        total.loss_sum += r.loss_sum;
+        total.correct  += r.correct;
+        total.samples  += r.samples;
+    }
+    return total;
+}
+
+HogwildTrainer::Result HogwildTrainer::run(const std::vector<Tensor3D>& xs,
+                                           const std::vector<int>& ys) {
+    if (xs.size() != ys.size())
+        throw std::invalid_argument("HogwildTrainer::run: размеры образцов и меток различаются");
+    size_t next = 0;
+    return run([&](Tensor3D& x, int& y) {
+        if (next >= xs.size()) return false;
+        x = xs[next];
+        y = ys[next];
+        ++next;
+        return true;
+    });
+}
+
+void HogwildTrainer::syncToNetwork() {
+    float* dst = net_.flatParameters();
+    for (size_t j = 0; j < size_; ++j)
+        dst[j] = param_[j].load(std::memory_order_relaxed);
+}
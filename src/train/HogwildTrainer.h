@@ -0,0 +1,64 @@
+#pragma once
+
+#include "network/network.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * Асинхронный lock-free SGD в стиле Hogwild.
+ *
+ * Потоки делят один набор параметров и буферов момента, хранящийся
+ * в std::atomic<float>. Каждый поток берёт очередной образец, читает
+ * текущие веса в свою реплику сети, считает градиенты в её приватные
+ * буферы и сразу применяет обновление SGD с моментом
+ * (v = momentum*v - lr*g; p += v) к общим весам relaxed-загрузками
+ * и записями без блокировок. Гонки между потоками приводят к потере
+ * части обновлений и устаревшим весам — это осознанная плата за
+ * отсутствие синхронизации.
+ *
+ * Обучение идёт в собственной копии весов; syncToNetwork() переносит её
+ * в исходную сеть (для валидации и чекпоинтов).
+ */
+class HogwildTrainer {
+public:
+    struct Config {
+        int   threads     = 0;      // <= 0 — все ядра
+        float lr          = 0.01f;
+        float momentum    = 0.9f;
+        int   local_batch = 1;      // сколько образцов копить перед обновлением
+    };
+
+    struct Result {
+        double loss_sum = 0.0;
+        int    correct  = 0;
+        int    samples  = 0;
+    };
+
+    /// Источник образцов: false, когда образцы кончились. Вызывается под мьютексом.
+    using PullFn = std::function<bool(Tensor3D& x, int& y)>;
+
+    HogwildTrainer(Network& net, Config cfg);
+
+    /// Обучать, пока pull отдаёт образцы
+    Result run(const PullFn& pull);
+
+    /// Один проход по готовому набору образцов
+    Result run(const std::vector<Tensor3D>& xs, const std::vector<int>& ys);
+
+    /// Скопировать общие веса в исходную сеть
+    void syncToNetwork();
+
+    int threads() const { return static_cast<int>(replicas_.size()); }
+
+private:
+    Network& net_;
+    Config   cfg_;
+    size_t   size_ = 0;                                       // Network::flatSize()
+    std::unique_ptr<std::atomic<float>[]> param_, velocity_;  // в раскладке арены сети
+    std::vector<std::unique_ptr<Network>> replicas_;
+
+    void pullWeights(Network& replica) const;
+    void applyUpdate(Network& replica);
+};
@@ -4,111 +4,277 @@
 #include <string>
 #include <chrono>
 #include <algorithm>
+#include <memory>
+#include <tuple>
 
 #include "data/DataLoader.h"
-#include "Network.h"
+#include "data/PrefetchLoader.h"
+#include "data/SampleCache.h"
+#include "network/network.h"
+#include "train/DataParallelTrainer.h"
+#include "train/HogwildTrainer.h"
+#include "train/AsyncCheckpointer.h"
+#include "dist/ShmAllReduce.h"
+#include "dist/GradientSync.h"
+#include "optim/Adam.h"
+#include "optim/LARS.h"
+#include "optim/LAMB.h"
+
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
 
 static int argmax(const std::vector<float>& v) {
     return static_cast<int>(std::distance(v.begin(), std::max_element(v.begin(), v.end())));
 }
 
-int main(int argc, char** argv) {
-    if (argc < 4) {
-        std::cout << "Использование:\n"
-                  << "  " << argv[0] << " <data_dir> <epochs> <batch_size> [val_ratio] [checkpoint_prefix]\n";
-        return 1;
-    }
+struct TrainOptions {
+    std::string data_dir;
+    int         epochs     = 1;
+    int         batch_size = 1;
+    float       val_ratio  = 0.2f;
+    std::string ckpt_file;
+    int         workers    = 1;
+    bool        hogwild    = false;
+    std::string optim      = "sgd";  // sgd | adam | adamw | lars | lamb
+    float       lr         = 0.0f;   // 0 — по умолчанию для оптимизатора
+    float       wd         = -1.0f;  // < 0 — по умолчанию для оптимизатора
+    bool        bf16       = false;  // активации в bf16 (веса остаются fp32)
+    int         ckpt_every = 0;      // чекпоинт каждые N шагов (0 — только по эпохам)
+    int         keep       = 0;      // хранить последние N снимков .step<N>.bin
+    int         loader_threads = 2;  // потоки чтения данных (0 — в потоке обучения)
+    int         prefetch   = 2;      // батчей, собираемых впереди обучения
+    int         cache_mb   = 0;      // кэш образцов в памяти, МБ (0 — без кэша)
+    std::string order      = "seq";  // seq | shuffle | stratified
+    uint64_t    seed       = 0;      // seed перестановок эпох (одинаков на всех рангах)
+    std::string io         = "auto"; // чтение файлов PLY: auto | uring | pread | sync
+    bool        augment    = false;  // повороты, отражения и сдвиги обучающих образцов
+    int         max_shift  = 2;      // сдвиг при аугментации, вокселей
+    float       voxel_dropout = 0.0f; // доля гасимых вокселей при аугментации
+};
+
+static std::unique_ptr<IOptimizer> makeOptimizer(const TrainOptions& opt) {
+    if (opt.optim == "sgd")
+        return std::make_unique<SGD>(opt.lr > 0 ? opt.lr : 0.01f, 0.9f);
+    if (opt.optim == "adam")
+        return std::make_unique<Adam>(opt.lr > 0 ? opt.lr : 1e-3f, 0.9f, 0.999f, 1e-8f,
+                                      opt.wd >= 0 ? opt.wd : 0.0f);
+    if (opt.optim == "adamw")
+        return std::make_unique<AdamW>(opt.lr > 0 ? opt.lr : 1e-3f, 0.9f, 0.999f, 1e-8f,
+                                       opt.wd >= 0 ? opt.wd : 1e-2f);
+    if (opt.optim == "lars")
+        return std::make_unique<LARS>(opt.lr > 0 ? opt.lr : 0.1f, 0.9f,
+                                      opt.wd >= 0 ? opt.wd : 0.0f);
+    if (opt.optim == "lamb")
+        return std::make_unique<LAMB>(opt.lr > 0 ? opt.lr : 1e-3f, 0.9f, 0.999f, 1e-6f,
+                                      opt.wd >= 0 ? opt.wd : 1e-2f);
+    throw std::invalid_argument("Неизвестный оптимизатор: " + opt.optim);
+}
+
+/**
+ * Обучение одного ранга. comm == nullptr — обычный запуск в одном процессе.
+ * Иначе каждый ранг грузит свою часть каждого батча, градиенты суммируются
+ * через comm перед шагом оптимизатора, а печатает и пишет чекпоинт только ранг 0.
+ */
+static int trainRank(const TrainOptions& opt, ICollective* comm) {
+    const std::string& data_dir   = opt.data_dir;
+    const int          epochs     = opt.epochs;
+    const int          batch_size = opt.batch_size;
+    const float        val_ratio  = opt.val_ratio;
+    const std::string& ckpt_file  = opt.ckpt_file;
+    const int          workers    = opt.workers;
+    const bool         hogwild    = opt.hogwild;
+    const bool         leader     = !comm || comm->rank() == 0;
 
-    const std::string data_dir    = argv[1];
-    const int         epochs      = std::stoi(argv[2]);
-    const int         batch_size  = std::stoi(argv[3]);
-    const float       val_ratio   = (argc > 4 ? std::stof(argv[4]) : 0.2f);
-    const std::string ckpt_prefix = (argc > 5 ? argv[5] : std::string("ckpt"));
-    const std::string ckpt_file   = ckpt_prefix + ".bin";
+    // Сумма тройки (loss, correct, samples) по всем рангам
+    auto reduceStats = [&](double& loss, int& correct, int& samples) {
+        if (!comm) return;
+        float buf[3] = { static_cast<float>(loss), static_cast<float>(correct),
+                         static_cast<float>(samples) };
+        comm->allReduce(buf, 3);
+        loss    = buf[0];
+        correct = static_cast<int>(buf[1] + 0.5f);
+        samples = static_cast<int>(buf[2] + 0.5f);
+    };
 
     // 1) Создаём загрузчик данных
     DataLoader loader(data_dir, batch_size, val_ratio);
+    if (comm) loader.setShard(comm->rank(), comm->world());
+    if (opt.cache_mb > 0) loader.enableCache(static_cast<size_t>(opt.cache_mb) << 20);
+    if (opt.order == "shuffle")         loader.setOrder(DataLoader::Order::Shuffle, opt.seed);
+    else if (opt.order == "stratified") loader.setOrder(DataLoader::Order::Stratified, opt.seed);
+    if (opt.augment) {
+        augment::Config acfg;
+        acfg.max_shift = opt.max_shift;
+        acfg.dropout   = opt.voxel_dropout;
+        loader.enableAugmentation(acfg, opt.seed);
+    }
+    // Россыпь мелких файлов читаем пакетами: на холодном кэше иначе всё упирается в задержку диска
+    if (!loader.sharded() && opt.io != "sync") {
+        using Backend = BatchFileReader::Backend;
+        loader.enableBatchedIo(opt.io == "uring" ? Backend::IoUring
+                             : opt.io == "pread" ? Backend::PreadPool : Backend::Auto);
+        if (leader) std::cout << "Чтение файлов: " << BatchFileReader::name(loader.io()->backend()) << "\n";
+    }
+    if (leader && loader.rawClouds())
+        std::cout << "Облака .bin: вокселизация при загрузке в сетку " << loader.voxelGrid() << "³\n";
     const size_t num_train = loader.getNumTrainSamples();
     const size_t num_val   = loader.getNumValSamples();
     const int    train_steps = static_cast<int>((num_train + batch_size - 1) / batch_size);
     const int    val_steps   = static_cast<int>((num_val   + batch_size - 1) / batch_size);
 
-    std::cout << "Train samples: " << num_train
-              << ", Val samples: " << num_val
-              << ", Batch size: "   << batch_size
-              << ", Steps/epoch: "  << train_steps << "\n";
+    // Батчи читаются фоном; эпоха e+1 планируется в начале эпохи e,
+    // так что на границе эпох обучение тоже не ждёт диска
+    PrefetchLoader prefetch(loader, opt.loader_threads, opt.prefetch);
+    // (последний батч эпохи неполный — образцы не повторяются)
+    auto scheduleEpoch = [&](int epoch) {
+        loader.reset(static_cast<uint64_t>(epoch));  // курсоры в начало, перестановка эпохи
+        prefetch.schedule(true,  train_steps);
+        prefetch.schedule(false, val_steps);
+    };
+    scheduleEpoch(1);
+
+    if (leader)
+        std::cout << "Train samples: " << num_train
+                  << ", Val samples: " << num_val
+                  << ", Batch size: "   << batch_size
+                  << ", Steps/epoch: "  << train_steps << "\n";
 
     // 2) Создаём сеть
     Network net;
+    net.setOptimizer(makeOptimizer(opt));
+    net.setBF16Activations(opt.bf16);
+    if (leader && opt.bf16) std::cout << "Активации: bf16, веса: fp32\n";
 
     // 3) Попытка загрузить предыдущий чекпоинт
     {
         std::ifstream fin(ckpt_file, std::ios::binary);
         if (fin) {
-            std::cout << "Загружаем чекпоинт \"" << ckpt_file << "\"...\n";
+            if (leader) std::cout << "Загружаем чекпоинт \"" << ckpt_file << "\"...\n";
             net.loadCheckpoint(ckpt_file);
         }
     }
 
-    // 4) Тренировка по эпохам
+    // Инициализация весов случайна в каждом процессе — стартуем с весов ранга 0
+    if (comm) {
+        broadcastParameters(net, *comm);
+        if (leader) std::cout << "Процессов: " << comm->world() << "\n";
+    }
+
+    // Потоки data-parallel (1 — обычное последовательное накопление)
+    // или асинхронный Hogwild на workers потоках
+    DataParallelTrainer trainer(net, hogwild ? 1 : workers);
+    if (comm)
+        trainer.setGradientHook([&](Network& master) {
+            allReduceGradients(master, *comm);
+        });
+    std::unique_ptr<HogwildTrainer> hog;
+    if (hogwild) {
+        HogwildTrainer::Config hcfg;
+        hcfg.threads = workers;
+        if (opt.lr > 0) hcfg.lr = opt.lr;
+        hog = std::make_unique<HogwildTrainer>(net, hcfg);
+        if (leader) std::cout << "Hogwild: " << workers << " потоков\n";
+    } else if (workers > 1) {
+        if (leader) std::cout << "Data-parallel: " << workers << " потоков\n";
+    }
+
+    // Чекпоинты пишет фоновый поток ранга 0; обучение ждёт только копирования весов
+    std::unique_ptr<AsyncCheckpointer> ckpt;
+    if (leader) ckpt = std::make_unique<AsyncCheckpointer>(ckpt_file, opt.keep);
+    long long global_step = 0, saved_step = -1;
+
+    // 4) Тренировка по эпохам; буферы батча переходят от шага к шагу
+    PrefetchLoader::Batch batch;
     for (int epoch = 1; epoch <= epochs; ++epoch) {
         double epoch_loss = 0.0;
         int    epoch_correct = 0;
         int    total_train_samples = 0;
 
         auto t0 = std::chrono::high_resolution_clock::now();
-        loader.reset();  // сброс курсоров train_pos_ и val_pos_
+        if (epoch < epochs) scheduleEpoch(epoch + 1);
+        prefetch.resetStats();
 
-        for (int step = 0; step < train_steps; ++step) {
-            // 4.1) Загружаем батч
-            auto [batchX, batchY] = loader.nextBatch(true);
+        if (hog) {
+            // 4.1') Hogwild: потоки сами тянут образцы из батчей загрузчика
+            batch.resize(0);
+            size_t next = 0;
+            int    steps_left = train_steps;
+            auto r = hog->run([&](Tensor3D& x, int& y) {
+                while (next >= batch.x.size()) {  // пустой батч (ранг без образцов) пропускаем
+                    if (steps_left == 0) return false;
+                    --steps_left;
+                    prefetch.next(batch);
+                    next = 0;
+                }
+                x = batch.x[next];
+                y = batch.y[next];
+                ++next;
+                return true;
+            });
+            hog->syncToNetwork();
 
-            // 4.2) Сбрасываем градиенты
-            net.zeroGrad();
+            epoch_loss          += r.loss_sum;
+            total_train_samples += r.samples;
+            epoch_correct       += r.correct;
+        }
+        else for (int step = 0; step < train_steps; ++step) {
+            // 4.1) Загружаем батч (в буферы прошлого батча)
+            prefetch.next(batch);
 
-            // 4.3) Накапливаем градиенты по всем примерам батча
-            for (int i = 0; i < batch_size; ++i) {
-                const Tensor3D& x = batchX[i];
-                int y = batchY[i];
+            // 4.2) Градиенты по всем примерам батча (куски по потокам),
+            //      их суммирование и шаг оптимизации для всего батча
+            auto r = trainer.step(batch.x, batch.y);
+            ++global_step;
 
-                auto logits = net.forward(x, /*training=*/true);
-                float loss = net.computeLoss({y});
-                net.backward();
+            epoch_loss          += r.loss_sum;
+            total_train_samples += r.samples;
+            epoch_correct       += r.correct;
 
-                epoch_loss += loss;
-                total_train_samples += 1;
-                if (argmax(logits) == y) {
-                    epoch_correct += 1;
-                }
+            // 4.3) Промежуточный чекпоинт по числу шагов
+            if (ckpt && opt.ckpt_every > 0 && global_step % opt.ckpt_every == 0) {
+                ckpt->save(net, global_step);
+                saved_step = global_step;
             }
-
-            // 4.4) Шаг оптимизации для всего батча
-            net.optimize();
         }
 
         auto t1 = std::chrono::high_resolution_clock::now();
         double train_time = std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count();
 
+        reduceStats(epoch_loss, epoch_correct, total_train_samples);
         double avg_loss = epoch_loss / total_train_samples;
         double accuracy = 100.0 * epoch_correct / total_train_samples;
-        std::cout << "[Epoch " << epoch << "/" << epochs << "] "
-                  << "Train Loss=" << avg_loss
-                  << ", Train Acc=" << accuracy << "% ("
-                  << epoch_correct << "/" << total_train_samples << ") "
-                  << "Time=" << train_time << "s\n";
+        if (leader) {
+            std::cout << "[Epoch " << epoch << "/" << epochs << "] "
+                      << "Train Loss=" << avg_loss
+                      << ", Train Acc=" << accuracy << "% ("
+                      << epoch_correct << "/" << total_train_samples << ") "
+                      << "Time=" << train_time << "s\n";
+            auto ds = prefetch.stats();
+            std::cout << "           Data  stall=" << ds.stall_seconds << "s ("
+                      << ds.stalled << "/" << ds.batches << " батчей ждали), чтение "
+                      << ds.decode_seconds << "s";
+            if (loader.batchedIo()) std::cout << " (из них файлы пакетами " << ds.fetch_seconds << "s)";
+            if (const SampleCache* c = loader.cache()) {
+                auto cs = c->stats();
+                std::cout << ", кэш " << (cs.bytes >> 10) << " КБ / " << cs.entries
+                          << " образцов, попаданий " << cs.hits << "/" << (cs.hits + cs.misses);
+            }
+            std::cout << "\n";
+        }
 
         // 5) Валидация после каждой эпохи
         double val_loss = 0.0;
         int    val_correct = 0;
         int    total_val_samples = 0;
 
-        // курсор val_pos_ сбросился вызовом loader.reset()
+        // val-батчи этой эпохи запланированы сразу за train-батчами
         for (int step = 0; step < val_steps; ++step) {
-            auto [batchX, batchY] = loader.nextBatch(false);
+            prefetch.next(batch);
 
-            for (int i = 0; i < batch_size; ++i) {
-                const Tensor3D& x = batchX[i];
-                int y = batchY[i];
+            for (size_t i = 0; i < batch.x.size(); ++i) {
+                const Tensor3D& x = batch.x[i];
+                int y = batch.y[i];
 
                 auto logits = net.forward(x, /*training=*/false);
                 float loss  = net.computeLoss({y});
@@ -120,17 +286,165 @@ int main(int argc, char** argv) {
             }
         }
 
+        reduceStats(val_loss, val_correct, total_val_samples);
         double avg_val_loss = val_loss / total_val_samples;
         double val_accuracy = 100.0 * val_correct / total_val_samples;
-        std::cout << "           Val   Loss=" << avg_val_loss
-                  << ", Val   Acc=" << val_accuracy << "% ("
-                  << val_correct << "/" << total_val_samples << ")\n";
+        if (leader) {
+            std::cout << "           Val   Loss=" << avg_val_loss
+                      << ", Val   Acc=" << val_accuracy << "% ("
+                      << val_correct << "/" << total_val_samples << ")\n";
+        }
 
-        // 6) Сохраняем чекпоинт
-        std::cout << "Сохраняем чекпоинт: " << ckpt_file << "\n";
-        net.saveCheckpoint(ckpt_file);
+        // 6) Сохраняем чекпоинт (веса у всех рангов одинаковые — пишет ранг 0)
+        if (hog) global_step += train_steps;
+        if (ckpt && saved_step != global_step) {
+            std::cout << "Сохраняем чекпоинт: " << ckpt_file << "\n";
+            ckpt->save(net, global_step);
+            saved_step = global_step;
+        }
+        if (comm) comm->barrier();
     }
 
-    std::cout << "Обучение завершено.\n";
+    if (ckpt) {
+        ckpt->flush();
+        auto st = ckpt->stats();
+        std::cout << "Чекпоинтов записано: " << st.written << " (пропущено: " << st.skipped
+                  << "), снимки в потоке обучения: " << st.snapshot_seconds
+                  << "s, запись в фоне: " << st.write_seconds << "s\n";
+    }
+    if (leader) std::cout << "Обучение завершено.\n";
     return 0;
 }
+
+int main(int argc, char** argv) {
+    // Позиционные аргументы и необязательные флаги вида --key=value
+    std::vector<std::string> pos;
+    TrainOptions opt;
+    int procs = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a.rfind("--workers=", 0) == 0) opt.workers = std::stoi(a.substr(10));
+        else if (a.rfind("--procs=", 0) == 0) procs = std::stoi(a.substr(8));
+        else if (a.rfind("--optim=", 0) == 0) opt.optim = a.substr(8);
+        else if (a.rfind("--lr=", 0) == 0)    opt.lr = std::stof(a.substr(5));
+        else if (a.rfind("--wd=", 0) == 0)    opt.wd = std::stof(a.substr(5));
+        else if (a == "--mode=sync")    opt.hogwild = false;
+        else if (a == "--mode=hogwild") opt.hogwild = true;
+        else if (a == "--bf16")         opt.bf16 = true;
+        else if (a.rfind("--ckpt-every=", 0) == 0) opt.ckpt_every = std::stoi(a.substr(13));
+        else if (a.rfind("--keep=", 0) == 0)       opt.keep       = std::stoi(a.substr(7));
+        else if (a.rfind("--loader-threads=", 0) == 0) opt.loader_threads = std::stoi(a.substr(17));
+        else if (a.rfind("--prefetch=", 0) == 0)   opt.prefetch   = std::stoi(a.substr(11));
+        else if (a.rfind("--cache-mb=", 0) == 0)   opt.cache_mb   = std::stoi(a.substr(11));
+        else if (a.rfind("--order=", 0) == 0)      opt.order      = a.substr(8);
+        else if (a.rfind("--seed=", 0) == 0)       opt.seed       = std::stoull(a.substr(7));
+        else if (a.rfind("--io=", 0) == 0)         opt.io         = a.substr(5);
+        else if (a == "--augment")                 opt.augment    = true;
+        else if (a.rfind("--max-shift=", 0) == 0)  opt.max_shift  = std::stoi(a.substr(12));
+        else if (a.rfind("--voxel-dropout=", 0) == 0) opt.voxel_dropout = std::stof(a.substr(16));
+        else if (a.rfind("--", 0) == 0) {
+            std::cerr << "Неизвестный параметр: " << a << "\n";
+            return 1;
+        }
+        else pos.push_back(a);
+    }
+    if (pos.size() < 3) {
+        std::cout << "Использование:\n"
+                  << "  " << argv[0] << " <data_dir> <epochs> <batch_size> [val_ratio] [checkpoint_prefix]"
+                  << " [--workers=N] [--procs=K] [--mode=sync|hogwild]"
+                  << " [--optim=sgd|adam|adamw|lars|lamb] [--lr=X] [--wd=X] [--bf16]"
+                  << " [--ckpt-every=STEPS] [--keep=N] [--loader-threads=N] [--prefetch=BATCHES]"
+                  << " [--cache-mb=N] [--order=seq|shuffle|stratified] [--seed=N]"
+                  << " [--io=auto|uring|pread|sync] [--augment] [--max-shift=N] [--voxel-dropout=P]\n";
+        return 1;
+    }
+    if (procs < 1) {
+        std::cerr << "--procs должен быть >= 1\n";
+        return 1;
+    }
+    if (opt.ckpt_every < 0 || opt.keep < 0) {
+        std::cerr << "--ckpt-every и --keep должны быть >= 0\n";
+        return 1;
+    }
+    if (opt.order != "seq" && opt.order != "shuffle" && opt.order != "stratified") {
+        std::cerr << "--order: ожидается seq, shuffle или stratified\n";
+        return 1;
+    }
+    if (opt.io != "auto" && opt.io != "uring" && opt.io != "pread" && opt.io != "sync") {
+        std::cerr << "--io: ожидается auto, uring, pread или sync\n";
+        return 1;
+    }
+    if (opt.loader_threads < 0 || opt.prefetch < 1 || opt.cache_mb < 0) {
+        std::cerr << "--loader-threads и --cache-mb должны быть >= 0, --prefetch >= 1\n";
+        return 1;
+    }
+    if (opt.max_shift < 0 || !(opt.voxel_dropout >= 0.0f && opt.voxel_dropout < 1.0f)) {
+        std::cerr << "--max-shift должен быть >= 0, --voxel-dropout — в [0, 1)\n";
+        return 1;
+    }
+    if (procs > 1 && opt.hogwild) {
+        std::cerr << "--procs несовместим с --mode=hogwild\n";
+        return 1;
+    }
+    if (opt.optim != "sgd" && opt.optim != "adam" && opt.optim != "adamw" &&
+        opt.optim != "lars" && opt.optim != "lamb") {
+        std::cerr << "Неизвестный оптимизатор: " << opt.optim << "\n";
+        return 1;
+    }
+    if (opt.hogwild && opt.optim != "sgd") {
+        std::cerr << "--mode=hogwild поддерживает только --optim=sgd\n";
+        return 1;
+    }
+
+    opt.data_dir   = pos[0];
+    opt.epochs     = std::stoi(pos[1]);
+    opt.batch_size = std::stoi(pos[2]);
+    opt.val_ratio  = (pos.size() > 3 ? std::stof(pos[3]) : 0.2f);
+    opt.ckpt_file  = (pos.size() > 4 ? pos[4] : std::string("ckpt")) + ".bin";
+
+    if (procs == 1) return trainRank(opt, nullptr);
+
+    // K процессов на одном хосте: сегмент общей памяти создаётся до fork,
+    // каждый ребёнок подключается к нему со своим рангом
+    const std::string shm_name = "/pointgrid_" + std::to_string(::getpid());
+    {
+        Network probe;
+        ShmAllReduce::create(shm_name, procs, probe.flatSize());
+    }
+    std::vector<pid_t> children;
+    for (int r = 0; r < procs; ++r) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            std::cerr << "fork не удался\n";
+            for (pid_t c : children) ::kill(c, SIGTERM);
+            break;
+        }
+        if (pid == 0) {
+            int rc = 1;
+            try {
+                ShmAllReduce comm(shm_name, r);
+                rc = trainRank(opt, &comm);
+            } catch (const std::exception& e) {
+                std::cerr << "[rank " << r << "] " << e.what() << "\n";
+            }
+            std::cout.flush();
+            ::_exit(rc);
+        }
+        children.push_back(pid);
+    }
+
+    // Если один ранг упал, остальные повиснут на барьере — гасим их
+    int rc = static_cast<int>(children.size()) == procs ? 0 : 1;
+    for (size_t left = children.size(); left > 0; --left) {
+        int status = 0;
+        pid_t pid = ::wait(&status);
+        if (pid < 0) break;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            if (rc == 0)
+                for (pid_t c : children) if (c != pid) ::kill(c, SIGTERM);
+            rc = 1;
+        }
+    }
+    ShmAllReduce::unlink(shm_name);
+    return rc;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * Блокирующая очередь ограниченной ёмкости для конвейеров
+ * «производитель → потребитель».
+ *
+ * push() ждёт свободного места, pop() — элемента. После close()
+ * новые элементы не принимаются, а pop() возвращает false,
+ * когда очередь опустела.
+ */
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : cap_(capacity ? capacity : 1) {}
+
+    /// false, если очередь уже закрыта
+    bool push(T item) {
+        std::unique_lock<std::mutex> lk(mu_);
+        not_full_.wait(lk, [&] { return closed_ || q_.size() < cap_; });
+        if (closed_) return false;
+        q_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /// false, если очередь закрыта и пуста
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lk(mu_);
+        not_empty_.wait(lk, [&] { return closed_ || !q_.empty(); });
+        if (q_.empty()) return false;
+        out = std::move(q_.front());
+        q_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(mu_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lk(mu_);
+        return q_.size();
+    }
+
+private:
+    size_t                  cap_;
+    bool                    closed_ = false;
+    std::deque<T>           q_;
+    mutable std::mutex      mu_;
+    std::condition_variable not_empty_, not_full_;
+};
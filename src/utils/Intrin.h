@@ -0,0 +1,27 @@
+#pragma once
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * <immintrin.h> для векторных ядер и рамка SIMD_KERNELS_BEGIN /
+ * SIMD_KERNELS_END вокруг них.
+ *
+ * В GCC 12 немаскированные интринсики AVX-512 (_mm512_min_ps,
+ * _mm512_srli_epi32, _mm512_sqrt_ps, _mm512_cvtepu8_epi32, …) собраны
+ * на _mm512_undefined_*() и после встраивания дают ложные
+ * -Wmaybe-uninitialized / -Wuninitialized (GCC PR 105593, исправлено
+ * в GCC 13). Рамка гасит только эти два предупреждения и только в коде
+ * между BEGIN и END, поэтому ядра пишутся обычными интринсиками.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 13
+#define SIMD_KERNELS_BEGIN                                         \
+    _Pragma("GCC diagnostic push")                                 \
+    _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")    \
+    _Pragma("GCC diagnostic ignored \"-Wuninitialized\"")
+#define SIMD_KERNELS_END _Pragma("GCC diagnostic pop")
+#else
+#define SIMD_KERNELS_BEGIN
+#define SIMD_KERNELS_END
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/// Число потоков по умолчанию (не меньше 1)
+inline int defaultThreadCount() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : static_cast<int>(n);
+}
+
+/**
+ * Делит диапазон [0, n) на непрерывные куски и обрабатывает их
+ * в num_threads потоках: fn(begin, end, thread_idx).
+ *
+ * Первый кусок выполняется в вызывающем потоке. При num_threads <= 0
+ * берётся defaultThreadCount(). Исключение из любого куска
+ * пробрасывается наружу после join всех потоков.
+ */
+template <class Fn>
+void parallelFor(size_t n, int num_threads, Fn&& fn) {
+    if (n == 0) return;
+    if (num_threads <= 0) num_threads = defaultThreadCount();
+    size_t T = std::min(static_cast<size_t>(num_threads), n);
+    if (T == 1) {
+        fn(size_t(0), n, 0);
+        return;
+    }
+
+    size_t chunk = (n + T - 1) / T;
+    std::vector<std::thread>        threads;
+    std::vector<std::exception_ptr> errors(T);
+    threads.reserve(T - 1);
+    for (size_t t = 1; t < T; ++t) {
+        size_t b = t * chunk, e = std::min(n, b + chunk);
+        if (b >= e) break;
+        threads.emplace_back([&, t, b, e] {
+            try { fn(b, e, static_cast<int>(t)); }
+            catch (...) { errors[t] = std::current_exception(); }
+        });
+    }
+    try { fn(size_t(0), std::min(n, chunk), 0); }
+    catch (...) { errors[0] = std::current_exception(); }
+
+    for (auto& th : threads) th.join();
+    for (auto& e : errors)
+        if (e) std::rethrow_exception(e);
+}
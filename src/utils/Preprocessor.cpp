@@ -1,15 +1,18 @@
 #include "Voxelizer.h"
+#include "data/PlyIO.h"
 #include <iostream>
-#include <fstream>
 #include <string>
+#include <vector>
 
 int main(int argc, char** argv) {
     if (argc < 3) {
-        std::cerr << "Usage: preprocess <input.txt> <output.ply>\n";
+        std::cerr << "Usage: preprocess <input.txt> <output.ply> [--binary]\n";
         return 1;
     }
     std::string in_txt  = argv[1];
     std::string out_ply = argv[2];
+    // binary_little_endian читается DataLoader без разбора текста
+    bool binary = argc > 3 && std::string(argv[3]) == "--binary";
 
     auto points = Voxelizer::loadPointCloud(in_txt);
     if (points.empty()) {
@@ -17,13 +20,13 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::ofstream out(out_ply);
-    out << "ply\nformat ascii 1.0\n"
-           "element vertex " << points.size() << "\n"
-           "property float x\nproperty float y\nproperty float z\n"
-           "end_header\n";
+    std::vector<float> xyz;
+    xyz.reserve(points.size() * 3);
     for (auto& p : points) {
-        out << p.x << " " << p.y << " " << p.z << "\n";
+        xyz.push_back(p.x);
+        xyz.push_back(p.y);
+        xyz.push_back(p.z);
     }
+    writePlyVertices(out_ply, xyz.data(), points.size(), binary);
     return 0;
 }
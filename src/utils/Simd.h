@@ -0,0 +1,255 @@
+#pragma once
+
+#include "utils/Intrin.h"
+#include <cmath>
+#include <cstddef>
+
+/**
+ * Векторные ядра для обновления параметров.
+ *
+ * Ширина выбирается при компиляции (-march=native): AVX-512, AVX2+FMA
+ * или скалярный цикл. Хвост, не кратный ширине регистра, досчитывается
+ * скалярно, поэтому выравнивание входов не требуется (но буферы арены
+ * параметров выровнены на 64 байта).
+ */
+SIMD_KERNELS_BEGIN
+namespace simd {
+
+#if defined(__AVX512F__)
+// Горизонтальная сумма дорожек, накопленная в double
+inline double hsum(__m512 x) {
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, x);
+    double s = 0.0;
+    for (float l : lanes) s += l;
+    return s;
+}
+#endif
+
+/// SGD с моментом: v = momentum*v - lr*g; p += v
+inline void sgdMomentum(float* p, const float* g, float* v, size_t n, float lr, float momentum) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const __m512 vm = _mm512_set1_ps(momentum), vlr = _mm512_set1_ps(-lr);
+    for (; i + 16 <= n; i += 16) {
+        __m512 vv = _mm512_fmadd_ps(vm, _mm512_loadu_ps(v + i),
+                                    _mm512_mul_ps(vlr, _mm512_loadu_ps(g + i)));
+        _mm512_storeu_ps(v + i, vv);
+        _mm512_storeu_ps(p + i, _mm512_add_ps(_mm512_loadu_ps(p + i), vv));
+    }
+#elif defined(__AVX2__) && defined(__FMA__)
+    const __m256 vm = _mm256_set1_ps(momentum), vlr = _mm256_set1_ps(-lr);
+    for (; i + 8 <= n; i += 8) {
+        __m256 vv = _mm256_fmadd_ps(vm, _mm256_loadu_ps(v + i),
+                                    _mm256_mul_ps(vlr, _mm256_loadu_ps(g + i)));
+        _mm256_storeu_ps(v + i, vv);
+        _mm256_storeu_ps(p + i, _mm256_add_ps(_mm256_loadu_ps(p + i), vv));
+    }
+#endif
+    for (; i < n; ++i) {
+        v[i] = momentum * v[i] - lr * g[i];
+        p[i] += v[i];
+    }
+}
+
+/**
+ * Один шаг Adam/AdamW по n элементам за проход:
+ *   g' = g + l2*p
+ *   m  = beta1*m + (1-beta1)*g'
+ *   v  = beta2*v + (1-beta2)*g'^2
+ *   p  = p - decay*p - step_size * m / (sqrt(v)*inv_sqrt_bc2 + eps)
+ * step_size = lr/(1-beta1^t), inv_sqrt_bc2 = 1/sqrt(1-beta2^t);
+ * l2 — L2-штраф в градиенте (Adam), decay = lr*wd — развязанный (AdamW).
+ */
+inline void adam(float* p, const float* g, float* m, float* v, size_t n,
+                 float step_size, float inv_sqrt_bc2, float beta1, float beta2,
+                 float eps, float l2, float decay) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const __m512 b1 = _mm512_set1_ps(beta1), c1 = _mm512_set1_ps(1.0f - beta1);
+    const __m512 b2 = _mm512_set1_ps(beta2), c2 = _mm512_set1_ps(1.0f - beta2);
+    const __m512 ss = _mm512_set1_ps(step_size), ib = _mm512_set1_ps(inv_sqrt_bc2);
+    const __m512 ve = _mm512_set1_ps(eps), vl2 = _mm512_set1_ps(l2), keep = _mm512_set1_ps(1.0f - decay);
+    for (; i + 16 <= n; i += 16) {
+        __m512 vp = _mm512_loadu_ps(p + i);
+        __m512 vg = _mm512_fmadd_ps(vl2, vp, _mm512_loadu_ps(g + i));
+        __m512 vm = _mm512_fmadd_ps(b1, _mm512_loadu_ps(m + i), _mm512_mul_ps(c1, vg));
+        __m512 vv = _mm512_fmadd_ps(b2, _mm512_loadu_ps(v + i), _mm512_mul_ps(c2, _mm512_mul_ps(vg, vg)));
+        __m512 den = _mm512_fmadd_ps(_mm512_sqrt_ps(vv), ib, ve);
+        vp = _mm512_fnmadd_ps(ss, _mm512_div_ps(vm, den), _mm512_mul_ps(keep, vp));
+        _mm512_storeu_ps(m + i, vm);
+        _mm512_storeu_ps(v + i, vv);
+        _mm512_storeu_ps(p + i, vp);
+    }
+#elif defined(__AVX2__) && defined(__FMA__)
+    const __m256 b1 = _mm256_set1_ps(beta1), c1 = _mm256_set1_ps(1.0f - beta1);
+    const __m256 b2 = _mm256_set1_ps(beta2), c2 = _mm256_set1_ps(1.0f - beta2);
+    const __m256 ss = _mm256_set1_ps(step_size), ib = _mm256_set1_ps(inv_sqrt_bc2);
+    const __m256 ve = _mm256_set1_ps(eps), vl2 = _mm256_set1_ps(l2), keep = _mm256_set1_ps(1.0f - decay);
+    for (; i + 8 <= n; i += 8) {
+        __m256 vp = _mm256_loadu_ps(p + i);
+        __m256 vg = _mm256_fmadd_ps(vl2, vp, _mm256_loadu_ps(g + i));
+        __m256 vm = _mm256_fmadd_ps(b1, _mm256_loadu_ps(m + i), _mm256_mul_ps(c1, vg));
+        __m256 vv = _mm256_fmadd_ps(b2, _mm256_loadu_ps(v + i), _mm256_mul_ps(c2, _mm256_mul_ps(vg, vg)));
+        __m256 den = _mm256_fmadd_ps(_mm256_sqrt_ps(vv), ib, ve);
+        vp = _mm256_fnmadd_ps(ss, _mm256_div_ps(vm, den), _mm256_mul_ps(keep, vp));
+        _mm256_storeu_ps(m + i, vm);
+        _mm256_storeu_ps(v + i, vv);
+        _mm256_storeu_ps(p + i, vp);
+    }
+#endif
+    for (; i < n; ++i) {
+        float gi = g[i] + l2 * p[i];
+        m[i] = beta1 * m[i] + (1.0f - beta1) * gi;
+        v[i] = beta2 * v[i] + (1.0f - beta2) * gi * gi;
+        p[i] = (1.0f - decay) * p[i] - step_size * m[i] / (std::sqrt(v[i]) * inv_sqrt_bc2 + eps);
+    }
+}
+
+/// Сумма квадратов (накопление в регистрах float, итог в double)
+inline double sumSquares(const float* a, size_t n) {
+    size_t i = 0;
+    double s = 0.0;
+#if defined(__AVX512F__)
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    for (; i + 32 <= n; i += 32) {
+        __m512 x0 = _mm512_loadu_ps(a + i), x1 = _mm512_loadu_ps(a + i + 16);
+        acc0 = _mm512_fmadd_ps(x0, x0, acc0);
+        acc1 = _mm512_fmadd_ps(x1, x1, acc1);
+    }
+    s = hsum(_mm512_add_ps(acc0, acc1));
+#elif defined(__AVX2__) && defined(__FMA__)
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        __m256 x0 = _mm256_loadu_ps(a + i), x1 = _mm256_loadu_ps(a + i + 8);
+        acc0 = _mm256_fmadd_ps(x0, x0, acc0);
+        acc1 = _mm256_fmadd_ps(x1, x1, acc1);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, _mm256_add_ps(acc0, acc1));
+    for (float l : lanes) s += l;
+#endif
+    for (; i < n; ++i) s += double(a[i]) * a[i];
+    return s;
+}
+
+/// LARS с моментом: v = momentum*v + local_lr*(g + wd*p); p -= v
+inline void larsMomentum(float* p, const float* g, float* v, size_t n,
+                         float local_lr, float momentum, float wd) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const __m512 vm = _mm512_set1_ps(momentum), vlr = _mm512_set1_ps(local_lr), vwd = _mm512_set1_ps(wd);
+    for (; i + 16 <= n; i += 16) {
+        __m512 vp = _mm512_loadu_ps(p + i);
+        __m512 u  = _mm512_fmadd_ps(vwd, vp, _mm512_loadu_ps(g + i));
+        __m512 vv = _mm512_fmadd_ps(vm, _mm512_loadu_ps(v + i), _mm512_mul_ps(vlr, u));
+        _mm512_storeu_ps(v + i, vv);
+        _mm512_storeu_ps(p + i, _mm512_sub_ps(vp, vv));
+    }
+#elif defined(__AVX2__) && defined(__FMA__)
+    const __m256 vm = _mm256_set1_ps(momentum), vlr = _mm256_set1_ps(local_lr), vwd = _mm256_set1_ps(wd);
+    for (; i + 8 <= n; i += 8) {
+        __m256 vp = _mm256_loadu_ps(p + i);
+        __m256 u  = _mm256_fmadd_ps(vwd, vp, _mm256_loadu_ps(g + i));
+        __m256 vv = _mm256_fmadd_ps(vm, _mm256_loadu_ps(v + i), _mm256_mul_ps(vlr, u));
+        _mm256_storeu_ps(v + i, vv);
+        _mm256_storeu_ps(p + i, _mm256_sub_ps(vp, vv));
+    }
+#endif
+    for (; i < n; ++i) {
+        v[i] = momentum * v[i] + local_lr * (g[i] + wd * p[i]);
+        p[i] -= v[i];
+    }
+}
+
+/**
+ * Моменты LAMB и направление обновления за один проход:
+ *   m = beta1*m + (1-beta1)*g;  v = beta2*v + (1-beta2)*g^2
+ *   r = m*inv_bc1 / (sqrt(v)*inv_sqrt_bc2 + eps) + wd*p
+ * Возвращает сумму r^2 (для доверительного коэффициента).
+ */
+inline double lambDirection(const float* p, const float* g, float* m, float* v, float* r, size_t n,
+                            float beta1, float beta2, float inv_bc1, float inv_sqrt_bc2,
+                            float eps, float wd) {
+    size_t i = 0;
+    double s = 0.0;
+#if defined(__AVX512F__)
+    const __m512 b1 = _mm512_set1_ps(beta1), c1 = _mm512_set1_ps(1.0f - beta1);
+    const __m512 b2 = _mm512_set1_ps(beta2), c2 = _mm512_set1_ps(1.0f - beta2);
+    const __m512 ib1 = _mm512_set1_ps(inv_bc1), ib2 = _mm512_set1_ps(inv_sqrt_bc2);
+    const __m512 ve = _mm512_set1_ps(eps), vwd = _mm512_set1_ps(wd);
+    __m512 acc = _mm512_setzero_ps();
+    for (; i + 16 <= n; i += 16) {
+        __m512 vg = _mm512_loadu_ps(g + i);
+        __m512 vm = _mm512_fmadd_ps(b1, _mm512_loadu_ps(m + i), _mm512_mul_ps(c1, vg));
+        __m512 vv = _mm512_fmadd_ps(b2, _mm512_loadu_ps(v + i), _mm512_mul_ps(c2, _mm512_mul_ps(vg, vg)));
+        __m512 den = _mm512_fmadd_ps(_mm512_sqrt_ps(vv), ib2, ve);
+        __m512 vr = _mm512_fmadd_ps(vwd, _mm512_loadu_ps(p + i),
+                                    _mm512_div_ps(_mm512_mul_ps(vm, ib1), den));
+        _mm512_storeu_ps(m + i, vm);
+        _mm512_storeu_ps(v + i, vv);
+        _mm512_storeu_ps(r + i, vr);
+        acc = _mm512_fmadd_ps(vr, vr, acc);
+    }
+    s = hsum(acc);
+#elif defined(__AVX2__) && defined(__FMA__)
+    const __m256 b1 = _mm256_set1_ps(beta1), c1 = _mm256_set1_ps(1.0f - beta1);
+    const __m256 b2 = _mm256_set1_ps(beta2), c2 = _mm256_set1_ps(1.0f - beta2);
+    const __m256 ib1 = _mm256_set1_ps(inv_bc1), ib2 = _mm256_set1_ps(inv_sqrt_bc2);
+    const __m256 ve = _mm256_set1_ps(eps), vwd = _mm256_set1_ps(wd);
+    __m256 acc = _mm256_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        __m256 vg = _mm256_loadu_ps(g + i);
+        __m256 vm = _mm256_fmadd_ps(b1, _mm256_loadu_ps(m + i), _mm256_mul_ps(c1, vg));
+        __m256 vv = _mm256_fmadd_ps(b2, _mm256_loadu_ps(v + i), _mm256_mul_ps(c2, _mm256_mul_ps(vg, vg)));
+        __m256 den = _mm256_fmadd_ps(_mm256_sqrt_ps(vv), ib2, ve);
+        __m256 vr = _mm256_fmadd_ps(vwd, _mm256_loadu_ps(p + i),
+                                    _mm256_div_ps(_mm256_mul_ps(vm, ib1), den));
+        _mm256_storeu_ps(m + i, vm);
+        _mm256_storeu_ps(v + i, vv);
+        _mm256_storeu_ps(r + i, vr);
+        acc = _mm256_fmadd_ps(vr, vr, acc);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    for (float l : lanes) s += l;
+#endif
+    for (; i < n; ++i) {
+        m[i] = beta1 * m[i] + (1.0f - beta1) * g[i];
+        v[i] = beta2 * v[i] + (1.0f - beta2) * g[i] * g[i];
+        r[i] = m[i] * inv_bc1 / (std::sqrt(v[i]) * inv_sqrt_bc2 + eps) + wd * p[i];
+        s += double(r[i]) * r[i];
+    }
+    return s;
+}
+
+/// y[i] += a * x[i]
+inline void axpy(float* y, float a, const float* x, size_t n) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    const __m512 va = _mm512_set1_ps(a);
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(y + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+#elif defined(__AVX2__) && defined(__FMA__)
+    const __m256 va = _mm256_set1_ps(a);
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+#endif
+    for (; i < n; ++i) y[i] += a * x[i];
+}
+
+/// a[i] += b[i]
+inline void add(float* a, const float* b, size_t n) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(a + i, _mm512_add_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+#elif defined(__AVX2__)
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(a + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+#endif
+    for (; i < n; ++i) a[i] += b[i];
+}
+
+} // namespace simd
+SIMD_KERNELS_END
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+#include "net/Tensor3D.h"
+
+/**
+ * Общие помощники тестов загрузки: датасет из PLY-файлов с метками и
+ * сравнение тензоров и батчей.
+ */
+namespace testutil {
+
+/// Основа имени образца i в dir: dir/s000, dir/s001, …
+inline std::string stem(const std::string& dir, int i) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/s%03d", i);
+    return dir + name;
+}
+
+/**
+ * Образец датасета: base.ply (ASCII, вершины verts с целыми координатами)
+ * и, если label >= 0, base_cls.txt с меткой класса.
+ */
+inline void writeSample(const std::string& base, std::initializer_list<std::array<int, 3>> verts, int label = -1) {
+    std::ofstream ply(base + ".ply");
+    ply << "ply\nformat ascii 1.0\nelement vertex " << verts.size() << "\nproperty float x\n"
+        << "property float y\nproperty float z\nend_header\n";
+    for (const auto& v : verts) ply << v[0] << " " << v[1] << " " << v[2] << "\n";
+    if (label >= 0) std::ofstream(base + "_cls.txt") << label << "\n";
+}
+
+/// Совпадают ли тензоры по форме и поэлементно
+inline bool same(const Tensor3D& a, const Tensor3D& b) {
+    if (a.depth() != b.depth() || a.height() != b.height() || a.width() != b.width() ||
+        a.channels() != b.channels())
+        return false;
+    for (int i = 0; i < a.size(); ++i)
+        if (a.data()[i] != b.data()[i]) return false;
+    return true;
+}
+
+/// Совпадает ли батч (SampleBatch, PrefetchLoader::Batch) с результатом DataLoader::nextBatch
+template <class Batch>
+bool sameBatch(const Batch& a, const std::pair<std::vector<Tensor3D>, std::vector<int>>& b) {
+    if (a.x.size() != b.first.size() || a.y != b.second) return false;
+    for (size_t i = 0; i < a.x.size(); ++i)
+        if (!same(a.x[i], b.first[i])) return false;
+    return true;
+}
+
+} // namespace testutil
@@ -0,0 +1,120 @@
+#include "optim/Adam.h"
+#include "network/network.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <cstdio>
+
+static bool almostEqual(float a, float b, float tol = 1e-5f) {
+    return std::fabs(a - b) < tol * (1.0f + std::fabs(b));
+}
+
+// Эталонный скалярный Adam/AdamW в double
+static void referenceStep(std::vector<double>& p, const std::vector<double>& g,
+                          std::vector<double>& m, std::vector<double>& v, int t,
+                          double lr, double b1, double b2, double eps, double wd, bool decoupled) {
+    for (size_t i = 0; i < p.size(); ++i) {
+        double gi = g[i] + (decoupled ? 0.0 : wd * p[i]);
+        m[i] = b1 * m[i] + (1 - b1) * gi;
+        v[i] = b2 * v[i] + (1 - b2) * gi * gi;
+        double mh = m[i] / (1 - std::pow(b1, t));
+        double vh = v[i] / (1 - std::pow(b2, t));
+        if (decoupled) p[i] -= lr * wd * p[i];
+        p[i] -= lr * mh / (std::sqrt(vh) + eps);
+    }
+}
+
+int main() {
+    std::cout << "=== Тест Adam ===\n";
+
+    // Первый шаг Adam: m̂ = g, v̂ = g², шаг ≈ lr * sign(g)
+    {
+        std::vector<float> w = {1.0f, -2.0f};
+        std::vector<float> g = {0.5f, -1.5f};
+        Adam opt(0.1f);
+        opt.addParam(w, g);
+        opt.step();
+        assert(almostEqual(w[0], 0.9f));
+        assert(almostEqual(w[1], -1.9f));
+        assert(opt.steps() == 1);
+    }
+
+    // Несколько шагов Adam и AdamW против эталона; два тензора подряд в одной
+    // арене (длина не кратна ширине регистра) — быстрый путь одним проходом
+    for (bool decoupled : {false, true}) {
+        const size_t n1 = 13, n2 = 1000;
+        std::vector<float> p(n1 + n2), g(n1 + n2);
+        std::vector<double> rp(n1 + n2), rm(n1 + n2, 0.0), rv(n1 + n2, 0.0);
+        for (size_t i = 0; i < p.size(); ++i) rp[i] = p[i] = 0.01f * float(int(i % 31) - 15);
+
+        Adam opt(0.01f, 0.9f, 0.999f, 1e-8f, 0.1f, decoupled);
+        opt.setThreads(2);
+        opt.addParam(p.data(), g.data(), n1);
+        opt.addParam(p.data() + n1, g.data() + n1, n2);
+        for (int t = 1; t <= 5; ++t) {
+            std::vector<double> rg(p.size());
+            for (size_t i = 0; i < p.size(); ++i) rg[i] = g[i] = 0.1f * std::sin(float(i + 7 * t));
+            opt.step();
+            referenceStep(rp, rg, rm, rv, t, 0.01, 0.9, 0.999, 1e-8, 0.1, decoupled);
+        }
+        for (size_t i = 0; i < p.size(); ++i)
+            assert(almostEqual(p[i], static_cast<float>(rp[i]), 1e-4f));
+
+        // Состояние: m по тензорам, v по тензорам; счётчик шагов отдельно
+        auto st = opt.getStateBuffers();
+        assert(st.size() == 4 && opt.steps() == 5);
+        assert(st[0].size() == n1 && st[1].size() == n2);
+        assert(almostEqual(st[1][10], static_cast<float>(rm[n1 + 10]), 1e-4f));
+
+        opt.zeroGrad();
+        for (float x : g) assert(x == 0.0f);
+        std::cout << (decoupled ? "AdamW" : "Adam") << " совпадает с эталоном\n";
+    }
+
+    // Моменты сохраняются в чекпоинт и восстанавливаются
+    {
+        Network a;
+        a.setOptimizer(std::make_unique<AdamW>(1e-3f));
+        Tensor3D x(8, 8, 8, 1);
+        for (int i = 0; i < x.size(); ++i) x.data()[i] = (i % 3 == 0) ? 1.0f : 0.0f;
+        for (int it = 0; it < 3; ++it) {
+            a.zeroGrad();
+            a.forward(x, true);
+            a.computeLoss({3});
+            a.backward();
+            a.optimize();
+        }
+        const char* path = "test_adam_ckpt.bin";
+        a.saveCheckpoint(path);
+
+        Network b;
+        b.setOptimizer(std::make_unique<AdamW>(1e-3f));
+        b.loadCheckpoint(path);
+        auto sa = a.optimizer().getStateBuffers();
+        auto sb = b.optimizer().getStateBuffers();
+        assert(sa == sb);
+        assert(b.optimizer().steps() == 3);
+
+        // Счётчик за 2^24 (и за 2^32) переживает чекпоинт без потерь
+        const long long big = (1LL << 33) + 7;
+        a.optimizer().setSteps(big);
+        a.saveCheckpoint(path);
+        b.loadCheckpoint(path);
+        assert(b.optimizer().steps() == big);
+
+        // Чекпоинт Adam не подходит ни SGD, ни Adam без развязанного затухания
+        Network c;
+        bool threw = false;
+        try { c.loadCheckpoint(path); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        c.setOptimizer(std::make_unique<Adam>(1e-3f));
+        threw = false;
+        try { c.loadCheckpoint(path); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        std::remove(path);
+    }
+
+    std::cout << "[OK] Adam tests passed\n";
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <sys/stat.h>
+#include "network/network.h"
+#include "network/Checkpoint.h"
+#include "train/AsyncCheckpointer.h"
+
+static bool exists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+static void trainStep(Network& net, const Tensor3D& x) {
+    net.zeroGrad();
+    net.forward(x, true);
+    net.computeLoss({1});
+    net.backward();
+    net.optimize();
+}
+
+static bool sameWeights(Network& a, Network& b) {
+    auto pa = a.parameters(), pb = b.parameters();
+    for (size_t k = 0; k < pa.size(); ++k)
+        for (size_t i = 0; i < pa[k]->size(); ++i)
+            if ((*pa[k])[i] != (*pb[k])[i]) return false;
+    return a.optimizer().getStateBuffers() == b.optimizer().getStateBuffers();
+}
+
+int main() {
+    std::cout << "=== Тест AsyncCheckpointer ===\n";
+    const std::string path = "test_async_ckpt.bin";
+
+    std::mt19937 gen(5);
+    std::bernoulli_distribution occ(0.3);
+    Tensor3D x(8, 8, 8, 1);
+    for (int i = 0; i < x.size(); ++i) x.data()[i] = occ(gen) ? 1.0f : 0.0f;
+    Network net;
+
+    // 1) Снимок фиксирует веса на момент save(), а не на момент записи
+    {
+        AsyncCheckpointer ck(path);
+        trainStep(net, x);
+        const std::vector<float> at_save(net.fc().weight().begin(), net.fc().weight().end());
+        ck.save(net, 1);
+        trainStep(net, x);  // веса меняются, пока снимок, возможно, ещё пишется
+        ck.flush();
+
+        Network loaded;
+        loaded.loadCheckpoint(path);
+        for (size_t i = 0; i < at_save.size(); ++i) assert(loaded.fc().weight()[i] == at_save[i]);
+        assert(!sameWeights(loaded, net));
+        assert(!exists(path + ".tmp"));
+        MappedCheckpoint mc(path);  // CRC досчитан в фоне и верен
+        assert(mc.has("fc.weight"));
+    }
+
+    // 2) Последний снимок совпадает с сетью после flush
+    {
+        AsyncCheckpointer ck(path);
+        ck.save(net, 3);
+        ck.flush();
+        Network loaded;
+        loaded.loadCheckpoint(path);
+        assert(sameWeights(loaded, net));
+        auto st = ck.stats();
+        assert(st.written == 1 && st.failed == 0);
+    }
+
+    // 3) keep_last: хранятся последние N снимков, path — самый свежий
+    {
+        AsyncCheckpointer ck(path, 2);
+        for (int step = 10; step <= 14; ++step) {
+            trainStep(net, x);
+            ck.save(net, step);
+            ck.flush();
+        }
+        assert(!exists(ck.stepPath(10)) && !exists(ck.stepPath(11)) && !exists(ck.stepPath(12)));
+        assert(exists(ck.stepPath(13)) && exists(ck.stepPath(14)));
+        assert(ck.stepPath(14) == "test_async_ckpt.step14.bin");
+
+        Network latest, step14;
+        latest.loadCheckpoint(path);
+        step14.loadCheckpoint(ck.stepPath(14));
+        assert(sameWeights(latest, net) && sameWeights(step14, net));
+        assert(!exists(path + ".lnk"));
+
+        std::remove(ck.stepPath(13).c_str());
+        std::remove(ck.stepPath(14).c_str());
+    }
+
+    // 4) Частые save(): обучение не ждёт диска, лишние снимки заменяются
+    {
+        AsyncCheckpointer ck(path);
+        const int n = 200;
+        for (int i = 0; i < n; ++i) ck.save(net, i);
+        ck.flush();
+        auto st = ck.stats();
+        assert(st.written + st.skipped == static_cast<size_t>(n));
+        assert(st.written >= 1);
+        std::cout << "save() x" << n << ": записано " << st.written << ", пропущено " << st.skipped
+                  << ", в потоке обучения " << st.snapshot_seconds << "s, в фоне " << st.write_seconds << "s\n";
+
+        Network loaded;
+        loaded.loadCheckpoint(path);
+        assert(sameWeights(loaded, net));
+    }
+
+    // 5) Ошибка записи всплывает из flush(), а не теряется в фоне
+    {
+        AsyncCheckpointer ck("no_such_dir/ckpt.bin");
+        ck.save(net, 1);
+        bool threw = false;
+        try { ck.flush(); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        assert(ck.stats().failed == 1);
+        ck.flush();  // ошибка сообщается один раз
+    }
+
+    std::remove(path.c_str());
+    std::cout << "[OK] AsyncCheckpointer tests passed\n";
+    return 0;
+}
@@ -0,0 +1,339 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/Augment.h"
+#include "data/DataLoader.h"
+#include "data/PrefetchLoader.h"
+#include "data/SampleCache.h"
+#include "data/Sampler.h"
+#include "data/Shard.h"
+#include "TestUtils.h"
+
+using testutil::same;
+
+// Разреженная сетка n³: ~density занятых вокселей со значениями 1..labels
+static Tensor3D randomGrid(int n, double density, int labels, uint64_t seed) {
+    sampler::SplitMix64 rng{seed};
+    Tensor3D x(n, n, n, 1);
+    for (int i = 0; i < x.size(); ++i)
+        x.data()[i] = rng.unit() < density ? static_cast<float>(1 + rng.below(labels)) : 0.0f;
+    return x;
+}
+
+// Эталон перестановки: каждый воксель — через mapVoxel
+static Tensor3D reference(const augment::Transform& t, const Tensor3D& x) {
+    const int n = x.depth();
+    Tensor3D out(n, n, n, 1);
+    out.fill(0.0f);
+    for (int d = 0; d < n; ++d)
+        for (int h = 0; h < n; ++h)
+            for (int w = 0; w < n; ++w) {
+                int od = d, oh = h, ow = w;
+                if (augment::mapVoxel(t, n, od, oh, ow)) out(od, oh, ow, 0) = x(d, h, w, 0);
+            }
+    return out;
+}
+
+static Tensor3D occupancy(const Tensor3D& x) {
+    Tensor3D m = x;
+    for (int i = 0; i < m.size(); ++i) m.data()[i] = m.data()[i] != 0.0f ? 1.0f : 0.0f;
+    return m;
+}
+
+static void writeCloud(const std::string& path, int i) {
+    sampler::SplitMix64 rng{static_cast<uint64_t>(i) + 100};
+    const uint32_t M = 400;
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&M), sizeof(M));
+    for (uint32_t k = 0; k < M; ++k) {
+        float p[3] = {static_cast<float>(rng.unit()), static_cast<float>(rng.unit() * 0.5),
+                      static_cast<float>(rng.unit() * 2.0)};
+        int32_t l = static_cast<int32_t>(1 + rng.below(4));
+        out.write(reinterpret_cast<const char*>(p), sizeof(p));
+        out.write(reinterpret_cast<const char*>(&l), sizeof(l));
+    }
+}
+
+int main() {
+    std::cout << "=== Тест аугментации ===\n";
+
+    // 1) Поворот вокруг вертикали: (d, h, w) → (w, h, n−1−d); четыре поворота — тождество
+    {
+        augment::Transform t;
+        t.rot = 1;
+        int d = 1, h = 5, w = 2;
+        assert(augment::mapVoxel(t, 32, d, h, w) && d == 2 && h == 5 && w == 30);
+        t.rot = 4;
+        d = 7; h = 3; w = 11;
+        assert(augment::mapVoxel(t, 32, d, h, w) && d == 7 && h == 3 && w == 11);
+        t = augment::Transform();
+        t.shift[2] = -3;
+        d = 0; h = 0; w = 2;
+        assert(!augment::mapVoxel(t, 32, d, h, w));
+    }
+
+    // 2) Битовый путь 32³ совпадает с поэлементным эталоном при всех поворотах,
+    //    отражениях и сдвигах (в том числе больше сетки)
+    {
+        const Tensor3D x0 = occupancy(randomGrid(32, 0.05, 1, 1));
+        const int shifts[] = {0, 1, -2, 31, -31, 40};
+        int cases = 0;
+        for (int rot = 0; rot < 4; ++rot)
+            for (int f = 0; f < 8; ++f)
+                for (int s = 0; s < 6; ++s) {
+                    augment::Transform t;
+                    t.rot = rot;
+                    for (int a = 0; a < 3; ++a) t.flip[a] = f >> a & 1;
+                    t.shift[0] = shifts[s];
+                    t.shift[1] = shifts[(s + 2) % 6];
+                    t.shift[2] = shifts[(s + 4) % 6];
+                    Tensor3D x = x0;
+                    augment::apply(t, x);
+                    assert(same(x, reference(t, x0)));
+                    ++cases;
+                }
+        std::cout << "битовый путь = эталон в " << cases << " вариантах\n";
+    }
+
+    // 2б) applyPacked над упакованной маской — то же, что apply, в том числе на месте
+    {
+        const Tensor3D x0 = occupancy(randomGrid(32, 0.2, 1, 8));
+        std::vector<uint32_t> in(32 * 32), out(32 * 32);
+        shard::packBits(x0.data(), x0.size(), reinterpret_cast<uint8_t*>(in.data()));
+        augment::Config cfg;
+        cfg.flip_y = true;
+        cfg.dropout = 0.3f;
+        for (uint64_t i = 0; i < 16; ++i) {
+            const augment::Transform t = augment::draw(cfg, 3, 1, i);
+            Tensor3D x = x0, y(32, 32, 32, 1);
+            augment::apply(t, x);
+            augment::applyPacked(t, in.data(), out.data());
+            shard::unpackBits(reinterpret_cast<const uint8_t*>(out.data()), y.size(), y.data());
+            assert(same(x, y));
+            std::vector<uint32_t> inplace = in;
+            augment::applyPacked(t, inplace.data(), inplace.data());
+            assert(inplace == out);
+        }
+    }
+
+    // 3) Метки сегментации и сетки другого размера — тем же отображением
+    for (int n : {16, 32, 40}) {
+        const Tensor3D seg0 = randomGrid(n, 0.08, 5, 2);
+        const Tensor3D x0   = occupancy(seg0);
+        for (uint64_t i = 0; i < 20; ++i) {
+            augment::Config cfg;
+            cfg.flip_y = true;
+            cfg.max_shift = 3;
+            augment::Transform t = augment::draw(cfg, 5, 1, i);
+            Tensor3D x = x0, seg = seg0;
+            augment::apply(t, x, &seg);
+            assert(same(seg, reference(t, seg0)));
+            assert(same(x, occupancy(seg)));
+        }
+    }
+
+    // 4) Гашение: только занятые воксели, доля около p, seg гасится вместе с маской;
+    //    битовый путь и поэлементный (n ≠ 32) дают одинаковую долю
+    for (int n : {32, 48}) {
+        const Tensor3D seg0 = randomGrid(n, 0.3, 3, 3);
+        const Tensor3D x0   = occupancy(seg0);
+        augment::Config cfg;
+        cfg.dropout = 0.25f;
+        augment::Transform t = augment::draw(cfg, 1, 2, 3);
+        Tensor3D x = x0, seg = seg0;
+        augment::apply(t, x, &seg);
+        const Tensor3D moved = reference(t, seg0);
+        size_t before = 0, after = 0;
+        for (int i = 0; i < x.size(); ++i) {
+            before += moved.data()[i] != 0.0f;
+            after  += x.data()[i] != 0.0f;
+            if (x.data()[i] != 0.0f) assert(seg.data()[i] == moved.data()[i]);
+            else                     assert(seg.data()[i] == 0.0f);
+        }
+        const double kept = static_cast<double>(after) / before;
+        std::cout << "n=" << n << ": гашение 0.25, сохранено " << kept << "\n";
+        assert(kept > 0.72 && kept < 0.78);
+    }
+
+    // 5) Параметры образца зависят только от (seed, epoch, index) и от Config
+    {
+        augment::Config cfg;
+        cfg.dropout = 0.1f;
+        bool epoch_differs = false;
+        int rot_seen[4] = {};
+        for (uint64_t i = 0; i < 200; ++i) {
+            augment::Transform a = augment::draw(cfg, 9, 3, i), b = augment::draw(cfg, 9, 3, i);
+            assert(a.rot == b.rot && a.drop_seed == b.drop_seed && a.shift[0] == b.shift[0]);
+            assert(!a.flip[1] && a.drop == 26);
+            for (int s : a.shift) assert(-2 <= s && s <= 2);
+            ++rot_seen[a.rot];
+            augment::Transform c = augment::draw(cfg, 9, 4, i);
+            epoch_differs |= c.drop_seed != a.drop_seed;
+        }
+        assert(epoch_differs);
+        for (int r : rot_seen) assert(r > 20);
+
+        augment::Config off;
+        off.rotate = off.flip_x = off.flip_z = false;
+        off.max_shift = 0;
+        const Tensor3D x0 = occupancy(randomGrid(32, 0.05, 1, 4));
+        Tensor3D x = x0;
+        augment::apply(augment::draw(off, 1, 1, 1), x);
+        assert(same(x, x0));
+    }
+
+    // 6) DataLoader: аугментируются только обучающие образцы; PrefetchLoader
+    //    в любом числе потоков выдаёт то же, что nextBatch
+    const std::string dir = "test_augment_data";
+    ::mkdir(dir.c_str(), 0755);
+    const int n = 10;
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/a%03d", i);
+        writeCloud(dir + stem + ".bin", i);
+        std::ofstream(dir + stem + "_cls.txt") << (i % 3) << "\n";
+    }
+    {
+        augment::Config cfg;
+        cfg.dropout = 0.1f;
+        DataLoader plain(dir, 4, 0.2f), aug(dir, 4, 0.2f);
+        aug.enableAugmentation(cfg, 11);
+        assert(aug.augmenting() && !plain.augmenting());
+        aug.reset(5);
+        SampleBatch batch;
+        aug.nextBatch(batch, true);
+        for (size_t i = 0; i < batch.x.size(); ++i) {
+            Tensor3D x;
+            int label;
+            plain.loadSample(i, x, label);
+            augment::apply(augment::draw(cfg, 11, 5, i), x);
+            assert(same(batch.x[i], x) && batch.y[i] == label);
+        }
+        aug.nextBatch(batch, false);  // валидация без изменений
+        for (size_t i = 0; i < batch.x.size(); ++i) {
+            Tensor3D x;
+            int label;
+            plain.loadSample(8 + i, x, label);
+            assert(same(batch.x[i], x));
+        }
+
+        // Сегментация: маска и метки преобразуются согласованно
+        aug.reset(6);
+        auto seg_batch = aug.nextSegBatch(true);
+        for (size_t i = 0; i < seg_batch.first.size(); ++i) {
+            Tensor3D x, seg;
+            plain.loadSegSample(i, x, seg);
+            augment::apply(augment::draw(cfg, 11, 6, i), x, &seg);
+            assert(same(seg_batch.first[i], x) && same(seg_batch.second[i], seg));
+        }
+
+        // Кэш: со второго чтения маска преобразуется упакованной, результат тот же
+        {
+            DataLoader cached(dir, 4, 0.2f);
+            cached.enableCache(1 << 20);
+            cached.enableAugmentation(cfg, 11);
+            for (uint64_t e : {1, 2})
+                for (size_t i = 0; i < 10; ++i) {
+                    Tensor3D x, expect;
+                    int label, expect_label;
+                    cached.loadAugmented(i, e, x, label);
+                    plain.loadSample(i, expect, expect_label);
+                    if (i < 8) augment::apply(augment::draw(cfg, 11, e, i), expect);
+                    assert(same(x, expect) && label == expect_label);
+                }
+            const auto st = cached.cache()->stats();
+            assert(st.misses == 10 && st.hits == 10);
+        }
+
+        for (int threads : {0, 2}) {
+            DataLoader ref(dir, 4, 0.2f), src(dir, 4, 0.2f);
+            for (DataLoader* d : {&ref, &src}) {
+                d->setOrder(DataLoader::Order::Shuffle, 3);
+                d->enableAugmentation(cfg, 11);
+            }
+            if (threads) {  // вторая эпоха — из кэша мимо пакетного чтения
+                src.enableCache(1 << 20);
+                src.enableBatchedIo(BatchFileReader::Backend::PreadPool, 2);
+            }
+            PrefetchLoader pf(src, threads, 2);
+            // Вторая эпоха планируется до того, как прочитана первая
+            for (int e = 1; e <= 2; ++e) {
+                src.reset(e);
+                pf.schedule(true, 2);
+                pf.schedule(false, 1);
+            }
+            PrefetchLoader::Batch b;
+            for (int e = 1; e <= 2; ++e) {
+                ref.reset(e);
+                for (int s = 0; s < 3; ++s) {
+                    pf.next(b);
+                    auto expect = ref.nextBatch(s < 2);
+                    assert(b.y == expect.second);
+                    for (size_t i = 0; i < b.x.size(); ++i) assert(same(b.x[i], expect.first[i]));
+                }
+            }
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/a%03d", i);
+        std::remove((dir + stem + ".bin").c_str());
+        std::remove((dir + stem + "_cls.txt").c_str());
+    }
+    ::rmdir(dir.c_str());
+
+    // 6б) Шарды: преобразование упакованной маски совпадает с loadSample + apply
+    {
+        const std::string sdir = "test_augment_shards";
+        ::mkdir(sdir.c_str(), 0755);
+        {
+            ShardWriter w(sdir + "/s.pgs", 32, false);
+            for (int i = 0; i < n; ++i) w.add("s" + std::to_string(i), occupancy(randomGrid(32, 0.05, 1, 20 + i)), i % 3);
+            w.finish();
+        }
+        augment::Config cfg;
+        cfg.dropout = 0.2f;
+        DataLoader plain(sdir, 4, 0.2f), aug(sdir, 4, 0.2f);
+        assert(aug.sharded());
+        aug.enableAugmentation(cfg, 13);
+        for (size_t i = 0; i < static_cast<size_t>(n); ++i) {
+            Tensor3D x, expect;
+            int label, expect_label;
+            aug.loadAugmented(i, 2, x, label);
+            plain.loadSample(i, expect, expect_label);
+            if (i < aug.getNumTrainSamples()) augment::apply(augment::draw(cfg, 13, 2, i), expect);
+            assert(same(x, expect) && label == expect_label);
+        }
+        std::remove((sdir + "/s.pgs").c_str());
+        ::rmdir(sdir.c_str());
+    }
+
+    // 7) Время на образец 32³ (упаковка, преобразование, распаковка)
+    {
+        augment::Config cfg;
+        cfg.dropout = 0.1f;
+        Tensor3D x = occupancy(randomGrid(32, 0.03, 1, 7));
+        const int reps = 20000;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; ++i) augment::apply(augment::draw(cfg, 1, 1, i), x);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / reps;
+        std::cout << "аугментация 32³: " << us << " мкс на образец\n";
+
+        std::vector<uint32_t> bits(32 * 32);
+        shard::packBits(x.data(), x.size(), reinterpret_cast<uint8_t*>(bits.data()));
+        t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < reps; ++i) augment::applyPacked(augment::draw(cfg, 1, 1, i), bits.data(), bits.data());
+        us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / reps;
+        std::cout << "из них над упакованной маской: " << us << " мкс\n";
+    }
+
+    std::cout << "[OK] Augment tests passed\n";
+    return 0;
+}
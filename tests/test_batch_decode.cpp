@@ -0,0 +1,148 @@
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/DataLoader.h"
+#include "data/PrefetchLoader.h"
+#include "data/Shard.h"
+#include "TestUtils.h"
+
+using testutil::sameBatch;
+
+// Счётчик выделений кучи во всём процессе (все потоки)
+static std::atomic<size_t> g_allocs{0};
+
+void* operator new(size_t n) {
+    ++g_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    std::cout << "=== Тест декодирования в батч ===\n";
+    const std::string dir = "test_batch_decode_ply", shard_dir = "test_batch_decode_pgs";
+    ::mkdir(dir.c_str(), 0755);
+    ::mkdir(shard_dir.c_str(), 0755);
+    const int n = 22;
+    // Образец i: воксели (i, 0, 0) и (0, i, 31), класс i % 5
+    for (int i = 0; i < n; ++i) testutil::writeSample(testutil::stem(dir, i), {{i, 0, 0}, {0, i, 31}}, i % 5);
+    {
+        ShardWriter w(shard_dir + "/shard-00000.pgs", 32, false);
+        for (int i = 0; i < n; ++i) {
+            char stem[32];
+            std::snprintf(stem, sizeof(stem), "/s%03d", i);
+            w.add(stem + 1, DataLoader::loadVoxelMask(dir + stem + ".ply"), i % 5);
+        }
+        w.finish();
+    }
+
+    // 1) SampleBatch::resize сохраняет тензоры при укорочении и удлинении
+    {
+        SampleBatch b;
+        b.resize(3);
+        for (auto& t : b.x) t = Tensor3D(32, 32, 32, 1);
+        const float* kept = b.x[2].data();
+        b.resize(1);
+        b.resize(3);
+        assert(b.x[2].data() == kept && b.x.size() == 3 && b.y.size() == 3);
+    }
+
+    // 2) nextBatch(SampleBatch&) выдаёт то же, что прежний nextBatch,
+    //    и пишет в те же тензоры
+    for (const std::string& src : {dir, shard_dir}) {
+        DataLoader a(src, 4, 0.25f), b(src, 4, 0.25f);
+        a.setOrder(DataLoader::Order::Shuffle, 1);
+        b.setOrder(DataLoader::Order::Shuffle, 1);
+        SampleBatch batch;
+        for (int e = 0; e < 2; ++e) {
+            a.reset(); b.reset();
+            for (int s = 0; s < 5; ++s) {  // 16 = 4·4 + пустой
+                a.nextBatch(batch, true);
+                assert(sameBatch(batch, b.nextBatch(true)));
+            }
+            a.nextBatch(batch, false);
+            assert(sameBatch(batch, b.nextBatch(false)));
+        }
+        const float* p0 = batch.x[0].data();
+        a.reset();
+        a.nextBatch(batch, true);
+        assert(batch.x[0].data() == p0);
+    }
+
+    // 3) Установившийся режим над шардами: ни одного выделения памяти
+    {
+        DataLoader dl(shard_dir, 5, 0.0f);
+        dl.setOrder(DataLoader::Order::Shuffle, 2);
+        SampleBatch batch;
+        for (int s = 0; s < 5; ++s) dl.nextBatch(batch, true);  // прогрев: 5+5+5+5+2
+        dl.reset(7);  // новая перестановка — отдельно, до замера
+        size_t before = g_allocs.load();
+        for (int s = 0; s < 5; ++s) dl.nextBatch(batch, true);
+        size_t allocs = g_allocs.load() - before;
+        std::cout << "DataLoader: выделений за эпоху " << allocs << "\n";
+        assert(allocs == 0);
+
+        // Кэш после заполнения — тоже без выделений
+        dl.enableCache(1 << 20);
+        dl.reset(8);
+        for (int s = 0; s < 5; ++s) dl.nextBatch(batch, true);
+        dl.reset(8);
+        before = g_allocs.load();
+        for (int s = 0; s < 5; ++s) dl.nextBatch(batch, true);
+        allocs = g_allocs.load() - before;
+        std::cout << "DataLoader + кэш: выделений за эпоху " << allocs << "\n";
+        assert(allocs == 0);
+    }
+
+    // 4) PrefetchLoader: буферы ходят по кругу через пул, фоновые потоки
+    //    пишут в уже выделенные тензоры
+    for (int threads : {0, 2}) {
+        DataLoader dl(shard_dir, 4, 0.0f);  // 22 образца: 5 полных батчей + 2
+        PrefetchLoader pf(dl, threads, 2);
+        for (int e = 0; e < 3; ++e) {
+            dl.reset();
+            pf.schedule(true, 6);
+        }
+        // Первая эпоха — прогрев пула: перед каждым next() окно заполнено
+        // целиком, так что в обороте уже все depth + 1 буферов
+        PrefetchLoader::Batch batch;
+        for (int s = 0; s < 6; ++s) {
+            while (threads && pf.ready() < 2) std::this_thread::yield();
+            pf.next(batch);
+        }
+
+        std::vector<int> labels;
+        labels.reserve(2 * n);
+        size_t before = g_allocs.load();
+        for (int s = 0; s < 12; ++s) {
+            pf.next(batch);
+            labels.insert(labels.end(), batch.y.begin(), batch.y.end());
+        }
+        size_t allocs = g_allocs.load() - before;
+        std::cout << "PrefetchLoader(" << threads << "): выделений за 2 эпохи " << allocs << "\n";
+        assert(allocs == 0);
+        assert(labels.size() == 2 * n);
+        for (size_t i = 0; i < labels.size(); ++i) assert(labels[i] == static_cast<int>(i % n) % 5);
+    }
+
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/s%03d", i);
+        std::remove((dir + stem + ".ply").c_str());
+        std::remove((dir + stem + "_cls.txt").c_str());
+    }
+    std::remove((shard_dir + "/shard-00000.pgs").c_str());
+    ::rmdir(dir.c_str());
+    ::rmdir(shard_dir.c_str());
+    std::cout << "[OK] Batch decode tests passed\n";
+    return 0;
+}
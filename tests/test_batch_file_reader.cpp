@@ -0,0 +1,175 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/BatchFileReader.h"
+#include "data/DataLoader.h"
+#include "data/PrefetchLoader.h"
+#include "TestUtils.h"
+
+using testutil::sameBatch;
+using Backend = BatchFileReader::Backend;
+
+static std::string content(int i) {
+    std::string s = "file " + std::to_string(i) + "\n";
+    s.append(static_cast<size_t>(i * 37 % 500), static_cast<char>('a' + i % 26));
+    return s;
+}
+
+int main() {
+    std::cout << "=== Тест BatchFileReader ===\n";
+    const bool uring = BatchFileReader::uringAvailable();
+    std::cout << "io_uring: " << (uring ? "есть" : "нет, проверяется только pread") << "\n";
+    std::vector<Backend> backends = {Backend::PreadPool};
+    if (uring) backends.push_back(Backend::IoUring);
+
+    const std::string dir = "test_bfr_data";
+    ::mkdir(dir.c_str(), 0755);
+    const int nf = 50;
+    std::vector<std::string> paths;
+    for (int i = 0; i < nf; ++i) {
+        paths.push_back(dir + "/f" + std::to_string(i) + ".txt");
+        std::ofstream(paths.back(), std::ios::binary) << content(i);
+    }
+    const std::string empty = dir + "/empty.txt", big = dir + "/big.bin", missing = dir + "/nope.txt";
+    std::ofstream(empty).close();
+    std::string big_data(3 << 20, '\0');
+    for (size_t i = 0; i < big_data.size(); ++i) big_data[i] = static_cast<char>(i * 131 % 251);
+    std::ofstream(big, std::ios::binary) << big_data;
+
+    // 1) Содержимое и ошибки; файлов больше, чем глубина кольца
+    for (Backend b : backends) {
+        for (int threads : {0, 3}) {
+            BatchFileReader r(b, threads, /*ring_entries=*/8);
+            assert(r.backend() == b);
+            std::vector<std::vector<char>> out(nf + 3, std::vector<char>(7, 'x'));
+            std::vector<BatchFileReader::Request> reqs;
+            for (int i = 0; i < nf; ++i) reqs.push_back({paths[i].c_str(), &out[i], -1});
+            reqs.push_back({empty.c_str(),   &out[nf],     -1});
+            reqs.push_back({big.c_str(),     &out[nf + 1], -1});
+            reqs.push_back({missing.c_str(), &out[nf + 2], -1});
+            r.readAll(reqs.data(), reqs.size());
+            for (int i = 0; i < nf; ++i)
+                assert(reqs[i].error == 0 && std::string(out[i].begin(), out[i].end()) == content(i));
+            assert(reqs[nf].error == 0 && out[nf].empty());
+            assert(reqs[nf + 1].error == 0 && std::string(out[nf + 1].begin(), out[nf + 1].end()) == big_data);
+            assert(reqs[nf + 2].error == ENOENT);
+        }
+    }
+
+    // 2) Одновременные readAll из нескольких потоков
+    for (Backend b : backends) {
+        BatchFileReader r(b, 2, 16);
+        std::vector<std::thread> th;
+        std::vector<int> ok(4, 1);
+        for (int t = 0; t < 4; ++t)
+            th.emplace_back([&, t] {
+                for (int rep = 0; rep < 20; ++rep) {
+                    std::vector<std::vector<char>> out(nf);
+                    std::vector<BatchFileReader::Request> reqs;
+                    for (int i = t; i < nf; i += 2) reqs.push_back({paths[i].c_str(), &out[i], 0});
+                    r.readAll(reqs.data(), reqs.size());
+                    for (int i = t; i < nf; i += 2)
+                        if (std::string(out[i].begin(), out[i].end()) != content(i)) ok[t] = 0;
+                }
+            });
+        for (auto& t : th) t.join();
+        for (int v : ok) assert(v);
+    }
+    for (const auto& p : paths) std::remove(p.c_str());
+    std::remove(empty.c_str());
+    std::remove(big.c_str());
+
+    // 3) PrefetchLoader с пакетным чтением: те же батчи, что у обычного пути
+    const int n = 30;
+    // Образец i: воксели (i, 1, 2) и (3, i, 30), класс i % 7
+    for (int i = 0; i < n; ++i) testutil::writeSample(testutil::stem(dir, i), {{i, 1, 2}, {3, i, 30}}, i % 7);
+    for (Backend b : backends) {
+        for (int threads : {0, 1, 3}) {
+            DataLoader ref(dir, 4, 0.2f), src(dir, 4, 0.2f);
+            src.enableBatchedIo(b, 2);
+            assert(src.batchedIo());
+            for (DataLoader* d : {&ref, &src}) d->setOrder(DataLoader::Order::Shuffle, 4);
+            PrefetchLoader pf(src, threads, 3);
+            for (int e = 0; e < 2; ++e) {
+                src.reset();
+                pf.schedule(true, 6);
+                pf.schedule(false, 2);
+            }
+            PrefetchLoader::Batch batch;
+            for (int e = 0; e < 2; ++e) {
+                ref.reset();
+                for (int s = 0; s < 6; ++s) {
+                    pf.next(batch);
+                    assert(sameBatch(batch, ref.nextBatch(true)));
+                }
+                for (int s = 0; s < 2; ++s) {
+                    pf.next(batch);
+                    assert(sameBatch(batch, ref.nextBatch(false)));
+                }
+            }
+            assert(pf.stats().fetch_seconds > 0.0);
+        }
+    }
+
+    // 4) Образцы из кэша не читаются; ошибка чтения всплывает из next()
+    {
+        DataLoader dl(dir, 5, 0.0f);
+        dl.enableBatchedIo();
+        dl.enableCache(1 << 20);
+        Tensor3D x;
+        int label;
+        dl.loadSample(3, x, label);
+        size_t idx[2] = {3, 4};
+        DataLoader::RawSample raw[2];
+        dl.fetchRaw(idx, 2, raw);
+        assert(raw[0].cached && raw[0].points.empty());
+        assert(!raw[1].cached && !raw[1].points.empty() && raw[1].error == 0);
+        dl.loadSample(4, raw[1], x, label);
+        assert(label == 4 && x(4, 1, 2, 0) == 1.0f && x(3, 4, 30, 0) == 1.0f);
+
+        testutil::writeSample(testutil::stem(dir, n), {{n, 1, 2}, {3, n, 30}});  // s030 без _cls.txt
+        DataLoader broken(dir, 31, 0.0f);
+        broken.enableBatchedIo();
+        PrefetchLoader pf(broken, 2, 1);
+        pf.schedule(true, 1);
+        bool threw = false;
+        try { pf.next(); } catch (const std::runtime_error& e) {
+            threw = std::string(e.what()).find("s030_cls.txt") != std::string::npos;
+        }
+        assert(threw);
+        std::remove((dir + "/s030.ply").c_str());
+    }
+
+    // 5) Время эпохи по одному файлу и пакетами (кэш страниц тёплый — это нижняя граница)
+    {
+        for (int mode = 0; mode < 1 + static_cast<int>(backends.size()); ++mode) {
+            DataLoader dl(dir, 10, 0.0f);
+            if (mode > 0) dl.enableBatchedIo(backends[mode - 1], 4);
+            PrefetchLoader pf(dl, 0, 1);
+            pf.schedule(true, 3);
+            auto t0 = std::chrono::steady_clock::now();
+            PrefetchLoader::Batch batch;
+            for (int s = 0; s < 3; ++s) pf.next(batch);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            std::cout << (mode == 0 ? "по одному" : BatchFileReader::name(backends[mode - 1]))
+                      << ": " << ms << " мс на " << n << " образцов\n";
+        }
+    }
+
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/s%03d", i);
+        std::remove((dir + stem + ".ply").c_str());
+        std::remove((dir + stem + "_cls.txt").c_str());
+    }
+    ::rmdir(dir.c_str());
+    std::cout << "[OK] BatchFileReader tests passed\n";
+    return 0;
+}
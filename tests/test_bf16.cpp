@@ -0,0 +1,132 @@
+#include "net/Tensor3DBF16.h"
+#include "layers/Conv3D.h"
+#include "network/network.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <random>
+
+static float relErr(const std::vector<float>& a, const std::vector<float>& b) {
+    double num = 0, den = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        num += double(a[i] - b[i]) * (a[i] - b[i]);
+        den += double(b[i]) * b[i];
+    }
+    return static_cast<float>(std::sqrt(num / (den + 1e-30)));
+}
+
+int main() {
+    std::cout << "=== Тест bf16 ===\n";
+
+    // Перевод float ↔ bf16: округление к ближайшему чётному
+    {
+        assert(bf16::fromFloat(1.0f) == 0x3F80);
+        assert(bf16::toFloat(0x3F80) == 1.0f);
+        assert(bf16::fromFloat(-2.0f) == 0xC000);
+        // 1 + 2^-8 ровно посередине между 1 и 1 + 2^-7 → к чётному (1)
+        assert(bf16::toFloat(bf16::fromFloat(1.0f + 1.0f / 256)) == 1.0f);
+        // 1 + 3·2^-8 посередине между 1 + 2^-7 и 1 + 2^-6 → к чётному (1 + 2^-6)
+        assert(bf16::toFloat(bf16::fromFloat(1.0f + 3.0f / 256)) == 1.0f + 1.0f / 64);
+        assert(std::isnan(bf16::toFloat(bf16::fromFloat(NAN))));
+        assert(bf16::positive(bf16::fromFloat(0.5f)));
+        assert(!bf16::positive(bf16::fromFloat(-0.5f)));
+        assert(!bf16::positive(0));
+
+        // Пакетный перевод совпадает со скалярным (включая хвост)
+        std::mt19937 rng(1);
+        std::normal_distribution<float> nd(0.0f, 10.0f);
+        std::vector<float> src(37), back(37);
+        std::vector<uint16_t> h(37);
+        for (auto& v : src) v = nd(rng);
+        bf16::fromFloat(src.data(), h.data(), src.size());
+        bf16::toFloat(h.data(), back.data(), h.size());
+        for (size_t i = 0; i < src.size(); ++i) {
+            assert(h[i] == bf16::fromFloat(src[i]));
+            assert(back[i] == bf16::toFloat(h[i]));
+            assert(std::fabs(back[i] - src[i]) <= std::fabs(src[i]) / 256);
+        }
+    }
+
+    // Conv3D в bf16 против fp32 на тех же (округлённых до bf16) данных
+    {
+        Conv3D conv(2, 20, 3, 3, 3, 1, 1, 1, Conv3D::Padding::SAME);
+        for (auto& w : conv.weight()) w = bf16::toFloat(bf16::fromFloat(w));
+        for (int i = 0; i < 20; ++i) conv.bias()[i] = 0.01f * i;
+
+        Tensor3D x(5, 4, 6, 2);
+        for (int i = 0; i < x.size(); ++i)
+            x.data()[i] = (i % 5 == 0) ? 0.0f : bf16::toFloat(bf16::fromFloat(0.1f * (i % 7) - 0.3f));
+
+        Tensor3D y32 = conv.forward(x);
+        Tensor3DBF16 x16, y16;
+        x16.assign(x);
+        conv.forward(x16, y16);
+        assert(y16.depth() == y32.depth() && y16.channels() == 20);
+        Tensor3D y = y16.toFloat();
+        for (int i = 0; i < y.size(); ++i)
+            assert(std::fabs(y.data()[i] - y32.data()[i]) <= 1e-2f * (1.0f + std::fabs(y32.data()[i])));
+
+        // Градиенты весов: bf16-путь против fp32
+        Tensor3D go(y32.depth(), y32.height(), y32.width(), 20);
+        for (int i = 0; i < go.size(); ++i) go.data()[i] = bf16::toFloat(bf16::fromFloat(0.05f * ((i % 11) - 5)));
+        conv.zeroGrad();
+        conv.backward(x, go);
+        std::vector<float> gw32(conv.weightGrad().begin(), conv.weightGrad().end());
+        std::vector<float> gb32(conv.biasGrad().begin(),   conv.biasGrad().end());
+        conv.zeroGrad();
+        Tensor3DBF16 go16;
+        go16.assign(go);
+        conv.backwardParams(x16, go16);
+        std::vector<float> gw16(conv.weightGrad().begin(), conv.weightGrad().end());
+        std::vector<float> gb16(conv.biasGrad().begin(),   conv.biasGrad().end());
+        assert(relErr(gw16, gw32) < 1e-5f);
+        assert(relErr(gb16, gb32) < 1e-5f);
+    }
+
+    // Network: логиты и градиенты в bf16 близки к fp32
+    {
+        Network net;
+        Tensor3D x(8, 8, 8, 1);
+        for (int i = 0; i < x.size(); ++i) x.data()[i] = (i % 3 == 0) ? 1.0f : 0.0f;
+
+        net.zeroGrad();
+        auto l32 = net.forward(x, false);
+        net.computeLoss({3});
+        net.backward();
+        std::vector<float> g32(net.flatGradients(), net.flatGradients() + net.flatSize());
+
+        net.setBF16Activations(true);
+        net.zeroGrad();
+        auto l16 = net.forward(x, false);
+        net.computeLoss({3});
+        net.backward();
+        std::vector<float> g16(net.flatGradients(), net.flatGradients() + net.flatSize());
+
+        assert(relErr(l16, l32) < 3e-2f);
+        assert(relErr(g16, g32) < 5e-2f);
+    }
+
+    // Обучение в bf16: потеря на одном примере падает
+    {
+        Network net;
+        net.setBF16Activations(true);
+        Tensor3D x(8, 8, 8, 1);
+        for (int i = 0; i < x.size(); ++i) x.data()[i] = (i % 4 == 1) ? 1.0f : 0.0f;
+        float first = 0, last = 0;
+        for (int it = 0; it < 20; ++it) {
+            net.zeroGrad();
+            net.forward(x, true);
+            float loss = net.computeLoss({7});
+            net.backward();
+            net.optimize();
+            if (it == 0) first = loss;
+            last = loss;
+        }
+        std::cout << "loss: " << first << " -> " << last << "\n";
+        assert(last < first);
+    }
+
+    std::cout << "[OK] bf16 tests passed\n";
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <cmath>
+#include <cassert>
+#include <random>
+#include "network/network.h"
+#include "train/DataParallelTrainer.h"
+
+static void copyParams(Network& from, Network& to) {
+    auto src = from.parameters();
+    auto dst = to.parameters();
+    for (size_t i = 0; i < src.size(); ++i) *dst[i] = *src[i];
+}
+
+int main(){
+    std::cout << "=== Тест DataParallelTrainer ===\n";
+
+    std::mt19937 gen(7);
+    std::bernoulli_distribution occ(0.3);
+    std::uniform_int_distribution<int> cls(0, 9);
+
+    Network seq, par;
+    copyParams(seq, par);
+    DataParallelTrainer trainer(par, 3);
+    assert(trainer.workers() == 3);
+
+    for (int step = 0; step < 3; ++step) {
+        // Батч из 7 образцов — делится на куски 2/2/3
+        std::vector<Tensor3D> xs;
+        std::vector<int>      ys;
+        for (int i = 0; i < 7; ++i) {
+            Tensor3D x(8, 8, 8, 1);
+            for (int j = 0; j < x.size(); ++j) x.data()[j] = occ(gen) ? 1.0f : 0.0f;
+            xs.push_back(x);
+            ys.push_back(cls(gen));
+        }
+
+        // Последовательное накопление градиентов
+        double seq_loss = 0.0;
+        seq.zeroGrad();
+        for (size_t i = 0; i < xs.size(); ++i) {
+            seq.forward(xs[i], true);
+            seq_loss += seq.computeLoss({ys[i]});
+            seq.backward();
+        }
+        seq.optimize();
+
+        auto r = trainer.step(xs, ys);
+        assert(r.samples == 7);
+        std::cout << "step " << step << ": loss seq=" << seq_loss
+                  << " par=" << r.loss_sum << "\n";
+        assert(std::fabs(r.loss_sum - seq_loss) < 1e-3 * (1.0 + std::fabs(seq_loss)));
+
+        auto a = seq.parameters();
+        auto b = par.parameters();
+        float max_diff = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i)
+            for (size_t j = 0; j < a[i]->size(); ++j)
+                max_diff = std::max(max_diff, std::fabs((*a[i])[j] - (*b[i])[j]));
+        std::cout << "  max |Δw| = " << max_diff << "\n";
+        assert(max_diff < 1e-4f);
+    }
+
+    std::cout << "[OK] DataParallelTrainer tests passed\n";
+    return 0;
+}
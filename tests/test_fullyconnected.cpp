@@ -9,11 +9,11 @@ int main(){
     FullyConnected fc(2, 2);
     {
         // Поменяем метод init, захардкодим
-        auto& W = const_cast<std::vector<float>&>(fc.weight());
+        auto& W = fc.weight();
         // Формат: row-major: [ W00, W01,  W10, W11 ]
         W = { 1.0f, 0.0f,
               0.0f, 1.0f };
-        auto& B = const_cast<std::vector<float>&>(fc.bias());
+        auto& B = fc.bias();
         B = { 1.0f, 2.0f };
     }
 
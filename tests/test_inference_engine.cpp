@@ -0,0 +1,128 @@
+#include <iostream>
+#include <cmath>
+#include <cassert>
+#include <random>
+#include <thread>
+#include <cstdio>
+#include "network/network.h"
+#include "network/Checkpoint.h"
+#include "infer/InferenceEngine.h"
+
+static Tensor3D randomGrid(std::mt19937& gen) {
+    std::bernoulli_distribution occ(0.3);
+    Tensor3D x(8, 8, 8, 1);
+    for (int i = 0; i < x.size(); ++i) x.data()[i] = occ(gen) ? 1.0f : 0.0f;
+    return x;
+}
+
+int main(){
+    std::cout << "=== Тест InferenceEngine ===\n";
+
+    std::mt19937 gen(42);
+    Network net;
+    InferenceEngine engine(net);
+    assert(engine.numClasses() == 10);
+
+    // 1) Совпадение с Network::forward(x, false)
+    std::vector<Tensor3D> xs;
+    for (int i = 0; i < 16; ++i) xs.push_back(randomGrid(gen));
+    std::vector<std::vector<float>> ref;
+    for (const auto& x : xs) {
+        auto a = net.forward(x, /*training=*/false);
+        auto b = engine.forward(x);
+        assert(a.size() == b.size());
+        for (size_t j = 0; j < a.size(); ++j)
+            assert(std::fabs(a[j] - b[j]) < 1e-3f);
+        ref.push_back(a);
+    }
+    std::cout << "forward совпадает с Network\n";
+
+    // 2) Батч в несколько потоков даёт те же логиты
+    auto batch = engine.forwardBatch(xs, 4);
+    assert(batch.size() == xs.size() * 10);
+    for (size_t i = 0; i < xs.size(); ++i)
+        for (int j = 0; j < 10; ++j)
+            assert(std::fabs(batch[i*10 + j] - ref[i][j]) < 1e-3f);
+    std::cout << "forwardBatch (4 потока) совпадает\n";
+
+    // 2б) Арены вызывающего переиспользуются от батча к батчу
+    std::vector<InferenceEngine::Workspace> arenas(3);
+    std::vector<float> again(xs.size() * 10);
+    for (int rep = 0; rep < 2; ++rep) {
+        engine.forwardBatch(xs.data(), xs.size(), again.data(), arenas);
+        assert(again == batch);
+    }
+    assert(arenas.size() == 3 && !arenas[0].conv.empty());
+
+    // 3) Одновременные вызовы одного движка из разных потоков
+    std::vector<std::thread> threads;
+    std::vector<int> ok(4, 1);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            InferenceEngine::Workspace ws;
+            float logits[10];
+            for (int rep = 0; rep < 20; ++rep)
+                for (size_t i = 0; i < xs.size(); ++i) {
+                    engine.forward(xs[i], ws, logits);
+                    for (int j = 0; j < 10; ++j)
+                        if (std::fabs(logits[j] - ref[i][j]) >= 1e-3f) ok[t] = 0;
+                }
+        });
+    }
+    for (auto& th : threads) th.join();
+    for (int v : ok) assert(v);
+
+    // 4) Смещение свёртки сокращается в BN по образцу — движок его не хранит
+    {
+        Network biased;
+        ParamBuffer& bias = *biased.parameters()[1];  // conv1.bias
+        for (size_t c = 0; c < bias.size(); ++c) bias[c] = 0.5f * c - 3.0f;
+        InferenceEngine e(biased);
+        for (const auto& x : xs) {
+            auto a = biased.forward(x, /*training=*/false);
+            auto b = e.forward(x);
+            for (size_t j = 0; j < a.size(); ++j) assert(std::fabs(a[j] - b[j]) < 1e-3f);
+        }
+    }
+
+    // 5) Упакованная модель: те же логиты бит в бит, веса читаются на месте
+    {
+        const std::string path = "test_inference_engine.packed";
+        engine.exportPacked(path);
+        assert(InferenceEngine::isPacked(path));
+        InferenceEngine packed(path);
+        InferenceEngine copy = packed;  // копия делит отображение
+        assert(packed.numClasses() == 10 && packed.inputChannels() == 1);
+        for (size_t i = 0; i < xs.size(); ++i) {
+            auto r = engine.forward(xs[i]);
+            auto a = packed.forward(xs[i]);
+            auto b = copy.forward(xs[i]);
+            for (int j = 0; j < 10; ++j) assert(a[j] == r[j] && b[j] == r[j]);
+        }
+
+        // Упакованная модель не является обучающим чекпоинтом
+        Network n;
+        bool threw = false;
+        try { n.loadCheckpoint(path); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+
+        // Чужая раскладка (другая ширина блока) — отказ, а не неверные логиты
+        {
+            MappedCheckpoint ck(path);
+            const size_t n = ck.find("packed.meta")->count;
+            const int32_t* m = ck.ints("packed.meta", n);
+            std::vector<int32_t> meta(m, m + n);
+            meta[1] = InferenceEngine::kLanes * 2;
+            CheckpointWriter w;
+            w.add("packed.meta", {static_cast<uint32_t>(meta.size())}, meta.data());
+            w.write(path);
+        }
+        threw = false;
+        try { InferenceEngine bad(path); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        std::remove(path.c_str());
+    }
+
+    std::cout << "[OK] InferenceEngine tests passed\n";
+    return 0;
+}
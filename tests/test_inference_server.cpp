@@ -0,0 +1,91 @@
+#include <iostream>
+#include <cmath>
+#include <cassert>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include "network/network.h"
+#include "infer/InferenceEngine.h"
+#include "infer/InferenceServer.h"
+
+int main(){
+    std::cout << "=== Тест InferenceServer ===\n";
+
+    Network net;
+    InferenceEngine engine(net);
+
+    ServerConfig cfg;
+    cfg.socket_path = "/tmp/pointgrid_test_" + std::to_string(::getpid()) + ".sock";
+    cfg.max_batch   = 4;
+    cfg.max_wait_us = 5000;
+    cfg.threads     = 2;
+    cfg.grid        = 8;
+
+    InferenceServer server(engine, cfg);
+    std::thread srv([&] { server.run(); });
+    while (!server.listening()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // 1) Несколько клиентов параллельно: ответы совпадают с движком
+    std::vector<std::thread> clients;
+    std::vector<int> ok(6, 1);
+    for (int c = 0; c < 6; ++c) {
+        clients.emplace_back([&, c] {
+            std::mt19937 gen(c);
+            std::bernoulli_distribution occ(0.3);
+            InferenceClient client(cfg.socket_path);
+            for (int rep = 0; rep < 10; ++rep) {
+                Tensor3D x(8, 8, 8, 1);
+                for (int i = 0; i < x.size(); ++i) x.data()[i] = occ(gen) ? 1.0f : 0.0f;
+                auto got  = client.classifyGrid(x);
+                auto want = engine.forward(x);
+                if (got.size() != want.size()) { ok[c] = 0; continue; }
+                for (size_t j = 0; j < got.size(); ++j)
+                    if (std::fabs(got[j] - want[j]) > 1e-5f) ok[c] = 0;
+            }
+        });
+    }
+    for (auto& th : clients) th.join();
+    for (int v : ok) assert(v);
+    std::cout << "60 запросов GRID обработаны корректно\n";
+
+    // 2) Облако точек растеризуется в сетку grid³
+    {
+        InferenceClient client(cfg.socket_path);
+        std::vector<float> xyz = {0,0,0,  1,2,3,  7,7,7,  100,0,0};
+        Tensor3D x(8, 8, 8, 1);
+        x(0,0,0,0) = 1.0f; x(1,2,3,0) = 1.0f; x(7,7,7,0) = 1.0f;
+        auto got  = client.classifyPoints(xyz);
+        auto want = engine.forward(x);
+        for (size_t j = 0; j < got.size(); ++j)
+            assert(std::fabs(got[j] - want[j]) < 1e-5f);
+
+        // 3) Счётчики
+        ServerStats s = client.stats();
+        std::cout << "requests=" << s.requests << " batches=" << s.batches
+                  << " mean_batch=" << s.mean_batch
+                  << " p50=" << s.p50_us << "us p99=" << s.p99_us << "us\n";
+        assert(s.requests == 61);
+        assert(s.batches >= 16 && s.batches <= 61);
+        assert(s.p50_us > 0.0 && s.p99_us >= s.p50_us);
+    }
+
+    // 4) Короткие соединения: потоки отключившихся клиентов не копятся
+    {
+        Tensor3D x(8, 8, 8, 1);
+        x(3, 3, 3, 0) = 1.0f;
+        for (int c = 0; c < 40; ++c) {
+            InferenceClient client(cfg.socket_path);
+            assert(client.classifyGrid(x).size() == static_cast<size_t>(engine.numClasses()));
+        }
+        // Поток закрывает соединение сам, join — на следующем витке accept (≤ 100 мс)
+        for (int w = 0; w < 100 && server.clientThreads() > 0; ++w)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::cout << "после 40 коротких соединений потоков: " << server.clientThreads() << "\n";
+        assert(server.clientThreads() == 0);
+    }
+
+    server.stop();
+    srv.join();
+    std::cout << "[OK] InferenceServer tests passed\n";
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "optim/LARS.h"
+#include "optim/LAMB.h"
+#include "network/network.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+static bool almostEqual(double a, double b, double tol = 1e-4) {
+    return std::fabs(a - b) < tol * (1.0 + std::fabs(b));
+}
+
+static double norm(const std::vector<double>& x) {
+    double s = 0.0;
+    for (double v : x) s += v * v;
+    return std::sqrt(s);
+}
+
+int main() {
+    std::cout << "=== Тест LARS / LAMB ===\n";
+
+    // Два тензора с сильно разным масштабом весов и градиентов:
+    // доверительный коэффициент считается по каждому отдельно
+    const size_t n1 = 37, n2 = 300;
+    std::vector<float> p(n1 + n2), g(n1 + n2);
+    for (size_t i = 0; i < n1; ++i)  p[i] = 0.5f + 0.01f * float(i);
+    for (size_t i = n1; i < p.size(); ++i) p[i] = 0.001f * std::cos(float(i));
+    for (size_t i = 0; i < n1; ++i)  g[i] = 0.001f * std::sin(float(i));
+    for (size_t i = n1; i < p.size(); ++i) g[i] = 2.0f * std::sin(float(3 * i));
+
+    // LARS против эталона в double
+    {
+        std::vector<float> w = p;
+        LARS opt(0.1f, 0.9f, 1e-4f, 0.02f);
+        opt.setThreads(2);
+        opt.addParam(w.data(), g.data(), n1);
+        opt.addParam(w.data() + n1, g.data() + n1, n2);
+
+        std::vector<double> rw(p.begin(), p.end()), rv(p.size(), 0.0);
+        for (int t = 0; t < 3; ++t) {
+            opt.step();
+            for (size_t blk = 0; blk < 2; ++blk) {
+                size_t lo = blk ? n1 : 0, hi = blk ? p.size() : n1;
+                std::vector<double> ws(rw.begin() + lo, rw.begin() + hi);
+                std::vector<double> gs(g.begin() + lo, g.begin() + hi);
+                double wn = norm(ws), gn = norm(gs);
+                double trust = 0.02 * wn / (gn + 1e-4 * wn);
+                assert(almostEqual(opt.trustRatios()[blk], trust));
+                for (size_t i = lo; i < hi; ++i) {
+                    rv[i] = 0.9 * rv[i] + 0.1 * trust * (g[i] + 1e-4 * rw[i]);
+                    rw[i] -= rv[i];
+                }
+            }
+        }
+        for (size_t i = 0; i < w.size(); ++i) assert(almostEqual(w[i], rw[i], 1e-3));
+        std::cout << "LARS trust = " << opt.trustRatios()[0] << ", " << opt.trustRatios()[1] << "\n";
+        assert(opt.getStateBuffers().size() == 2);
+    }
+
+    // LAMB против эталона в double
+    {
+        std::vector<float> w = p;
+        LAMB opt(0.01f, 0.9f, 0.999f, 1e-6f, 0.01f);
+        opt.addParam(w.data(), g.data(), n1);
+        opt.addParam(w.data() + n1, g.data() + n1, n2);
+
+        std::vector<double> rw(p.begin(), p.end()), rm(p.size(), 0.0), rv(p.size(), 0.0);
+        for (int t = 1; t <= 3; ++t) {
+            opt.step();
+            double bc1 = 1 - std::pow(0.9, t), bc2 = 1 - std::pow(0.999, t);
+            for (size_t blk = 0; blk < 2; ++blk) {
+                size_t lo = blk ? n1 : 0, hi = blk ? p.size() : n1;
+                std::vector<double> r(hi - lo), ws(rw.begin() + lo, rw.begin() + hi);
+                for (size_t i = lo; i < hi; ++i) {
+                    rm[i] = 0.9 * rm[i] + 0.1 * g[i];
+                    rv[i] = 0.999 * rv[i] + 0.001 * double(g[i]) * g[i];
+                    r[i - lo] = (rm[i] / bc1) / (std::sqrt(rv[i] / bc2) + 1e-6) + 0.01 * rw[i];
+                }
+                double trust = norm(ws) / norm(r);
+                assert(almostEqual(opt.trustRatios()[blk], trust));
+                for (size_t i = lo; i < hi; ++i) rw[i] -= 0.01 * trust * r[i - lo];
+            }
+        }
+        for (size_t i = 0; i < w.size(); ++i) assert(almostEqual(w[i], rw[i], 1e-3));
+        std::cout << "LAMB trust = " << opt.trustRatios()[0] << ", " << opt.trustRatios()[1] << "\n";
+
+        auto st = opt.getStateBuffers();
+        assert(st.size() == 4 && opt.steps() == 3);
+        LAMB other(0.01f);
+        std::vector<float> w2(p.size()), g2(p.size());
+        other.addParam(w2.data(), g2.data(), n1);
+        other.addParam(w2.data() + n1, g2.data() + n1, n2);
+        other.setStateBuffers(st);
+        other.setSteps(opt.steps());
+        assert(other.steps() == 3 && other.getStateBuffers() == st);
+    }
+
+    // Нулевые веса: коэффициент 1 (иначе тензор никогда не сдвинется)
+    {
+        std::vector<float> w(8, 0.0f), gz(8, 1.0f);
+        LARS opt(0.1f, 0.0f);
+        opt.addParam(w, gz);
+        opt.step();
+        assert(opt.trustRatios()[0] == 1.0f);
+        assert(almostEqual(w[0], -0.1));
+    }
+
+    // Буферы LARS по форме совпадают с буферами SGD с моментом: чекпоинт
+    // отличает их по записанному типу оптимизатора
+    {
+        Network a;
+        a.setOptimizer(std::make_unique<LARS>(0.1f, 0.9f));
+        const char* path = "test_lars_ckpt.bin";
+        a.saveCheckpoint(path);
+
+        Network sgd;
+        assert(sgd.optimizer().getStateBuffers().size() == a.optimizer().getStateBuffers().size());
+        bool threw = false;
+        try { sgd.loadCheckpoint(path); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+
+        Network b;
+        b.setOptimizer(std::make_unique<LARS>(0.1f, 0.9f));
+        b.loadCheckpoint(path);
+        std::remove(path);
+    }
+
+    std::cout << "[OK] LARS/LAMB tests passed\n";
+    return 0;
+}
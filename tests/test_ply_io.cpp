@@ -0,0 +1,167 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include "data/DataLoader.h"
+#include "data/PlyIO.h"
+
+static void writeText(const std::string& path, const std::string& s) {
+    std::ofstream(path, std::ios::binary) << s;
+}
+
+template <typename T>
+static void putBE(std::string& s, T v) {
+    unsigned char b[sizeof(T)];
+    std::memcpy(b, &v, sizeof(T));
+    for (size_t i = sizeof(T); i-- > 0;) s.push_back(static_cast<char>(b[i]));
+}
+
+static bool throws(const std::string& path) {
+    std::vector<float> xyz;
+    try { readPlyVertices(path, xyz); } catch (const std::runtime_error&) { return true; }
+    return false;
+}
+
+// Прежний разбор loadVoxelMask: getline по заголовку и in >> float
+static std::vector<float> readStream(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    size_t n = 0;
+    while (std::getline(in, line)) {
+        if (line.rfind("element vertex", 0) == 0) {
+            std::istringstream iss(line);
+            std::string a, b;
+            iss >> a >> b >> n;
+        }
+        if (line == "end_header") break;
+    }
+    std::vector<float> xyz(3 * n);
+    for (auto& v : xyz) in >> v;
+    return xyz;
+}
+
+int main() {
+    std::cout << "=== Тест PlyIO ===\n";
+    const std::string path = "test_ply_io.ply";
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<float> coord(-40.0f, 40.0f);
+
+    // 1) Запись и чтение в обоих форматах без потерь
+    {
+        std::vector<float> pts(3 * 1001);
+        for (auto& v : pts) v = coord(gen);
+        for (bool binary : {false, true}) {
+            writePlyVertices(path, pts.data(), pts.size() / 3, binary);
+            std::vector<float> back;
+            readPlyVertices(path, back);
+            assert(back == pts);  // to_chars/from_chars — кратчайшая точная запись
+        }
+    }
+
+    // 2) ASCII: лишние свойства, список после vertex, CRLF, табы, '+', экспонента
+    {
+        writeText(path,
+            "ply\r\nformat ascii 1.0\r\ncomment test\r\nelement vertex 2\r\n"
+            "property uchar red\r\nproperty float z\r\nproperty double x\r\n"
+            "property list uchar int idx\r\nproperty float y\r\n"
+            "element face 1\r\nproperty list uchar int vertex_indices\r\nend_header\r\n"
+            "255 3.5 +1 2 7 8 -2e1\r\n"
+            "0\t6 4 0 5\r\n"
+            "3 0 1 0\r\n");
+        std::vector<float> xyz;
+        readPlyVertices(path, xyz);
+        assert((xyz == std::vector<float>{1.0f, -20.0f, 3.5f, 4.0f, 5.0f, 6.0f}));
+    }
+
+    // 3) Бинарный big-endian: элемент до vertex, double и short координаты
+    {
+        std::string s = "ply\nformat binary_big_endian 1.0\nelement camera 2\nproperty int id\n"
+                        "element vertex 2\nproperty double x\nproperty uchar flag\n"
+                        "property short y\nproperty float z\nend_header\n";
+        putBE<int32_t>(s, 7); putBE<int32_t>(s, 8);
+        putBE<double>(s, 1.25); s.push_back(1); putBE<int16_t>(s, -3); putBE<float>(s, 9.5f);
+        putBE<double>(s, -4.0); s.push_back(0); putBE<int16_t>(s, 12); putBE<float>(s, 0.25f);
+        writeText(path, s);
+        std::vector<float> xyz;
+        readPlyVertices(path, xyz);
+        assert((xyz == std::vector<float>{1.25f, -3.0f, 9.5f, -4.0f, 12.0f, 0.25f}));
+    }
+
+    // 4) Ошибки: обрезанные данные, нет координат, чужой файл
+    {
+        std::vector<float> pts = {1, 2, 3, 4, 5, 6};
+        writePlyVertices(path, pts.data(), 2, true);
+        std::ifstream in(path, std::ios::binary);
+        std::string full((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        writeText(path, full.substr(0, full.size() - 1));
+        assert(throws(path));
+        writeText(path, "ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\n"
+                        "property float y\nproperty float z\nend_header\n1 2 3\n4 5\n");
+        assert(throws(path));
+        writeText(path, "ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\n"
+                        "property float y\nend_header\n1 2\n");
+        assert(throws(path));
+        // Число вершин из заголовка больше, чем уместится в файле: отказ до выделения
+        writeText(path, "ply\nformat ascii 1.0\nelement vertex 4000000000\nproperty float x\n"
+                        "property float y\nproperty float z\nend_header\n1 2 3\n");
+        assert(throws(path));
+        // Минимальная запись без завершающего перевода строки ещё допустима
+        writeText(path, "ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\n"
+                        "property float y\nproperty float z\nend_header\n1 2 3\n4 5 6");
+        std::vector<float> tight;
+        readPlyVertices(path, tight);
+        assert((tight == std::vector<float>{1, 2, 3, 4, 5, 6}));
+        writeText(path, "solid cube\n");
+        assert(throws(path));
+        assert(throws("test_ply_io_missing.ply"));
+    }
+
+    // 5) loadVoxelMask: одна и та же маска из ascii и binary
+    {
+        std::vector<float> pts(3 * 500);
+        std::uniform_real_distribution<float> vox(-2.0f, 34.0f);
+        for (auto& v : pts) v = vox(gen);
+        writePlyVertices(path, pts.data(), 500, false);
+        Tensor3D a = DataLoader::loadVoxelMask(path);
+        writePlyVertices(path, pts.data(), 500, true);
+        Tensor3D b = DataLoader::loadVoxelMask(path);
+        int occupied = 0;
+        for (int i = 0; i < a.size(); ++i) {
+            assert(a.data()[i] == b.data()[i]);
+            occupied += a.data()[i] != 0.0f;
+        }
+        assert(occupied > 0);
+    }
+
+    // 6) Скорость на большом облаке: прежний потоковый разбор против нового
+    {
+        const size_t n = 400000;
+        std::vector<float> pts(3 * n);
+        for (auto& v : pts) v = coord(gen);
+        writePlyVertices(path, pts.data(), n, false);
+        auto t0 = std::chrono::steady_clock::now();
+        auto old = readStream(path);
+        auto t1 = std::chrono::steady_clock::now();
+        std::vector<float> ascii, binary;
+        readPlyVertices(path, ascii);
+        auto t2 = std::chrono::steady_clock::now();
+        writePlyVertices(path, pts.data(), n, true);
+        auto t3 = std::chrono::steady_clock::now();
+        readPlyVertices(path, binary);
+        auto t4 = std::chrono::steady_clock::now();
+        assert(ascii == pts && binary == pts && old.size() == pts.size());
+        auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+        std::cout << n << " точек: istream " << ms(t0, t1) << " мс, from_chars " << ms(t1, t2)
+                  << " мс, binary " << ms(t3, t4) << " мс\n";
+    }
+
+    std::remove(path.c_str());
+    std::cout << "[OK] PlyIO tests passed\n";
+    return 0;
+}
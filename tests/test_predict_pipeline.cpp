@@ -0,0 +1,206 @@
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "infer/PredictPipeline.h"
+#include "utils/BoundedQueue.h"
+
+constexpr int kClasses = 3;
+
+// Облако i: отрезок из 4 + i точек вдоль диагонали и угол куба
+static void writeCloud(const std::string& path, int i) {
+    std::ofstream out(path, std::ios::binary);
+    const uint32_t M = static_cast<uint32_t>(5 + i);
+    out.write(reinterpret_cast<const char*>(&M), sizeof(M));
+    for (uint32_t k = 0; k < M; ++k) {
+        const float p[3] = {k == 0 ? 1.0f : 0.1f * k / M, 0.05f * k / M, 0.2f * (i % 3) * k / M};
+        const int32_t label = 0;
+        out.write(reinterpret_cast<const char*>(p), sizeof(p));
+        out.write(reinterpret_cast<const char*>(&label), sizeof(label));
+    }
+}
+
+// Логиты «модели»: число занятых вокселей и его производные
+static void fakeLogits(const Tensor3D& x, float* logits) {
+    float occupied = 0.0f;
+    for (int k = 0; k < x.size(); ++k) occupied += x.data()[k];
+    logits[0] = occupied;
+    logits[1] = -occupied;
+    logits[2] = static_cast<float>(static_cast<int>(occupied) % 7);
+}
+
+struct Record {
+    uint32_t index;
+    int32_t  pred;
+    float    logits[kClasses];
+};
+
+static std::vector<Record> readBinary(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    uint32_t magic = 0, classes = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    in.read(reinterpret_cast<char*>(&classes), sizeof(classes));
+    assert(in && magic == predict::kMagic && classes == kClasses);
+    assert(std::memcmp(&magic, "PGPR", 4) == 0);
+    std::vector<Record> recs;
+    Record r;
+    while (in.read(reinterpret_cast<char*>(&r), sizeof(r))) recs.push_back(r);
+    assert(in.gcount() == 0);  // без обрезанного хвоста
+    return recs;
+}
+
+int main() {
+    std::cout << "=== Тест конвейера predict ===\n";
+
+    // 1) BoundedQueue: ёмкость, close() будит ждущих, pop дочитывает остаток
+    {
+        BoundedQueue<int> q(2);
+        assert(q.push(1) && q.push(2));
+        std::atomic<bool> pushed{false};
+        std::thread producer([&] { q.push(3); pushed = true; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        assert(!pushed.load() && q.size() == 2);  // очередь полна — push ждёт
+        int v = 0;
+        assert(q.pop(v) && v == 1);
+        producer.join();
+        assert(pushed.load() && q.size() == 2);
+
+        q.close();
+        assert(!q.push(4));
+        assert(q.pop(v) && v == 2);
+        assert(q.pop(v) && v == 3);
+        assert(!q.pop(v));
+
+        BoundedQueue<int> empty(1);
+        std::thread consumer([&] { int x; assert(!empty.pop(x)); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        empty.close();
+        consumer.join();
+
+        BoundedQueue<int> full(1);
+        full.push(0);
+        std::thread blocked([&] { assert(!full.push(1)); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        full.close();
+        blocked.join();
+    }
+
+    const std::string dir = "test_predict_data";
+    ::mkdir(dir.c_str(), 0755);
+    const int n = 23;
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/c%03d.bin", i);
+        writeCloud(dir + stem, i);
+    }
+    std::ofstream(dir + "/c010.bin", std::ios::binary) << "xx";  // битый файл пропускается
+
+    const auto files = predict::listInputs(dir);
+    assert(static_cast<int>(files.size()) == n);
+    std::vector<std::vector<float>> expect(n, std::vector<float>(kClasses));
+    {
+        std::vector<float> xyz;
+        for (int i = 0; i < n; ++i)
+            if (i != 10) fakeLogits(predict::loadSample(files[i], 16, xyz), expect[i].data());
+    }
+    auto forward = [](const Tensor3D* x, size_t count, float* logits) {
+        for (size_t k = 0; k < count; ++k) fakeLogits(x[k], logits + k * kClasses);
+    };
+
+    // 2) Бинарный PGPR: все файлы, кроме битого, ровно по разу, логиты и pred верны;
+    //    при одном io-потоке записи идут в порядке файлов
+    for (int io : {1, 3}) {
+        predict::PipelineConfig cfg;
+        cfg.binary = true;
+        cfg.batch = 4;
+        cfg.io_threads = io;
+        cfg.grid = 16;
+        cfg.queue = 2;
+        const std::string out = dir + "/pred.bin";
+        predict::Summary sum = predict::run(files, out, kClasses, forward, cfg);
+        assert(sum.done == static_cast<size_t>(n - 1) && sum.failed == 1);
+
+        const auto recs = readBinary(out);
+        assert(recs.size() == static_cast<size_t>(n - 1));
+        std::set<uint32_t> seen;
+        for (size_t k = 0; k < recs.size(); ++k) {
+            const Record& r = recs[k];
+            assert(r.index < static_cast<uint32_t>(n) && r.index != 10 && seen.insert(r.index).second);
+            for (int c = 0; c < kClasses; ++c) assert(r.logits[c] == expect[r.index][c]);
+            assert(r.pred == (expect[r.index][0] >= expect[r.index][2] ? 0 : 2));
+            if (io == 1) assert(k == 0 || r.index > recs[k - 1].index);
+        }
+        std::remove(out.c_str());
+    }
+
+    // 3) CSV: заголовок и строка «путь,pred,логиты» на файл
+    {
+        predict::PipelineConfig cfg;
+        cfg.batch = 5;
+        cfg.io_threads = 1;
+        cfg.grid = 16;
+        const std::string out = dir + "/pred.csv";
+        predict::run(files, out, kClasses, forward, cfg);
+        std::ifstream in(out);
+        std::string line;
+        std::getline(in, line);
+        assert(line == "path,pred,logit0,logit1,logit2");
+        int rows = 0;
+        while (std::getline(in, line)) {
+            const int i = rows < 10 ? rows : rows + 1;
+            assert(line.rfind(files[i] + ",", 0) == 0);
+            ++rows;
+        }
+        assert(rows == n - 1);
+        std::remove(out.c_str());
+    }
+
+    // 3б) Метка образца — из <stem>_cls.txt рядом; нет файла — −1
+    {
+        std::ofstream(dir + "/c004_cls.txt") << "2\n";
+        assert(predict::loadLabel(files[4]) == 2);
+        assert(predict::loadLabel(files[5]) == -1);
+        assert(predict::listInputs(dir).size() == files.size());
+        std::remove((dir + "/c004_cls.txt").c_str());
+    }
+
+    // 4) Ошибки стадий: выход не открывается, forward бросает — исключение
+    //    из run() после остановки всех потоков, а не выход процесса
+    {
+        predict::PipelineConfig cfg;
+        cfg.batch = 2;
+        cfg.io_threads = 2;
+        cfg.grid = 16;
+        cfg.queue = 1;
+        bool threw = false;
+        try { predict::run(files, dir + "/no/such/dir/pred.csv", kClasses, forward, cfg); }
+        catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+
+        threw = false;
+        int calls = 0;
+        auto broken = [&](const Tensor3D*, size_t, float*) {
+            if (++calls == 3) throw std::runtime_error("forward");
+        };
+        try { predict::run(files, dir + "/pred.csv", kClasses, broken, cfg); }
+        catch (const std::runtime_error& e) { threw = std::string(e.what()) == "forward"; }
+        assert(threw && calls == 3);
+        std::remove((dir + "/pred.csv").c_str());
+    }
+
+    for (const auto& f : files) std::remove(f.c_str());
+    ::rmdir(dir.c_str());
+    std::cout << "[OK] Predict pipeline tests passed\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/DataLoader.h"
+#include "data/PrefetchLoader.h"
+#include "TestUtils.h"
+
+using testutil::sameBatch;
+
+int main() {
+    std::cout << "=== Тест PrefetchLoader ===\n";
+    const std::string dir = "test_prefetch_data";
+    ::mkdir(dir.c_str(), 0755);
+    const int n = 20;
+    // Образец i: один занятый воксель (i, i, i), класс i % 10
+    for (int i = 0; i < n; ++i) testutil::writeSample(testutil::stem(dir, i), {{i, i, i}}, i % 10);
+
+    // 1) Порядок и содержимое совпадают с синхронным nextBatch, в том числе
+    //    через границу эпохи (train/val чередуются, последний val-батч неполный)
+    for (int threads : {0, 1, 4}) {
+        DataLoader ref(dir, 3, 0.25f), src(dir, 3, 0.25f);
+        PrefetchLoader pf(src, threads, 2);
+        for (int epoch = 0; epoch < 2; ++epoch) {
+            src.reset();
+            pf.schedule(true, 5);
+            pf.schedule(false, 2);
+        }
+        assert(pf.pending() == 14);
+        for (int epoch = 0; epoch < 2; ++epoch) {
+            ref.reset();
+            for (int s = 0; s < 5; ++s) assert(sameBatch(pf.next(), ref.nextBatch(true)));
+            for (int s = 0; s < 2; ++s) assert(sameBatch(pf.next(), ref.nextBatch(false)));
+        }
+        assert(pf.pending() == 0);
+        auto st = pf.stats();
+        assert(st.batches == 14 && st.stalled <= st.batches);
+        if (threads == 0) assert(st.stalled == 14);
+
+        bool threw = false;
+        try { pf.next(); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+    }
+
+    // 2) Шардинг: ранги вместе покрывают тот же батч
+    {
+        DataLoader full(dir, 4, 0.0f), r0(dir, 4, 0.0f), r1(dir, 4, 0.0f);
+        r0.setShard(0, 2);
+        r1.setShard(1, 2);
+        PrefetchLoader p0(r0, 2), p1(r1, 2);
+        p0.schedule(true, 3);
+        p1.schedule(true, 3);
+        for (int s = 0; s < 3; ++s) {
+            auto f = full.nextBatch(true);
+            auto a = p0.next(), b = p1.next();
+            assert(a.y.size() == 2 && b.y.size() == 2);
+            assert(a.y[0] == f.second[0] && a.y[1] == f.second[1]);
+            assert(b.y[0] == f.second[2] && b.y[1] == f.second[3]);
+        }
+    }
+
+    // 3) Фоновые потоки успевают собрать батчи, пока потребитель занят
+    {
+        DataLoader src(dir, 4, 0.0f);
+        PrefetchLoader pf(src, 2, 2);
+        pf.schedule(true, 5);
+        for (int s = 0; s < 5; ++s) {
+            ::usleep(20000);  // «шаг обучения»
+            pf.next();
+        }
+        auto st = pf.stats();
+        std::cout << "stall " << st.stall_seconds << "s (" << st.stalled << "/" << st.batches
+                  << "), чтение " << st.decode_seconds << "s\n";
+        assert(st.stalled <= 1);  // допускаем запоздалый старт потоков
+        pf.resetStats();
+        assert(pf.stats().batches == 0);
+    }
+
+    // 4) Ошибка чтения образца всплывает из next() своего батча
+    {
+        testutil::writeSample(testutil::stem(dir, n), {{n, n, n}});  // s020 без _cls.txt
+        DataLoader src(dir, 3, 0.0f);               // 21 образец: 7 батчей
+        PrefetchLoader pf(src, 3, 3);
+        pf.schedule(true, 7);
+        for (int s = 0; s < 6; ++s) pf.next();
+        bool threw = false;
+        try { pf.next(); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        std::remove((dir + "/s020.ply").c_str());
+    }
+
+    // 5) Разрушение с незавершённым планом не зависает
+    {
+        DataLoader src(dir, 4, 0.0f);
+        PrefetchLoader pf(src, 2, 2);
+        pf.schedule(true, 50);
+        pf.next();
+    }
+
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/s%03d", i);
+        std::remove((dir + stem + ".ply").c_str());
+        std::remove((dir + stem + "_cls.txt").c_str());
+    }
+    ::rmdir(dir.c_str());
+    std::cout << "[OK] PrefetchLoader tests passed\n";
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <cmath>
+#include <cassert>
+#include <random>
+#include "network/network.h"
+#include "infer/InferenceEngine.h"
+#include "infer/QuantizedEngine.h"
+
+// Класс 0 — точки в нижней половине сетки, класс 1 — в верхней
+static Tensor3D halfGrid(std::mt19937& gen, int label) {
+    std::bernoulli_distribution occ(0.4);
+    Tensor3D x(8, 8, 8, 1);
+    x.fill(0.0f);
+    for (int d = label * 4; d < label * 4 + 4; ++d)
+        for (int h = 0; h < 8; ++h)
+            for (int w = 0; w < 8; ++w)
+                if (occ(gen)) x(d, h, w, 0) = 1.0f;
+    return x;
+}
+
+int main() {
+    std::cout << "=== Тест QuantizedEngine ===\n";
+    std::cout << "int8-ядро: " << QuantizedEngine::kernelName() << "\n";
+
+    std::mt19937 gen(7);
+    std::vector<Tensor3D> xs;
+    std::vector<int> labels;
+    for (int i = 0; i < 64; ++i) {
+        labels.push_back(i % 2);
+        xs.push_back(halfGrid(gen, i % 2));
+    }
+
+    // Немного обучаем, чтобы метки что-то значили
+    Network net;
+    for (int epoch = 0; epoch < 3; ++epoch)
+        for (size_t i = 0; i < xs.size(); ++i) {
+            net.zeroGrad();
+            net.forward(xs[i], true);
+            net.computeLoss({labels[i]});
+            net.backward();
+            net.optimize();
+        }
+
+    // 1) Калибровка: вход 0/1, вход FC неотрицателен
+    auto calib = QuantizedEngine::calibrate(net, xs.data(), 16);
+    assert(calib.samples == 16);
+    assert(calib.input_min == 0.0f && calib.input_max == 1.0f);
+    assert(calib.fc_max > 0.0f);
+
+    InferenceEngine fp32(net);
+    QuantizedEngine int8(net, calib);
+    assert(int8.numClasses() == 10);
+
+    // 2) Логиты близки к FP32, top-1 почти всегда совпадает
+    auto r = compareQuantized(fp32, int8, xs.data(), xs.size(), labels.data(), 2);
+    std::cout << r.toString() << "\n";
+    assert(r.samples == xs.size());
+    assert(r.agreement >= 0.9);
+    assert(std::fabs(r.int8_accuracy - r.fp32_accuracy) <= 0.1);
+    double scale = 0;
+    for (const auto& x : xs)
+        for (float v : fp32.forward(x)) scale = std::max(scale, static_cast<double>(std::fabs(v)));
+    assert(r.max_abs_diff < 0.1 * scale);
+
+    // 3) Батч и одиночный forward совпадают бит в бит
+    auto batch = int8.forwardBatch(xs, 3);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        auto one = int8.forward(xs[i]);
+        for (int c = 0; c < 10; ++c) assert(batch[i * 10 + c] == one[c]);
+    }
+
+    // 4) Веса в int8 — примерно вчетверо меньше FP32
+    size_t fp32_bytes = net.flatSize() * sizeof(float);
+    std::cout << "веса: FP32 " << fp32_bytes << " байт, INT8 " << int8.weightBytes() << " байт\n";
+    assert(int8.weightBytes() * 3 < fp32_bytes);
+
+    // 5) Знакопеременный вход: асимметричное квантование с нулевой точкой
+    {
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+        std::vector<Tensor3D> ys;
+        for (int i = 0; i < 8; ++i) {
+            Tensor3D y(8, 8, 8, 1);
+            for (int j = 0; j < y.size(); ++j) y.data()[j] = u(gen);
+            ys.push_back(y);
+        }
+        auto c2 = QuantizedEngine::calibrate(net, ys.data(), ys.size());
+        assert(c2.input_min < 0.0f);
+        QuantizedEngine q2(net, c2);
+        auto r2 = compareQuantized(fp32, q2, ys.data(), ys.size());
+        std::cout << r2.toString() << "\n";
+        double s2 = 0;
+        for (const auto& y : ys)
+            for (float v : fp32.forward(y)) s2 = std::max(s2, static_cast<double>(std::fabs(v)));
+        assert(r2.max_abs_diff < 0.1 * s2);
+    }
+
+    // 6) Без калибровки движок не строится
+    bool threw = false;
+    try { QuantizedEngine bad(net, QuantizedEngine::Calibration{}); }
+    catch (const std::invalid_argument&) { threw = true; }
+    assert(threw);
+
+    std::cout << "[OK] QuantizedEngine tests passed\n";
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/DataLoader.h"
+#include "data/PointCloudIO.h"
+#include "data/PrefetchLoader.h"
+#include "data/VoxelMask.h"
+#include "TestUtils.h"
+
+using testutil::same;
+
+struct Cloud {
+    std::vector<float>   xyz;
+    std::vector<int32_t> labels;
+};
+
+// Облако образца i: куб [0, 1]³ с точкой на каждом углу и «хвостом» вдоль x
+static Cloud makeCloud(int i) {
+    Cloud c;
+    auto add = [&](float x, float y, float z, int32_t l) {
+        c.xyz.insert(c.xyz.end(), {x, y, z});
+        c.labels.push_back(l);
+    };
+    for (int k = 0; k < 8; ++k) add(k & 1, (k >> 1) & 1, (k >> 2) & 1, k % 3);
+    for (int k = 0; k < 5 + i; ++k) add(0.1f * k / (5 + i), 0.5f, 0.25f + 0.01f * i, 1 + i % 2);
+    return c;
+}
+
+static void writeCloud(const std::string& path, const Cloud& c) {
+    std::ofstream out(path, std::ios::binary);
+    uint32_t M = static_cast<uint32_t>(c.labels.size());
+    out.write(reinterpret_cast<const char*>(&M), sizeof(M));
+    for (uint32_t i = 0; i < M; ++i) {
+        out.write(reinterpret_cast<const char*>(&c.xyz[3 * i]), 3 * sizeof(float));
+        out.write(reinterpret_cast<const char*>(&c.labels[i]), sizeof(int32_t));
+    }
+}
+
+int main() {
+    std::cout << "=== Тест вокселизации облаков .bin при загрузке ===\n";
+    const std::string dir = "test_raw_clouds_data";
+    ::mkdir(dir.c_str(), 0755);
+    const int n = 12;
+    std::vector<Cloud> clouds;
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/c%03d", i);
+        clouds.push_back(makeCloud(i));
+        writeCloud(dir + stem + ".bin", clouds.back());
+        std::ofstream(dir + stem + "_cls.txt") << (i % 4) << "\n";
+    }
+    // Чекпоинт рядом с данными: .bin без _cls.txt — не облако, загрузчик его пропускает
+    std::ofstream(dir + "/a_model.bin", std::ios::binary) << "PGCK not a cloud";
+
+    // 1) Чтение .bin: координаты, метки, обрезанный файл
+    {
+        std::vector<float> xyz;
+        std::vector<int32_t> labels;
+        readPointCloudBin(dir + "/c003.bin", xyz, &labels);
+        assert(xyz == clouds[3].xyz && labels == clouds[3].labels);
+
+        std::ofstream(dir + "/cut.dat", std::ios::binary).write("\x05\0\0\0abc", 7);
+        bool threw = false;
+        try { readPointCloudBin(dir + "/cut.dat", xyz); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        std::remove((dir + "/cut.dat").c_str());
+    }
+
+    // 1б) NaN и ±Inf: читатель отбрасывает такие точки, а ячейка любой точки,
+    //     переданной в обход читателя, всё равно внутри сетки
+    {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        const float inf = std::numeric_limits<float>::infinity();
+        Cloud bad;
+        bad.xyz    = {0, 0, 0,  nan, 1, 1,  1, 1, 1,  -inf, 0, 0,  0.5f, inf, 0.5f,  0, 1, 0};
+        bad.labels = {1, 2, 3, 4, 5, 6};
+        writeCloud(dir + "/bad.dat", bad);
+        std::vector<float> xyz;
+        std::vector<int32_t> labels;
+        readPointCloudBin(dir + "/bad.dat", xyz, &labels);
+        assert((xyz == std::vector<float>{0, 0, 0, 1, 1, 1, 0, 1, 0}));
+        assert((labels == std::vector<int32_t>{1, 3, 6}));
+        std::remove((dir + "/bad.dat").c_str());
+
+        for (const Bounds& b : {Bounds{{0, 0, 0}, {1, 1, 1}}, Bounds{{-inf, 0, 0}, {inf, 1, 1}}}) {
+            const NormalizedGrid g(b, 4, 4, 4);
+            for (size_t i = 0; i < bad.labels.size(); ++i) assert(g.cell(&bad.xyz[3 * i]) < g.cells());
+            CellIndex cells;
+            binPoints(bad.xyz.data(), bad.labels.size(), g, cells);
+            assert(cells.start.back() == bad.labels.size());
+        }
+        Tensor3D mask(4, 4, 4, 1);
+        mask.fill(0.0f);
+        rasterizeNormalized(bad.xyz.data(), bad.labels.size(), mask);  // бокс бесконечен: всё в угол
+        assert(mask(0, 0, 0, 0) == 1.0f);
+    }
+
+    // 2) Голосование меток в ячейке: большинство, при равенстве — меньшая,
+    //    отрицательные метки не голосуют
+    {
+        const float xyz[] = {0, 0, 0,  0, 0, 0,  0, 0, 0,  1, 1, 1,  1, 1, 1,  0, 1, 0,  0, 1, 0};
+        const int32_t lab[] = {2, 5, 5,  3, 1,  -1, -1};
+        Tensor3D mask(2, 2, 2, 1);
+        mask.fill(0.0f);
+        uint8_t seg[8] = {};
+        CellIndex cells;
+        rasterizeNormalizedSeg(xyz, lab, 7, mask, seg, cells);
+        assert(mask(0, 0, 0, 0) == 1.0f && mask(1, 1, 1, 0) == 1.0f && mask(0, 1, 0, 0) == 1.0f);
+        assert(mask(1, 0, 0, 0) == 0.0f);
+        assert(seg[0] == 5 && seg[7] == 1 && seg[2] == 0);
+
+        const int32_t big[] = {2, 300, 5, 3, 1, -1, -1};
+        bool threw = false;
+        try { rasterizeNormalizedSeg(xyz, big, 7, mask, seg, cells); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+
+        Tensor3D plain(2, 2, 2, 1);
+        plain.fill(0.0f);
+        rasterizeNormalized(xyz, 7, plain);
+        assert(same(plain, mask));
+    }
+
+    // 3) DataLoader над .bin: маски как у rasterizeNormalized, метки из _cls.txt
+    {
+        DataLoader dl(dir, 5, 0.25f);
+        assert(dl.rawClouds() && !dl.sharded() && dl.voxelGrid() == 32);
+        assert(dl.getNumTrainSamples() == 9 && dl.getNumValSamples() == 3);
+        SampleBatch batch;
+        dl.nextBatch(batch, true);
+        assert(batch.x.size() == 5);
+        for (int i = 0; i < 5; ++i) {
+            Tensor3D expect(32, 32, 32, 1);
+            expect.fill(0.0f);
+            rasterizeNormalized(clouds[i].xyz.data(), clouds[i].labels.size(), expect);
+            assert(same(batch.x[i], expect));
+            assert(batch.y[i] == i % 4);
+        }
+
+        Tensor3D x;
+        std::vector<uint8_t> seg;
+        dl.loadSegSample(7, x, seg);
+        Tensor3D em(32, 32, 32, 1);
+        em.fill(0.0f);
+        std::vector<uint8_t> es(32 * 32 * 32, 0);
+        CellIndex cells;
+        rasterizeNormalizedSeg(clouds[7].xyz.data(), clouds[7].labels.data(), clouds[7].labels.size(), em, es.data(), cells);
+        assert(same(x, em) && seg == es);
+        assert(seg.back() == 1);  // угол (1,1,1): метка 7 % 3
+
+        Tensor3D segf;
+        dl.loadSegSample(7, x, segf);
+        assert(segf(31, 31, 31, 0) == 1.0f && segf.size() == static_cast<int>(es.size()));
+    }
+
+    // 4) Смена сетки без пересборки датасета; PLY-режим её не допускает
+    {
+        DataLoader dl(dir, 4, 0.0f);
+        dl.enableCache(1 << 20);
+        SampleBatch batch;
+        dl.nextBatch(batch, true);
+        assert(batch.x[0].depth() == 32);
+        dl.setVoxelGrid(16);
+        dl.reset();
+        dl.nextBatch(batch, true);
+        assert(batch.x[0].depth() == 16 && batch.x[0].width() == 16);
+        Tensor3D expect(16, 16, 16, 1);
+        expect.fill(0.0f);
+        rasterizeNormalized(clouds[2].xyz.data(), clouds[2].labels.size(), expect);
+        assert(same(batch.x[2], expect));
+
+        bool threw = false;
+        try { dl.setVoxelGrid(0); } catch (const std::invalid_argument&) { threw = true; }
+        assert(threw);
+    }
+
+    // 5) Пакетное чтение и фоновые потоки дают те же батчи
+    for (int threads : {0, 2}) {
+        DataLoader ref(dir, 3, 0.25f), src(dir, 3, 0.25f);
+        src.enableBatchedIo(BatchFileReader::Backend::PreadPool, 2);
+        for (DataLoader* d : {&ref, &src}) d->setOrder(DataLoader::Order::Shuffle, 9);
+        PrefetchLoader pf(src, threads, 2);
+        src.reset();
+        pf.schedule(true, 3);
+        pf.schedule(false, 1);
+        ref.reset();
+        PrefetchLoader::Batch batch;
+        for (int s = 0; s < 4; ++s) {
+            pf.next(batch);
+            auto expect = ref.nextBatch(s < 3);
+            assert(batch.y == expect.second && batch.x.size() == expect.first.size());
+            for (size_t i = 0; i < batch.x.size(); ++i) assert(same(batch.x[i], expect.first[i]));
+        }
+    }
+
+    // 6) Уже вокселизированные PLY важнее облаков в той же директории
+    {
+        std::ofstream(dir + "/p000.ply") << "ply\nformat ascii 1.0\nelement vertex 1\nproperty float x\n"
+                                            "property float y\nproperty float z\nend_header\n1 2 3\n";
+        std::ofstream(dir + "/p000_cls.txt") << "3\n";
+        DataLoader dl(dir, 4, 0.0f);
+        assert(!dl.rawClouds() && dl.getNumTrainSamples() == 1);
+        bool threw = false;
+        try { dl.setVoxelGrid(16); } catch (const std::invalid_argument&) { threw = true; }
+        assert(threw);
+        std::remove((dir + "/p000.ply").c_str());
+        std::remove((dir + "/p000_cls.txt").c_str());
+    }
+
+    // 7) Основа — префикс другой (x и x_a): метка остаётся при своём облаке
+    {
+        const std::string pdir = dir + "/prefix";
+        ::mkdir(pdir.c_str(), 0755);
+        writeCloud(pdir + "/x.bin", clouds[0]);
+        writeCloud(pdir + "/x_a.bin", clouds[1]);
+        std::ofstream(pdir + "/x_cls.txt") << "1\n";
+        std::ofstream(pdir + "/x_a_cls.txt") << "2\n";
+        DataLoader dl(pdir, 2, 0.0f);
+        SampleBatch batch;
+        dl.nextBatch(batch, true);
+        Tensor3D expect(32, 32, 32, 1);
+        expect.fill(0.0f);
+        rasterizeNormalized(clouds[0].xyz.data(), clouds[0].labels.size(), expect);
+        assert(same(batch.x[0], expect));
+        assert(batch.y[0] == 1 && batch.y[1] == 2);
+        for (const char* f : {"/x.bin", "/x_a.bin", "/x_cls.txt", "/x_a_cls.txt"}) std::remove((pdir + f).c_str());
+        ::rmdir(pdir.c_str());
+    }
+
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/c%03d", i);
+        std::remove((dir + stem + ".bin").c_str());
+        std::remove((dir + stem + "_cls.txt").c_str());
+    }
+    std::remove((dir + "/a_model.bin").c_str());
+    ::rmdir(dir.c_str());
+    std::cout << "[OK] Raw cloud tests passed\n";
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/DataLoader.h"
+#include "data/SampleCache.h"
+#include "data/Shard.h"
+#include "TestUtils.h"
+
+using testutil::same;
+
+static Tensor3D randomMask(std::mt19937& gen, double p) {
+    std::bernoulli_distribution occ(p);
+    Tensor3D x(32, 32, 32, 1);
+    for (int i = 0; i < x.size(); ++i) x.data()[i] = occ(gen) ? 1.0f : 0.0f;
+    return x;
+}
+
+int main() {
+    std::cout << "=== Тест SampleCache ===\n";
+    std::mt19937 gen(11);
+
+    // 1) Обе кодировки без потерь; редкая маска хранится короче битовой карты
+    {
+        SampleCache c(1 << 20);
+        Tensor3D sparse = randomMask(gen, 0.01), dense = randomMask(gen, 0.5);
+        assert(c.put(1, sparse, 3));
+        size_t sparse_bytes = c.stats().bytes;
+        assert(c.put(2, dense, 7));
+        size_t dense_bytes = c.stats().bytes - sparse_bytes;
+        assert(sparse_bytes < dense_bytes && dense_bytes <= 4096 + 256);
+
+        Tensor3D x;
+        int label = -1;
+        assert(c.get(1, x, label) && label == 3 && same(x, sparse));
+        assert(c.get(2, x, label) && label == 7 && same(x, dense));  // x переиспользуется
+        assert(!c.get(3, x, label));
+        auto st = c.stats();
+        assert(st.hits == 2 && st.misses == 1 && st.entries == 2);
+
+        // Биты без распаковки: те же, что packBits, для обеих кодировок
+        std::vector<uint8_t> bits(4096), expect(4096);
+        for (int key : {1, 2}) {
+            const Tensor3D& m = key == 1 ? sparse : dense;
+            shard::packBits(m.data(), m.size(), expect.data());
+            std::fill(bits.begin(), bits.end(), 0xAA);
+            assert(c.getBits(key, 32, 32, 32, bits.data(), label) && label == (key == 1 ? 3 : 7));
+            assert(bits == expect);
+        }
+        assert(!c.getBits(1, 16, 32, 32, bits.data(), label));  // другая форма
+        assert(!c.getBits(3, 32, 32, 32, bits.data(), label));
+
+        // Не маска 0/1 — не кэшируется
+        Tensor3D bad(32, 32, 32, 1);
+        bad.data()[5] = 0.5f;
+        assert(!c.put(4, bad, 0));
+    }
+
+    // 2) Бюджет и LRU: вытесняется давно не читанный образец
+    {
+        const size_t per = 4096 + 128;  // плотная маска + служебные расходы
+        SampleCache c(3 * per);
+        std::vector<Tensor3D> xs;
+        for (int i = 0; i < 4; ++i) xs.push_back(randomMask(gen, 0.5));
+        for (int i = 0; i < 3; ++i) assert(c.put(i, xs[i], i));
+        Tensor3D x;
+        int label;
+        assert(c.get(0, x, label));   // 0 свежее, чем 1
+        assert(c.put(3, xs[3], 3));   // вытесняет 1
+        assert(!c.get(1, x, label));
+        assert(c.get(0, x, label) && c.get(2, x, label) && c.get(3, x, label));
+        auto st = c.stats();
+        assert(st.evictions == 1 && st.entries == 3 && st.bytes <= c.budget());
+
+        SampleCache tiny(100);
+        assert(!tiny.put(0, xs[0], 0));  // больше всего бюджета
+    }
+
+    // 3) Одновременные get/put из нескольких потоков
+    {
+        SampleCache c(64 * 4300);
+        std::vector<Tensor3D> xs;
+        for (int i = 0; i < 96; ++i) xs.push_back(randomMask(gen, 0.2));
+        std::vector<std::thread> th;
+        std::vector<int> ok(4, 1);
+        for (int t = 0; t < 4; ++t)
+            th.emplace_back([&, t] {
+                Tensor3D x;
+                int label;
+                for (int rep = 0; rep < 5; ++rep)
+                    for (int i = t; i < 96; i += 2) {
+                        if (c.get(i, x, label)) {
+                            if (label != i || !same(x, xs[i])) ok[t] = 0;
+                        } else {
+                            c.put(i, xs[i], i);
+                        }
+                    }
+            });
+        for (auto& t : th) t.join();
+        for (int v : ok) assert(v);
+        assert(c.stats().bytes <= c.budget());
+    }
+
+    // 4) DataLoader: те же батчи, вторая эпоха целиком из памяти
+    {
+        const std::string dir = "test_sample_cache_data";
+        ::mkdir(dir.c_str(), 0755);
+        const int n = 10;
+        for (int i = 0; i < n; ++i) {
+            const std::string base = dir + "/s" + std::to_string(i);
+            std::ofstream ply(base + ".ply");
+            ply << "ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\n"
+                << "property float y\nproperty float z\nend_header\n"
+                << i << " 1 2\n3 " << i << " 30\n";
+            std::ofstream(base + "_cls.txt") << i % 4 << "\n";
+        }
+        DataLoader ref(dir, 5, 0.0f), cached(dir, 5, 0.0f);
+        cached.enableCache(1 << 20);
+        for (int epoch = 0; epoch < 2; ++epoch) {
+            ref.reset();
+            cached.reset();
+            for (int s = 0; s < 2; ++s) {
+                auto a = ref.nextBatch(true), b = cached.nextBatch(true);
+                assert(a.second == b.second);
+                for (size_t i = 0; i < a.first.size(); ++i) assert(same(a.first[i], b.first[i]));
+            }
+        }
+        auto st = cached.cache()->stats();
+        assert(st.misses == static_cast<size_t>(n) && st.hits == static_cast<size_t>(n));
+        std::cout << "кэш: " << st.entries << " образцов, " << st.bytes << " байт\n";
+
+        for (int i = 0; i < n; ++i) {
+            const std::string base = dir + "/s" + std::to_string(i);
+            std::remove((base + ".ply").c_str());
+            std::remove((base + "_cls.txt").c_str());
+        }
+        ::rmdir(dir.c_str());
+    }
+
+    std::cout << "[OK] SampleCache tests passed\n";
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/DataLoader.h"
+#include "data/SampleCache.h"
+#include "data/Sampler.h"
+#include "data/Shard.h"
+#include "TestUtils.h"
+
+static bool isPermutation(std::vector<uint32_t> p, size_t n) {
+    if (p.size() != n) return false;
+    std::sort(p.begin(), p.end());
+    for (size_t i = 0; i < n; ++i)
+        if (p[i] != i) return false;
+    return true;
+}
+
+// Все образцы эпохи (по всем батчам) в порядке выдачи
+static std::vector<size_t> epochOrder(DataLoader& dl, bool train, std::vector<size_t>* sizes = nullptr) {
+    std::vector<size_t> all;
+    for (;;) {
+        auto idx = dl.nextBatchIndices(train);
+        if (idx.empty()) break;
+        if (sizes) sizes->push_back(idx.size());
+        all.insert(all.end(), idx.begin(), idx.end());
+    }
+    return all;
+}
+
+int main() {
+    std::cout << "=== Тест Sampler ===\n";
+
+    // 1) Перестановки: корректны, воспроизводимы, разные по эпохам и seed
+    {
+        for (size_t n : {0u, 1u, 2u, 17u, 1000u}) {
+            assert(isPermutation(sampler::permutation(n, 7, 3), n));
+        }
+        auto a = sampler::permutation(1000, 7, 3);
+        assert(a == sampler::permutation(1000, 7, 3));
+        assert(a != sampler::permutation(1000, 7, 4));
+        assert(a != sampler::permutation(1000, 8, 3));
+        // Фиксированный генератор: порядок не зависит от стандартной библиотеки
+        auto small = sampler::permutation(5, 0, 0);
+        std::cout << "permutation(5, 0, 0) = ";
+        for (auto v : small) std::cout << v << " ";
+        std::cout << "\n";
+    }
+
+    // 2) Стратификация: класс размазан по эпохе ровно, в отличие от «как повезёт»
+    {
+        std::vector<int> labels;
+        for (int i = 0; i < 900; ++i) labels.push_back(i < 600 ? 0 : (i < 810 ? 1 : 2));
+        auto p = sampler::stratified(labels, 1, 0);
+        assert(isPermutation(p, labels.size()));
+        assert(p == sampler::stratified(labels, 1, 0) && p != sampler::stratified(labels, 1, 1));
+        // В каждом батче из 30: класс 0 — 20±1, 1 — 7±1 (доля 7/30), 2 — 3±1
+        for (size_t b = 0; b + 30 <= p.size(); b += 30) {
+            int cnt[3] = {0, 0, 0};
+            for (size_t i = b; i < b + 30; ++i) ++cnt[labels[p[i]]];
+            assert(std::abs(cnt[0] - 20) <= 1 && std::abs(cnt[1] - 7) <= 1 && std::abs(cnt[2] - 3) <= 1);
+        }
+        // Внутри класса порядок тоже перемешан
+        std::vector<uint32_t> zeros;
+        for (auto v : p) if (labels[v] == 0) zeros.push_back(v);
+        assert(!std::is_sorted(zeros.begin(), zeros.end()));
+    }
+
+    const std::string dir = "test_sampler_data", shard_dir = "test_sampler_pgs";
+    ::mkdir(dir.c_str(), 0755);
+    ::mkdir(shard_dir.c_str(), 0755);
+    const int n = 23;
+    std::vector<int> cls(n);
+    for (int i = 0; i < n; ++i) cls[i] = i < 12 ? 0 : (i < 18 ? 1 : 2);
+    // Образец i: один воксель (i, 0, 0), класс по таблице cls
+    for (int i = 0; i < n; ++i) testutil::writeSample(testutil::stem(dir, i), {{i, 0, 0}}, cls[i]);
+
+    // 3) Эпоха — ровно один проход: последний батч неполный, без повторов
+    {
+        DataLoader dl(dir, 4, 0.2f);  // 18 train, 5 val
+        dl.setOrder(DataLoader::Order::Shuffle, 42);
+        std::vector<std::vector<size_t>> epochs;
+        for (int e = 0; e < 3; ++e) {
+            dl.reset();
+            std::vector<size_t> sizes;
+            auto train = epochOrder(dl, true, &sizes);
+            assert((sizes == std::vector<size_t>{4, 4, 4, 4, 2}));
+            std::vector<uint32_t> p(train.begin(), train.end());
+            assert(isPermutation(p, 18));
+            sizes.clear();
+            auto val = epochOrder(dl, false, &sizes);
+            assert((sizes == std::vector<size_t>{4, 1}));
+            assert((val == std::vector<size_t>{18, 19, 20, 21, 22}));  // val — по порядку
+            epochs.push_back(train);
+        }
+        assert(epochs[0] != epochs[1] && epochs[1] != epochs[2]);
+
+        // Тот же seed и номер эпохи — тот же порядок, в том числе у другого загрузчика
+        DataLoader other(dir, 4, 0.2f);
+        other.setOrder(DataLoader::Order::Shuffle, 42);
+        other.reset(dl.epoch());
+        assert(epochOrder(other, true) == epochs[2]);
+
+        // Sequential — прежний порядок файлов
+        DataLoader seq(dir, 5, 0.2f);
+        auto order = epochOrder(seq, true);
+        for (size_t i = 0; i < order.size(); ++i) assert(order[i] == i);
+    }
+
+    // 4) Ранги вместе покрывают тот же перемешанный глобальный батч,
+    //    включая неполный последний (ранг может получить пустую часть)
+    {
+        DataLoader full(dir, 5, 0.2f), r0(dir, 5, 0.2f), r1(dir, 5, 0.2f), r2(dir, 5, 0.2f);
+        r0.setShard(0, 3);
+        r1.setShard(1, 3);
+        r2.setShard(2, 3);
+        for (DataLoader* d : {&full, &r0, &r1, &r2}) {
+            d->setOrder(DataLoader::Order::Stratified, 9);
+            d->reset(5);
+        }
+        for (int step = 0; step < 4; ++step) {  // 18 = 5 + 5 + 5 + 3
+            auto f = full.nextBatchIndices(true);
+            auto a = r0.nextBatchIndices(true), b = r1.nextBatchIndices(true), c = r2.nextBatchIndices(true);
+            a.insert(a.end(), b.begin(), b.end());
+            a.insert(a.end(), c.begin(), c.end());
+            assert(a == f);
+        }
+        assert(full.nextBatchIndices(true).empty() && r2.nextBatchIndices(true).empty());
+    }
+
+    // 5) Шарды и кэш: тот же порядок и те же образцы, что у PLY
+    {
+        ShardWriter w(shard_dir + "/shard-00000.pgs", 32, /*with_seg=*/false);
+        for (int i = 0; i < n; ++i) {
+            char stem[32];
+            std::snprintf(stem, sizeof(stem), "/s%03d", i);
+            w.add(stem + 1, DataLoader::loadVoxelMask(dir + stem + ".ply"), cls[i]);
+        }
+        w.finish();
+
+        DataLoader ply(dir, 6, 0.2f), sh(shard_dir, 6, 0.2f);
+        sh.enableCache(1 << 20);
+        for (DataLoader* d : {&ply, &sh}) d->setOrder(DataLoader::Order::Stratified, 3);
+        for (int e = 0; e < 2; ++e) {
+            ply.reset();
+            sh.reset();
+            std::map<int, int> seen;
+            for (int step = 0; step < 3; ++step) {
+                auto a = ply.nextBatch(true), b = sh.nextBatch(true);
+                assert(a.second == b.second);
+                for (size_t i = 0; i < a.first.size(); ++i) {
+                    for (int k = 0; k < a.first[i].size(); ++k)
+                        assert(a.first[i].data()[k] == b.first[i].data()[k]);
+                }
+                for (int y : b.second) ++seen[y];
+            }
+            assert(seen[0] == 12 && seen[1] == 6 && seen[2] == 0);  // класс 2 — весь в val
+        }
+        auto st = sh.cache()->stats();
+        assert(st.misses == 18 && st.hits == 18);  // вторая эпоха в другом порядке — из памяти
+    }
+
+    for (int i = 0; i < n; ++i) {
+        char stem[32];
+        std::snprintf(stem, sizeof(stem), "/s%03d", i);
+        std::remove((dir + stem + ".ply").c_str());
+        std::remove((dir + stem + "_cls.txt").c_str());
+    }
+    std::remove((shard_dir + "/shard-00000.pgs").c_str());
+    ::rmdir(dir.c_str());
+    ::rmdir(shard_dir.c_str());
+    std::cout << "[OK] Sampler tests passed\n";
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/Augment.h"
+#include "data/DataLoader.h"
+#include "data/Sampler.h"
+#include "data/SegLabels.h"
+#include "TestUtils.h"
+
+using seglabels::Encoding;
+
+// Метки 32³ «поверхности»: ~density ненулевых вокселей, сериями по run
+static std::vector<uint8_t> surfaceLabels(double density, int run, uint64_t seed) {
+    sampler::SplitMix64 rng{seed};
+    std::vector<uint8_t> v(32 * 32 * 32, 0);
+    for (size_t i = 0; i < v.size(); i += run)
+        if (rng.unit() < density) {
+            const uint8_t l = static_cast<uint8_t>(1 + rng.below(6));
+            for (size_t k = i; k < std::min(v.size(), i + run); ++k) v[k] = l;
+        }
+    return v;
+}
+
+static bool throwsOnDecode(const std::vector<uint8_t>& blob, int grid = 32) {
+    std::vector<uint8_t> out(static_cast<size_t>(grid) * grid * grid);
+    try {
+        seglabels::decode(blob.data(), blob.size(), grid, "blob", out.data());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// PLY образца i с вокселем (i, 1, 2)
+static void writeSegSample(const std::string& base, int i, const std::vector<uint8_t>& seg, bool compact) {
+    testutil::writeSample(base, {{i, 1, 2}}, i % 3);
+    if (compact) {
+        seglabels::write(base + ".seg", seg.data(), 32, seglabels::smallest(seg.data(), 32));
+    } else {
+        std::ofstream txt(base + "_seg.txt");
+        for (uint8_t l : seg) txt << static_cast<int>(l) << "\n";
+    }
+}
+
+int main() {
+    std::cout << "=== Тест компактных меток сегментации ===\n";
+
+    // 1) Все кодировки восстанавливают метки, размер — как обещает encodedSize
+    {
+        std::vector<std::vector<uint8_t>> cases = {
+            surfaceLabels(0.05, 1, 1), surfaceLabels(0.05, 8, 2), surfaceLabels(0.9, 1, 3),
+            std::vector<uint8_t>(32 * 32 * 32, 0), std::vector<uint8_t>(32 * 32 * 32, 255)};
+        for (const auto& labels : cases)
+            for (Encoding e : {Encoding::Dense, Encoding::Sparse, Encoding::Rle}) {
+                std::vector<uint8_t> blob, back(labels.size(), 77);
+                seglabels::encode(labels.data(), 32, e, blob);
+                assert(blob.size() == seglabels::encodedSize(labels.data(), 32, e));
+                seglabels::decode(blob.data(), blob.size(), 32, "blob", back.data());
+                assert(back == labels);
+            }
+        // Малые сетки и длинные серии (varint в несколько байт)
+        std::vector<uint8_t> tiny = {0, 3, 0, 0, 0, 0, 0, 9};
+        for (Encoding e : {Encoding::Dense, Encoding::Sparse, Encoding::Rle}) {
+            std::vector<uint8_t> blob, back(8);
+            seglabels::encode(tiny.data(), 2, e, blob);
+            seglabels::decode(blob.data(), blob.size(), 2, "tiny", back.data());
+            assert(back == tiny);
+        }
+    }
+
+    // 2) Выбор кодировки и выигрыш на типичной поверхности
+    {
+        const auto scattered = surfaceLabels(0.04, 1, 4), runs = surfaceLabels(0.1, 16, 5);
+        const auto dense = surfaceLabels(0.95, 1, 6);
+        assert(seglabels::smallest(scattered.data(), 32) == Encoding::Sparse);
+        assert(seglabels::smallest(runs.data(), 32) == Encoding::Rle);
+        assert(seglabels::smallest(dense.data(), 32) == Encoding::Dense);
+        const size_t bytes = seglabels::encodedSize(scattered.data(), 32, Encoding::Sparse);
+        std::cout << "поверхность 4%: " << bytes << " байт вместо " << scattered.size() * sizeof(float)
+                  << " (float) и ~" << scattered.size() * 2 << " (_seg.txt)\n";
+        assert(bytes * 10 < scattered.size());
+    }
+
+    // 3) Повреждённые блоки
+    {
+        const auto labels = surfaceLabels(0.05, 4, 7);
+        for (Encoding e : {Encoding::Dense, Encoding::Sparse, Encoding::Rle}) {
+            std::vector<uint8_t> blob;
+            seglabels::encode(labels.data(), 32, e, blob);
+            auto bad = blob;
+            bad.resize(bad.size() - 1);
+            assert(throwsOnDecode(bad));                     // обрезан
+            bad = blob;
+            bad[0] = 'X';
+            assert(throwsOnDecode(bad));                     // сигнатура
+            assert(throwsOnDecode(blob, 16));                // другая сетка
+        }
+        // Серия длиннее сетки и разреженный индекс за её пределами
+        std::vector<uint8_t> allz(32 * 32 * 32, 0), blob;
+        seglabels::encode(allz.data(), 32, Encoding::Rle, blob);
+        blob.push_back(1);
+        blob.push_back(0);
+        blob[12] += 2;  // payload_bytes
+        assert(throwsOnDecode(blob));
+        std::vector<uint8_t> one = allz;
+        one.back() = 4;
+        seglabels::encode(one.data(), 32, Encoding::Sparse, blob);
+        blob.push_back(0);
+        blob.push_back(4);
+        blob[12] += 2;
+        assert(throwsOnDecode(blob));
+    }
+
+    // 4) Текст: значения, нехватка меток, метка вне байта
+    {
+        const char good[] = " 0 7\n255\t1 ";
+        uint8_t out[4];
+        seglabels::parseText(good, sizeof(good) - 1, 1, "t", out);
+        assert(out[0] == 0);
+        const char many[] = "0 1 2 3 4 5 6 7";
+        uint8_t cube[8];
+        seglabels::parseText(many, sizeof(many) - 1, 2, "t", cube);
+        assert(cube[7] == 7);
+        bool threw = false;
+        try { seglabels::parseText("1 2 3", 5, 2, "t", cube); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+        threw = false;
+        try { seglabels::parseText("1 2 3 4 5 6 7 256", 17, 2, "t", cube); } catch (const std::runtime_error&) { threw = true; }
+        assert(threw);
+    }
+
+    // 5) DataLoader: .seg важнее _seg.txt, метки те же; батч байтами с аугментацией
+    const std::string dir = "test_seg_labels_data";
+    ::mkdir(dir.c_str(), 0755);
+    const int n = 6;
+    std::vector<std::vector<uint8_t>> segs;
+    for (int i = 0; i < n; ++i) {
+        segs.push_back(surfaceLabels(0.05, 2, 10 + i));
+        writeSegSample(dir + "/p" + std::to_string(i), i, segs.back(), /*compact=*/i % 2 == 0);
+    }
+    {
+        // Рядом с .seg — устаревший _seg.txt с другими метками: он не читается
+        std::ofstream(dir + "/p0_seg.txt") << "1\n";
+        DataLoader dl(dir, 3, 0.0f);
+        for (int i = 0; i < n; ++i) {
+            Tensor3D x, y;
+            std::vector<uint8_t> y8;
+            dl.loadSegSample(i, x, y8);
+            assert(y8 == segs[i] && x(i, 1, 2, 0) == 1.0f);
+            dl.loadSegSample(i, x, y);
+            for (int k = 0; k < y.size(); ++k) assert(y.data()[k] == segs[i][k]);
+        }
+        std::remove((dir + "/p0_seg.txt").c_str());
+
+        augment::Config cfg;
+        cfg.dropout = 0.2f;
+        DataLoader aug(dir, 3, 0.0f);
+        aug.enableAugmentation(cfg, 5);
+        aug.reset(2);
+        SegBatch batch;
+        aug.nextSegBatch(batch, true);
+        assert(batch.x.size() == 3 && batch.y.size() == 3);
+        for (size_t i = 0; i < batch.x.size(); ++i) {
+            Tensor3D x, y;
+            dl.loadSegSample(i, x, y);
+            augment::apply(augment::draw(cfg, 5, 2, i), x, &y);
+            assert(batch.y[i].size() == static_cast<size_t>(y.size()));
+            for (int k = 0; k < y.size(); ++k)
+                assert(batch.y[i][k] == y.data()[k] && batch.x[i].data()[k] == x.data()[k]);
+        }
+        // Повторный батч в тот же SegBatch — без новых буферов меток
+        const uint8_t* before = batch.y[0].data();
+        aug.nextSegBatch(batch, true);
+        assert(batch.y.size() == 3 && batch.y[0].data() == before);
+    }
+
+    // 6) Время чтения меток одного образца: текст и компактный файл
+    {
+        const auto labels = surfaceLabels(0.05, 2, 99);
+        const std::string txt = dir + "/t_seg.txt", bin = dir + "/t.seg";
+        {
+            std::ofstream out(txt);
+            for (uint8_t l : labels) out << static_cast<int>(l) << "\n";
+        }
+        seglabels::write(bin, labels.data(), 32, seglabels::smallest(labels.data(), 32));
+        struct stat st_txt{}, st_bin{};
+        ::stat(txt.c_str(), &st_txt);
+        ::stat(bin.c_str(), &st_bin);
+        std::vector<uint8_t> out;
+        for (const std::string& path : {txt, bin}) {
+            const int reps = 200;
+            auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; ++r) seglabels::read(path, 32, out);
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / reps;
+            assert(out == labels);
+            std::cout << path << ": " << (path == txt ? st_txt.st_size : st_bin.st_size) << " байт, "
+                      << us << " мкс на чтение\n";
+        }
+        std::remove(txt.c_str());
+        std::remove(bin.c_str());
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const std::string base = dir + "/p" + std::to_string(i);
+        for (const char* suf : {".ply", "_cls.txt", "_seg.txt", ".seg"}) std::remove((base + suf).c_str());
+    }
+    ::rmdir(dir.c_str());
+    std::cout << "[OK] Seg label tests passed\n";
+    return 0;
+}
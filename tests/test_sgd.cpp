@@ -42,6 +42,38 @@ int main() {
     assert(almostEqual(w[0], 0.785f));
     assert(almostEqual(w[1], -1.845f));
 
+    // Тензоры подряд в одной арене (быстрый путь, 2 потока) и те же
+    // тензоры отдельными векторами должны обновляться одинаково
+    {
+        const size_t n1 = 37, n2 = 70000;
+        std::vector<float> arena_p(n1 + n2), arena_g(n1 + n2);
+        std::vector<float> p1(n1), g1(n1), p2(n2), g2(n2);
+        for (size_t i = 0; i < n1 + n2; ++i) {
+            arena_p[i] = 0.001f * float(i % 97);
+            arena_g[i] = 0.01f * float(int(i % 13) - 6);
+        }
+        std::copy(arena_p.begin(), arena_p.begin() + n1, p1.begin());
+        std::copy(arena_p.begin() + n1, arena_p.end(), p2.begin());
+        std::copy(arena_g.begin(), arena_g.begin() + n1, g1.begin());
+        std::copy(arena_g.begin() + n1, arena_g.end(), g2.begin());
+
+        SGD flat(0.1f, 0.9f), split(0.1f, 0.9f);
+        flat.setThreads(2);
+        flat.addParam(arena_p.data(), arena_g.data(), n1);
+        flat.addParam(arena_p.data() + n1, arena_g.data() + n1, n2);
+        split.addParam(p1, g1);
+        split.addParam(p2, g2);
+        for (int it = 0; it < 3; ++it) { flat.step(); split.step(); }
+
+        for (size_t i = 0; i < n1; ++i) assert(almostEqual(arena_p[i], p1[i]));
+        for (size_t i = 0; i < n2; ++i) assert(almostEqual(arena_p[n1 + i], p2[i]));
+        auto vels = flat.getVelocityStates();
+        assert(vels.size() == 2 && vels[0].size() == n1 && vels[1].size() == n2);
+
+        flat.zeroGrad();
+        for (float v : arena_g) assert(v == 0.0f);
+    }
+
     std::cout << "[OK] Все проверки пройдены!\n";
     return 0;
 }
@@ -0,0 +1,178 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "data/DataLoader.h"
+#include "data/Shard.h"
+#include "TestUtils.h"
+
+using testutil::same;
+
+static bool exists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+// Образец i: несколько вокселей, класс i % 10, сегментация — (d + i) % 7
+static void writeSegSample(const std::string& dir, int i) {
+    const std::string base = dir + "/s" + std::to_string(100 + i);
+    testutil::writeSample(base, {{i, 2 * i, 31 - i}, {0, 0, 0}, {31, 31, i}}, i % 10);
+    std::ofstream seg(base + "_seg.txt");
+    for (int d = 0; d < 32; ++d)
+        for (int k = 0; k < 32 * 32; ++k) seg << (d + i) % 7 << " ";
+}
+
+int main() {
+    std::cout << "=== Тест Shard ===\n";
+
+    // 1) Упаковка битов туда и обратно, включая хвост не кратный 16
+    {
+        std::mt19937 gen(1);
+        std::bernoulli_distribution occ(0.3);
+        for (size_t n : {1u, 15u, 16u, 37u, 32768u}) {
+            std::vector<float> v(n), back(n, -1.0f);
+            for (auto& x : v) x = occ(gen) ? 1.0f : 0.0f;
+            std::vector<uint8_t> bits((n + 7) / 8, 0xFF);
+            shard::packBits(v.data(), n, bits.data());
+            shard::unpackBits(bits.data(), n, back.data());
+            assert(back == v);
+        }
+        uint8_t lab[20];
+        float   f[20];
+        for (int i = 0; i < 20; ++i) lab[i] = static_cast<uint8_t>(i * 13);
+        shard::widenLabels(lab, 20, f);
+        for (int i = 0; i < 20; ++i) assert(f[i] == static_cast<float>(lab[i]));
+    }
+
+    const std::string ply_dir = "test_shard_ply", shard_dir = "test_shard_pgs";
+    ::mkdir(ply_dir.c_str(), 0755);
+    ::mkdir(shard_dir.c_str(), 0755);
+    const int n = 7;
+    for (int i = 0; i < n; ++i) writeSegSample(ply_dir, i);
+
+    // 2) Два шарда из тех же файлов (как make_shards --per-shard=4):
+    //    первый с плотными метками (версия 1), второй — со сжатыми
+    for (int s = 0; s < 2; ++s) {
+        const std::string path = shard_dir + "/shard-0000" + std::to_string(s) + ".pgs";
+        ShardWriter w(path, 32, /*with_seg=*/true, /*encode_seg=*/s == 1);
+        for (int i = 4 * s; i < std::min(n, 4 * s + 4); ++i) {
+            const std::string base = ply_dir + "/s" + std::to_string(100 + i);
+            Tensor3D seg = DataLoader::loadSegMask(base + "_seg.txt");
+            std::vector<uint8_t> seg8(seg.size());
+            for (int k = 0; k < seg.size(); ++k) seg8[k] = static_cast<uint8_t>(seg.data()[k]);
+            w.add("s" + std::to_string(100 + i), DataLoader::loadVoxelMask(base + ".ply"),
+                  DataLoader::loadLabels(base + "_cls.txt")[0], seg8.data());
+        }
+        assert(exists(path + ".tmp") && !exists(path));
+        w.finish();
+        assert(!exists(path + ".tmp") && exists(path));
+    }
+
+    // 3) Содержимое шарда: метки, имена, распаковка, выравнивание, CRC
+    const std::string first = shard_dir + "/shard-00000.pgs";
+    {
+        assert(MappedShard::isShard(first));
+        MappedShard sh(first, /*verify=*/true);
+        assert(sh.size() == 4 && sh.grid() == 32 && sh.hasSeg());
+        for (size_t i = 0; i < sh.size(); ++i) {
+            assert(sh.label(static_cast<int>(i)) == static_cast<int>(i) % 10);
+            assert(sh.name(i) == "s" + std::to_string(100 + i));
+            assert(reinterpret_cast<uintptr_t>(sh.occupancy(i)) % shard::kAlign == 0);
+            Tensor3D x, y;
+            sh.unpackOccupancy(i, x);
+            sh.unpackSeg(i, y);
+            const std::string base = ply_dir + "/s" + std::to_string(100 + i);
+            assert(same(x, DataLoader::loadVoxelMask(base + ".ply")));
+            assert(same(y, DataLoader::loadSegMask(base + "_seg.txt")));
+        }
+    }
+
+    // 3б) Сжатые метки: те же значения, запись короче плотной
+    {
+        MappedShard sh(shard_dir + "/shard-00001.pgs", /*verify=*/true);
+        assert(sh.hasSeg() && sh.segEncoded() && !MappedShard(first).segEncoded());
+        for (size_t i = 0; i < sh.size(); ++i) {
+            assert(sh.segBytes(i) < 32 * 32 * 32 / 10);
+            Tensor3D y;
+            std::vector<uint8_t> y8;
+            sh.unpackSeg(i, y);
+            sh.unpackSeg(i, y8);
+            const std::string base = ply_dir + "/s" + std::to_string(104 + i);
+            assert(same(y, DataLoader::loadSegMask(base + "_seg.txt")));
+            for (int k = 0; k < y.size(); ++k) assert(y8[k] == y.data()[k]);
+        }
+    }
+
+    // 4) DataLoader над шардами выдаёт те же батчи, что над PLY
+    {
+        DataLoader a(ply_dir, 3, 0.3f), b(shard_dir, 3, 0.3f);
+        assert(b.sharded() && !a.sharded());
+        assert(a.getNumTrainSamples() == b.getNumTrainSamples());
+        assert(a.getNumValSamples() == b.getNumValSamples());
+        for (int step = 0; step < 4; ++step) {
+            auto pa = a.nextBatch(step % 2 == 0), pb = b.nextBatch(step % 2 == 0);
+            assert(pa.second == pb.second);
+            for (size_t i = 0; i < pa.first.size(); ++i) assert(same(pa.first[i], pb.first[i]));
+        }
+        a.reset(); b.reset();
+        auto sa = a.nextSegBatch(true), sb = b.nextSegBatch(true);
+        for (size_t i = 0; i < sa.first.size(); ++i)
+            assert(same(sa.first[i], sb.first[i]) && same(sa.second[i], sb.second[i]));
+        // Валидационные образцы лежат в сжатом шарде; метки байтами без расширения
+        SegBatch ba, bb;
+        a.nextSegBatch(ba, false);
+        b.nextSegBatch(bb, false);
+        assert(ba.y.size() == 3 && ba.y == bb.y);
+        for (size_t i = 0; i < ba.x.size(); ++i) assert(same(ba.x[i], bb.x[i]));
+    }
+
+    // 5) Повреждения: бит в данных ловит только verify, обрезку — всегда
+    {
+        std::ifstream in(first, std::ios::binary);
+        std::vector<char> good((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        auto rewrite = [&](const std::vector<char>& bytes) {
+            std::ofstream out(first, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        };
+        auto throws = [&](bool verify) {
+            try { MappedShard sh(first, verify); } catch (const std::runtime_error&) { return true; }
+            return false;
+        };
+        auto bad = good;
+        bad[200] ^= 0x01;
+        rewrite(bad);
+        assert(!throws(false) && throws(true));
+        bad = good;
+        bad.resize(bad.size() - 64);
+        rewrite(bad);
+        assert(throws(false));
+        rewrite(good);
+        assert(!throws(true));
+    }
+
+    // 6) Незавершённый шард не остаётся на диске
+    {
+        const std::string path = shard_dir + "/aborted.pgs";
+        {
+            ShardWriter w(path, 32, false);
+            w.add("x", Tensor3D(32, 32, 32, 1), 0);
+        }
+        assert(!exists(path) && !exists(path + ".tmp"));
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const std::string base = ply_dir + "/s" + std::to_string(100 + i);
+        for (const char* suf : {".ply", "_cls.txt", "_seg.txt"}) std::remove((base + suf).c_str());
+    }
+    std::remove((shard_dir + "/shard-00000.pgs").c_str());
+    std::remove((shard_dir + "/shard-00001.pgs").c_str());
+    ::rmdir(ply_dir.c_str());
+    ::rmdir(shard_dir.c_str());
+    std::cout << "[OK] Shard tests passed\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <cmath>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "dist/ShmAllReduce.h"
+#include "dist/GradientSync.h"
+
+// Тело ранга: возвращает 0, если все проверки прошли (assert в ребёнке
+// завершит только его, поэтому результат передаём кодом выхода)
+static int rankMain(const std::string& name, int rank, int K) {
+    ShmAllReduce comm(name, rank);
+    comm.setTimeoutSeconds(30.0);
+    if (comm.rank() != rank || comm.world() != K) return 1;
+
+    // allReduce: у ранга r значение r + 1 + i, сумма известна заранее.
+    // Длина 1000 не делится на K — проверяем неровные куски кольца.
+    for (size_t n : {size_t(1), size_t(5), size_t(1000)}) {
+        std::vector<float> v(n);
+        for (size_t i = 0; i < n; ++i) v[i] = float(rank + 1) + float(i);
+        comm.allReduce(v.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            float expect = float(K * (K + 1) / 2) + float(K) * float(i);
+            if (std::fabs(v[i] - expect) > 1e-3f) return 2;
+        }
+    }
+
+    // broadcast с некорневого ранга
+    std::vector<float> b(17, float(rank));
+    comm.broadcast(b.data(), b.size(), K - 1);
+    for (float x : b) if (x != float(K - 1)) return 3;
+
+    // Синхронизация сети: после broadcast веса одинаковы, градиенты — сумма
+    Network net;
+    broadcastParameters(net, comm);
+    auto grads = net.gradients();
+    for (auto* g : grads) std::fill(g->begin(), g->end(), 1.0f);
+    allReduceGradients(net, comm);
+    for (auto* g : grads)
+        for (float x : *g) if (x != float(K)) return 4;
+
+    // Сумма весов — одинаковая у всех рангов, если broadcast сработал
+    double s = 0.0;
+    for (auto* p : net.parameters()) for (float x : *p) s += x;
+    float sum = static_cast<float>(s), sums[1] = { sum };
+    comm.allReduce(sums, 1);
+    if (std::fabs(sums[0] - K * sum) > 1e-2f * (1.0f + std::fabs(sums[0]))) return 5;
+
+    comm.barrier();
+    return 0;
+}
+
+int main(){
+    std::cout << "=== Тест ShmAllReduce ===\n";
+
+    for (int K : {1, 2, 3, 4}) {
+        Network probe;
+        const std::string name = "/pointgrid_test_" + std::to_string(::getpid());
+        ShmAllReduce::create(name, K, probe.flatSize());
+
+        std::vector<pid_t> kids;
+        for (int r = 0; r < K; ++r) {
+            pid_t pid = ::fork();
+            assert(pid >= 0);
+            if (pid == 0) ::_exit(rankMain(name, r, K));
+            kids.push_back(pid);
+        }
+        for (pid_t pid : kids) {
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                std::cout << "  rank pid " << pid << " code " << WEXITSTATUS(status) << "\n";
+            assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+        ShmAllReduce::unlink(name);
+        std::cout << "world=" << K << " ok\n";
+    }
+
+    // Подключение к несуществующему сегменту и неверный ранг
+    bool threw = false;
+    try { ShmAllReduce c("/pointgrid_missing_segment", 0); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+    {
+        const std::string name = "/pointgrid_test_rank_" + std::to_string(::getpid());
+        ShmAllReduce::create(name, 2, 16);
+        threw = false;
+        try { ShmAllReduce c(name, 2); } catch (const std::invalid_argument&) { threw = true; }
+        assert(threw);
+        ShmAllReduce c(name, 0);
+        std::vector<float> big(17);
+        threw = false;
+        try { c.allReduce(big.data(), big.size()); } catch (const std::invalid_argument&) { threw = true; }
+        assert(threw);
+        ShmAllReduce::unlink(name);
+    }
+
+    std::cout << "[OK] ShmAllReduce tests passed\n";
+    return 0;
+}
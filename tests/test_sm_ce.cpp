@@ -61,6 +61,22 @@ int main(){
         }
     }
 
+    // 3) Метки вокселей байтами (сегментация) — то же, что int
+    {
+        std::vector<float>   logits = {0.5f, -1.0f, 2.0f,   1.0f, 1.0f, 0.0f,   -2.0f, 0.0f, 3.0f};
+        std::vector<int>     labels = {2, 0, 1};
+        std::vector<uint8_t> bytes  = {2, 0, 1};
+        float loss_int  = crit.forward(logits, labels);
+        auto  grad_int  = crit.backward();
+        float loss_byte = crit.forward(logits, bytes);
+        auto  grad_byte = crit.backward();
+        std::cout << "Loss3 = " << loss_byte << " (int: " << loss_int << ")\n";
+        assert(loss_int == loss_byte && grad_int == grad_byte);
+        // после int-меток backward снова по ним
+        crit.forward(logits, labels);
+        assert(crit.backward() == grad_int);
+    }
+
     std::cout << "[OK] SoftmaxCrossEntropy tests passed\n";
     return 0;
 }
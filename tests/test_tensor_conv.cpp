@@ -61,9 +61,9 @@ int main(){
     Conv3D conv(1,1,1,2,2,1,1,1, Conv3D::Padding::VALID);
     // Все веса =1, bias=0
     {
-        auto& W = const_cast<std::vector<float>&>(conv.weight());
+        auto& W = conv.weight();
         std::fill(W.begin(), W.end(), 1.0f);
-        auto& B = const_cast<std::vector<float>&>(conv.bias());
+        auto& B = conv.bias();
         std::fill(B.begin(), B.end(), 0.0f);
     }
 
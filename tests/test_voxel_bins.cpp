@@ -0,0 +1,137 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include "data/Sampler.h"
+#include "data/VoxelMask.h"
+
+// Облако из count точек по stride float, x/y/z — первые три
+static std::vector<float> makePoints(size_t count, size_t stride, uint64_t seed) {
+    sampler::SplitMix64 rng{seed};
+    std::vector<float> v(count * stride);
+    for (size_t i = 0; i < count; ++i)
+        for (size_t a = 0; a < stride; ++a)
+            v[i * stride + a] = a < 3 ? static_cast<float>(rng.unit() * (10.0 + 5.0 * a) - 3.0 * a)
+                                      : static_cast<float>(1e6 * rng.unit());  // «нормали», метки
+    return v;
+}
+
+static Bounds scalarBounds(const std::vector<float>& v, size_t count, size_t stride) {
+    Bounds b;
+    for (int a = 0; a < 3; ++a) b.lo[a] = b.hi[a] = v[a];
+    for (size_t i = 0; i < count; ++i)
+        for (int a = 0; a < 3; ++a) {
+            b.lo[a] = std::min(b.lo[a], v[i * stride + a]);
+            b.hi[a] = std::max(b.hi[a], v[i * stride + a]);
+        }
+    return b;
+}
+
+static bool sameBounds(const Bounds& a, const Bounds& b) {
+    for (int k = 0; k < 3; ++k)
+        if (a.lo[k] != b.lo[k] || a.hi[k] != b.hi[k]) return false;
+    return true;
+}
+
+// Прежняя разметка: ключи (ячейка << 32 | метка), сортировка, большинство в серии
+static void sortedSeg(const float* xyz, const int32_t* labels, size_t count, int n, std::vector<uint8_t>& seg) {
+    const NormalizedGrid g(xyz, count, n, n, n);
+    std::map<size_t, std::map<int32_t, int>> votes;
+    for (size_t i = 0; i < count; ++i) {
+        auto& cell = votes[g.cell(xyz + 3 * i)];
+        if (labels[i] >= 0) ++cell[labels[i]];
+    }
+    seg.assign(g.cells(), 0);
+    for (const auto& [c, m] : votes) {
+        int best = 0, best_n = 0;
+        for (const auto& [l, k] : m)
+            if (k > best_n) { best = l; best_n = k; }
+        seg[c] = static_cast<uint8_t>(best);
+    }
+}
+
+int main() {
+    std::cout << "=== Тест границ облака и раскладки точек по ячейкам ===\n";
+
+    // 1) Границы: любые шаги структуры и хвосты, потоки, NaN не портит бокс
+    {
+        for (size_t stride : {3, 4, 7, 16, 19})
+            for (size_t count : {1, 5, 16, 17, 1000, 140001}) {
+                const auto v = makePoints(count, stride, stride * 1000 + count);
+                const Bounds expect = scalarBounds(v, count, stride);
+                for (int threads : {1, 4})
+                    assert(sameBounds(computeBounds(v.data(), count, stride, threads), expect));
+            }
+        auto v = makePoints(64, 3, 1);
+        const Bounds expect = scalarBounds(v, 64, 3);
+        v[3 * 40 + 1] = std::numeric_limits<float>::quiet_NaN();
+        const Bounds got = computeBounds(v.data(), 64, 3);
+        assert(got.lo[0] == expect.lo[0] && got.hi[2] == expect.hi[2]);
+        assert(!std::isnan(got.lo[1]) && !std::isnan(got.hi[1]));
+
+        const Bounds empty = computeBounds(nullptr, 0);
+        assert(empty.lo[0] == 0.0f && empty.hi[2] == 0.0f);
+    }
+
+    // 2) CSR: каждая точка в своей ячейке, порядок внутри ячейки — исходный,
+    //    результат не зависит от числа потоков
+    {
+        const size_t count = 200000;
+        const auto v = makePoints(count, 3, 7);
+        const NormalizedGrid g(v.data(), count, 32, 32, 32);
+        CellIndex one, many;
+        binPoints(v.data(), count, g, one, 1);
+        binPoints(v.data(), count, g, many, 4);
+        assert(one.start == many.start && one.order == many.order && one.occupied == many.occupied);
+        assert(one.start.size() == g.cells() + 1 && one.start.back() == count);
+        size_t seen = 0;
+        uint32_t prev_cell = 0;
+        for (size_t k = 0; k < one.occupied.size(); ++k) {
+            const uint32_t c = one.occupied[k];
+            assert(k == 0 || c > prev_cell);
+            prev_cell = c;
+            assert(one.start[c + 1] > one.start[c]);
+            for (uint32_t j = one.start[c]; j < one.start[c + 1]; ++j) {
+                assert(g.cell(v.data() + 3 * one.order[j]) == c);
+                assert(j == one.start[c] || one.order[j] > one.order[j - 1]);
+            }
+            seen += one.start[c + 1] - one.start[c];
+        }
+        assert(seen == count);
+
+        // Повторное использование индекса на меньшем облаке
+        binPoints(v.data(), 10, g, many, 4);
+        assert(many.start.back() == 10 && many.order.size() == 10);
+    }
+
+    // 3) Голосование по ячейкам совпадает с прежней сортировкой ключей
+    {
+        const size_t count = 150000;
+        const auto v = makePoints(count, 3, 11);
+        sampler::SplitMix64 rng{3};
+        std::vector<int32_t> labels(count);
+        for (auto& l : labels) l = static_cast<int32_t>(rng.below(5)) - 1;
+        std::vector<uint8_t> expect;
+        sortedSeg(v.data(), labels.data(), count, 32, expect);
+        for (int threads : {1, 4}) {
+            Tensor3D mask(32, 32, 32, 1);
+            mask.fill(0.0f);
+            std::vector<uint8_t> seg(expect.size(), 0);
+            CellIndex cells;
+            rasterizeNormalizedSeg(v.data(), labels.data(), count, mask, seg.data(), cells, threads);
+            assert(seg == expect);
+            Tensor3D plain(32, 32, 32, 1);
+            plain.fill(0.0f);
+            rasterizeNormalized(v.data(), count, plain);
+            for (int k = 0; k < plain.size(); ++k) assert(plain.data()[k] == mask.data()[k]);
+        }
+    }
+
+    std::cout << "[OK] Voxel bin tests passed\n";
+    return 0;
+}